@@ -200,6 +200,37 @@ m_xhalf(m, k, err)
 }
 #endif
 
+#if !defined(KERNEL) && !defined(_KERNEL)
+/*
+ * Source of the numbers loaded from BPF_AD_RANDOM; a xorshift
+ * generator, so that a savefile filtered with the same program
+ * always yields the same packets.  Each thread has its own, so that
+ * threads filtering packets don't race on it; with compilers that
+ * don't support thread-local variables, all threads share one.
+ */
+#if defined(_MSC_VER)
+#define BPF_THREAD_LOCAL	__declspec(thread)
+#elif defined(__GNUC__)
+#define BPF_THREAD_LOCAL	__thread
+#else
+#define BPF_THREAD_LOCAL
+#endif
+
+static BPF_THREAD_LOCAL u_int32 bpf_random_state = 2463534242U;
+
+static u_int32
+bpf_random(void)
+{
+	u_int32 x = bpf_random_state;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	bpf_random_state = x;
+	return x;
+}
+#endif
+
 /*
  * Execute the filter program starting at pc on the packet p
  * wirelen is the length of the original packet
@@ -255,6 +286,12 @@ bpf_filter(pc, p, wirelen, buflen)
 
 		case BPF_LD|BPF_W|BPF_ABS:
 			k = pc->k;
+#if !defined(KERNEL) && !defined(_KERNEL)
+			if (pc->k == BPF_AD_RANDOM) {
+				A = bpf_random();
+				continue;
+			}
+#endif
 			if (k + sizeof(int32) > buflen) {
 #if defined(KERNEL) || defined(_KERNEL)
 				if (m == NULL)
@@ -0,0 +1 @@
+./bpf/net/bpf_filter.c
\ No newline at end of file
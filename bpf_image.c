@@ -82,7 +82,7 @@ bpf_image(p, n)
 
 	case BPF_LD|BPF_W|BPF_ABS:
 		op = "ld";
-		fmt = "[%d]";
+		fmt = p->k == BPF_AD_RANDOM ? "rand" : "[%d]";
 		break;
 
 	case BPF_LD|BPF_H|BPF_ABS:
@@ -0,0 +1,343 @@
+/*
+ * Copyright (c) 1993, 1994, 1995, 1996, 1997
+ *	The Regents of the University of California.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that: (1) source code distributions
+ * retain the above copyright notice and this paragraph in its entirety, (2)
+ * distributions including binary code include the above copyright notice and
+ * this paragraph in its entirety in the documentation or other materials
+ * provided with the distribution, and (3) all advertising materials mentioning
+ * features or use of this software display the following acknowledgement:
+ * ``This product includes software developed by the University of California,
+ * Lawrence Berkeley Laboratory and its contributors.'' Neither the name of
+ * the University nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * dedup.c - suppression of duplicate packets
+ *
+ * A SPAN port or tap often delivers a packet twice, once as it enters
+ * the mirrored switch and once as it leaves it.  The copies differ in
+ * the IPv4 TTL and header checksum, or the IPv6 hop limit, and possibly
+ * in the link-layer header, so we hash the rest of the packet from the
+ * network-layer header on, and drop a packet if a packet with the same
+ * hash was seen within a time window.  The hashes live in a fixed-size
+ * open-addressing table; each one probes a few slots, reusing an expired
+ * or, failing that, the oldest one, so the table never grows.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#ifdef WIN32
+#include <pcap-stdinc.h>
+#else /* WIN32 */
+#if HAVE_INTTYPES_H
+#include <inttypes.h>
+#elif HAVE_STDINT_H
+#include <stdint.h>
+#endif
+#ifdef HAVE_SYS_BITYPES_H
+#include <sys/bitypes.h>
+#endif
+#include <sys/types.h>
+#endif /* WIN32 */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pcap-int.h"
+
+#include "ethertype.h"
+#include "flowhash.h"
+
+#ifdef HAVE_OS_PROTO_H
+#include "os-proto.h"
+#endif
+
+#define DEDUP_DEFAULT_SIZE	65536
+#define DEDUP_MAX_SIZE		(1 << 24)
+#define DEDUP_PROBES		8	/* slots looked at for each hash */
+
+/*
+ * FNV-1a, 64 bits.
+ */
+#define FNV_OFFSET	0xcbf29ce484222325ULL
+#define FNV_PRIME	0x100000001b3ULL
+
+struct dedup_entry {
+	u_int64_t hash;		/* 0 if the slot has never been used */
+	u_int64_t ts;		/* time stamp of the packet, in microseconds */
+};
+
+struct pcap_dedup {
+	struct dedup_entry *table;
+	u_int mask;		/* table size - 1 */
+	u_int64_t window;	/* in microseconds */
+	u_int64_t dups;		/* packets dropped as duplicates */
+
+	/*
+	 * For live captures, the handle's own read routine, and the
+	 * callback, its argument, and the number of packets handed to
+	 * it for the read in progress.
+	 */
+	read_op_t read_op;
+	pcap_handler callback;
+	u_char *user;
+	int passed;
+};
+
+static u_int64_t
+hash_bytes(u_int64_t h, const u_char *cp, u_int len)
+{
+	while (len != 0) {
+		h ^= *cp++;
+		h *= FNV_PRIME;
+		len--;
+	}
+	return (h);
+}
+
+/*
+ * Hash the parts of a packet that are the same in every copy of it.
+ */
+static u_int64_t
+dedup_hash(int linktype, const struct pcap_pkthdr *h, const u_char *pkt)
+{
+	u_int64_t hash;
+	u_int off, ethertype, len;
+	bpf_u_int32 wirelen;
+	const u_char *nh;
+	int network;
+
+	/*
+	 * Raw IP link types have the network-layer header at offset
+	 * 0, so whether we found it is a separate question.
+	 */
+	network = flow_network(linktype, pkt, h->caplen, &off, &ethertype);
+	if (!network || off > h->caplen) {
+		network = 0;
+		off = 0;
+	}
+	nh = pkt + off;
+	len = h->caplen - off;
+
+	/*
+	 * Include the on-the-wire length of the part we hash, so that
+	 * packets that differ only past the snapshot length aren't
+	 * taken for copies of each other.
+	 */
+	wirelen = h->len - off;
+	hash = hash_bytes(FNV_OFFSET, (const u_char *)&wirelen,
+	    sizeof(wirelen));
+
+	if (network && ethertype == ETHERTYPE_IP && len >= 20) {
+		/*
+		 * Skip the TTL and the header checksum.
+		 */
+		hash = hash_bytes(hash, nh, 8);
+		hash = hash_bytes(hash, nh + 9, 1);
+		hash = hash_bytes(hash, nh + 12, len - 12);
+	} else if (network && ethertype == ETHERTYPE_IPV6 && len >= 40) {
+		/*
+		 * Skip the hop limit.
+		 */
+		hash = hash_bytes(hash, nh, 7);
+		hash = hash_bytes(hash, nh + 8, len - 8);
+	} else {
+		/*
+		 * Not IP; the whole packet has to match.
+		 */
+		hash = hash_bytes(hash, pkt, h->caplen);
+	}
+
+	/*
+	 * 0 marks an unused slot.
+	 */
+	if (hash == 0)
+		hash = 1;
+	return (hash);
+}
+
+/*
+ * Return 1 if the packet is a copy of one seen within the window, and
+ * 0, after remembering it, if it isn't.
+ */
+int
+pcap_dedup_check(pcap_t *p, const struct pcap_pkthdr *h, const u_char *pkt)
+{
+	struct pcap_dedup *d = p->dedup;
+	struct dedup_entry *e, *victim;
+	u_int64_t hash, ts, age, oldest;
+	u_int i, slot;
+
+	hash = dedup_hash(p->linktype, h, pkt);
+	ts = (u_int64_t)h->ts.tv_sec * 1000000 + h->ts.tv_usec;
+	victim = NULL;
+	oldest = 0;
+	slot = (u_int)(hash ^ (hash >> 32));
+	for (i = 0; i < DEDUP_PROBES; i++) {
+		e = &d->table[(slot + i) & d->mask];
+		if (e->hash == 0) {
+			/*
+			 * Slots are never emptied, so the hash can't be
+			 * in a later one.
+			 */
+			victim = e;
+			break;
+		}
+
+		/*
+		 * Packets from several sources may not be in time
+		 * stamp order, so a copy may appear to be older than
+		 * the original.
+		 */
+		age = ts >= e->ts ? ts - e->ts : e->ts - ts;
+		if (age <= d->window) {
+			if (e->hash == hash) {
+				d->dups++;
+				return (1);
+			}
+		} else
+			age = (u_int64_t)-1;	/* expired; reuse first */
+		if (victim == NULL || age > oldest) {
+			victim = e;
+			oldest = age;
+		}
+	}
+	victim->hash = hash;
+	victim->ts = ts;
+	return (0);
+}
+
+/*
+ * Callback for live captures; hand the packet to the application's
+ * callback unless it's a duplicate.
+ */
+static void
+dedup_callback(u_char *user, const struct pcap_pkthdr *h, const u_char *pkt)
+{
+	pcap_t *p = (pcap_t *)user;
+	struct pcap_dedup *d = p->dedup;
+
+	if (pcap_dedup_check(p, h, pkt))
+		return;
+	d->passed++;
+	(*d->callback)(d->user, h, pkt);
+}
+
+/*
+ * Read routine for live captures with duplicate suppression.  Returns
+ * the number of packets handed to the callback; if a read got nothing
+ * but duplicates, read again, so that we don't report a timeout that
+ * didn't happen.
+ */
+static int
+dedup_read(pcap_t *p, int cnt, pcap_handler callback, u_char *user)
+{
+	struct pcap_dedup *d = p->dedup;
+	int n;
+
+	d->callback = callback;
+	d->user = user;
+	do {
+		d->passed = 0;
+		n = d->read_op(p, cnt, dedup_callback, (u_char *)p);
+	} while (n > 0 && d->passed == 0 && !p->break_loop);
+	if (n > 0)
+		return (d->passed);
+	return (n);
+}
+
+u_int64_t
+pcap_dedup_count(pcap_t *p)
+{
+	if (p->dedup == NULL)
+		return (0);
+	return (p->dedup->dups);
+}
+
+void
+pcap_dedup_free(pcap_t *p)
+{
+	struct pcap_dedup *d = p->dedup;
+
+	if (d == NULL)
+		return;
+	if (d->read_op != NULL)
+		p->read_op = d->read_op;
+	free(d->table);
+	free(d);
+	p->dedup = NULL;
+}
+
+int
+pcap_setdedup(pcap_t *p, int window_ms, int size)
+{
+	struct pcap_dedup *d;
+	struct dedup_entry *table;
+	u_int n;
+
+	if (!p->activated) {
+		snprintf(p->errbuf, PCAP_ERRBUF_SIZE,
+		    "Duplicate suppression can only be set up on an activated pcap_t");
+		return (PCAP_ERROR_NOT_ACTIVATED);
+	}
+	if (window_ms < 0 || size < 0) {
+		snprintf(p->errbuf, PCAP_ERRBUF_SIZE,
+		    "Invalid duplicate suppression window or table size");
+		return (-1);
+	}
+	if (window_ms == 0) {
+		pcap_dedup_free(p);
+		return (0);
+	}
+
+	if (size == 0)
+		size = DEDUP_DEFAULT_SIZE;
+	if (size > DEDUP_MAX_SIZE)
+		size = DEDUP_MAX_SIZE;
+	for (n = DEDUP_PROBES; n < (u_int)size; n <<= 1)
+		;
+	table = (struct dedup_entry *)calloc(n, sizeof(*table));
+	if (table == NULL) {
+		snprintf(p->errbuf, PCAP_ERRBUF_SIZE, "calloc: %s",
+		    pcap_strerror(errno));
+		return (-1);
+	}
+
+	d = p->dedup;
+	if (d == NULL) {
+		d = (struct pcap_dedup *)malloc(sizeof(*d));
+		if (d == NULL) {
+			snprintf(p->errbuf, PCAP_ERRBUF_SIZE, "malloc: %s",
+			    pcap_strerror(errno));
+			free(table);
+			return (-1);
+		}
+		memset(d, 0, sizeof(*d));
+
+		/*
+		 * pcap_offline_read() checks savefile packets itself,
+		 * as pcap_loop() and pcap_next_ex() call it directly;
+		 * for live captures, interpose on the read routine.
+		 */
+		if (!PCAP_IS_SAVEFILE(p)) {
+			d->read_op = p->read_op;
+			p->read_op = dedup_read;
+		}
+		p->dedup = d;
+	} else
+		free(d->table);
+	d->table = table;
+	d->mask = n - 1;
+	d->window = (u_int64_t)window_ms * 1000;
+	return (0);
+}
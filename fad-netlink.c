@@ -0,0 +1,700 @@
+/* -*- Mode: c; tab-width: 8; indent-tabs-mode: 1; c-basic-offset: 8; -*- */
+/*
+ * Copyright (c) 1994, 1995, 1996, 1997, 1998
+ *	The Regents of the University of California.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. All advertising materials mentioning features or use of this software
+ *    must display the following acknowledgement:
+ *	This product includes software developed by the Computer Systems
+ *	Engineering Group at Lawrence Berkeley Laboratory.
+ * 4. Neither the name of the University nor of the Laboratory may be used
+ *    to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#include <net/if.h>
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef HAVE_NETPACKET_PACKET_H
+# include <netpacket/packet.h>
+#else /* HAVE_NETPACKET_PACKET_H */
+# include <linux/types.h>
+# include <linux/if_packet.h>
+#endif /* HAVE_NETPACKET_PACKET_H */
+
+#include <linux/types.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+#include "pcap-int.h"
+
+#ifdef HAVE_OS_PROTO_H
+#include "os-proto.h"
+#endif
+
+/*
+ * This gets the list of interfaces, and their addresses, from rtnetlink,
+ * with one RTM_GETLINK dump and one RTM_GETADDR dump, rather than with
+ * "getifaddrs()" followed by a scan of "/sys/class/net".
+ *
+ * "getifaddrs()" does the same dumps, but we then have to add its
+ * entries to the list one at a time, and looking up an interface in,
+ * and inserting an interface into, the list takes time linear in the
+ * length of the list; on a machine with thousands of interfaces (for
+ * example, a host for containers, each of which has a veth interface),
+ * that adds up.  Instead, we keep the interfaces we've found in a hash
+ * table indexed by interface index, which is what the address messages
+ * refer to, and add them all to the list in one step at the end.
+ */
+
+/*
+ * Size of the buffer into which we read netlink messages; dump replies
+ * are generally no larger than 32K.
+ */
+#define NL_BUFSIZE	65536
+
+/*
+ * An interface we've found.
+ */
+struct nl_if {
+	int	ifindex;
+	u_int	flags;
+	pcap_if_t *dev;
+};
+
+/*
+ * The interfaces we've found, in the order in which we found them, and
+ * an open-addressed hash table, indexed by interface index, of indices
+ * (plus 1, so that 0 means "empty") into that array.
+ */
+struct nl_iftab {
+	struct nl_if *ifs;
+	u_int	n_ifs;
+	u_int	max_ifs;
+	u_int	*hash;
+	u_int	hashsize;	/* a power of 2 */
+};
+
+/*
+ * Netlink socket, and the state of the request we've sent on it.
+ */
+struct nl_sock {
+	int	fd;
+	u_int	seq;
+	u_int	pid;
+	u_char	*buf;
+};
+
+#define NL_HASH(ifindex, hashsize)	\
+	(((u_int)(ifindex) * 2654435761U) & ((hashsize) - 1))
+
+static struct nl_if *
+nl_find_if(struct nl_iftab *tab, int ifindex)
+{
+	u_int i, n;
+
+	if (tab->hashsize == 0)
+		return (NULL);
+	for (i = NL_HASH(ifindex, tab->hashsize); (n = tab->hash[i]) != 0;
+	    i = (i + 1) & (tab->hashsize - 1)) {
+		if (tab->ifs[n - 1].ifindex == ifindex)
+			return (&tab->ifs[n - 1]);
+	}
+	return (NULL);
+}
+
+/*
+ * Add an interface to the table; we grow the array and the hash table
+ * by doubling, so that the hash table is never more than half full.
+ */
+static struct nl_if *
+nl_add_if(struct nl_iftab *tab, int ifindex, u_int flags, pcap_if_t *dev,
+    char *errbuf)
+{
+	struct nl_if *newifs;
+	u_int *newhash, newsize, i, j;
+
+	if (tab->n_ifs == tab->max_ifs) {
+		tab->max_ifs = (tab->max_ifs == 0) ? 64 : tab->max_ifs * 2;
+		newifs = realloc(tab->ifs, tab->max_ifs * sizeof(*newifs));
+		if (newifs == NULL) {
+			(void)snprintf(errbuf, PCAP_ERRBUF_SIZE,
+			    "malloc: %s", pcap_strerror(errno));
+			return (NULL);
+		}
+		tab->ifs = newifs;
+
+		newsize = tab->max_ifs * 2;
+		newhash = calloc(newsize, sizeof(*newhash));
+		if (newhash == NULL) {
+			(void)snprintf(errbuf, PCAP_ERRBUF_SIZE,
+			    "malloc: %s", pcap_strerror(errno));
+			return (NULL);
+		}
+		for (i = 0; i < tab->n_ifs; i++) {
+			for (j = NL_HASH(tab->ifs[i].ifindex, newsize);
+			    newhash[j] != 0; j = (j + 1) & (newsize - 1))
+				;
+			newhash[j] = i + 1;
+		}
+		free(tab->hash);
+		tab->hash = newhash;
+		tab->hashsize = newsize;
+	}
+
+	for (j = NL_HASH(ifindex, tab->hashsize); tab->hash[j] != 0;
+	    j = (j + 1) & (tab->hashsize - 1))
+		;
+	tab->ifs[tab->n_ifs].ifindex = ifindex;
+	tab->ifs[tab->n_ifs].flags = flags;
+	tab->ifs[tab->n_ifs].dev = dev;
+	tab->hash[j] = ++tab->n_ifs;
+	return (&tab->ifs[tab->n_ifs - 1]);
+}
+
+/*
+ * Send a dump request of the given type for the given address family.
+ */
+static int
+nl_request_dump(struct nl_sock *nl, int type, int family, char *errbuf)
+{
+	struct {
+		struct nlmsghdr nlh;
+		struct rtgenmsg g;
+	} req;
+	struct sockaddr_nl snl;
+
+	memset(&req, 0, sizeof(req));
+	req.nlh.nlmsg_len = NLMSG_LENGTH(sizeof(req.g));
+	req.nlh.nlmsg_type = type;
+	req.nlh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+	req.nlh.nlmsg_seq = ++nl->seq;
+	req.g.rtgen_family = family;
+
+	memset(&snl, 0, sizeof(snl));
+	snl.nl_family = AF_NETLINK;
+	if (sendto(nl->fd, &req, req.nlh.nlmsg_len, 0,
+	    (struct sockaddr *)&snl, sizeof(snl)) < 0) {
+		(void)snprintf(errbuf, PCAP_ERRBUF_SIZE,
+		    "Can't send rtnetlink request: %s", pcap_strerror(errno));
+		return (-1);
+	}
+	return (0);
+}
+
+/*
+ * Read the replies to the request we just sent, and hand each of them
+ * to "cb".  Returns 0 when we get to the end of the dump and -1 on an
+ * error.
+ */
+static int
+nl_read_dump(struct nl_sock *nl, struct nl_iftab *tab,
+    int (*cb)(struct nlmsghdr *, struct nl_iftab *, char *), char *errbuf)
+{
+	struct sockaddr_nl snl;
+	socklen_t snl_len;
+	struct nlmsghdr *nlh;
+	struct nlmsgerr *err;
+	ssize_t cc;
+	int len;
+
+	for (;;) {
+		snl_len = sizeof(snl);
+		cc = recvfrom(nl->fd, nl->buf, NL_BUFSIZE, 0,
+		    (struct sockaddr *)&snl, &snl_len);
+		if (cc < 0) {
+			if (errno == EINTR)
+				continue;
+			(void)snprintf(errbuf, PCAP_ERRBUF_SIZE,
+			    "Can't read rtnetlink reply: %s",
+			    pcap_strerror(errno));
+			return (-1);
+		}
+		if (snl.nl_pid != 0) {
+			/*
+			 * Not from the kernel.
+			 */
+			continue;
+		}
+
+		len = (int)cc;
+		for (nlh = (struct nlmsghdr *)nl->buf; NLMSG_OK(nlh, len);
+		    nlh = NLMSG_NEXT(nlh, len)) {
+			if (nlh->nlmsg_seq != nl->seq ||
+			    nlh->nlmsg_pid != nl->pid)
+				continue;	/* not a reply to our request */
+			switch (nlh->nlmsg_type) {
+
+			case NLMSG_DONE:
+				return (0);
+
+			case NLMSG_ERROR:
+				err = (struct nlmsgerr *)NLMSG_DATA(nlh);
+				(void)snprintf(errbuf, PCAP_ERRBUF_SIZE,
+				    "rtnetlink error: %s",
+				    nlh->nlmsg_len < NLMSG_LENGTH(sizeof(*err)) ?
+				      "truncated message" :
+				      pcap_strerror(-err->error));
+				return (-1);
+
+			default:
+				if ((*cb)(nlh, tab, errbuf) == -1)
+					return (-1);
+				break;
+			}
+		}
+	}
+}
+
+/*
+ * Largest link-layer address we handle; Infiniband addresses are 20
+ * bytes, which doesn't fit in a "struct sockaddr_ll".
+ */
+#define NL_MAX_HALEN	24
+
+struct sockaddr_ll_max {
+	struct sockaddr_ll sll;
+	u_char	pad[NL_MAX_HALEN - sizeof(((struct sockaddr_ll *)0)->sll_addr)];
+};
+
+static void
+nl_make_sockaddr_ll(struct sockaddr_ll_max *sllm, size_t *sizep,
+    struct ifinfomsg *ifi, struct rtattr *rta)
+{
+	size_t halen;
+
+	halen = RTA_PAYLOAD(rta);
+	if (halen > NL_MAX_HALEN)
+		halen = NL_MAX_HALEN;
+	memset(sllm, 0, sizeof(*sllm));
+	sllm->sll.sll_family = AF_PACKET;
+	sllm->sll.sll_ifindex = ifi->ifi_index;
+	sllm->sll.sll_hatype = ifi->ifi_type;
+	sllm->sll.sll_halen = (u_char)halen;
+	memcpy(sllm->sll.sll_addr, RTA_DATA(rta), halen);
+	*sizep = offsetof(struct sockaddr_ll, sll_addr) + halen;
+	if (*sizep < sizeof(struct sockaddr_ll))
+		*sizep = sizeof(struct sockaddr_ll);
+}
+
+/*
+ * Handle an RTM_NEWLINK message: add an entry for the interface, if
+ * it's up, with its link-layer address as an AF_PACKET address, as
+ * "getifaddrs()" does.
+ */
+static int
+nl_link_cb(struct nlmsghdr *nlh, struct nl_iftab *tab, char *errbuf)
+{
+	struct ifinfomsg *ifi;
+	struct rtattr *rta;
+	int len;
+	const char *name = NULL;
+	struct rtattr *addr_rta = NULL, *other_rta = NULL;
+	struct sockaddr_ll_max addr, other;
+	size_t addr_size = 0, other_size = 0;
+	pcap_if_t *dev;
+
+	if (nlh->nlmsg_type != RTM_NEWLINK ||
+	    nlh->nlmsg_len < NLMSG_LENGTH(sizeof(*ifi)))
+		return (0);
+	ifi = (struct ifinfomsg *)NLMSG_DATA(nlh);
+
+	/*
+	 * Is this interface up?
+	 */
+	if (!(ifi->ifi_flags & IFF_UP)) {
+		/*
+		 * No, so don't add it to the list.
+		 */
+		return (0);
+	}
+	if (nl_find_if(tab, ifi->ifi_index) != NULL) {
+		/*
+		 * We already have it; this can happen if the interface
+		 * changed while we were dumping.
+		 */
+		return (0);
+	}
+
+	len = IFLA_PAYLOAD(nlh);
+	for (rta = IFLA_RTA(ifi); RTA_OK(rta, len); rta = RTA_NEXT(rta, len)) {
+		switch (rta->rta_type) {
+
+		case IFLA_IFNAME:
+			if (RTA_PAYLOAD(rta) != 0 &&
+			    ((char *)RTA_DATA(rta))[RTA_PAYLOAD(rta) - 1] == '\0')
+				name = (char *)RTA_DATA(rta);
+			break;
+
+		case IFLA_ADDRESS:
+			addr_rta = rta;
+			break;
+
+		case IFLA_BROADCAST:
+			other_rta = rta;
+			break;
+		}
+	}
+	if (name == NULL)
+		return (0);
+
+	dev = new_if(name, ifi->ifi_flags, NULL, errbuf);
+	if (dev == NULL)
+		return (-1);
+	if (nl_add_if(tab, ifi->ifi_index, ifi->ifi_flags, dev,
+	    errbuf) == NULL) {
+		pcap_freealldevs(dev);
+		return (-1);
+	}
+
+	/*
+	 * As with "getifaddrs()", the second address is the broadcast
+	 * address on a broadcast interface and the destination address
+	 * on a point-to-point interface.
+	 */
+	if (addr_rta != NULL)
+		nl_make_sockaddr_ll(&addr, &addr_size, ifi, addr_rta);
+	if (other_rta != NULL)
+		nl_make_sockaddr_ll(&other, &other_size, ifi, other_rta);
+	return (add_addr_to_if(dev,
+	    addr_rta != NULL ? (struct sockaddr *)&addr : NULL, addr_size,
+	    NULL, 0,
+	    ((ifi->ifi_flags & IFF_BROADCAST) && other_rta != NULL) ?
+	      (struct sockaddr *)&other : NULL, other_size,
+	    ((ifi->ifi_flags & IFF_POINTOPOINT) && other_rta != NULL) ?
+	      (struct sockaddr *)&other : NULL, other_size,
+	    errbuf));
+}
+
+/*
+ * Fill in a socket address for an IPv4 or IPv6 address from an
+ * rtnetlink attribute.  Returns the size of the address, or 0 if
+ * the attribute isn't the right size.
+ */
+static size_t
+nl_make_sockaddr(struct sockaddr_storage *ss, struct ifaddrmsg *ifa,
+    struct rtattr *rta)
+{
+	struct sockaddr_in *sin;
+#ifdef INET6
+	struct sockaddr_in6 *sin6;
+#endif
+
+	memset(ss, 0, sizeof(*ss));
+	switch (ifa->ifa_family) {
+
+	case AF_INET:
+		sin = (struct sockaddr_in *)ss;
+		if (RTA_PAYLOAD(rta) != sizeof(sin->sin_addr))
+			return (0);
+		sin->sin_family = AF_INET;
+		memcpy(&sin->sin_addr, RTA_DATA(rta), sizeof(sin->sin_addr));
+		return (sizeof(*sin));
+
+#ifdef INET6
+	case AF_INET6:
+		sin6 = (struct sockaddr_in6 *)ss;
+		if (RTA_PAYLOAD(rta) != sizeof(sin6->sin6_addr))
+			return (0);
+		sin6->sin6_family = AF_INET6;
+		memcpy(&sin6->sin6_addr, RTA_DATA(rta),
+		    sizeof(sin6->sin6_addr));
+		if (IN6_IS_ADDR_LINKLOCAL(&sin6->sin6_addr) ||
+		    IN6_IS_ADDR_MC_LINKLOCAL(&sin6->sin6_addr))
+			sin6->sin6_scope_id = ifa->ifa_index;
+		return (sizeof(*sin6));
+#endif
+	}
+	return (0);
+}
+
+/*
+ * Fill in a netmask with the given prefix length.
+ */
+static size_t
+nl_make_netmask(struct sockaddr_storage *ss, int family, u_int prefixlen)
+{
+	u_char *p;
+	size_t size, maxlen, i;
+
+	memset(ss, 0, sizeof(*ss));
+	switch (family) {
+
+	case AF_INET:
+		((struct sockaddr_in *)ss)->sin_family = AF_INET;
+		p = (u_char *)&((struct sockaddr_in *)ss)->sin_addr;
+		size = sizeof(struct sockaddr_in);
+		maxlen = 4;
+		break;
+
+#ifdef INET6
+	case AF_INET6:
+		((struct sockaddr_in6 *)ss)->sin6_family = AF_INET6;
+		p = (u_char *)&((struct sockaddr_in6 *)ss)->sin6_addr;
+		size = sizeof(struct sockaddr_in6);
+		maxlen = 16;
+		break;
+#endif
+
+	default:
+		return (0);
+	}
+	for (i = 0; i < maxlen && prefixlen >= 8; i++, prefixlen -= 8)
+		p[i] = 0xff;
+	if (i < maxlen && prefixlen != 0)
+		p[i] = (u_char)(0xff << (8 - prefixlen));
+	return (size);
+}
+
+/*
+ * Handle an RTM_NEWADDR message: add the address to the list of
+ * addresses for its interface, if that interface is one we're
+ * including in the list.
+ *
+ * "getifaddrs()" reports an address with an IFA_LABEL of "eth0:1"
+ * as an address of an interface named "eth0:1", which
+ * "pcap_findalldevs_interfaces()" then treats as "eth0"; we just
+ * use the interface index.
+ */
+static int
+nl_addr_cb(struct nlmsghdr *nlh, struct nl_iftab *tab, char *errbuf)
+{
+	struct ifaddrmsg *ifa;
+	struct rtattr *rta;
+	int len;
+	struct nl_if *nlif;
+	struct rtattr *address = NULL, *local = NULL, *broadcast = NULL;
+	struct rtattr *other_rta;
+	struct sockaddr_storage addr, netmask, other;
+	size_t addr_size, netmask_size, other_size = 0;
+
+	if (nlh->nlmsg_type != RTM_NEWADDR ||
+	    nlh->nlmsg_len < NLMSG_LENGTH(sizeof(*ifa)))
+		return (0);
+	ifa = (struct ifaddrmsg *)NLMSG_DATA(nlh);
+	if (ifa->ifa_family != AF_INET
+#ifdef INET6
+	    && ifa->ifa_family != AF_INET6
+#endif
+	    )
+		return (0);
+	nlif = nl_find_if(tab, ifa->ifa_index);
+	if (nlif == NULL) {
+		/*
+		 * The interface isn't up, or it appeared after we
+		 * dumped the interfaces.
+		 */
+		return (0);
+	}
+
+	len = IFA_PAYLOAD(nlh);
+	for (rta = IFA_RTA(ifa); RTA_OK(rta, len); rta = RTA_NEXT(rta, len)) {
+		switch (rta->rta_type) {
+
+		case IFA_ADDRESS:
+			address = rta;
+			break;
+
+		case IFA_LOCAL:
+			local = rta;
+			break;
+
+		case IFA_BROADCAST:
+			broadcast = rta;
+			break;
+		}
+	}
+
+	/*
+	 * IFA_LOCAL, if present, is the local address, and IFA_ADDRESS
+	 * is then the address of the other end of a point-to-point link;
+	 * otherwise, IFA_ADDRESS is the local address.  As with
+	 * "getifaddrs()", an explicit broadcast address overrides the
+	 * other end's address.
+	 */
+	if (local != NULL) {
+		other_rta = address;
+		address = local;
+	} else
+		other_rta = NULL;
+	if (broadcast != NULL)
+		other_rta = broadcast;
+	if (address == NULL)
+		return (0);
+
+	addr_size = nl_make_sockaddr(&addr, ifa, address);
+	if (addr_size == 0)
+		return (0);
+	netmask_size = nl_make_netmask(&netmask, ifa->ifa_family,
+	    ifa->ifa_prefixlen);
+	if (other_rta != NULL)
+		other_size = nl_make_sockaddr(&other, ifa, other_rta);
+
+	return (add_addr_to_if(nlif->dev,
+	    (struct sockaddr *)&addr, addr_size,
+	    (struct sockaddr *)&netmask, netmask_size,
+	    ((nlif->flags & IFF_BROADCAST) && other_size != 0) ?
+	      (struct sockaddr *)&other : NULL, other_size,
+	    ((nlif->flags & IFF_POINTOPOINT) && other_size != 0) ?
+	      (struct sockaddr *)&other : NULL, other_size,
+	    errbuf));
+}
+
+/*
+ * Can we open all of the interfaces for capturing?
+ *
+ * Opening an interface for capturing on Linux succeeds for any
+ * interface if we can open a PF_PACKET socket at all, so rather than
+ * doing a "pcap_open_live()" on each interface, which takes a while
+ * (closing a PF_PACKET socket waits for the networking stack to
+ * finish with it), and adds up when there are thousands of
+ * interfaces, we try to open one PF_PACKET socket.
+ *
+ * Returns 1 if we can open all of them, 0 if we can't open any of them,
+ * and -1 if we don't know, in which case we have to check each one.
+ */
+static int
+can_open_all_ifs(void)
+{
+	int fd;
+
+	fd = socket(PF_PACKET, SOCK_RAW, 0);
+	if (fd == -1) {
+		if (errno == EPERM || errno == EACCES)
+			return (0);
+		return (-1);
+	}
+	close(fd);
+	return (1);
+}
+
+/*
+ * Get a list of all interfaces that are up and that we can open.
+ * Returns -1 on error, 0 otherwise.
+ * The list, as returned through "alldevsp", may be null if no interfaces
+ * were up and could be opened.
+ */
+int
+pcap_findalldevs_interfaces(pcap_if_t **alldevsp, char *errbuf)
+{
+	struct nl_sock nl;
+	struct nl_iftab tab;
+	struct sockaddr_nl snl;
+	socklen_t snl_len;
+	pcap_if_t *devlist = NULL, **devtailp;
+	int can_open;
+	u_int i;
+	int ret = -1;
+
+	*alldevsp = NULL;
+	memset(&tab, 0, sizeof(tab));
+	nl.seq = 0;
+	nl.buf = malloc(NL_BUFSIZE);
+	if (nl.buf == NULL) {
+		(void)snprintf(errbuf, PCAP_ERRBUF_SIZE,
+		    "malloc: %s", pcap_strerror(errno));
+		return (-1);
+	}
+	nl.fd = socket(AF_NETLINK, SOCK_RAW, NETLINK_ROUTE);
+	if (nl.fd == -1) {
+		(void)snprintf(errbuf, PCAP_ERRBUF_SIZE,
+		    "Can't open rtnetlink socket: %s", pcap_strerror(errno));
+		free(nl.buf);
+		return (-1);
+	}
+	memset(&snl, 0, sizeof(snl));
+	snl.nl_family = AF_NETLINK;
+	snl_len = sizeof(snl);
+	if (bind(nl.fd, (struct sockaddr *)&snl, sizeof(snl)) == -1 ||
+	    getsockname(nl.fd, (struct sockaddr *)&snl, &snl_len) == -1) {
+		(void)snprintf(errbuf, PCAP_ERRBUF_SIZE,
+		    "Can't bind rtnetlink socket: %s", pcap_strerror(errno));
+		goto done;
+	}
+	nl.pid = snl.nl_pid;
+
+	/*
+	 * Get the interfaces, and then their addresses.
+	 */
+	if (nl_request_dump(&nl, RTM_GETLINK, AF_PACKET, errbuf) == -1 ||
+	    nl_read_dump(&nl, &tab, nl_link_cb, errbuf) == -1)
+		goto done;
+	if (nl_request_dump(&nl, RTM_GETADDR, AF_UNSPEC, errbuf) == -1 ||
+	    nl_read_dump(&nl, &tab, nl_addr_cb, errbuf) == -1)
+		goto done;
+
+	/*
+	 * Chain together the ones we can open, in the order in which
+	 * we found them, and free the others.
+	 */
+	can_open = can_open_all_ifs();
+	devtailp = &devlist;
+	for (i = 0; i < tab.n_ifs; i++) {
+		switch (can_open != -1 ? can_open :
+		    can_open_if(tab.ifs[i].dev->name, errbuf)) {
+
+		case -1:
+			goto done;
+
+		case 0:
+			pcap_freealldevs(tab.ifs[i].dev);
+			break;
+
+		default:
+			*devtailp = tab.ifs[i].dev;
+			devtailp = &tab.ifs[i].dev->next;
+			break;
+		}
+		tab.ifs[i].dev = NULL;
+	}
+	add_iflist_to_iflist(alldevsp, devlist);
+	devlist = NULL;
+	ret = 0;
+
+done:
+	for (i = 0; i < tab.n_ifs; i++) {
+		if (tab.ifs[i].dev != NULL)
+			pcap_freealldevs(tab.ifs[i].dev);
+	}
+	if (devlist != NULL)
+		pcap_freealldevs(devlist);
+	free(tab.ifs);
+	free(tab.hash);
+	close(nl.fd);
+	free(nl.buf);
+	return (ret);
+}
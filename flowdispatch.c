@@ -0,0 +1,504 @@
+/*
+ * Copyright (c) 1993, 1994, 1995, 1996, 1997
+ *	The Regents of the University of California.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that: (1) source code distributions
+ * retain the above copyright notice and this paragraph in its entirety, (2)
+ * distributions including binary code include the above copyright notice and
+ * this paragraph in its entirety in the documentation or other materials
+ * provided with the distribution, and (3) all advertising materials mentioning
+ * features or use of this software display the following acknowledgement:
+ * ``This product includes software developed by the University of California,
+ * Lawrence Berkeley Laboratory and its contributors.'' Neither the name of
+ * the University nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * flowdispatch.c - spread the packets from one capture over several
+ * worker threads, keeping all the packets of a flow on the same thread
+ *
+ * The thread that calls pcap_flowdisp_loop() reads packets with
+ * pcap_loop(), hashes each one with a symmetric flow hash, and copies
+ * it into a single-producer/single-consumer ring belonging to the worker
+ * the hash selects.  Each worker thread takes packets from its ring and
+ * hands them to the callback.
+ *
+ * A ring is a power-of-2-sized run of bytes holding variable-length
+ * records, each a pcap_pkthdr followed by caplen bytes of data, padded
+ * to keep the next header aligned, so that small packets don't take up
+ * a snapshot length's worth of memory apiece.  A record is never split
+ * across the end of the ring; if it won't fit there, the producer
+ * starts it at the beginning instead, and marks the space it skipped
+ * with a header whose caplen is RING_WRAP, unless there's no room for
+ * a header, in which case the consumer skips it without being told.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#ifdef WIN32
+#include <pcap-stdinc.h>
+#else /* WIN32 */
+#if HAVE_INTTYPES_H
+#include <inttypes.h>
+#elif HAVE_STDINT_H
+#include <stdint.h>
+#endif
+#ifdef HAVE_SYS_BITYPES_H
+#include <sys/bitypes.h>
+#endif
+#include <sys/types.h>
+#endif /* WIN32 */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef HAVE_PTHREADS
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "pcap-int.h"
+
+#include "flowhash.h"
+
+#ifdef HAVE_OS_PROTO_H
+#include "os-proto.h"
+#endif
+
+#ifdef HAVE_PTHREADS
+
+/*
+ * Memory ordering for the ring indices.  The producer publishes a record
+ * by storing the new head with release semantics, and the consumer frees
+ * records by storing the new tail with release semantics; each side loads
+ * the other's index with acquire semantics.
+ */
+#if defined(__ATOMIC_ACQUIRE)
+#define LOAD_ACQUIRE(p)		__atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define STORE_RELEASE(p, v)	__atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define FULL_BARRIER()		__atomic_thread_fence(__ATOMIC_SEQ_CST)
+#elif defined(__GNUC__)
+#define LOAD_ACQUIRE(p)		(__sync_synchronize(), *(p))
+#define STORE_RELEASE(p, v)	(__sync_synchronize(), *(p) = (v))
+#define FULL_BARRIER()		__sync_synchronize()
+#else
+#error "Don't know how to order memory accesses with this compiler"
+#endif
+
+/*
+ * Default size, in bytes, of each worker's ring; that's room for about
+ * 700 full-sized Ethernet packets, or about 10,000 minimum-sized ones.
+ */
+#define DEFAULT_RING_SIZE	(1024*1024)
+
+/*
+ * caplen of the header marking the space at the end of the ring that
+ * the producer skipped because the next record didn't fit there.
+ */
+#define RING_WRAP		0xffffffffU
+
+/*
+ * Bytes taken up in a ring by a packet with "caplen" bytes of data.
+ */
+#define RECORD_SIZE(caplen) \
+	((sizeof(struct pcap_pkthdr) + (caplen) + sizeof(long) - 1) & \
+	    ~(sizeof(long) - 1))
+
+/*
+ * Number of times a worker checks an empty ring before going to sleep.
+ */
+#define SPIN_COUNT		1000
+
+/*
+ * Size of a cache line, for keeping the producer's and consumer's
+ * indices from sharing one.
+ */
+#define CACHE_LINE_SIZE		64
+
+struct flow_worker {
+	/*
+	 * Written by the capture thread.
+	 */
+	volatile u_int head;		/* byte offset of next record to fill */
+	u_int64_t recv;			/* packets queued to this worker */
+	u_int64_t drop;			/* packets dropped, ring full */
+	u_int64_t waits;		/* times we waited for room */
+	char pad1[CACHE_LINE_SIZE];
+
+	/*
+	 * Written by the worker thread.
+	 */
+	volatile u_int tail;		/* byte offset of next record to empty */
+	volatile int sleeping;		/* waiting for packets */
+	u_int64_t delivered;		/* packets handed to the callback */
+	char pad2[CACHE_LINE_SIZE];
+
+	u_char *ring;			/* the ring itself */
+	pthread_t thread;
+	pthread_mutex_t lock;		/* for sleeping and waking up */
+	pthread_cond_t wakeup;
+	struct pcap_flowdisp *fd;
+	int index;
+};
+
+struct pcap_flowdisp {
+	pcap_t *p;
+	int nworkers;
+	u_int ringsize;			/* bytes per ring; a power of 2 */
+	u_int datasize;			/* most packet data in a record */
+	int flags;
+	volatile int stop;		/* tells workers to exit */
+	pcap_flowdisp_handler callback;
+	u_char *user;
+	struct flow_worker *workers;
+};
+
+#define RING_OFFSET(w, i)	((i) & ((w)->fd->ringsize - 1))
+
+/*
+ * Wake up a worker if it's asleep.  The barrier orders our store of
+ * the ring head before our load of the sleeping flag; the worker does
+ * the reverse, so at least one of us sees the other's store.
+ */
+static void
+wake_worker(struct flow_worker *w)
+{
+	FULL_BARRIER();
+	if (LOAD_ACQUIRE(&w->sleeping)) {
+		pthread_mutex_lock(&w->lock);
+		pthread_cond_signal(&w->wakeup);
+		pthread_mutex_unlock(&w->lock);
+	}
+}
+
+static void *
+worker_thread(void *arg)
+{
+	struct flow_worker *w = arg;
+	struct pcap_flowdisp *fd = w->fd;
+	struct pcap_pkthdr *h;
+	u_int head, tail, off;
+	int spins = 0;
+
+	tail = w->tail;
+	for (;;) {
+		head = LOAD_ACQUIRE(&w->head);
+		if (head == tail) {
+			if (LOAD_ACQUIRE(&fd->stop))
+				break;
+			if (++spins < SPIN_COUNT) {
+				sched_yield();
+				continue;
+			}
+
+			/*
+			 * Nothing's arrived for a while; go to sleep
+			 * until the capture thread wakes us up.
+			 */
+			pthread_mutex_lock(&w->lock);
+			STORE_RELEASE(&w->sleeping, 1);
+			FULL_BARRIER();
+			while (LOAD_ACQUIRE(&w->head) == tail &&
+			    !LOAD_ACQUIRE(&fd->stop))
+				pthread_cond_wait(&w->wakeup, &w->lock);
+			STORE_RELEASE(&w->sleeping, 0);
+			pthread_mutex_unlock(&w->lock);
+			spins = 0;
+			continue;
+		}
+		spins = 0;
+
+		/*
+		 * Hand everything that's in the ring to the callback,
+		 * then give the space back.
+		 */
+		while (tail != head) {
+			off = RING_OFFSET(w, tail);
+			h = (struct pcap_pkthdr *)(w->ring + off);
+			if (fd->ringsize - off < sizeof(*h) ||
+			    h->caplen == RING_WRAP) {
+				/*
+				 * The next record is at the beginning.
+				 */
+				tail += fd->ringsize - off;
+				continue;
+			}
+			(*fd->callback)(fd->user, w->index, h,
+			    (u_char *)h + sizeof(*h));
+			tail += RECORD_SIZE(h->caplen);
+			w->delivered++;
+		}
+		STORE_RELEASE(&w->tail, tail);
+	}
+	return (NULL);
+}
+
+/*
+ * pcap_loop() callback, run on the capture thread; queue the packet to
+ * the worker for its flow.
+ */
+static void
+flowdisp_enqueue(u_char *user, const struct pcap_pkthdr *h,
+    const u_char *pkt)
+{
+	struct pcap_flowdisp *fd = (struct pcap_flowdisp *)user;
+	struct flow_worker *w;
+	struct pcap_pkthdr *rec_hdr;
+	bpf_u_int32 hash, caplen;
+	u_int head, off, skip, need;
+
+	(void)flowhash(fd->p->linktype, pkt, h->caplen, &hash);
+	w = &fd->workers[((u_int64_t)hash * fd->nworkers) >> 32];
+
+	caplen = h->caplen;
+	if (caplen > fd->datasize)
+		caplen = fd->datasize;
+	need = RECORD_SIZE(caplen);
+
+	/*
+	 * If the record won't fit before the end of the ring, we have
+	 * to skip what's left there, too.
+	 */
+	head = w->head;
+	off = RING_OFFSET(w, head);
+	skip = fd->ringsize - off < need ? fd->ringsize - off : 0;
+	while (fd->ringsize - (head - LOAD_ACQUIRE(&w->tail)) < skip + need) {
+		/*
+		 * The ring is full.
+		 */
+		if (fd->flags & PCAP_FLOWDISP_DROP) {
+			w->drop++;
+			return;
+		}
+		w->waits++;
+		wake_worker(w);
+		sched_yield();
+	}
+
+	if (skip != 0) {
+		if (skip >= sizeof(*rec_hdr))
+			((struct pcap_pkthdr *)(w->ring + off))->caplen =
+			    RING_WRAP;
+		head += skip;
+		off = 0;
+	}
+	rec_hdr = (struct pcap_pkthdr *)(w->ring + off);
+	*rec_hdr = *h;
+	rec_hdr->caplen = caplen;
+	memcpy((u_char *)rec_hdr + sizeof(*rec_hdr), pkt, caplen);
+	STORE_RELEASE(&w->head, head + need);
+	w->recv++;
+	wake_worker(w);
+}
+
+/*
+ * Stop and reap the first "n" worker threads.
+ */
+static void
+stop_workers(struct pcap_flowdisp *fd, int n)
+{
+	int i;
+
+	STORE_RELEASE(&fd->stop, 1);
+	for (i = 0; i < n; i++)
+		wake_worker(&fd->workers[i]);
+	for (i = 0; i < n; i++) {
+		pthread_join(fd->workers[i].thread, NULL);
+		pthread_cond_destroy(&fd->workers[i].wakeup);
+		pthread_mutex_destroy(&fd->workers[i].lock);
+	}
+}
+
+static void
+free_flowdisp(struct pcap_flowdisp *fd)
+{
+	int i;
+
+	if (fd->workers != NULL) {
+		for (i = 0; i < fd->nworkers; i++)
+			free(fd->workers[i].ring);
+		free(fd->workers);
+	}
+	free(fd);
+}
+
+pcap_flowdisp_t *
+pcap_flowdisp_create(pcap_t *p, int nworkers, int ringsize, int flags,
+    pcap_flowdisp_handler callback, u_char *user, char *errbuf)
+{
+	struct pcap_flowdisp *fd;
+	struct flow_worker *w;
+	u_int size, datasize;
+	int i, err;
+
+	if (!p->activated) {
+		snprintf(errbuf, PCAP_ERRBUF_SIZE,
+		    "The capture must be activated before dispatching to workers");
+		return (NULL);
+	}
+	if (nworkers <= 0) {
+		snprintf(errbuf, PCAP_ERRBUF_SIZE,
+		    "Number of workers %d is not positive", nworkers);
+		return (NULL);
+	}
+	if (ringsize < 0 || ringsize > 0x40000000) {
+		snprintf(errbuf, PCAP_ERRBUF_SIZE,
+		    "Ring size %d is out of range", ringsize);
+		return (NULL);
+	}
+
+	/*
+	 * Round the ring size up to a power of 2, so that the indices
+	 * can wrap around freely, and to at least twice the largest
+	 * record, so that a record always fits in an empty ring even
+	 * if it has to skip to the beginning.
+	 */
+	datasize = p->snapshot > 0 ? p->snapshot : 65535;
+	if (ringsize == 0)
+		ringsize = DEFAULT_RING_SIZE;
+	for (size = 1; size < (u_int)ringsize ||
+	    size < 2 * RECORD_SIZE(datasize); size <<= 1)
+		;
+
+	fd = malloc(sizeof(*fd));
+	if (fd == NULL) {
+		snprintf(errbuf, PCAP_ERRBUF_SIZE, "malloc: %s",
+		    pcap_strerror(errno));
+		return (NULL);
+	}
+	memset(fd, 0, sizeof(*fd));
+	fd->p = p;
+	fd->nworkers = nworkers;
+	fd->ringsize = size;
+	fd->datasize = datasize;
+	fd->flags = flags;
+	fd->callback = callback;
+	fd->user = user;
+
+	fd->workers = malloc(nworkers * sizeof(*fd->workers));
+	if (fd->workers == NULL) {
+		snprintf(errbuf, PCAP_ERRBUF_SIZE, "malloc: %s",
+		    pcap_strerror(errno));
+		free(fd);
+		return (NULL);
+	}
+	memset(fd->workers, 0, nworkers * sizeof(*fd->workers));
+	for (i = 0; i < nworkers; i++) {
+		w = &fd->workers[i];
+		w->fd = fd;
+		w->index = i;
+		w->ring = malloc(size);
+		if (w->ring == NULL) {
+			snprintf(errbuf, PCAP_ERRBUF_SIZE, "malloc: %s",
+			    pcap_strerror(errno));
+			free_flowdisp(fd);
+			return (NULL);
+		}
+	}
+
+	for (i = 0; i < nworkers; i++) {
+		w = &fd->workers[i];
+		pthread_mutex_init(&w->lock, NULL);
+		pthread_cond_init(&w->wakeup, NULL);
+		err = pthread_create(&w->thread, NULL, worker_thread, w);
+		if (err != 0) {
+			snprintf(errbuf, PCAP_ERRBUF_SIZE,
+			    "pthread_create: %s", pcap_strerror(err));
+			pthread_cond_destroy(&w->wakeup);
+			pthread_mutex_destroy(&w->lock);
+			stop_workers(fd, i);
+			free_flowdisp(fd);
+			return (NULL);
+		}
+	}
+	return (fd);
+}
+
+/*
+ * Read packets as pcap_loop() would, handing them to the workers, and
+ * wait for the workers to finish with them before returning.  Returns
+ * what pcap_loop() returned.
+ */
+int
+pcap_flowdisp_loop(pcap_flowdisp_t *fd, int cnt)
+{
+	struct flow_worker *w;
+	int status, i;
+
+	status = pcap_loop(fd->p, cnt, flowdisp_enqueue, (u_char *)fd);
+
+	for (i = 0; i < fd->nworkers; i++) {
+		w = &fd->workers[i];
+		while (LOAD_ACQUIRE(&w->tail) != w->head) {
+			wake_worker(w);
+			sched_yield();
+		}
+	}
+	return (status);
+}
+
+int
+pcap_flowdisp_stats(pcap_flowdisp_t *fd, int worker,
+    struct pcap_flowdisp_stat *fs)
+{
+	struct flow_worker *w;
+
+	if (worker < 0 || worker >= fd->nworkers) {
+		snprintf(fd->p->errbuf, PCAP_ERRBUF_SIZE,
+		    "Worker %d doesn't exist", worker);
+		return (-1);
+	}
+	w = &fd->workers[worker];
+	fs->fs_recv = w->recv;
+	fs->fs_delivered = w->delivered;
+	fs->fs_drop = w->drop;
+	fs->fs_waits = w->waits;
+	return (0);
+}
+
+void
+pcap_flowdisp_close(pcap_flowdisp_t *fd)
+{
+	stop_workers(fd, fd->nworkers);
+	free_flowdisp(fd);
+}
+
+#else /* HAVE_PTHREADS */
+
+pcap_flowdisp_t *
+pcap_flowdisp_create(pcap_t *p _U_, int nworkers _U_, int ringsize _U_,
+    int flags _U_, pcap_flowdisp_handler callback _U_, u_char *user _U_,
+    char *errbuf)
+{
+	snprintf(errbuf, PCAP_ERRBUF_SIZE,
+	    "Dispatching to worker threads isn't supported on this platform");
+	return (NULL);
+}
+
+int
+pcap_flowdisp_loop(pcap_flowdisp_t *fd _U_, int cnt _U_)
+{
+	return (-1);
+}
+
+int
+pcap_flowdisp_stats(pcap_flowdisp_t *fd _U_, int worker _U_,
+    struct pcap_flowdisp_stat *fs _U_)
+{
+	return (-1);
+}
+
+void
+pcap_flowdisp_close(pcap_flowdisp_t *fd _U_)
+{
+}
+
+#endif /* HAVE_PTHREADS */
@@ -0,0 +1,463 @@
+/*
+ * Copyright (c) 1993, 1994, 1995, 1996, 1997
+ *	The Regents of the University of California.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that: (1) source code distributions
+ * retain the above copyright notice and this paragraph in its entirety, (2)
+ * distributions including binary code include the above copyright notice and
+ * this paragraph in its entirety in the documentation or other materials
+ * provided with the distribution, and (3) all advertising materials mentioning
+ * features or use of this software display the following acknowledgement:
+ * ``This product includes software developed by the University of California,
+ * Lawrence Berkeley Laboratory and its contributors.'' Neither the name of
+ * the University nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * flowhash.c - symmetric flow hashing of captured packets
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#ifdef WIN32
+#include <pcap-stdinc.h>
+#else /* WIN32 */
+#if HAVE_INTTYPES_H
+#include <inttypes.h>
+#elif HAVE_STDINT_H
+#include <stdint.h>
+#endif
+#ifdef HAVE_SYS_BITYPES_H
+#include <sys/bitypes.h>
+#endif
+#include <sys/types.h>
+#endif /* WIN32 */
+
+#include <string.h>
+
+#include "pcap-int.h"
+
+#include "ethertype.h"
+#include "ppp.h"
+#include "pcap/sll.h"
+#include "flowhash.h"
+
+#ifdef HAVE_OS_PROTO_H
+#include "os-proto.h"
+#endif
+
+#ifndef ETHERTYPE_8021AD
+#define ETHERTYPE_8021AD	0x88a8
+#endif
+
+#define EXTRACT_SHORT(p)	((u_short)((u_short)(p)[0] << 8 | (p)[1]))
+#define EXTRACT_LONG(p) \
+	((bpf_u_int32)(p)[0] << 24 | (bpf_u_int32)(p)[1] << 16 | \
+	 (bpf_u_int32)(p)[2] << 8 | (bpf_u_int32)(p)[3])
+
+/*
+ * IP protocol numbers for which we hash on the ports.
+ */
+#define IPPROTO_TCP_	6
+#define IPPROTO_UDP_	17
+#define IPPROTO_DCCP_	33
+#define IPPROTO_SCTP_	132
+#define IPPROTO_UDPLITE_ 136
+
+/*
+ * IPv6 extension headers we skip to get to the transport header.
+ */
+#define IP6_HOPOPTS	0
+#define IP6_ROUTING	43
+#define IP6_FRAGMENT	44
+#define IP6_AH		51
+#define IP6_DSTOPTS	60
+
+/*
+ * Bob Jenkins' lookup3 mixing functions.
+ */
+#define rot(x, k)	(((x) << (k)) | ((x) >> (32 - (k))))
+
+#define mix(a, b, c) \
+{ \
+	a -= c;  a ^= rot(c, 4);  c += b; \
+	b -= a;  b ^= rot(a, 6);  a += c; \
+	c -= b;  c ^= rot(b, 8);  b += a; \
+	a -= c;  a ^= rot(c, 16); c += b; \
+	b -= a;  b ^= rot(a, 19); a += c; \
+	c -= b;  c ^= rot(b, 4);  b += a; \
+}
+
+#define final(a, b, c) \
+{ \
+	c ^= b; c -= rot(b, 14); \
+	a ^= c; a -= rot(c, 11); \
+	b ^= a; b -= rot(a, 25); \
+	c ^= b; c -= rot(b, 16); \
+	a ^= c; a -= rot(c, 4);  \
+	b ^= a; b -= rot(a, 14); \
+	c ^= b; c -= rot(b, 24); \
+}
+
+static bpf_u_int32
+hashwords(const bpf_u_int32 *k, u_int length, bpf_u_int32 initval)
+{
+	bpf_u_int32 a, b, c;
+
+	a = b = c = 0xdeadbeef + (((bpf_u_int32)length) << 2) + initval;
+	while (length > 3) {
+		a += k[0];
+		b += k[1];
+		c += k[2];
+		mix(a, b, c);
+		length -= 3;
+		k += 3;
+	}
+	switch (length) {
+
+	case 3:
+		c += k[2];
+		/* FALLTHROUGH */
+	case 2:
+		b += k[1];
+		/* FALLTHROUGH */
+	case 1:
+		a += k[0];
+		final(a, b, c);
+		/* FALLTHROUGH */
+	case 0:
+		break;
+	}
+	return (c);
+}
+
+/*
+ * Get the ports from the transport-layer header at "l4", if the protocol
+ * has them and they're in the captured data; otherwise return 0 for
+ * both of them.
+ */
+static void
+get_ports(u_int proto, const u_char *l4, u_int l4len, u_short *sport,
+    u_short *dport)
+{
+	switch (proto) {
+
+	case IPPROTO_TCP_:
+	case IPPROTO_UDP_:
+	case IPPROTO_DCCP_:
+	case IPPROTO_SCTP_:
+	case IPPROTO_UDPLITE_:
+		if (l4len >= 4) {
+			*sport = EXTRACT_SHORT(&l4[0]);
+			*dport = EXTRACT_SHORT(&l4[2]);
+			return;
+		}
+		break;
+	}
+	*sport = 0;
+	*dport = 0;
+}
+
+/*
+ * Hash two equal-length addresses and a pair of ports so that swapping
+ * source and destination doesn't change the result: put the "smaller"
+ * endpoint first.
+ */
+static bpf_u_int32
+hash_endpoints(const u_char *src, const u_char *dst, u_int addrlen,
+    u_short sport, u_short dport, u_int proto)
+{
+	bpf_u_int32 key[9];
+	const u_char *lo, *hi;
+	u_short lo_port, hi_port;
+	u_int i, nwords;
+	int cmp;
+
+	cmp = memcmp(src, dst, addrlen);
+	if (cmp < 0 || (cmp == 0 && sport <= dport)) {
+		lo = src;
+		lo_port = sport;
+		hi = dst;
+		hi_port = dport;
+	} else {
+		lo = dst;
+		lo_port = dport;
+		hi = src;
+		hi_port = sport;
+	}
+
+	/*
+	 * Addresses are 4, 6 or 16 bytes long; pad the last word of
+	 * each with zeroes.
+	 */
+	nwords = (addrlen + 3) / 4;
+	memset(key, 0, sizeof(key));
+	for (i = 0; i < addrlen; i++) {
+		key[i / 4] |= (bpf_u_int32)lo[i] << (8 * (3 - (i % 4)));
+		key[nwords + i / 4] |= (bpf_u_int32)hi[i] << (8 * (3 - (i % 4)));
+	}
+	key[2 * nwords] = (bpf_u_int32)lo_port << 16 | hi_port;
+	return (hashwords(key, 2 * nwords + 1, proto));
+}
+
+static int
+hash_ipv4(const u_char *ip, u_int len, bpf_u_int32 *hashp)
+{
+	u_int hlen, proto;
+	u_short sport, dport;
+
+	if (len < 20)
+		return (0);
+	hlen = (ip[0] & 0x0f) * 4;
+	if (hlen < 20 || hlen > len)
+		return (0);
+	proto = ip[9];
+
+	/*
+	 * Fragments other than the first one don't have a transport
+	 * header, so, to keep all the fragments of a packet together,
+	 * don't use the ports of any fragment.
+	 */
+	if ((EXTRACT_SHORT(&ip[6]) & 0x3fff) != 0) {
+		sport = 0;
+		dport = 0;
+	} else
+		get_ports(proto, ip + hlen, len - hlen, &sport, &dport);
+	*hashp = hash_endpoints(&ip[12], &ip[16], 4, sport, dport, proto);
+	return (1);
+}
+
+static int
+hash_ipv6(const u_char *ip6, u_int len, bpf_u_int32 *hashp)
+{
+	u_int off, proto, extlen;
+	u_short sport, dport;
+	int fragmented = 0;
+
+	if (len < 40)
+		return (0);
+	proto = ip6[6];
+	off = 40;
+
+	/*
+	 * Skip the extension headers that can come before the
+	 * transport header.
+	 */
+	for (;;) {
+		switch (proto) {
+
+		case IP6_HOPOPTS:
+		case IP6_ROUTING:
+		case IP6_DSTOPTS:
+			if (off + 8 > len)
+				goto done;
+			extlen = (ip6[off + 1] + 1) * 8;
+			break;
+
+		case IP6_AH:
+			if (off + 8 > len)
+				goto done;
+			extlen = (ip6[off + 1] + 2) * 4;
+			break;
+
+		case IP6_FRAGMENT:
+			if (off + 8 > len)
+				goto done;
+			fragmented = 1;
+			extlen = 8;
+			break;
+
+		default:
+			goto done;
+		}
+		proto = ip6[off];
+		off += extlen;
+	}
+done:
+	if (fragmented || off > len) {
+		sport = 0;
+		dport = 0;
+	} else
+		get_ports(proto, ip6 + off, len - off, &sport, &dport);
+	*hashp = hash_endpoints(&ip6[8], &ip6[24], 16, sport, dport, proto);
+	return (1);
+}
+
+/*
+ * Hash a packet whose network-layer header starts at "nh" and is of the
+ * type given by the Ethernet type "ethertype".
+ */
+static int
+hash_network(u_int ethertype, const u_char *nh, u_int len,
+    bpf_u_int32 *hashp)
+{
+	switch (ethertype) {
+
+	case ETHERTYPE_IP:
+		return (hash_ipv4(nh, len, hashp));
+
+	case ETHERTYPE_IPV6:
+		return (hash_ipv6(nh, len, hashp));
+	}
+	return (0);
+}
+
+/*
+ * Map the IP version of a packet whose link-layer header doesn't tell
+ * us the network protocol to an Ethernet type, or return 0 if it's not
+ * IPv4 or IPv6.
+ */
+static u_int
+ip_ethertype(const u_char *nh, u_int len)
+{
+	if (len < 1)
+		return (0);
+	switch (nh[0] >> 4) {
+
+	case 4:
+		return (ETHERTYPE_IP);
+
+	case 6:
+		return (ETHERTYPE_IPV6);
+	}
+	return (0);
+}
+
+/*
+ * The link-layer header lengths, and the offsets of the protocol type
+ * fields, are the ones init_linktype() in gencode.c uses for the same
+ * link-layer types.
+ */
+int
+flow_network(int linktype, const u_char *pkt, u_int caplen, u_int *offp,
+    u_int *ethertypep)
+{
+	u_int off, ethertype;
+
+	switch (linktype) {
+
+	case DLT_EN10MB:
+		if (caplen < 14)
+			return (0);
+		off = 12;
+		ethertype = EXTRACT_SHORT(&pkt[off]);
+
+		/*
+		 * Skip any VLAN tags.
+		 */
+		while ((ethertype == ETHERTYPE_8021Q ||
+		    ethertype == ETHERTYPE_8021AD ||
+		    ethertype == ETHERTYPE_8021QINQ) && off + 6 <= caplen) {
+			off += 4;
+			ethertype = EXTRACT_SHORT(&pkt[off]);
+		}
+		off += 2;
+		break;
+
+	case DLT_LINUX_SLL:
+		if (caplen < SLL_HDR_LEN)
+			return (0);
+		off = SLL_HDR_LEN;
+		ethertype = EXTRACT_SHORT(&pkt[14]);
+		break;
+
+	case DLT_C_HDLC:
+		/*
+		 * Cisco HDLC has an Ethernet type after the address and
+		 * control bytes.
+		 */
+		if (caplen < 4)
+			return (0);
+		off = 4;
+		ethertype = EXTRACT_SHORT(&pkt[2]);
+		break;
+
+	case DLT_PPP:
+	case DLT_PPP_SERIAL:
+		/*
+		 * PPP has a PPP protocol number after the address and
+		 * control bytes.
+		 */
+		if (caplen < 4)
+			return (0);
+		off = 4;
+		switch (EXTRACT_SHORT(&pkt[2])) {
+
+		case PPP_IP:
+			ethertype = ETHERTYPE_IP;
+			break;
+
+		case PPP_IPV6:
+			ethertype = ETHERTYPE_IPV6;
+			break;
+
+		default:
+			return (0);
+		}
+		break;
+
+	case DLT_NULL:
+	case DLT_LOOP:
+		/*
+		 * The 4-byte address family is in host byte order for
+		 * DLT_NULL, and AF_INET6 has different values on
+		 * different platforms; just look at the IP version.
+		 */
+		if (caplen < 4)
+			return (0);
+		off = 4;
+		ethertype = ip_ethertype(pkt + 4, caplen - 4);
+		if (ethertype == 0)
+			return (0);
+		break;
+
+	case DLT_RAW:
+	case DLT_IPV4:
+	case DLT_IPV6:
+		off = 0;
+		ethertype = ip_ethertype(pkt, caplen);
+		if (ethertype == 0)
+			return (0);
+		break;
+
+	default:
+		return (0);
+	}
+	*offp = off;
+	*ethertypep = ethertype;
+	return (1);
+}
+
+static int
+hash_link(int linktype, const u_char *pkt, u_int caplen, bpf_u_int32 *hashp)
+{
+	u_int off, ethertype;
+
+	if (!flow_network(linktype, pkt, caplen, &off, &ethertype))
+		return (0);
+	if (hash_network(ethertype, pkt + off, caplen - off, hashp))
+		return (1);
+	if (linktype == DLT_EN10MB) {
+		/*
+		 * Not IP; hash the MAC addresses.
+		 */
+		*hashp = hash_endpoints(&pkt[6], &pkt[0], 6, 0, 0, ethertype);
+		return (1);
+	}
+	return (0);
+}
+
+int
+flowhash(int linktype, const u_char *pkt, u_int caplen, bpf_u_int32 *hashp)
+{
+	if (hash_link(linktype, pkt, caplen, hashp))
+		return (1);
+	*hashp = 0;
+	return (0);
+}
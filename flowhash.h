@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 1993, 1994, 1995, 1996, 1997
+ *	The Regents of the University of California.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that: (1) source code distributions
+ * retain the above copyright notice and this paragraph in its entirety, (2)
+ * distributions including binary code include the above copyright notice and
+ * this paragraph in its entirety in the documentation or other materials
+ * provided with the distribution, and (3) all advertising materials mentioning
+ * features or use of this software display the following acknowledgement:
+ * ``This product includes software developed by the University of California,
+ * Lawrence Berkeley Laboratory and its contributors.'' Neither the name of
+ * the University nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * flowhash.h - symmetric flow hashing of captured packets
+ */
+
+#ifndef flowhash_h
+#define	flowhash_h
+
+/*
+ * Compute a hash of the IP addresses, protocol, and, if present, ports
+ * of a packet with the given link-layer header type, and put it in
+ * "*hashp".  The hash is the same for both directions of a flow.
+ * Packets that aren't IP hash on their link-layer addresses, if we know
+ * where those are.  Returns 1 if the packet was hashed and 0 if we don't
+ * know how to hash it, in which case "*hashp" is set to 0.
+ */
+extern int flowhash(int linktype, const u_char *pkt, u_int caplen,
+    bpf_u_int32 *hashp);
+
+/*
+ * Find the network-layer header of a packet with the given link-layer
+ * header type; put its offset in "*offp" and its Ethernet type in
+ * "*ethertypep", and return 1, or return 0 if we don't know where it is.
+ */
+extern int flow_network(int linktype, const u_char *pkt, u_int caplen,
+    u_int *offp, u_int *ethertypep);
+
+#endif
@@ -294,6 +294,7 @@ static struct block *gen_check_802_11_data_frame(void);
 
 static struct block *gen_ppi_dlt_check(void);
 static struct block *gen_msg_abbrev(int type);
+static struct block *gen_hdrlen_ret(void);
 
 static void *
 newchunk(n)
@@ -399,6 +400,7 @@ syntax()
 
 static bpf_u_int32 netmask;
 static int snaplen;
+static int headers_only;
 int no_optimize;
 #ifdef WIN32
 static int
@@ -443,6 +445,7 @@ pcap_compile(pcap_t *p, struct bpf_program *program,
 		return (-1);
 	}
 	no_optimize = 0;
+	headers_only = 0;
 	n_errors = 0;
 	root = NULL;
 	bpf_pcap = p;
@@ -573,6 +576,18 @@ finish_parse(p)
 	struct block *p;
 {
 	struct block *ppi_dlt_check;
+	struct block *ret;
+
+	/*
+	 * Generate the return for accepted packets now, as the code
+	 * that computes the length of the headers may use the offset
+	 * of the MAC-layer payload, which has to be set up by the
+	 * statements inserted below.
+	 */
+	if (headers_only)
+		ret = gen_hdrlen_ret();
+	else
+		ret = gen_retblk(snaplen);
 
 	/*
 	 * Insert before the statements of the first (root) block any
@@ -592,18 +607,32 @@ finish_parse(p)
 	 * postpone computing the lengths so that it's not done
 	 * for tests that fail early, and it's not clear that's
 	 * worth the effort.
+	 *
+	 * A program with no expression, such as "headers-only" by
+	 * itself, starts with the return.
 	 */
-	insert_compute_vloffsets(p->head);
+	if (p != NULL)
+		insert_compute_vloffsets(p->head);
+	else
+		insert_compute_vloffsets(ret);
 	
 	/*
 	 * For DLT_PPI captures, generate a check of the per-packet
 	 * DLT value to make sure it's DLT_IEEE802_11.
 	 */
 	ppi_dlt_check = gen_ppi_dlt_check();
-	if (ppi_dlt_check != NULL)
-		gen_and(ppi_dlt_check, p);
+	if (ppi_dlt_check != NULL) {
+		if (p != NULL)
+			gen_and(ppi_dlt_check, p);
+		else
+			p = ppi_dlt_check;
+	}
+	if (p == NULL) {
+		root = ret;
+		return;
+	}
 
-	backpatch(p, gen_retblk(snaplen));
+	backpatch(p, ret);
 	p->sense = !p->sense;
 	backpatch(p, gen_retblk(0));
 	root = p->head;
@@ -3205,7 +3234,7 @@ gen_linktype(proto)
 			 * Then we run it through "htonl()", and
 			 * generate code to compare against the result.
 			 */
-			if (bpf_pcap->sf.rfile != NULL &&
+			if (PCAP_IS_SAVEFILE(bpf_pcap) &&
 			    bpf_pcap->sf.swapped)
 				proto = SWAPLONG(proto);
 			proto = htonl(proto);
@@ -7555,8 +7584,8 @@ gen_inbound(dir)
 		 * special meta-data in the filter expression;
 		 * if it's a savefile, we can't.
 		 */
-		if (bpf_pcap->sf.rfile != NULL) {
-			/* We have a FILE *, so this is a savefile */
+		if (PCAP_IS_SAVEFILE(bpf_pcap)) {
+			/* This is a savefile */
 			bpf_error("inbound/outbound not supported on linktype %d when reading savefiles",
 			    linktype);
 			b0 = NULL;
@@ -7579,6 +7608,265 @@ gen_inbound(dir)
 	return (b0);
 }
 
+/*
+ * Match a packet with probability "prob", by comparing a random number
+ * with that fraction of 2^32.  The random number comes from the Linux
+ * socket filter's SKF_AD_RANDOM ancillary load, so the sampling is done
+ * in the kernel on Linux; bpf_filter() supplies its own random numbers
+ * for the same load, for userland filtering and savefiles.
+ */
+static struct block *
+gen_sample_prob(double prob)
+{
+	struct slist *s;
+	struct block *b;
+	double thresh;
+
+	thresh = prob * 4294967296.0 + 0.5;
+	if (thresh >= 4294967296.0)
+		return gen_true();
+	if (thresh < 1.0)
+		return gen_false();
+
+	s = new_stmt(BPF_LD|BPF_W|BPF_ABS);
+	s->s.k = BPF_AD_RANDOM;
+	b = new_block(JMP(BPF_JGE));
+	b->stmts = s;
+	b->s.k = (bpf_u_int32)thresh;
+	gen_not(b);
+	return b;
+}
+
+/*
+ * "sample N" matches, on average, one packet in every N.
+ */
+struct block *
+gen_sample(n)
+	int n;
+{
+	if (n <= 0)
+		bpf_error("sample count must be greater than 0");
+	return gen_sample_prob(1.0 / n);
+}
+
+/*
+ * "sample rate R" matches, on average, the fraction R of the packets;
+ * R is a decimal fraction between 0 and 1, such as 0.01 or .01.  The
+ * scanner hands that to us as a host ID, so we parse it ourselves, which
+ * also keeps it independent of the locale.
+ */
+struct block *
+gen_sample_rate(s)
+	const char *s;
+{
+	const char *cp;
+	double rate = 0.0, scale = 1.0;
+	int seen_dot = 0;
+
+	for (cp = s; *cp != '\0'; cp++) {
+		if (*cp == '.' && !seen_dot) {
+			seen_dot = 1;
+			continue;
+		}
+		if (*cp < '0' || *cp > '9')
+			bpf_error("invalid sample rate %s", s);
+		if (seen_dot) {
+			scale /= 10.0;
+			rate += (*cp - '0') * scale;
+		} else
+			rate = rate * 10.0 + (*cp - '0');
+	}
+	if (rate > 1.0)
+		bpf_error("sample rate %s is greater than 1", s);
+	return gen_sample_prob(rate);
+}
+
+/*
+ * "sample rate 0" and "sample rate 1", which the scanner hands to us
+ * as numbers.
+ */
+struct block *
+gen_sample_rate_num(n)
+	bpf_u_int32 n;
+{
+	if (n > 1)
+		bpf_error("sample rate %u is greater than 1", n);
+	return gen_sample_prob((double)n);
+}
+
+/*
+ * "headers-only" at the beginning of a filter expression makes the
+ * program return, for each accepted packet, the length of its headers
+ * through the transport-layer header, rather than the snapshot length,
+ * so that packets are truncated to their headers in the kernel or by
+ * the userland filter.
+ */
+void
+gen_headers_only()
+{
+	headers_only = 1;
+}
+
+/*
+ * Make "cond" jump to "t" if it's true and "f" if it's false, and
+ * return its first block.
+ */
+static struct block *
+gen_branch(cond, t, f)
+	struct block *cond, *t, *f;
+{
+	backpatch(cond, t);
+	cond->sense = !cond->sense;
+	backpatch(cond, f);
+	cond->sense = !cond->sense;
+	return cond->head;
+}
+
+/*
+ * Return the header length that the statements "s" leave in the
+ * accumulator, or the snapshot length, if that's smaller.
+ */
+static struct block *
+gen_hdrlen_cap(s, snapret, aret)
+	struct slist *s;
+	struct block *snapret, *aret;
+{
+	struct block *b;
+
+	b = new_block(JMP(BPF_JGT));
+	b->stmts = s;
+	b->s.k = snaplen;
+	JT(b) = snapret;
+	JF(b) = aret;
+	return b;
+}
+
+/*
+ * Generate code that returns the length of the headers of a packet,
+ * through the TCP, UDP, or ICMP header for IPv4 and IPv6 packets, or
+ * through the network-layer header for other IP packets and for
+ * fragments other than the first; IPv6 extension headers aren't
+ * followed.  Packets that aren't IP packets get the snapshot length.
+ */
+static struct block *
+gen_hdrlen_ret()
+{
+	struct block *snapret, *aret;
+	struct block *ip4, *ip4first, *tcp4, *l4_4, *b0;
+	struct block *ip6, *tcp6, *l4_6;
+	struct block *rtcp4, *rl4_4, *rnet4, *rtcp6, *rl4_6, *rnet6;
+	struct slist *s, *s2;
+	u_int hdrlen;
+
+	snapret = gen_retblk(snaplen);
+	aret = new_block(BPF_RET|BPF_A);
+
+	/*
+	 * IPv4: the X register gets the length of the IP header
+	 * (plus the offset of the MAC-layer payload, if that's
+	 * variable, in which case off_macpl is 0).  For TCP, add the
+	 * TCP header length from the data offset field.
+	 */
+	s = gen_loadx_iphdrlen();
+	s2 = new_stmt(BPF_LD|BPF_IND|BPF_B);
+	s2->s.k = off_macpl + off_nl + 12;
+	sappend(s, s2);
+	s2 = new_stmt(BPF_ALU|BPF_AND|BPF_K);
+	s2->s.k = 0xf0;
+	sappend(s, s2);
+	s2 = new_stmt(BPF_ALU|BPF_RSH|BPF_K);
+	s2->s.k = 2;
+	sappend(s, s2);
+	sappend(s, new_stmt(BPF_ALU|BPF_ADD|BPF_X));
+	s2 = new_stmt(BPF_ALU|BPF_ADD|BPF_K);
+	s2->s.k = off_macpl + off_nl;
+	sappend(s, s2);
+	rtcp4 = gen_hdrlen_cap(s, snapret, aret);
+
+	s = gen_loadx_iphdrlen();
+	sappend(s, new_stmt(BPF_MISC|BPF_TXA));
+	s2 = new_stmt(BPF_ALU|BPF_ADD|BPF_K);
+	s2->s.k = off_macpl + off_nl + 8;
+	sappend(s, s2);
+	rl4_4 = gen_hdrlen_cap(s, snapret, aret);
+
+	s = gen_loadx_iphdrlen();
+	sappend(s, new_stmt(BPF_MISC|BPF_TXA));
+	s2 = new_stmt(BPF_ALU|BPF_ADD|BPF_K);
+	s2->s.k = off_macpl + off_nl;
+	sappend(s, s2);
+	rnet4 = gen_hdrlen_cap(s, snapret, aret);
+
+	/*
+	 * IPv6: the fixed header is 40 bytes long.
+	 */
+	s = gen_load_a(OR_TRAN_IPV6, 12, BPF_B);
+	s2 = new_stmt(BPF_ALU|BPF_AND|BPF_K);
+	s2->s.k = 0xf0;
+	sappend(s, s2);
+	s2 = new_stmt(BPF_ALU|BPF_RSH|BPF_K);
+	s2->s.k = 2;
+	sappend(s, s2);
+	s2 = gen_off_macpl();
+	if (s2 != NULL) {
+		sappend(s, s2);
+		sappend(s, new_stmt(BPF_ALU|BPF_ADD|BPF_X));
+		s2 = new_stmt(BPF_ALU|BPF_ADD|BPF_K);
+		s2->s.k = off_nl + 40;
+	} else {
+		s2 = new_stmt(BPF_ALU|BPF_ADD|BPF_K);
+		s2->s.k = off_macpl + off_nl + 40;
+	}
+	sappend(s, s2);
+	rtcp6 = gen_hdrlen_cap(s, snapret, aret);
+
+	s = gen_off_macpl();
+	if (s != NULL) {
+		sappend(s, new_stmt(BPF_MISC|BPF_TXA));
+		s2 = new_stmt(BPF_ALU|BPF_ADD|BPF_K);
+		s2->s.k = off_nl + 48;
+		sappend(s, s2);
+		rl4_6 = gen_hdrlen_cap(s, snapret, aret);
+
+		s = gen_off_macpl();
+		sappend(s, new_stmt(BPF_MISC|BPF_TXA));
+		s2 = new_stmt(BPF_ALU|BPF_ADD|BPF_K);
+		s2->s.k = off_nl + 40;
+		sappend(s, s2);
+		rnet6 = gen_hdrlen_cap(s, snapret, aret);
+	} else {
+		/*
+		 * The lengths are constants; cap them here.
+		 */
+		hdrlen = off_macpl + off_nl + 48;
+		rl4_6 = gen_retblk(hdrlen < (u_int)snaplen ? hdrlen : snaplen);
+		hdrlen = off_macpl + off_nl + 40;
+		rnet6 = gen_retblk(hdrlen < (u_int)snaplen ? hdrlen : snaplen);
+	}
+
+	/*
+	 * Now wire up the tests, starting from the end.
+	 */
+	tcp6 = gen_cmp(OR_NET, 6, BPF_B, IPPROTO_TCP);
+	l4_6 = gen_cmp(OR_NET, 6, BPF_B, IPPROTO_UDP);
+	b0 = gen_cmp(OR_NET, 6, BPF_B, IPPROTO_ICMPV6);
+	gen_or(l4_6, b0);
+	gen_branch(b0, rl4_6, rnet6);
+	ip6 = gen_linktype(ETHERTYPE_IPV6);
+	gen_branch(ip6, gen_branch(tcp6, rtcp6, b0->head), snapret);
+
+	tcp4 = gen_cmp(OR_NET, 9, BPF_B, IPPROTO_TCP);
+	l4_4 = gen_cmp(OR_NET, 9, BPF_B, IPPROTO_UDP);
+	b0 = gen_cmp(OR_NET, 9, BPF_B, IPPROTO_ICMP);
+	gen_or(l4_4, b0);
+	gen_branch(b0, rl4_4, rnet4);
+	gen_branch(tcp4, rtcp4, b0->head);
+	ip4first = gen_ipfrag();
+	gen_branch(ip4first, tcp4->head, rnet4);
+	ip4 = gen_linktype(ETHERTYPE_IP);
+	return gen_branch(ip4, ip4first->head, ip6->head);
+}
+
 #ifdef HAVE_NET_PFVAR_H
 /* PF firewall log matched interface */
 struct block *
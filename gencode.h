@@ -226,11 +226,6 @@ typedef bpf_u_int32 atomset;
 #define ATOMMASK(n) (1 << (n))
 #define ATOMELEM(d, n) (d & ATOMMASK(n))
 
-/*
- * An unbounded set.
- */
-typedef bpf_u_int32 *uset;
-
 /*
  * Total number of atomic entities, including accumulator (A) and index (X).
  * We treat all these guys similarly during flow analysis.
@@ -240,7 +235,6 @@ typedef bpf_u_int32 *uset;
 struct edge {
 	int id;
 	int code;
-	uset edom;
 	struct block *succ;
 	struct block *pred;
 	struct edge *next;	/* link list of incoming edges for a node */
@@ -260,8 +254,6 @@ struct block {
 	struct edge ef;
 	struct block *head;
 	struct block *link;	/* link field used by optimizer */
-	uset dom;
-	uset closure;
 	struct edge *in_edges;
 	atomset def, kill;
 	atomset in_use;
@@ -309,6 +301,10 @@ struct block *gen_byteop(int, int, int);
 struct block *gen_broadcast(int);
 struct block *gen_multicast(int);
 struct block *gen_inbound(int);
+struct block *gen_sample(int);
+struct block *gen_sample_rate(const char *);
+struct block *gen_sample_rate_num(bpf_u_int32);
+void gen_headers_only(void);
 
 struct block *gen_vlan(int);
 struct block *gen_mpls(int);
@@ -0,0 +1,3670 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison implementation for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* C LALR(1) parser skeleton written by Richard Stallman, by
+   simplifying the original so-called "semantic" parser.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+/* All symbols defined below should begin with yy or YY, to avoid
+   infringing on user name space.  This should be done even for local
+   variables, as they might otherwise be expanded by user macros.
+   There are some unavoidable exceptions within include files to
+   define necessary library symbols; they are noted "INFRINGES ON
+   USER NAME SPACE" below.  */
+
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
+
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
+
+/* Skeleton name.  */
+#define YYSKELETON_NAME "yacc.c"
+
+/* Pure parsers.  */
+#define YYPURE 0
+
+/* Push parsers.  */
+#define YYPUSH 0
+
+/* Pull parsers.  */
+#define YYPULL 1
+
+
+
+
+/* First part of user prologue.  */
+#line 1 "grammar.y"
+
+/*
+ * Copyright (c) 1988, 1989, 1990, 1991, 1992, 1993, 1994, 1995, 1996
+ *	The Regents of the University of California.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that: (1) source code distributions
+ * retain the above copyright notice and this paragraph in its entirety, (2)
+ * distributions including binary code include the above copyright notice and
+ * this paragraph in its entirety in the documentation or other materials
+ * provided with the distribution, and (3) all advertising materials mentioning
+ * features or use of this software display the following acknowledgement:
+ * ``This product includes software developed by the University of California,
+ * Lawrence Berkeley Laboratory and its contributors.'' Neither the name of
+ * the University nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ */
+#ifndef lint
+static const char rcsid[] _U_ =
+    "@(#) $Header: /tcpdump/master/libpcap/grammar.y,v 1.101 2007-11-18 02:03:52 guy Exp $ (LBL)";
+#endif
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#ifdef WIN32
+#include <pcap-stdinc.h>
+#else /* WIN32 */
+#include <sys/types.h>
+#include <sys/socket.h>
+#endif /* WIN32 */
+
+#include <stdlib.h>
+
+#ifndef WIN32
+#if __STDC__
+struct mbuf;
+struct rtentry;
+#endif
+
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#endif /* WIN32 */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "pcap-int.h"
+
+#include "gencode.h"
+#ifdef HAVE_NET_PFVAR_H
+#include <net/if.h>
+#include <net/pfvar.h>
+#include <net/if_pflog.h>
+#endif
+#include "ieee80211.h"
+#include <pcap/namedb.h>
+
+#ifdef HAVE_OS_PROTO_H
+#include "os-proto.h"
+#endif
+
+#define QSET(q, p, d, a) (q).proto = (p),\
+			 (q).dir = (d),\
+			 (q).addr = (a)
+
+struct tok {
+	int v;			/* value */
+	const char *s;		/* string */
+};
+
+static const struct tok ieee80211_types[] = {
+	{ IEEE80211_FC0_TYPE_DATA, "data" },
+	{ IEEE80211_FC0_TYPE_MGT, "mgt" },
+	{ IEEE80211_FC0_TYPE_MGT, "management" },
+	{ IEEE80211_FC0_TYPE_CTL, "ctl" },
+	{ IEEE80211_FC0_TYPE_CTL, "control" },
+	{ 0, NULL }
+};
+static const struct tok ieee80211_mgt_subtypes[] = {
+	{ IEEE80211_FC0_SUBTYPE_ASSOC_REQ, "assocreq" },
+	{ IEEE80211_FC0_SUBTYPE_ASSOC_REQ, "assoc-req" },
+	{ IEEE80211_FC0_SUBTYPE_ASSOC_RESP, "assocresp" },
+	{ IEEE80211_FC0_SUBTYPE_ASSOC_RESP, "assoc-resp" },
+	{ IEEE80211_FC0_SUBTYPE_REASSOC_REQ, "reassocreq" },
+	{ IEEE80211_FC0_SUBTYPE_REASSOC_REQ, "reassoc-req" },
+	{ IEEE80211_FC0_SUBTYPE_REASSOC_RESP, "reassocresp" },
+	{ IEEE80211_FC0_SUBTYPE_REASSOC_RESP, "reassoc-resp" },
+	{ IEEE80211_FC0_SUBTYPE_PROBE_REQ, "probereq" },
+	{ IEEE80211_FC0_SUBTYPE_PROBE_REQ, "probe-req" },
+	{ IEEE80211_FC0_SUBTYPE_PROBE_RESP, "proberesp" },
+	{ IEEE80211_FC0_SUBTYPE_PROBE_RESP, "probe-resp" },
+	{ IEEE80211_FC0_SUBTYPE_BEACON, "beacon" },
+	{ IEEE80211_FC0_SUBTYPE_ATIM, "atim" },
+	{ IEEE80211_FC0_SUBTYPE_DISASSOC, "disassoc" },
+	{ IEEE80211_FC0_SUBTYPE_DISASSOC, "disassociation" },
+	{ IEEE80211_FC0_SUBTYPE_AUTH, "auth" },
+	{ IEEE80211_FC0_SUBTYPE_AUTH, "authentication" },
+	{ IEEE80211_FC0_SUBTYPE_DEAUTH, "deauth" },
+	{ IEEE80211_FC0_SUBTYPE_DEAUTH, "deauthentication" },
+	{ 0, NULL }
+};
+static const struct tok ieee80211_ctl_subtypes[] = {
+	{ IEEE80211_FC0_SUBTYPE_PS_POLL, "ps-poll" },
+	{ IEEE80211_FC0_SUBTYPE_RTS, "rts" },
+	{ IEEE80211_FC0_SUBTYPE_CTS, "cts" },
+	{ IEEE80211_FC0_SUBTYPE_ACK, "ack" },
+	{ IEEE80211_FC0_SUBTYPE_CF_END, "cf-end" },
+	{ IEEE80211_FC0_SUBTYPE_CF_END_ACK, "cf-end-ack" },
+	{ 0, NULL }
+};
+static const struct tok ieee80211_data_subtypes[] = {
+	{ IEEE80211_FC0_SUBTYPE_DATA, "data" },
+	{ IEEE80211_FC0_SUBTYPE_CF_ACK, "data-cf-ack" },
+	{ IEEE80211_FC0_SUBTYPE_CF_POLL, "data-cf-poll" },
+	{ IEEE80211_FC0_SUBTYPE_CF_ACPL, "data-cf-ack-poll" },
+	{ IEEE80211_FC0_SUBTYPE_NODATA, "null" },
+	{ IEEE80211_FC0_SUBTYPE_NODATA_CF_ACK, "cf-ack" },
+	{ IEEE80211_FC0_SUBTYPE_NODATA_CF_POLL, "cf-poll"  },
+	{ IEEE80211_FC0_SUBTYPE_NODATA_CF_ACPL, "cf-ack-poll" },
+	{ IEEE80211_FC0_SUBTYPE_QOS|IEEE80211_FC0_SUBTYPE_DATA, "qos-data" },
+	{ IEEE80211_FC0_SUBTYPE_QOS|IEEE80211_FC0_SUBTYPE_CF_ACK, "qos-data-cf-ack" },
+	{ IEEE80211_FC0_SUBTYPE_QOS|IEEE80211_FC0_SUBTYPE_CF_POLL, "qos-data-cf-poll" },
+	{ IEEE80211_FC0_SUBTYPE_QOS|IEEE80211_FC0_SUBTYPE_CF_ACPL, "qos-data-cf-ack-poll" },
+	{ IEEE80211_FC0_SUBTYPE_QOS|IEEE80211_FC0_SUBTYPE_NODATA, "qos" },
+	{ IEEE80211_FC0_SUBTYPE_QOS|IEEE80211_FC0_SUBTYPE_NODATA_CF_POLL, "qos-cf-poll" },
+	{ IEEE80211_FC0_SUBTYPE_QOS|IEEE80211_FC0_SUBTYPE_NODATA_CF_ACPL, "qos-cf-ack-poll" },
+	{ 0, NULL }
+};
+struct type2tok {
+	int type;
+	const struct tok *tok;
+};
+static const struct type2tok ieee80211_type_subtypes[] = {
+	{ IEEE80211_FC0_TYPE_MGT, ieee80211_mgt_subtypes },
+	{ IEEE80211_FC0_TYPE_CTL, ieee80211_ctl_subtypes },
+	{ IEEE80211_FC0_TYPE_DATA, ieee80211_data_subtypes },
+	{ 0, NULL }
+};
+
+static int
+str2tok(const char *str, const struct tok *toks)
+{
+	int i;
+
+	for (i = 0; toks[i].s != NULL; i++) {
+		if (pcap_strcasecmp(toks[i].s, str) == 0)
+			return (toks[i].v);
+	}
+	return (-1);
+}
+
+int n_errors = 0;
+
+static struct qual qerr = { Q_UNDEF, Q_UNDEF, Q_UNDEF, Q_UNDEF };
+
+static void
+yyerror(const char *msg)
+{
+	++n_errors;
+	bpf_error("%s", msg);
+	/* NOTREACHED */
+}
+
+#ifdef NEED_YYPARSE_WRAPPER
+int yyparse(void);
+
+int
+pcap_parse()
+{
+	return (yyparse());
+}
+#endif
+
+#ifdef HAVE_NET_PFVAR_H
+static int
+pfreason_to_num(const char *reason)
+{
+	const char *reasons[] = PFRES_NAMES;
+	int i;
+
+	for (i = 0; reasons[i]; i++) {
+		if (pcap_strcasecmp(reason, reasons[i]) == 0)
+			return (i);
+	}
+	bpf_error("unknown PF reason");
+	/*NOTREACHED*/
+}
+
+static int
+pfaction_to_num(const char *action)
+{
+	if (pcap_strcasecmp(action, "pass") == 0 ||
+	    pcap_strcasecmp(action, "accept") == 0)
+		return (PF_PASS);
+	else if (pcap_strcasecmp(action, "drop") == 0 ||
+		pcap_strcasecmp(action, "block") == 0)
+		return (PF_DROP);
+#if HAVE_PF_NAT_THROUGH_PF_NORDR
+	else if (pcap_strcasecmp(action, "rdr") == 0)
+		return (PF_RDR);
+	else if (pcap_strcasecmp(action, "nat") == 0)
+		return (PF_NAT);
+	else if (pcap_strcasecmp(action, "binat") == 0)
+		return (PF_BINAT);
+	else if (pcap_strcasecmp(action, "nordr") == 0)
+		return (PF_NORDR);
+#endif
+	else {
+		bpf_error("unknown PF action");
+		/*NOTREACHED*/
+	}
+}
+#else /* !HAVE_NET_PFVAR_H */
+static int
+pfreason_to_num(const char *reason)
+{
+	bpf_error("libpcap was compiled on a machine without pf support");
+	/*NOTREACHED*/
+
+	/* this is to make the VC compiler happy */
+	return -1;
+}
+
+static int
+pfaction_to_num(const char *action)
+{
+	bpf_error("libpcap was compiled on a machine without pf support");
+	/*NOTREACHED*/
+
+	/* this is to make the VC compiler happy */
+	return -1;
+}
+#endif /* HAVE_NET_PFVAR_H */
+
+#line 313 "y.tab.c"
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
+
+/* Use api.header.include to #include this header
+   instead of duplicating it here.  */
+#ifndef YY_YY_Y_TAB_H_INCLUDED
+# define YY_YY_Y_TAB_H_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 0
+#endif
+#if YYDEBUG
+extern int yydebug;
+#endif
+
+/* Token kinds.  */
+#ifndef YYTOKENTYPE
+# define YYTOKENTYPE
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    DST = 258,                     /* DST  */
+    SRC = 259,                     /* SRC  */
+    HOST = 260,                    /* HOST  */
+    GATEWAY = 261,                 /* GATEWAY  */
+    NET = 262,                     /* NET  */
+    NETMASK = 263,                 /* NETMASK  */
+    PORT = 264,                    /* PORT  */
+    PORTRANGE = 265,               /* PORTRANGE  */
+    LESS = 266,                    /* LESS  */
+    GREATER = 267,                 /* GREATER  */
+    PROTO = 268,                   /* PROTO  */
+    PROTOCHAIN = 269,              /* PROTOCHAIN  */
+    CBYTE = 270,                   /* CBYTE  */
+    ARP = 271,                     /* ARP  */
+    RARP = 272,                    /* RARP  */
+    IP = 273,                      /* IP  */
+    SCTP = 274,                    /* SCTP  */
+    TCP = 275,                     /* TCP  */
+    UDP = 276,                     /* UDP  */
+    ICMP = 277,                    /* ICMP  */
+    IGMP = 278,                    /* IGMP  */
+    IGRP = 279,                    /* IGRP  */
+    PIM = 280,                     /* PIM  */
+    VRRP = 281,                    /* VRRP  */
+    CARP = 282,                    /* CARP  */
+    ATALK = 283,                   /* ATALK  */
+    AARP = 284,                    /* AARP  */
+    DECNET = 285,                  /* DECNET  */
+    LAT = 286,                     /* LAT  */
+    SCA = 287,                     /* SCA  */
+    MOPRC = 288,                   /* MOPRC  */
+    MOPDL = 289,                   /* MOPDL  */
+    TK_BROADCAST = 290,            /* TK_BROADCAST  */
+    TK_MULTICAST = 291,            /* TK_MULTICAST  */
+    NUM = 292,                     /* NUM  */
+    INBOUND = 293,                 /* INBOUND  */
+    OUTBOUND = 294,                /* OUTBOUND  */
+    SAMPLE = 295,                  /* SAMPLE  */
+    HDRONLY = 296,                 /* HDRONLY  */
+    PF_IFNAME = 297,               /* PF_IFNAME  */
+    PF_RSET = 298,                 /* PF_RSET  */
+    PF_RNR = 299,                  /* PF_RNR  */
+    PF_SRNR = 300,                 /* PF_SRNR  */
+    PF_REASON = 301,               /* PF_REASON  */
+    PF_ACTION = 302,               /* PF_ACTION  */
+    TYPE = 303,                    /* TYPE  */
+    SUBTYPE = 304,                 /* SUBTYPE  */
+    DIR = 305,                     /* DIR  */
+    ADDR1 = 306,                   /* ADDR1  */
+    ADDR2 = 307,                   /* ADDR2  */
+    ADDR3 = 308,                   /* ADDR3  */
+    ADDR4 = 309,                   /* ADDR4  */
+    RA = 310,                      /* RA  */
+    TA = 311,                      /* TA  */
+    LINK = 312,                    /* LINK  */
+    GEQ = 313,                     /* GEQ  */
+    LEQ = 314,                     /* LEQ  */
+    NEQ = 315,                     /* NEQ  */
+    ID = 316,                      /* ID  */
+    EID = 317,                     /* EID  */
+    HID = 318,                     /* HID  */
+    HID6 = 319,                    /* HID6  */
+    AID = 320,                     /* AID  */
+    LSH = 321,                     /* LSH  */
+    RSH = 322,                     /* RSH  */
+    LEN = 323,                     /* LEN  */
+    IPV6 = 324,                    /* IPV6  */
+    ICMPV6 = 325,                  /* ICMPV6  */
+    AH = 326,                      /* AH  */
+    ESP = 327,                     /* ESP  */
+    VLAN = 328,                    /* VLAN  */
+    MPLS = 329,                    /* MPLS  */
+    PPPOED = 330,                  /* PPPOED  */
+    PPPOES = 331,                  /* PPPOES  */
+    ISO = 332,                     /* ISO  */
+    ESIS = 333,                    /* ESIS  */
+    CLNP = 334,                    /* CLNP  */
+    ISIS = 335,                    /* ISIS  */
+    L1 = 336,                      /* L1  */
+    L2 = 337,                      /* L2  */
+    IIH = 338,                     /* IIH  */
+    LSP = 339,                     /* LSP  */
+    SNP = 340,                     /* SNP  */
+    CSNP = 341,                    /* CSNP  */
+    PSNP = 342,                    /* PSNP  */
+    STP = 343,                     /* STP  */
+    IPX = 344,                     /* IPX  */
+    NETBEUI = 345,                 /* NETBEUI  */
+    LANE = 346,                    /* LANE  */
+    LLC = 347,                     /* LLC  */
+    METAC = 348,                   /* METAC  */
+    BCC = 349,                     /* BCC  */
+    SC = 350,                      /* SC  */
+    ILMIC = 351,                   /* ILMIC  */
+    OAMF4EC = 352,                 /* OAMF4EC  */
+    OAMF4SC = 353,                 /* OAMF4SC  */
+    OAM = 354,                     /* OAM  */
+    OAMF4 = 355,                   /* OAMF4  */
+    CONNECTMSG = 356,              /* CONNECTMSG  */
+    METACONNECT = 357,             /* METACONNECT  */
+    VPI = 358,                     /* VPI  */
+    VCI = 359,                     /* VCI  */
+    RADIO = 360,                   /* RADIO  */
+    FISU = 361,                    /* FISU  */
+    LSSU = 362,                    /* LSSU  */
+    MSU = 363,                     /* MSU  */
+    HFISU = 364,                   /* HFISU  */
+    HLSSU = 365,                   /* HLSSU  */
+    HMSU = 366,                    /* HMSU  */
+    SIO = 367,                     /* SIO  */
+    OPC = 368,                     /* OPC  */
+    DPC = 369,                     /* DPC  */
+    SLS = 370,                     /* SLS  */
+    HSIO = 371,                    /* HSIO  */
+    HOPC = 372,                    /* HOPC  */
+    HDPC = 373,                    /* HDPC  */
+    HSLS = 374,                    /* HSLS  */
+    OR = 375,                      /* OR  */
+    AND = 376,                     /* AND  */
+    UMINUS = 377                   /* UMINUS  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
+#endif
+/* Token kinds.  */
+#define YYEMPTY -2
+#define YYEOF 0
+#define YYerror 256
+#define YYUNDEF 257
+#define DST 258
+#define SRC 259
+#define HOST 260
+#define GATEWAY 261
+#define NET 262
+#define NETMASK 263
+#define PORT 264
+#define PORTRANGE 265
+#define LESS 266
+#define GREATER 267
+#define PROTO 268
+#define PROTOCHAIN 269
+#define CBYTE 270
+#define ARP 271
+#define RARP 272
+#define IP 273
+#define SCTP 274
+#define TCP 275
+#define UDP 276
+#define ICMP 277
+#define IGMP 278
+#define IGRP 279
+#define PIM 280
+#define VRRP 281
+#define CARP 282
+#define ATALK 283
+#define AARP 284
+#define DECNET 285
+#define LAT 286
+#define SCA 287
+#define MOPRC 288
+#define MOPDL 289
+#define TK_BROADCAST 290
+#define TK_MULTICAST 291
+#define NUM 292
+#define INBOUND 293
+#define OUTBOUND 294
+#define SAMPLE 295
+#define HDRONLY 296
+#define PF_IFNAME 297
+#define PF_RSET 298
+#define PF_RNR 299
+#define PF_SRNR 300
+#define PF_REASON 301
+#define PF_ACTION 302
+#define TYPE 303
+#define SUBTYPE 304
+#define DIR 305
+#define ADDR1 306
+#define ADDR2 307
+#define ADDR3 308
+#define ADDR4 309
+#define RA 310
+#define TA 311
+#define LINK 312
+#define GEQ 313
+#define LEQ 314
+#define NEQ 315
+#define ID 316
+#define EID 317
+#define HID 318
+#define HID6 319
+#define AID 320
+#define LSH 321
+#define RSH 322
+#define LEN 323
+#define IPV6 324
+#define ICMPV6 325
+#define AH 326
+#define ESP 327
+#define VLAN 328
+#define MPLS 329
+#define PPPOED 330
+#define PPPOES 331
+#define ISO 332
+#define ESIS 333
+#define CLNP 334
+#define ISIS 335
+#define L1 336
+#define L2 337
+#define IIH 338
+#define LSP 339
+#define SNP 340
+#define CSNP 341
+#define PSNP 342
+#define STP 343
+#define IPX 344
+#define NETBEUI 345
+#define LANE 346
+#define LLC 347
+#define METAC 348
+#define BCC 349
+#define SC 350
+#define ILMIC 351
+#define OAMF4EC 352
+#define OAMF4SC 353
+#define OAM 354
+#define OAMF4 355
+#define CONNECTMSG 356
+#define METACONNECT 357
+#define VPI 358
+#define VCI 359
+#define RADIO 360
+#define FISU 361
+#define LSSU 362
+#define MSU 363
+#define HFISU 364
+#define HLSSU 365
+#define HMSU 366
+#define SIO 367
+#define OPC 368
+#define DPC 369
+#define SLS 370
+#define HSIO 371
+#define HOPC 372
+#define HDPC 373
+#define HSLS 374
+#define OR 375
+#define AND 376
+#define UMINUS 377
+
+/* Value type.  */
+#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
+union YYSTYPE
+{
+#line 243 "grammar.y"
+
+	int i;
+	bpf_u_int32 h;
+	u_char *e;
+	char *s;
+	struct stmt *stmt;
+	struct arth *a;
+	struct {
+		struct qual q;
+		int atmfieldtype;
+		int mtp3fieldtype;
+		struct block *b;
+	} blk;
+	struct block *rblk;
+
+#line 626 "y.tab.c"
+
+};
+typedef union YYSTYPE YYSTYPE;
+# define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
+#endif
+
+
+extern YYSTYPE yylval;
+
+
+int yyparse (void);
+
+
+#endif /* !YY_YY_Y_TAB_H_INCLUDED  */
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_DST = 3,                        /* DST  */
+  YYSYMBOL_SRC = 4,                        /* SRC  */
+  YYSYMBOL_HOST = 5,                       /* HOST  */
+  YYSYMBOL_GATEWAY = 6,                    /* GATEWAY  */
+  YYSYMBOL_NET = 7,                        /* NET  */
+  YYSYMBOL_NETMASK = 8,                    /* NETMASK  */
+  YYSYMBOL_PORT = 9,                       /* PORT  */
+  YYSYMBOL_PORTRANGE = 10,                 /* PORTRANGE  */
+  YYSYMBOL_LESS = 11,                      /* LESS  */
+  YYSYMBOL_GREATER = 12,                   /* GREATER  */
+  YYSYMBOL_PROTO = 13,                     /* PROTO  */
+  YYSYMBOL_PROTOCHAIN = 14,                /* PROTOCHAIN  */
+  YYSYMBOL_CBYTE = 15,                     /* CBYTE  */
+  YYSYMBOL_ARP = 16,                       /* ARP  */
+  YYSYMBOL_RARP = 17,                      /* RARP  */
+  YYSYMBOL_IP = 18,                        /* IP  */
+  YYSYMBOL_SCTP = 19,                      /* SCTP  */
+  YYSYMBOL_TCP = 20,                       /* TCP  */
+  YYSYMBOL_UDP = 21,                       /* UDP  */
+  YYSYMBOL_ICMP = 22,                      /* ICMP  */
+  YYSYMBOL_IGMP = 23,                      /* IGMP  */
+  YYSYMBOL_IGRP = 24,                      /* IGRP  */
+  YYSYMBOL_PIM = 25,                       /* PIM  */
+  YYSYMBOL_VRRP = 26,                      /* VRRP  */
+  YYSYMBOL_CARP = 27,                      /* CARP  */
+  YYSYMBOL_ATALK = 28,                     /* ATALK  */
+  YYSYMBOL_AARP = 29,                      /* AARP  */
+  YYSYMBOL_DECNET = 30,                    /* DECNET  */
+  YYSYMBOL_LAT = 31,                       /* LAT  */
+  YYSYMBOL_SCA = 32,                       /* SCA  */
+  YYSYMBOL_MOPRC = 33,                     /* MOPRC  */
+  YYSYMBOL_MOPDL = 34,                     /* MOPDL  */
+  YYSYMBOL_TK_BROADCAST = 35,              /* TK_BROADCAST  */
+  YYSYMBOL_TK_MULTICAST = 36,              /* TK_MULTICAST  */
+  YYSYMBOL_NUM = 37,                       /* NUM  */
+  YYSYMBOL_INBOUND = 38,                   /* INBOUND  */
+  YYSYMBOL_OUTBOUND = 39,                  /* OUTBOUND  */
+  YYSYMBOL_SAMPLE = 40,                    /* SAMPLE  */
+  YYSYMBOL_HDRONLY = 41,                   /* HDRONLY  */
+  YYSYMBOL_PF_IFNAME = 42,                 /* PF_IFNAME  */
+  YYSYMBOL_PF_RSET = 43,                   /* PF_RSET  */
+  YYSYMBOL_PF_RNR = 44,                    /* PF_RNR  */
+  YYSYMBOL_PF_SRNR = 45,                   /* PF_SRNR  */
+  YYSYMBOL_PF_REASON = 46,                 /* PF_REASON  */
+  YYSYMBOL_PF_ACTION = 47,                 /* PF_ACTION  */
+  YYSYMBOL_TYPE = 48,                      /* TYPE  */
+  YYSYMBOL_SUBTYPE = 49,                   /* SUBTYPE  */
+  YYSYMBOL_DIR = 50,                       /* DIR  */
+  YYSYMBOL_ADDR1 = 51,                     /* ADDR1  */
+  YYSYMBOL_ADDR2 = 52,                     /* ADDR2  */
+  YYSYMBOL_ADDR3 = 53,                     /* ADDR3  */
+  YYSYMBOL_ADDR4 = 54,                     /* ADDR4  */
+  YYSYMBOL_RA = 55,                        /* RA  */
+  YYSYMBOL_TA = 56,                        /* TA  */
+  YYSYMBOL_LINK = 57,                      /* LINK  */
+  YYSYMBOL_GEQ = 58,                       /* GEQ  */
+  YYSYMBOL_LEQ = 59,                       /* LEQ  */
+  YYSYMBOL_NEQ = 60,                       /* NEQ  */
+  YYSYMBOL_ID = 61,                        /* ID  */
+  YYSYMBOL_EID = 62,                       /* EID  */
+  YYSYMBOL_HID = 63,                       /* HID  */
+  YYSYMBOL_HID6 = 64,                      /* HID6  */
+  YYSYMBOL_AID = 65,                       /* AID  */
+  YYSYMBOL_LSH = 66,                       /* LSH  */
+  YYSYMBOL_RSH = 67,                       /* RSH  */
+  YYSYMBOL_LEN = 68,                       /* LEN  */
+  YYSYMBOL_IPV6 = 69,                      /* IPV6  */
+  YYSYMBOL_ICMPV6 = 70,                    /* ICMPV6  */
+  YYSYMBOL_AH = 71,                        /* AH  */
+  YYSYMBOL_ESP = 72,                       /* ESP  */
+  YYSYMBOL_VLAN = 73,                      /* VLAN  */
+  YYSYMBOL_MPLS = 74,                      /* MPLS  */
+  YYSYMBOL_PPPOED = 75,                    /* PPPOED  */
+  YYSYMBOL_PPPOES = 76,                    /* PPPOES  */
+  YYSYMBOL_ISO = 77,                       /* ISO  */
+  YYSYMBOL_ESIS = 78,                      /* ESIS  */
+  YYSYMBOL_CLNP = 79,                      /* CLNP  */
+  YYSYMBOL_ISIS = 80,                      /* ISIS  */
+  YYSYMBOL_L1 = 81,                        /* L1  */
+  YYSYMBOL_L2 = 82,                        /* L2  */
+  YYSYMBOL_IIH = 83,                       /* IIH  */
+  YYSYMBOL_LSP = 84,                       /* LSP  */
+  YYSYMBOL_SNP = 85,                       /* SNP  */
+  YYSYMBOL_CSNP = 86,                      /* CSNP  */
+  YYSYMBOL_PSNP = 87,                      /* PSNP  */
+  YYSYMBOL_STP = 88,                       /* STP  */
+  YYSYMBOL_IPX = 89,                       /* IPX  */
+  YYSYMBOL_NETBEUI = 90,                   /* NETBEUI  */
+  YYSYMBOL_LANE = 91,                      /* LANE  */
+  YYSYMBOL_LLC = 92,                       /* LLC  */
+  YYSYMBOL_METAC = 93,                     /* METAC  */
+  YYSYMBOL_BCC = 94,                       /* BCC  */
+  YYSYMBOL_SC = 95,                        /* SC  */
+  YYSYMBOL_ILMIC = 96,                     /* ILMIC  */
+  YYSYMBOL_OAMF4EC = 97,                   /* OAMF4EC  */
+  YYSYMBOL_OAMF4SC = 98,                   /* OAMF4SC  */
+  YYSYMBOL_OAM = 99,                       /* OAM  */
+  YYSYMBOL_OAMF4 = 100,                    /* OAMF4  */
+  YYSYMBOL_CONNECTMSG = 101,               /* CONNECTMSG  */
+  YYSYMBOL_METACONNECT = 102,              /* METACONNECT  */
+  YYSYMBOL_VPI = 103,                      /* VPI  */
+  YYSYMBOL_VCI = 104,                      /* VCI  */
+  YYSYMBOL_RADIO = 105,                    /* RADIO  */
+  YYSYMBOL_FISU = 106,                     /* FISU  */
+  YYSYMBOL_LSSU = 107,                     /* LSSU  */
+  YYSYMBOL_MSU = 108,                      /* MSU  */
+  YYSYMBOL_HFISU = 109,                    /* HFISU  */
+  YYSYMBOL_HLSSU = 110,                    /* HLSSU  */
+  YYSYMBOL_HMSU = 111,                     /* HMSU  */
+  YYSYMBOL_SIO = 112,                      /* SIO  */
+  YYSYMBOL_OPC = 113,                      /* OPC  */
+  YYSYMBOL_DPC = 114,                      /* DPC  */
+  YYSYMBOL_SLS = 115,                      /* SLS  */
+  YYSYMBOL_HSIO = 116,                     /* HSIO  */
+  YYSYMBOL_HOPC = 117,                     /* HOPC  */
+  YYSYMBOL_HDPC = 118,                     /* HDPC  */
+  YYSYMBOL_HSLS = 119,                     /* HSLS  */
+  YYSYMBOL_OR = 120,                       /* OR  */
+  YYSYMBOL_AND = 121,                      /* AND  */
+  YYSYMBOL_122_ = 122,                     /* '!'  */
+  YYSYMBOL_123_ = 123,                     /* '|'  */
+  YYSYMBOL_124_ = 124,                     /* '&'  */
+  YYSYMBOL_125_ = 125,                     /* '+'  */
+  YYSYMBOL_126_ = 126,                     /* '-'  */
+  YYSYMBOL_127_ = 127,                     /* '*'  */
+  YYSYMBOL_128_ = 128,                     /* '/'  */
+  YYSYMBOL_UMINUS = 129,                   /* UMINUS  */
+  YYSYMBOL_130_ = 130,                     /* ')'  */
+  YYSYMBOL_131_ = 131,                     /* '('  */
+  YYSYMBOL_132_ = 132,                     /* '>'  */
+  YYSYMBOL_133_ = 133,                     /* '='  */
+  YYSYMBOL_134_ = 134,                     /* '<'  */
+  YYSYMBOL_135_ = 135,                     /* '['  */
+  YYSYMBOL_136_ = 136,                     /* ']'  */
+  YYSYMBOL_137_ = 137,                     /* ':'  */
+  YYSYMBOL_YYACCEPT = 138,                 /* $accept  */
+  YYSYMBOL_prog = 139,                     /* prog  */
+  YYSYMBOL_hdronly = 140,                  /* hdronly  */
+  YYSYMBOL_rate = 141,                     /* rate  */
+  YYSYMBOL_null = 142,                     /* null  */
+  YYSYMBOL_expr = 143,                     /* expr  */
+  YYSYMBOL_and = 144,                      /* and  */
+  YYSYMBOL_or = 145,                       /* or  */
+  YYSYMBOL_id = 146,                       /* id  */
+  YYSYMBOL_nid = 147,                      /* nid  */
+  YYSYMBOL_not = 148,                      /* not  */
+  YYSYMBOL_paren = 149,                    /* paren  */
+  YYSYMBOL_pid = 150,                      /* pid  */
+  YYSYMBOL_qid = 151,                      /* qid  */
+  YYSYMBOL_term = 152,                     /* term  */
+  YYSYMBOL_head = 153,                     /* head  */
+  YYSYMBOL_rterm = 154,                    /* rterm  */
+  YYSYMBOL_pqual = 155,                    /* pqual  */
+  YYSYMBOL_dqual = 156,                    /* dqual  */
+  YYSYMBOL_aqual = 157,                    /* aqual  */
+  YYSYMBOL_ndaqual = 158,                  /* ndaqual  */
+  YYSYMBOL_pname = 159,                    /* pname  */
+  YYSYMBOL_other = 160,                    /* other  */
+  YYSYMBOL_pfvar = 161,                    /* pfvar  */
+  YYSYMBOL_p80211 = 162,                   /* p80211  */
+  YYSYMBOL_type = 163,                     /* type  */
+  YYSYMBOL_subtype = 164,                  /* subtype  */
+  YYSYMBOL_type_subtype = 165,             /* type_subtype  */
+  YYSYMBOL_dir = 166,                      /* dir  */
+  YYSYMBOL_reason = 167,                   /* reason  */
+  YYSYMBOL_action = 168,                   /* action  */
+  YYSYMBOL_relop = 169,                    /* relop  */
+  YYSYMBOL_irelop = 170,                   /* irelop  */
+  YYSYMBOL_arth = 171,                     /* arth  */
+  YYSYMBOL_narth = 172,                    /* narth  */
+  YYSYMBOL_byteop = 173,                   /* byteop  */
+  YYSYMBOL_pnum = 174,                     /* pnum  */
+  YYSYMBOL_atmtype = 175,                  /* atmtype  */
+  YYSYMBOL_atmmultitype = 176,             /* atmmultitype  */
+  YYSYMBOL_atmfield = 177,                 /* atmfield  */
+  YYSYMBOL_atmvalue = 178,                 /* atmvalue  */
+  YYSYMBOL_atmfieldvalue = 179,            /* atmfieldvalue  */
+  YYSYMBOL_atmlistvalue = 180,             /* atmlistvalue  */
+  YYSYMBOL_mtp2type = 181,                 /* mtp2type  */
+  YYSYMBOL_mtp3field = 182,                /* mtp3field  */
+  YYSYMBOL_mtp3value = 183,                /* mtp3value  */
+  YYSYMBOL_mtp3fieldvalue = 184,           /* mtp3fieldvalue  */
+  YYSYMBOL_mtp3listvalue = 185             /* mtp3listvalue  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
+
+
+
+
+#ifdef short
+# undef short
+#endif
+
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
+#endif
+
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
+typedef signed char yytype_int8;
+#endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
+#else
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
+#else
+typedef short yytype_uint8;
+#endif
+
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
+#else
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
+#endif
+
+#ifndef YYSIZE_T
+# ifdef __SIZE_TYPE__
+#  define YYSIZE_T __SIZE_TYPE__
+# elif defined size_t
+#  define YYSIZE_T size_t
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYSIZE_T size_t
+# else
+#  define YYSIZE_T unsigned
+# endif
+#endif
+
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_int16 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
+
+#ifndef YY_
+# if defined YYENABLE_NLS && YYENABLE_NLS
+#  if ENABLE_NLS
+#   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
+#  endif
+# endif
+# ifndef YY_
+#  define YY_(Msgid) Msgid
+# endif
+#endif
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
+# endif
+#endif
+
+/* Suppress unused-variable warnings by "using" E.  */
+#if ! defined lint || defined __GNUC__
+# define YY_USE(E) ((void) (E))
+#else
+# define YY_USE(E) /* empty */
+#endif
+
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
+#else
+# define YY_INITIAL_VALUE(Value) Value
+#endif
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
+#endif
+
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if !defined yyoverflow
+
+/* The parser invokes alloca or malloc; define the necessary symbols.  */
+
+# ifdef YYSTACK_USE_ALLOCA
+#  if YYSTACK_USE_ALLOCA
+#   ifdef __GNUC__
+#    define YYSTACK_ALLOC __builtin_alloca
+#   elif defined __BUILTIN_VA_ARG_INCR
+#    include <alloca.h> /* INFRINGES ON USER NAME SPACE */
+#   elif defined _AIX
+#    define YYSTACK_ALLOC __alloca
+#   elif defined _MSC_VER
+#    include <malloc.h> /* INFRINGES ON USER NAME SPACE */
+#    define alloca _alloca
+#   else
+#    define YYSTACK_ALLOC alloca
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
+#     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
+#     endif
+#    endif
+#   endif
+#  endif
+# endif
+
+# ifdef YYSTACK_ALLOC
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+    /* The OS might guarantee only one guard page at the bottom of the stack,
+       and a page size can be as small as 4096 bytes.  So we cannot safely
+       invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
+       to allow for a few compiler-allocated temporary stack slots.  */
+#   define YYSTACK_ALLOC_MAXIMUM 4032 /* reasonable circa 2006 */
+#  endif
+# else
+#  define YYSTACK_ALLOC YYMALLOC
+#  define YYSTACK_FREE YYFREE
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+#   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
+#  endif
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
+       && ! ((defined YYMALLOC || defined malloc) \
+             && (defined YYFREE || defined free)))
+#   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
+#   endif
+#  endif
+#  ifndef YYMALLOC
+#   define YYMALLOC malloc
+#   if ! defined malloc && ! defined EXIT_SUCCESS
+void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+#  ifndef YYFREE
+#   define YYFREE free
+#   if ! defined free && ! defined EXIT_SUCCESS
+void free (void *); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+# endif
+#endif /* !defined yyoverflow */
+
+#if (! defined yyoverflow \
+     && (! defined __cplusplus \
+         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+
+/* A type that is properly aligned for any stack member.  */
+union yyalloc
+{
+  yy_state_t yyss_alloc;
+  YYSTYPE yyvs_alloc;
+};
+
+/* The size of the maximum gap between one aligned stack and the next.  */
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
+
+/* The size of an array large to enough to hold all stacks, each with
+   N elements.  */
+# define YYSTACK_BYTES(N) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
+      + YYSTACK_GAP_MAXIMUM)
+
+# define YYCOPY_NEEDED 1
+
+/* Relocate STACK from its old location to the new one.  The
+   local variables YYSIZE and YYSTACKSIZE give the old and new number of
+   elements in the stack, and YYPTR gives the new location of the
+   stack.  Advance YYPTR to a properly aligned location for the next
+   stack.  */
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
+
+#endif
+
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
+/* YYFINAL -- State number of the termination state.  */
+#define YYFINAL  5
+/* YYLAST -- Last index in YYTABLE.  */
+#define YYLAST   835
+
+/* YYNTOKENS -- Number of terminals.  */
+#define YYNTOKENS  138
+/* YYNNTS -- Number of nonterminals.  */
+#define YYNNTS  48
+/* YYNRULES -- Number of rules.  */
+#define YYNRULES  220
+/* YYNSTATES -- Number of states.  */
+#define YYNSTATES  296
+
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   377
+
+
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_uint8 yytranslate[] =
+{
+       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,   122,     2,     2,     2,     2,   124,     2,
+     131,   130,   127,   125,     2,   126,     2,   128,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,   137,     2,
+     134,   133,   132,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,   135,     2,   136,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,   123,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
+       5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
+      15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
+      25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
+      35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
+      45,    46,    47,    48,    49,    50,    51,    52,    53,    54,
+      55,    56,    57,    58,    59,    60,    61,    62,    63,    64,
+      65,    66,    67,    68,    69,    70,    71,    72,    73,    74,
+      75,    76,    77,    78,    79,    80,    81,    82,    83,    84,
+      85,    86,    87,    88,    89,    90,    91,    92,    93,    94,
+      95,    96,    97,    98,    99,   100,   101,   102,   103,   104,
+     105,   106,   107,   108,   109,   110,   111,   112,   113,   114,
+     115,   116,   117,   118,   119,   120,   121,   129
+};
+
+#if YYDEBUG
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int16 yyrline[] =
+{
+       0,   317,   317,   321,   322,   326,   331,   337,   340,   342,
+     343,   344,   345,   346,   348,   350,   352,   353,   355,   357,
+     358,   359,   361,   363,   376,   385,   394,   403,   412,   414,
+     416,   418,   419,   420,   422,   424,   426,   427,   429,   430,
+     431,   432,   433,   434,   436,   437,   438,   439,   441,   443,
+     444,   445,   446,   447,   448,   451,   452,   455,   456,   457,
+     458,   459,   460,   461,   462,   463,   464,   465,   466,   469,
+     470,   471,   472,   475,   477,   478,   479,   480,   481,   482,
+     483,   484,   485,   486,   487,   488,   489,   490,   491,   492,
+     493,   494,   495,   496,   497,   498,   499,   500,   501,   502,
+     503,   504,   505,   506,   507,   508,   509,   510,   511,   512,
+     513,   514,   515,   517,   518,   519,   520,   521,   522,   523,
+     524,   525,   526,   527,   528,   529,   530,   531,   532,   533,
+     534,   537,   538,   539,   540,   541,   542,   545,   550,   553,
+     557,   560,   561,   567,   568,   588,   604,   605,   618,   619,
+     622,   625,   626,   627,   629,   630,   631,   633,   634,   636,
+     637,   638,   639,   640,   641,   642,   643,   644,   645,   646,
+     647,   648,   650,   651,   652,   653,   654,   656,   657,   659,
+     660,   661,   662,   663,   664,   665,   666,   668,   669,   670,
+     671,   674,   675,   677,   678,   679,   680,   682,   689,   690,
+     693,   694,   695,   696,   697,   698,   701,   702,   703,   704,
+     705,   706,   707,   708,   710,   711,   712,   713,   715,   728,
+     729
+};
+#endif
+
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
+/* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
+   First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
+static const char *const yytname[] =
+{
+  "\"end of file\"", "error", "\"invalid token\"", "DST", "SRC", "HOST",
+  "GATEWAY", "NET", "NETMASK", "PORT", "PORTRANGE", "LESS", "GREATER",
+  "PROTO", "PROTOCHAIN", "CBYTE", "ARP", "RARP", "IP", "SCTP", "TCP",
+  "UDP", "ICMP", "IGMP", "IGRP", "PIM", "VRRP", "CARP", "ATALK", "AARP",
+  "DECNET", "LAT", "SCA", "MOPRC", "MOPDL", "TK_BROADCAST", "TK_MULTICAST",
+  "NUM", "INBOUND", "OUTBOUND", "SAMPLE", "HDRONLY", "PF_IFNAME",
+  "PF_RSET", "PF_RNR", "PF_SRNR", "PF_REASON", "PF_ACTION", "TYPE",
+  "SUBTYPE", "DIR", "ADDR1", "ADDR2", "ADDR3", "ADDR4", "RA", "TA", "LINK",
+  "GEQ", "LEQ", "NEQ", "ID", "EID", "HID", "HID6", "AID", "LSH", "RSH",
+  "LEN", "IPV6", "ICMPV6", "AH", "ESP", "VLAN", "MPLS", "PPPOED", "PPPOES",
+  "ISO", "ESIS", "CLNP", "ISIS", "L1", "L2", "IIH", "LSP", "SNP", "CSNP",
+  "PSNP", "STP", "IPX", "NETBEUI", "LANE", "LLC", "METAC", "BCC", "SC",
+  "ILMIC", "OAMF4EC", "OAMF4SC", "OAM", "OAMF4", "CONNECTMSG",
+  "METACONNECT", "VPI", "VCI", "RADIO", "FISU", "LSSU", "MSU", "HFISU",
+  "HLSSU", "HMSU", "SIO", "OPC", "DPC", "SLS", "HSIO", "HOPC", "HDPC",
+  "HSLS", "OR", "AND", "'!'", "'|'", "'&'", "'+'", "'-'", "'*'", "'/'",
+  "UMINUS", "')'", "'('", "'>'", "'='", "'<'", "'['", "']'", "':'",
+  "$accept", "prog", "hdronly", "rate", "null", "expr", "and", "or", "id",
+  "nid", "not", "paren", "pid", "qid", "term", "head", "rterm", "pqual",
+  "dqual", "aqual", "ndaqual", "pname", "other", "pfvar", "p80211", "type",
+  "subtype", "type_subtype", "dir", "reason", "action", "relop", "irelop",
+  "arth", "narth", "byteop", "pnum", "atmtype", "atmmultitype", "atmfield",
+  "atmvalue", "atmfieldvalue", "atmlistvalue", "mtp2type", "mtp3field",
+  "mtp3value", "mtp3fieldvalue", "mtp3listvalue", YY_NULLPTR
+};
+
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
+{
+  return yytname[yysymbol];
+}
+#endif
+
+#define YYPACT_NINF (-212)
+
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
+
+#define YYTABLE_NINF (-47)
+
+#define yytable_value_is_error(Yyn) \
+  0
+
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
+static const yytype_int16 yypact[] =
+{
+       8,  -212,   107,  -212,   220,  -212,   341,    25,    72,    77,
+    -212,  -212,  -212,  -212,  -212,  -212,  -212,  -212,  -212,  -212,
+    -212,  -212,  -212,  -212,  -212,  -212,  -212,  -212,  -212,  -212,
+    -212,  -212,   -10,    63,    68,    81,    86,    -6,    83,  -212,
+    -212,  -212,  -212,  -212,  -212,   -27,   -27,  -212,  -212,  -212,
+    -212,  -212,  -212,  -212,  -212,  -212,  -212,  -212,  -212,  -212,
+    -212,  -212,  -212,  -212,  -212,  -212,  -212,  -212,  -212,  -212,
+    -212,  -212,  -212,  -212,  -212,  -212,  -212,  -212,  -212,  -212,
+    -212,  -212,  -212,  -212,  -212,  -212,  -212,  -212,  -212,  -212,
+    -212,  -212,  -212,   691,  -212,   -52,   575,   575,  -212,   147,
+    -212,   779,    15,  -212,  -212,   674,  -212,  -212,  -212,  -212,
+     -12,  -212,    57,   -52,  -212,  -212,    62,  -212,  -212,   -11,
+    -212,  -212,  -212,  -212,  -212,  -212,  -212,  -212,  -212,   -27,
+    -212,  -212,   691,    11,  -212,  -212,  -212,   458,   458,  -212,
+     -92,    21,    22,  -212,  -212,  -212,     4,    10,  -212,  -212,
+    -212,   147,   147,  -212,   -35,   -31,  -212,  -212,  -212,  -212,
+    -212,  -212,  -212,  -212,  -212,    -2,   100,    -1,  -212,  -212,
+    -212,  -212,  -212,  -212,   192,  -212,  -212,  -212,   691,  -212,
+    -212,  -212,   691,   691,   691,   691,   691,   691,   691,   691,
+    -212,  -212,  -212,   691,   691,  -212,   125,   126,   129,  -212,
+    -212,  -212,   132,   138,   155,  -212,  -212,  -212,  -212,  -212,
+    -212,  -212,   156,  -212,  -212,    22,   -46,   -10,  -212,   458,
+     458,  -212,     7,  -212,  -212,  -212,  -212,  -212,   135,   163,
+     166,  -212,  -212,    74,   -52,    22,   201,   202,   204,   210,
+    -212,  -212,   165,  -212,  -212,  -212,  -212,  -212,  -212,   -53,
+      55,    55,    46,   101,     3,     3,  -212,  -212,   -46,   -46,
+    -212,   -63,  -212,  -212,  -212,   -54,  -212,  -212,  -212,   -87,
+    -212,  -212,  -212,  -212,   147,   147,  -212,  -212,  -212,  -212,
+       0,  -212,   180,  -212,   125,  -212,   132,  -212,  -212,  -212,
+    -212,  -212,    82,  -212,  -212,  -212
+};
+
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_uint8 yydefact[] =
+{
+       8,     6,     0,     8,    56,     1,    56,     0,     0,     0,
+      76,    77,    75,    78,    79,    80,    81,    82,    83,    84,
+      85,    86,    87,    88,    89,    90,    91,    93,    92,   177,
+     118,   119,     0,     0,     0,     0,     0,     0,     0,    74,
+     171,    94,    95,    96,    97,   124,   126,   127,   128,    98,
+      99,   108,   100,   101,   102,   103,   104,   105,   107,   106,
+     109,   110,   111,   179,   180,   181,   182,   185,   186,   183,
+     184,   187,   188,   189,   190,   191,   192,   112,   200,   201,
+     202,   203,   204,   205,   206,   207,   208,   209,   210,   211,
+     212,   213,    29,     0,    30,     2,    56,    56,     9,     0,
+      36,     0,    55,    49,   129,     0,   158,   157,    50,    51,
+       0,    53,     0,     4,   115,   116,     0,   120,     7,     0,
+     131,   132,   133,   134,   148,   149,   135,   150,   136,     0,
+     123,   125,     0,     0,   169,    15,    14,    56,    56,    37,
+       0,   158,   157,    20,    19,    26,    23,    25,    27,    44,
+      16,     0,     0,    17,    58,    57,    69,    73,    70,    71,
+      72,    41,    42,   113,   114,     0,     0,     0,    63,    64,
+      65,    66,    67,    68,    39,    40,    43,   130,     0,   152,
+     154,   156,     0,     0,     0,     0,     0,     0,     0,     0,
+     151,   153,   155,     0,     0,   197,     0,     0,     0,    52,
+     193,   218,     0,     0,     0,    54,   214,   173,   172,   175,
+     176,   174,     0,   122,   121,     0,     0,    20,    11,    56,
+      56,    10,   157,    13,    12,    45,   170,   178,     0,     0,
+       0,    28,    31,    35,     0,    34,     0,     0,     0,     0,
+     141,   142,   138,   145,   139,   146,   147,   140,    38,     0,
+     167,   168,   166,   165,   161,   162,   163,   164,    47,    48,
+     198,     0,   194,   195,   219,     0,   215,   216,   117,   157,
+      22,    21,    24,    18,     0,     0,    60,    62,    59,    61,
+       0,   159,     0,   196,     0,   217,     0,    32,    33,   143,
+     144,   137,     0,   199,   220,   160
+};
+
+/* YYPGOTO[NTERM-NUM].  */
+static const yytype_int16 yypgoto[] =
+{
+    -212,  -212,  -212,  -212,   216,    18,    27,  -211,   -98,  -133,
+       2,    -4,  -212,  -212,   -93,  -212,  -212,  -212,  -212,    49,
+    -212,     5,  -212,  -212,  -212,  -212,  -212,  -212,  -212,  -212,
+    -212,   -80,   -47,   -29,   -79,  -212,   -41,  -212,  -212,  -212,
+    -212,  -179,  -212,  -212,  -212,  -212,  -186,  -212
+};
+
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_int16 yydefgoto[] =
+{
+       0,     2,     3,   119,     4,   140,   137,   138,   231,   150,
+     151,   132,   233,   234,    98,    99,   100,   101,   174,   175,
+     176,   133,   103,   104,   177,   242,   291,   244,   247,   126,
+     128,   193,   194,   105,   106,   212,   107,   108,   109,   110,
+     199,   200,   261,   111,   112,   205,   206,   265
+};
+
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_int16 yytable[] =
+{
+      97,   149,    97,   139,   130,   131,    96,   -17,    96,   102,
+      29,   102,   228,   182,   183,   -46,   264,   260,   141,   232,
+     182,   183,    95,   275,   113,   195,   213,   117,   135,   136,
+     197,   124,   203,   -34,   -34,   240,   245,   289,   225,   218,
+     223,   129,   129,   227,   221,   224,   179,   180,   181,     1,
+     284,   118,   214,   141,   286,   125,   142,   135,   153,   241,
+     246,   290,   114,   198,   134,   204,   135,   283,   135,   136,
+     184,   185,   186,   187,   188,   189,   285,   184,   185,   186,
+     187,   188,   189,   281,   282,   236,   237,   232,   215,   238,
+     239,   142,    97,    97,   201,   152,   222,   222,    96,    96,
+     294,   102,   102,   216,    94,   293,   196,     5,   202,   115,
+     153,   235,   182,   183,   116,   179,   180,   181,   122,    94,
+     190,   191,   192,   123,   120,   129,   139,   -17,   -17,   121,
+     188,   189,   229,   220,   220,   -46,   -46,   -17,   230,   219,
+     219,   141,   102,   102,   127,   -46,   178,   152,   129,   249,
+     178,   226,   227,   250,   251,   252,   253,   254,   255,   256,
+     257,   243,   195,   262,   258,   259,   263,   182,   183,   201,
+     185,   186,   187,   188,   189,   266,   287,   288,   222,   269,
+     186,   187,   188,   189,    29,   207,   208,   143,    94,   190,
+     191,   192,   267,   268,   209,   210,   211,   156,   270,   158,
+     271,   159,   160,   272,   273,   276,   277,   278,   144,   145,
+     146,   147,   148,   279,   280,   220,    97,   292,   295,     6,
+      -3,   219,   219,   248,   102,   102,   186,   187,   188,   189,
+       0,     7,     8,   153,   153,     9,    10,    11,    12,    13,
+      14,    15,    16,    17,    18,    19,    20,    21,    22,    23,
+      24,    25,    26,    27,    28,     0,     0,    29,    30,    31,
+      32,   274,    33,    34,    35,    36,    37,    38,     0,    92,
+     152,   152,     0,     0,     0,     0,     0,    39,    94,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,    40,    41,
+      42,    43,    44,    45,    46,    47,    48,    49,    50,    51,
+      52,    53,    54,    55,    56,    57,    58,    59,    60,    61,
+      62,    63,    64,    65,    66,    67,    68,    69,    70,    71,
+      72,    73,    74,    75,    76,    77,    78,    79,    80,    81,
+      82,    83,    84,    85,    86,    87,    88,    89,    90,    91,
+       0,    -5,    92,     0,     0,     0,    93,     0,     0,     0,
+       0,    94,     7,     8,     0,     0,     9,    10,    11,    12,
+      13,    14,    15,    16,    17,    18,    19,    20,    21,    22,
+      23,    24,    25,    26,    27,    28,     0,     0,    29,    30,
+      31,    32,     0,    33,    34,    35,    36,    37,    38,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,    39,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,    40,
+      41,    42,    43,    44,    45,    46,    47,    48,    49,    50,
+      51,    52,    53,    54,    55,    56,    57,    58,    59,    60,
+      61,    62,    63,    64,    65,    66,    67,    68,    69,    70,
+      71,    72,    73,    74,    75,    76,    77,    78,    79,    80,
+      81,    82,    83,    84,    85,    86,    87,    88,    89,    90,
+      91,     0,     0,    92,     0,     0,     0,    93,     0,     7,
+       8,     0,    94,     9,    10,    11,    12,    13,    14,    15,
+      16,    17,    18,    19,    20,    21,    22,    23,    24,    25,
+      26,    27,    28,     0,     0,    29,    30,    31,   217,     0,
+      33,    34,    35,    36,    37,    38,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,    39,     0,     0,     0,   144,
+     145,   146,   147,   148,     0,     0,    40,    41,    42,    43,
+      44,    45,    46,    47,    48,    49,    50,    51,    52,    53,
+      54,    55,    56,    57,    58,    59,    60,    61,    62,    63,
+      64,    65,    66,    67,    68,    69,    70,    71,    72,    73,
+      74,    75,    76,    77,    78,    79,    80,    81,    82,    83,
+      84,    85,    86,    87,    88,    89,    90,    91,     0,     0,
+      92,     0,     0,     0,    93,     0,     7,     8,     0,    94,
+       9,    10,    11,    12,    13,    14,    15,    16,    17,    18,
+      19,    20,    21,    22,    23,    24,    25,    26,    27,    28,
+       0,     0,    29,    30,    31,    32,     0,    33,    34,    35,
+      36,    37,    38,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,    39,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,    40,    41,    42,    43,    44,    45,    46,
+      47,    48,    49,    50,    51,    52,    53,    54,    55,    56,
+      57,    58,    59,    60,    61,    62,    63,    64,    65,    66,
+      67,    68,    69,    70,    71,    72,    73,    74,    75,    76,
+      77,    78,    79,    80,    81,    82,    83,    84,    85,    86,
+      87,    88,    89,    90,    91,     0,     0,    92,     0,     0,
+       0,    93,     0,     0,     0,     0,    94,    10,    11,    12,
+      13,    14,    15,    16,    17,    18,    19,    20,    21,    22,
+      23,    24,    25,    26,    27,    28,     0,     0,    29,     0,
+       0,     0,   179,   180,   181,     0,     0,     0,     0,     0,
+     182,   183,     0,     0,     0,     0,     0,     0,    39,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,    40,
+      41,    42,    43,    44,     0,     0,     0,     0,    49,    50,
+      51,    52,    53,    54,    55,    56,    57,    58,    59,    60,
+      61,    62,   154,   155,   156,   157,   158,     0,   159,   160,
+       0,     0,   161,   162,     0,     0,    77,   184,   185,   186,
+     187,   188,   189,     0,     0,     0,   190,   191,   192,     0,
+       0,     0,     0,     0,   163,   164,     0,    93,     0,     0,
+       0,     0,    94,     0,     0,     0,     0,   165,   166,   167,
+     168,   169,   170,   171,   172,   173
+};
+
+static const yytype_int16 yycheck[] =
+{
+       4,    99,     6,    96,    45,    46,     4,     0,     6,     4,
+      37,     6,     8,    66,    67,     0,   202,   196,    97,   152,
+      66,    67,     4,   234,     6,    37,    37,    37,   120,   121,
+     110,    37,   112,   120,   121,    37,    37,    37,   130,   137,
+     138,    45,    46,   130,   137,   138,    58,    59,    60,    41,
+     261,    61,    63,   132,   265,    61,    97,   120,    99,    61,
+      61,    61,    37,   110,    93,   112,   120,   130,   120,   121,
+     123,   124,   125,   126,   127,   128,   130,   123,   124,   125,
+     126,   127,   128,   136,   137,   120,   121,   220,   129,   120,
+     121,   132,    96,    97,    37,    99,   137,   138,    96,    97,
+     286,    96,    97,   132,   131,   284,   110,     0,   112,    37,
+     151,   152,    66,    67,    37,    58,    59,    60,    37,   131,
+     132,   133,   134,    37,    61,   129,   219,   120,   121,    61,
+     127,   128,   128,   137,   138,   120,   121,   130,   128,   137,
+     138,   220,   137,   138,    61,   130,   135,   151,   152,   178,
+     135,   130,   130,   182,   183,   184,   185,   186,   187,   188,
+     189,    61,    37,    37,   193,   194,    37,    66,    67,    37,
+     124,   125,   126,   127,   128,    37,   274,   275,   219,   220,
+     125,   126,   127,   128,    37,   123,   124,    40,   131,   132,
+     133,   134,    37,    37,   132,   133,   134,     5,    63,     7,
+      37,     9,    10,    37,   130,     4,     4,     3,    61,    62,
+      63,    64,    65,     3,    49,   219,   220,    37,   136,     3,
+       0,   219,   220,   174,   219,   220,   125,   126,   127,   128,
+      -1,    11,    12,   274,   275,    15,    16,    17,    18,    19,
+      20,    21,    22,    23,    24,    25,    26,    27,    28,    29,
+      30,    31,    32,    33,    34,    -1,    -1,    37,    38,    39,
+      40,   234,    42,    43,    44,    45,    46,    47,    -1,   122,
+     274,   275,    -1,    -1,    -1,    -1,    -1,    57,   131,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    68,    69,
+      70,    71,    72,    73,    74,    75,    76,    77,    78,    79,
+      80,    81,    82,    83,    84,    85,    86,    87,    88,    89,
+      90,    91,    92,    93,    94,    95,    96,    97,    98,    99,
+     100,   101,   102,   103,   104,   105,   106,   107,   108,   109,
+     110,   111,   112,   113,   114,   115,   116,   117,   118,   119,
+      -1,     0,   122,    -1,    -1,    -1,   126,    -1,    -1,    -1,
+      -1,   131,    11,    12,    -1,    -1,    15,    16,    17,    18,
+      19,    20,    21,    22,    23,    24,    25,    26,    27,    28,
+      29,    30,    31,    32,    33,    34,    -1,    -1,    37,    38,
+      39,    40,    -1,    42,    43,    44,    45,    46,    47,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    57,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    68,
+      69,    70,    71,    72,    73,    74,    75,    76,    77,    78,
+      79,    80,    81,    82,    83,    84,    85,    86,    87,    88,
+      89,    90,    91,    92,    93,    94,    95,    96,    97,    98,
+      99,   100,   101,   102,   103,   104,   105,   106,   107,   108,
+     109,   110,   111,   112,   113,   114,   115,   116,   117,   118,
+     119,    -1,    -1,   122,    -1,    -1,    -1,   126,    -1,    11,
+      12,    -1,   131,    15,    16,    17,    18,    19,    20,    21,
+      22,    23,    24,    25,    26,    27,    28,    29,    30,    31,
+      32,    33,    34,    -1,    -1,    37,    38,    39,    40,    -1,
+      42,    43,    44,    45,    46,    47,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    57,    -1,    -1,    -1,    61,
+      62,    63,    64,    65,    -1,    -1,    68,    69,    70,    71,
+      72,    73,    74,    75,    76,    77,    78,    79,    80,    81,
+      82,    83,    84,    85,    86,    87,    88,    89,    90,    91,
+      92,    93,    94,    95,    96,    97,    98,    99,   100,   101,
+     102,   103,   104,   105,   106,   107,   108,   109,   110,   111,
+     112,   113,   114,   115,   116,   117,   118,   119,    -1,    -1,
+     122,    -1,    -1,    -1,   126,    -1,    11,    12,    -1,   131,
+      15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
+      25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
+      -1,    -1,    37,    38,    39,    40,    -1,    42,    43,    44,
+      45,    46,    47,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    57,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    68,    69,    70,    71,    72,    73,    74,
+      75,    76,    77,    78,    79,    80,    81,    82,    83,    84,
+      85,    86,    87,    88,    89,    90,    91,    92,    93,    94,
+      95,    96,    97,    98,    99,   100,   101,   102,   103,   104,
+     105,   106,   107,   108,   109,   110,   111,   112,   113,   114,
+     115,   116,   117,   118,   119,    -1,    -1,   122,    -1,    -1,
+      -1,   126,    -1,    -1,    -1,    -1,   131,    16,    17,    18,
+      19,    20,    21,    22,    23,    24,    25,    26,    27,    28,
+      29,    30,    31,    32,    33,    34,    -1,    -1,    37,    -1,
+      -1,    -1,    58,    59,    60,    -1,    -1,    -1,    -1,    -1,
+      66,    67,    -1,    -1,    -1,    -1,    -1,    -1,    57,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    68,
+      69,    70,    71,    72,    -1,    -1,    -1,    -1,    77,    78,
+      79,    80,    81,    82,    83,    84,    85,    86,    87,    88,
+      89,    90,     3,     4,     5,     6,     7,    -1,     9,    10,
+      -1,    -1,    13,    14,    -1,    -1,   105,   123,   124,   125,
+     126,   127,   128,    -1,    -1,    -1,   132,   133,   134,    -1,
+      -1,    -1,    -1,    -1,    35,    36,    -1,   126,    -1,    -1,
+      -1,    -1,   131,    -1,    -1,    -1,    -1,    48,    49,    50,
+      51,    52,    53,    54,    55,    56
+};
+
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_uint8 yystos[] =
+{
+       0,    41,   139,   140,   142,     0,   142,    11,    12,    15,
+      16,    17,    18,    19,    20,    21,    22,    23,    24,    25,
+      26,    27,    28,    29,    30,    31,    32,    33,    34,    37,
+      38,    39,    40,    42,    43,    44,    45,    46,    47,    57,
+      68,    69,    70,    71,    72,    73,    74,    75,    76,    77,
+      78,    79,    80,    81,    82,    83,    84,    85,    86,    87,
+      88,    89,    90,    91,    92,    93,    94,    95,    96,    97,
+      98,    99,   100,   101,   102,   103,   104,   105,   106,   107,
+     108,   109,   110,   111,   112,   113,   114,   115,   116,   117,
+     118,   119,   122,   126,   131,   143,   148,   149,   152,   153,
+     154,   155,   159,   160,   161,   171,   172,   174,   175,   176,
+     177,   181,   182,   143,    37,    37,    37,    37,    61,   141,
+      61,    61,    37,    37,    37,    61,   167,    61,   168,   149,
+     174,   174,   149,   159,   171,   120,   121,   144,   145,   152,
+     143,   172,   174,    40,    61,    62,    63,    64,    65,   146,
+     147,   148,   149,   174,     3,     4,     5,     6,     7,     9,
+      10,    13,    14,    35,    36,    48,    49,    50,    51,    52,
+      53,    54,    55,    56,   156,   157,   158,   162,   135,    58,
+      59,    60,    66,    67,   123,   124,   125,   126,   127,   128,
+     132,   133,   134,   169,   170,    37,   149,   169,   170,   178,
+     179,    37,   149,   169,   170,   183,   184,   123,   124,   132,
+     133,   134,   173,    37,    63,   174,   171,    40,   146,   148,
+     149,   152,   174,   146,   152,   130,   130,   130,     8,   128,
+     128,   146,   147,   150,   151,   174,   120,   121,   120,   121,
+      37,    61,   163,    61,   165,    37,    61,   166,   157,   171,
+     171,   171,   171,   171,   171,   171,   171,   171,   171,   171,
+     179,   180,    37,    37,   184,   185,    37,    37,    37,   174,
+      63,    37,    37,   130,   144,   145,     4,     4,     3,     3,
+      49,   136,   137,   130,   145,   130,   145,   146,   146,    37,
+      61,   164,    37,   179,   184,   136
+};
+
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_uint8 yyr1[] =
+{
+       0,   138,   139,   139,   139,   139,   140,   141,   142,   143,
+     143,   143,   143,   143,   144,   145,   146,   146,   146,   147,
+     147,   147,   147,   147,   147,   147,   147,   147,   147,   148,
+     149,   150,   150,   150,   151,   151,   152,   152,   153,   153,
+     153,   153,   153,   153,   154,   154,   154,   154,   154,   154,
+     154,   154,   154,   154,   154,   155,   155,   156,   156,   156,
+     156,   156,   156,   156,   156,   156,   156,   156,   156,   157,
+     157,   157,   157,   158,   159,   159,   159,   159,   159,   159,
+     159,   159,   159,   159,   159,   159,   159,   159,   159,   159,
+     159,   159,   159,   159,   159,   159,   159,   159,   159,   159,
+     159,   159,   159,   159,   159,   159,   159,   159,   159,   159,
+     159,   159,   159,   160,   160,   160,   160,   160,   160,   160,
+     160,   160,   160,   160,   160,   160,   160,   160,   160,   160,
+     160,   161,   161,   161,   161,   161,   161,   162,   162,   162,
+     162,   163,   163,   164,   164,   165,   166,   166,   167,   167,
+     168,   169,   169,   169,   170,   170,   170,   171,   171,   172,
+     172,   172,   172,   172,   172,   172,   172,   172,   172,   172,
+     172,   172,   173,   173,   173,   173,   173,   174,   174,   175,
+     175,   175,   175,   175,   175,   175,   175,   176,   176,   176,
+     176,   177,   177,   178,   178,   178,   178,   179,   180,   180,
+     181,   181,   181,   181,   181,   181,   182,   182,   182,   182,
+     182,   182,   182,   182,   183,   183,   183,   183,   184,   185,
+     185
+};
+
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
+{
+       0,     2,     2,     1,     3,     2,     1,     1,     0,     1,
+       3,     3,     3,     3,     1,     1,     1,     1,     3,     1,
+       1,     3,     3,     1,     3,     1,     1,     1,     2,     1,
+       1,     1,     3,     3,     1,     1,     1,     2,     3,     2,
+       2,     2,     2,     2,     2,     3,     1,     3,     3,     1,
+       1,     1,     2,     1,     2,     1,     0,     1,     1,     3,
+       3,     3,     3,     1,     1,     1,     1,     1,     1,     1,
+       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
+       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
+       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
+       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
+       1,     1,     1,     2,     2,     2,     2,     4,     1,     1,
+       2,     3,     3,     2,     1,     2,     1,     1,     1,     1,
+       2,     2,     2,     2,     2,     2,     2,     4,     2,     2,
+       2,     1,     1,     1,     1,     1,     1,     1,     1,     1,
+       1,     1,     1,     1,     1,     1,     1,     1,     1,     4,
+       6,     3,     3,     3,     3,     3,     3,     3,     3,     2,
+       3,     1,     1,     1,     1,     1,     1,     1,     3,     1,
+       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
+       1,     1,     1,     1,     2,     2,     3,     1,     1,     3,
+       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
+       1,     1,     1,     1,     1,     2,     2,     3,     1,     1,
+       3
+};
+
+
+enum { YYENOMEM = -2 };
+
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
+
+
+#define YYRECOVERING()  (!!yyerrstatus)
+
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
+
+
+/* Enable debugging if requested.  */
+#if YYDEBUG
+
+# ifndef YYFPRINTF
+#  include <stdio.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYFPRINTF fprintf
+# endif
+
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
+static void
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
+{
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  if (!yyvaluep)
+    return;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
+
+static void
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
+{
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
+
+  yy_symbol_value_print (yyo, yykind, yyvaluep);
+  YYFPRINTF (yyo, ")");
+}
+
+/*------------------------------------------------------------------.
+| yy_stack_print -- Print the state stack from its BOTTOM up to its |
+| TOP (included).                                                   |
+`------------------------------------------------------------------*/
+
+static void
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
+{
+  YYFPRINTF (stderr, "Stack now");
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
+  YYFPRINTF (stderr, "\n");
+}
+
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
+
+
+/*------------------------------------------------.
+| Report that the YYRULE is going to be reduced.  |
+`------------------------------------------------*/
+
+static void
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule)
+{
+  int yylno = yyrline[yyrule];
+  int yynrhs = yyr2[yyrule];
+  int yyi;
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
+  /* The symbols being reduced.  */
+  for (yyi = 0; yyi < yynrhs; yyi++)
+    {
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)]);
+      YYFPRINTF (stderr, "\n");
+    }
+}
+
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, Rule); \
+} while (0)
+
+/* Nonzero means print parse trace.  It is left uninitialized so that
+   multiple parsers can coexist.  */
+int yydebug;
+#else /* !YYDEBUG */
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
+# define YY_STACK_PRINT(Bottom, Top)
+# define YY_REDUCE_PRINT(Rule)
+#endif /* !YYDEBUG */
+
+
+/* YYINITDEPTH -- initial size of the parser's stacks.  */
+#ifndef YYINITDEPTH
+# define YYINITDEPTH 200
+#endif
+
+/* YYMAXDEPTH -- maximum size the stacks can grow to (effective only
+   if the built-in stack extension method is used).
+
+   Do not make this value too large; the results are undefined if
+   YYSTACK_ALLOC_MAXIMUM < YYSTACK_BYTES (YYMAXDEPTH)
+   evaluated with infinite-precision integer arithmetic.  */
+
+#ifndef YYMAXDEPTH
+# define YYMAXDEPTH 10000
+#endif
+
+
+
+
+
+
+/*-----------------------------------------------.
+| Release the memory associated to this symbol.  |
+`-----------------------------------------------*/
+
+static void
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep)
+{
+  YY_USE (yyvaluep);
+  if (!yymsg)
+    yymsg = "Deleting";
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/* Lookahead token kind.  */
+int yychar;
+
+/* The semantic value of the lookahead symbol.  */
+YYSTYPE yylval;
+/* Number of syntax errors so far.  */
+int yynerrs;
+
+
+
+
+/*----------.
+| yyparse.  |
+`----------*/
+
+int
+yyparse (void)
+{
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
+
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
+
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
+
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
+
+  int yyn;
+  /* The return value of yyparse.  */
+  int yyresult;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
+  /* The variables used to return semantic value and location from the
+     action routines.  */
+  YYSTYPE yyval;
+
+
+
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
+
+  /* The number of symbols on the RHS of the reduced rule.
+     Keep to zero when no symbol should be popped.  */
+  int yylen = 0;
+
+  YYDPRINTF ((stderr, "Starting parse\n"));
+
+  yychar = YYEMPTY; /* Cause a token to be read.  */
+
+  goto yysetstate;
+
+
+/*------------------------------------------------------------.
+| yynewstate -- push a new state, which is found in yystate.  |
+`------------------------------------------------------------*/
+yynewstate:
+  /* In all cases, when you get here, the value and location stacks
+     have just been pushed.  So pushing a state here evens the stacks.  */
+  yyssp++;
+
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
+
+  if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
+    {
+      /* Get the current used size of the three stacks, in elements.  */
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
+
+# if defined yyoverflow
+      {
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
+      }
+# else /* defined YYSTACK_RELOCATE */
+      /* Extend the stack our own way.  */
+      if (YYMAXDEPTH <= yystacksize)
+        YYNOMEM;
+      yystacksize *= 2;
+      if (YYMAXDEPTH < yystacksize)
+        yystacksize = YYMAXDEPTH;
+
+      {
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+#  undef YYSTACK_RELOCATE
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
+      }
+# endif
+
+      yyssp = yyss + yysize - 1;
+      yyvsp = yyvs + yysize - 1;
+
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
+
+      if (yyss + yystacksize - 1 <= yyssp)
+        YYABORT;
+    }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
+
+
+  if (yystate == YYFINAL)
+    YYACCEPT;
+
+  goto yybackup;
+
+
+/*-----------.
+| yybackup.  |
+`-----------*/
+yybackup:
+  /* Do appropriate processing given the current state.  Read a
+     lookahead token if we need one and don't already have one.  */
+
+  /* First try to decide what to do without reference to lookahead token.  */
+  yyn = yypact[yystate];
+  if (yypact_value_is_default (yyn))
+    goto yydefault;
+
+  /* Not known => get a lookahead token if don't already have one.  */
+
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
+  if (yychar == YYEMPTY)
+    {
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex ();
+    }
+
+  if (yychar <= YYEOF)
+    {
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
+      YYDPRINTF ((stderr, "Now at end of input.\n"));
+    }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
+  else
+    {
+      yytoken = YYTRANSLATE (yychar);
+      YY_SYMBOL_PRINT ("Next token is", yytoken, &yylval, &yylloc);
+    }
+
+  /* If the proper action on seeing token YYTOKEN is to reduce or to
+     detect an error, take that action.  */
+  yyn += yytoken;
+  if (yyn < 0 || YYLAST < yyn || yycheck[yyn] != yytoken)
+    goto yydefault;
+  yyn = yytable[yyn];
+  if (yyn <= 0)
+    {
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
+      yyn = -yyn;
+      goto yyreduce;
+    }
+
+  /* Count tokens shifted since error; after three, turn off error
+     status.  */
+  if (yyerrstatus)
+    yyerrstatus--;
+
+  /* Shift the lookahead token.  */
+  YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
+  yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
+  goto yynewstate;
+
+
+/*-----------------------------------------------------------.
+| yydefault -- do the default action for the current state.  |
+`-----------------------------------------------------------*/
+yydefault:
+  yyn = yydefact[yystate];
+  if (yyn == 0)
+    goto yyerrlab;
+  goto yyreduce;
+
+
+/*-----------------------------.
+| yyreduce -- do a reduction.  |
+`-----------------------------*/
+yyreduce:
+  /* yyn is the number of a rule to reduce with.  */
+  yylen = yyr2[yyn];
+
+  /* If YYLEN is nonzero, implement the default value of the action:
+     '$$ = $1'.
+
+     Otherwise, the following line sets YYVAL to garbage.
+     This behavior is undocumented and Bison
+     users should not rely upon it.  Assigning to YYVAL
+     unconditionally makes the parser a bit smaller, and it avoids a
+     GCC warning that YYVAL may be used uninitialized.  */
+  yyval = yyvsp[1-yylen];
+
+
+  YY_REDUCE_PRINT (yyn);
+  switch (yyn)
+    {
+  case 2: /* prog: null expr  */
+#line 318 "grammar.y"
+{
+	finish_parse((yyvsp[0].blk).b);
+}
+#line 2139 "y.tab.c"
+    break;
+
+  case 4: /* prog: hdronly null expr  */
+#line 323 "grammar.y"
+{
+	finish_parse((yyvsp[0].blk).b);
+}
+#line 2147 "y.tab.c"
+    break;
+
+  case 5: /* prog: hdronly null  */
+#line 327 "grammar.y"
+{
+	finish_parse(NULL);
+}
+#line 2155 "y.tab.c"
+    break;
+
+  case 6: /* hdronly: HDRONLY  */
+#line 331 "grammar.y"
+                                { gen_headers_only(); }
+#line 2161 "y.tab.c"
+    break;
+
+  case 7: /* rate: ID  */
+#line 337 "grammar.y"
+                                { if (strcmp((yyvsp[0].s), "rate") != 0)
+					bpf_error("expected \"rate\" after \"sample\", not %s", (yyvsp[0].s)); }
+#line 2168 "y.tab.c"
+    break;
+
+  case 8: /* null: %empty  */
+#line 340 "grammar.y"
+                                { (yyval.blk).q = qerr; }
+#line 2174 "y.tab.c"
+    break;
+
+  case 10: /* expr: expr and term  */
+#line 343 "grammar.y"
+                                { gen_and((yyvsp[-2].blk).b, (yyvsp[0].blk).b); (yyval.blk) = (yyvsp[0].blk); }
+#line 2180 "y.tab.c"
+    break;
+
+  case 11: /* expr: expr and id  */
+#line 344 "grammar.y"
+                                { gen_and((yyvsp[-2].blk).b, (yyvsp[0].blk).b); (yyval.blk) = (yyvsp[0].blk); }
+#line 2186 "y.tab.c"
+    break;
+
+  case 12: /* expr: expr or term  */
+#line 345 "grammar.y"
+                                { gen_or((yyvsp[-2].blk).b, (yyvsp[0].blk).b); (yyval.blk) = (yyvsp[0].blk); }
+#line 2192 "y.tab.c"
+    break;
+
+  case 13: /* expr: expr or id  */
+#line 346 "grammar.y"
+                                { gen_or((yyvsp[-2].blk).b, (yyvsp[0].blk).b); (yyval.blk) = (yyvsp[0].blk); }
+#line 2198 "y.tab.c"
+    break;
+
+  case 14: /* and: AND  */
+#line 348 "grammar.y"
+                                { (yyval.blk) = (yyvsp[-1].blk); }
+#line 2204 "y.tab.c"
+    break;
+
+  case 15: /* or: OR  */
+#line 350 "grammar.y"
+                                { (yyval.blk) = (yyvsp[-1].blk); }
+#line 2210 "y.tab.c"
+    break;
+
+  case 17: /* id: pnum  */
+#line 353 "grammar.y"
+                                { (yyval.blk).b = gen_ncode(NULL, (bpf_u_int32)(yyvsp[0].i),
+						   (yyval.blk).q = (yyvsp[-1].blk).q); }
+#line 2217 "y.tab.c"
+    break;
+
+  case 18: /* id: paren pid ')'  */
+#line 355 "grammar.y"
+                                { (yyval.blk) = (yyvsp[-1].blk); }
+#line 2223 "y.tab.c"
+    break;
+
+  case 19: /* nid: ID  */
+#line 357 "grammar.y"
+                                { (yyval.blk).b = gen_scode((yyvsp[0].s), (yyval.blk).q = (yyvsp[-1].blk).q); }
+#line 2229 "y.tab.c"
+    break;
+
+  case 20: /* nid: SAMPLE  */
+#line 358 "grammar.y"
+                                { (yyval.blk).b = gen_scode("sample", (yyval.blk).q = (yyvsp[-1].blk).q); }
+#line 2235 "y.tab.c"
+    break;
+
+  case 21: /* nid: HID '/' NUM  */
+#line 359 "grammar.y"
+                                { (yyval.blk).b = gen_mcode((yyvsp[-2].s), NULL, (yyvsp[0].i),
+				    (yyval.blk).q = (yyvsp[-3].blk).q); }
+#line 2242 "y.tab.c"
+    break;
+
+  case 22: /* nid: HID NETMASK HID  */
+#line 361 "grammar.y"
+                                { (yyval.blk).b = gen_mcode((yyvsp[-2].s), (yyvsp[0].s), 0,
+				    (yyval.blk).q = (yyvsp[-3].blk).q); }
+#line 2249 "y.tab.c"
+    break;
+
+  case 23: /* nid: HID  */
+#line 363 "grammar.y"
+                                {
+				  /* Decide how to parse HID based on proto */
+				  (yyval.blk).q = (yyvsp[-1].blk).q;
+				  if ((yyval.blk).q.addr == Q_PORT)
+				  	bpf_error("'port' modifier applied to ip host");
+				  else if ((yyval.blk).q.addr == Q_PORTRANGE)
+				  	bpf_error("'portrange' modifier applied to ip host");
+				  else if ((yyval.blk).q.addr == Q_PROTO)
+				  	bpf_error("'proto' modifier applied to ip host");
+				  else if ((yyval.blk).q.addr == Q_PROTOCHAIN)
+				  	bpf_error("'protochain' modifier applied to ip host");
+				  (yyval.blk).b = gen_ncode((yyvsp[0].s), 0, (yyval.blk).q);
+				}
+#line 2267 "y.tab.c"
+    break;
+
+  case 24: /* nid: HID6 '/' NUM  */
+#line 376 "grammar.y"
+                                {
+#ifdef INET6
+				  (yyval.blk).b = gen_mcode6((yyvsp[-2].s), NULL, (yyvsp[0].i),
+				    (yyval.blk).q = (yyvsp[-3].blk).q);
+#else
+				  bpf_error("'ip6addr/prefixlen' not supported "
+					"in this configuration");
+#endif /*INET6*/
+				}
+#line 2281 "y.tab.c"
+    break;
+
+  case 25: /* nid: HID6  */
+#line 385 "grammar.y"
+                                {
+#ifdef INET6
+				  (yyval.blk).b = gen_mcode6((yyvsp[0].s), 0, 128,
+				    (yyval.blk).q = (yyvsp[-1].blk).q);
+#else
+				  bpf_error("'ip6addr' not supported "
+					"in this configuration");
+#endif /*INET6*/
+				}
+#line 2295 "y.tab.c"
+    break;
+
+  case 26: /* nid: EID  */
+#line 394 "grammar.y"
+                                { 
+				  (yyval.blk).b = gen_ecode((yyvsp[0].e), (yyval.blk).q = (yyvsp[-1].blk).q);
+				  /*
+				   * $1 was allocated by "pcap_ether_aton()",
+				   * so we must free it now that we're done
+				   * with it.
+				   */
+				  free((yyvsp[0].e));
+				}
+#line 2309 "y.tab.c"
+    break;
+
+  case 27: /* nid: AID  */
+#line 403 "grammar.y"
+                                {
+				  (yyval.blk).b = gen_acode((yyvsp[0].e), (yyval.blk).q = (yyvsp[-1].blk).q);
+				  /*
+				   * $1 was allocated by "pcap_ether_aton()",
+				   * so we must free it now that we're done
+				   * with it.
+				   */
+				  free((yyvsp[0].e));
+				}
+#line 2323 "y.tab.c"
+    break;
+
+  case 28: /* nid: not id  */
+#line 412 "grammar.y"
+                                { gen_not((yyvsp[0].blk).b); (yyval.blk) = (yyvsp[0].blk); }
+#line 2329 "y.tab.c"
+    break;
+
+  case 29: /* not: '!'  */
+#line 414 "grammar.y"
+                                { (yyval.blk) = (yyvsp[-1].blk); }
+#line 2335 "y.tab.c"
+    break;
+
+  case 30: /* paren: '('  */
+#line 416 "grammar.y"
+                                { (yyval.blk) = (yyvsp[-1].blk); }
+#line 2341 "y.tab.c"
+    break;
+
+  case 32: /* pid: qid and id  */
+#line 419 "grammar.y"
+                                { gen_and((yyvsp[-2].blk).b, (yyvsp[0].blk).b); (yyval.blk) = (yyvsp[0].blk); }
+#line 2347 "y.tab.c"
+    break;
+
+  case 33: /* pid: qid or id  */
+#line 420 "grammar.y"
+                                { gen_or((yyvsp[-2].blk).b, (yyvsp[0].blk).b); (yyval.blk) = (yyvsp[0].blk); }
+#line 2353 "y.tab.c"
+    break;
+
+  case 34: /* qid: pnum  */
+#line 422 "grammar.y"
+                                { (yyval.blk).b = gen_ncode(NULL, (bpf_u_int32)(yyvsp[0].i),
+						   (yyval.blk).q = (yyvsp[-1].blk).q); }
+#line 2360 "y.tab.c"
+    break;
+
+  case 37: /* term: not term  */
+#line 427 "grammar.y"
+                                { gen_not((yyvsp[0].blk).b); (yyval.blk) = (yyvsp[0].blk); }
+#line 2366 "y.tab.c"
+    break;
+
+  case 38: /* head: pqual dqual aqual  */
+#line 429 "grammar.y"
+                                { QSET((yyval.blk).q, (yyvsp[-2].i), (yyvsp[-1].i), (yyvsp[0].i)); }
+#line 2372 "y.tab.c"
+    break;
+
+  case 39: /* head: pqual dqual  */
+#line 430 "grammar.y"
+                                { QSET((yyval.blk).q, (yyvsp[-1].i), (yyvsp[0].i), Q_DEFAULT); }
+#line 2378 "y.tab.c"
+    break;
+
+  case 40: /* head: pqual aqual  */
+#line 431 "grammar.y"
+                                { QSET((yyval.blk).q, (yyvsp[-1].i), Q_DEFAULT, (yyvsp[0].i)); }
+#line 2384 "y.tab.c"
+    break;
+
+  case 41: /* head: pqual PROTO  */
+#line 432 "grammar.y"
+                                { QSET((yyval.blk).q, (yyvsp[-1].i), Q_DEFAULT, Q_PROTO); }
+#line 2390 "y.tab.c"
+    break;
+
+  case 42: /* head: pqual PROTOCHAIN  */
+#line 433 "grammar.y"
+                                { QSET((yyval.blk).q, (yyvsp[-1].i), Q_DEFAULT, Q_PROTOCHAIN); }
+#line 2396 "y.tab.c"
+    break;
+
+  case 43: /* head: pqual ndaqual  */
+#line 434 "grammar.y"
+                                { QSET((yyval.blk).q, (yyvsp[-1].i), Q_DEFAULT, (yyvsp[0].i)); }
+#line 2402 "y.tab.c"
+    break;
+
+  case 44: /* rterm: head id  */
+#line 436 "grammar.y"
+                                { (yyval.blk) = (yyvsp[0].blk); }
+#line 2408 "y.tab.c"
+    break;
+
+  case 45: /* rterm: paren expr ')'  */
+#line 437 "grammar.y"
+                                { (yyval.blk).b = (yyvsp[-1].blk).b; (yyval.blk).q = (yyvsp[-2].blk).q; }
+#line 2414 "y.tab.c"
+    break;
+
+  case 46: /* rterm: pname  */
+#line 438 "grammar.y"
+                                { (yyval.blk).b = gen_proto_abbrev((yyvsp[0].i)); (yyval.blk).q = qerr; }
+#line 2420 "y.tab.c"
+    break;
+
+  case 47: /* rterm: arth relop arth  */
+#line 439 "grammar.y"
+                                { (yyval.blk).b = gen_relation((yyvsp[-1].i), (yyvsp[-2].a), (yyvsp[0].a), 0);
+				  (yyval.blk).q = qerr; }
+#line 2427 "y.tab.c"
+    break;
+
+  case 48: /* rterm: arth irelop arth  */
+#line 441 "grammar.y"
+                                { (yyval.blk).b = gen_relation((yyvsp[-1].i), (yyvsp[-2].a), (yyvsp[0].a), 1);
+				  (yyval.blk).q = qerr; }
+#line 2434 "y.tab.c"
+    break;
+
+  case 49: /* rterm: other  */
+#line 443 "grammar.y"
+                                { (yyval.blk).b = (yyvsp[0].rblk); (yyval.blk).q = qerr; }
+#line 2440 "y.tab.c"
+    break;
+
+  case 50: /* rterm: atmtype  */
+#line 444 "grammar.y"
+                                { (yyval.blk).b = gen_atmtype_abbrev((yyvsp[0].i)); (yyval.blk).q = qerr; }
+#line 2446 "y.tab.c"
+    break;
+
+  case 51: /* rterm: atmmultitype  */
+#line 445 "grammar.y"
+                                { (yyval.blk).b = gen_atmmulti_abbrev((yyvsp[0].i)); (yyval.blk).q = qerr; }
+#line 2452 "y.tab.c"
+    break;
+
+  case 52: /* rterm: atmfield atmvalue  */
+#line 446 "grammar.y"
+                                { (yyval.blk).b = (yyvsp[0].blk).b; (yyval.blk).q = qerr; }
+#line 2458 "y.tab.c"
+    break;
+
+  case 53: /* rterm: mtp2type  */
+#line 447 "grammar.y"
+                                { (yyval.blk).b = gen_mtp2type_abbrev((yyvsp[0].i)); (yyval.blk).q = qerr; }
+#line 2464 "y.tab.c"
+    break;
+
+  case 54: /* rterm: mtp3field mtp3value  */
+#line 448 "grammar.y"
+                                { (yyval.blk).b = (yyvsp[0].blk).b; (yyval.blk).q = qerr; }
+#line 2470 "y.tab.c"
+    break;
+
+  case 56: /* pqual: %empty  */
+#line 452 "grammar.y"
+                                { (yyval.i) = Q_DEFAULT; }
+#line 2476 "y.tab.c"
+    break;
+
+  case 57: /* dqual: SRC  */
+#line 455 "grammar.y"
+                                { (yyval.i) = Q_SRC; }
+#line 2482 "y.tab.c"
+    break;
+
+  case 58: /* dqual: DST  */
+#line 456 "grammar.y"
+                                { (yyval.i) = Q_DST; }
+#line 2488 "y.tab.c"
+    break;
+
+  case 59: /* dqual: SRC OR DST  */
+#line 457 "grammar.y"
+                                { (yyval.i) = Q_OR; }
+#line 2494 "y.tab.c"
+    break;
+
+  case 60: /* dqual: DST OR SRC  */
+#line 458 "grammar.y"
+                                { (yyval.i) = Q_OR; }
+#line 2500 "y.tab.c"
+    break;
+
+  case 61: /* dqual: SRC AND DST  */
+#line 459 "grammar.y"
+                                { (yyval.i) = Q_AND; }
+#line 2506 "y.tab.c"
+    break;
+
+  case 62: /* dqual: DST AND SRC  */
+#line 460 "grammar.y"
+                                { (yyval.i) = Q_AND; }
+#line 2512 "y.tab.c"
+    break;
+
+  case 63: /* dqual: ADDR1  */
+#line 461 "grammar.y"
+                                { (yyval.i) = Q_ADDR1; }
+#line 2518 "y.tab.c"
+    break;
+
+  case 64: /* dqual: ADDR2  */
+#line 462 "grammar.y"
+                                { (yyval.i) = Q_ADDR2; }
+#line 2524 "y.tab.c"
+    break;
+
+  case 65: /* dqual: ADDR3  */
+#line 463 "grammar.y"
+                                { (yyval.i) = Q_ADDR3; }
+#line 2530 "y.tab.c"
+    break;
+
+  case 66: /* dqual: ADDR4  */
+#line 464 "grammar.y"
+                                { (yyval.i) = Q_ADDR4; }
+#line 2536 "y.tab.c"
+    break;
+
+  case 67: /* dqual: RA  */
+#line 465 "grammar.y"
+                                { (yyval.i) = Q_RA; }
+#line 2542 "y.tab.c"
+    break;
+
+  case 68: /* dqual: TA  */
+#line 466 "grammar.y"
+                                { (yyval.i) = Q_TA; }
+#line 2548 "y.tab.c"
+    break;
+
+  case 69: /* aqual: HOST  */
+#line 469 "grammar.y"
+                                { (yyval.i) = Q_HOST; }
+#line 2554 "y.tab.c"
+    break;
+
+  case 70: /* aqual: NET  */
+#line 470 "grammar.y"
+                                { (yyval.i) = Q_NET; }
+#line 2560 "y.tab.c"
+    break;
+
+  case 71: /* aqual: PORT  */
+#line 471 "grammar.y"
+                                { (yyval.i) = Q_PORT; }
+#line 2566 "y.tab.c"
+    break;
+
+  case 72: /* aqual: PORTRANGE  */
+#line 472 "grammar.y"
+                                { (yyval.i) = Q_PORTRANGE; }
+#line 2572 "y.tab.c"
+    break;
+
+  case 73: /* ndaqual: GATEWAY  */
+#line 475 "grammar.y"
+                                { (yyval.i) = Q_GATEWAY; }
+#line 2578 "y.tab.c"
+    break;
+
+  case 74: /* pname: LINK  */
+#line 477 "grammar.y"
+                                { (yyval.i) = Q_LINK; }
+#line 2584 "y.tab.c"
+    break;
+
+  case 75: /* pname: IP  */
+#line 478 "grammar.y"
+                                { (yyval.i) = Q_IP; }
+#line 2590 "y.tab.c"
+    break;
+
+  case 76: /* pname: ARP  */
+#line 479 "grammar.y"
+                                { (yyval.i) = Q_ARP; }
+#line 2596 "y.tab.c"
+    break;
+
+  case 77: /* pname: RARP  */
+#line 480 "grammar.y"
+                                { (yyval.i) = Q_RARP; }
+#line 2602 "y.tab.c"
+    break;
+
+  case 78: /* pname: SCTP  */
+#line 481 "grammar.y"
+                                { (yyval.i) = Q_SCTP; }
+#line 2608 "y.tab.c"
+    break;
+
+  case 79: /* pname: TCP  */
+#line 482 "grammar.y"
+                                { (yyval.i) = Q_TCP; }
+#line 2614 "y.tab.c"
+    break;
+
+  case 80: /* pname: UDP  */
+#line 483 "grammar.y"
+                                { (yyval.i) = Q_UDP; }
+#line 2620 "y.tab.c"
+    break;
+
+  case 81: /* pname: ICMP  */
+#line 484 "grammar.y"
+                                { (yyval.i) = Q_ICMP; }
+#line 2626 "y.tab.c"
+    break;
+
+  case 82: /* pname: IGMP  */
+#line 485 "grammar.y"
+                                { (yyval.i) = Q_IGMP; }
+#line 2632 "y.tab.c"
+    break;
+
+  case 83: /* pname: IGRP  */
+#line 486 "grammar.y"
+                                { (yyval.i) = Q_IGRP; }
+#line 2638 "y.tab.c"
+    break;
+
+  case 84: /* pname: PIM  */
+#line 487 "grammar.y"
+                                { (yyval.i) = Q_PIM; }
+#line 2644 "y.tab.c"
+    break;
+
+  case 85: /* pname: VRRP  */
+#line 488 "grammar.y"
+                                { (yyval.i) = Q_VRRP; }
+#line 2650 "y.tab.c"
+    break;
+
+  case 86: /* pname: CARP  */
+#line 489 "grammar.y"
+                                { (yyval.i) = Q_CARP; }
+#line 2656 "y.tab.c"
+    break;
+
+  case 87: /* pname: ATALK  */
+#line 490 "grammar.y"
+                                { (yyval.i) = Q_ATALK; }
+#line 2662 "y.tab.c"
+    break;
+
+  case 88: /* pname: AARP  */
+#line 491 "grammar.y"
+                                { (yyval.i) = Q_AARP; }
+#line 2668 "y.tab.c"
+    break;
+
+  case 89: /* pname: DECNET  */
+#line 492 "grammar.y"
+                                { (yyval.i) = Q_DECNET; }
+#line 2674 "y.tab.c"
+    break;
+
+  case 90: /* pname: LAT  */
+#line 493 "grammar.y"
+                                { (yyval.i) = Q_LAT; }
+#line 2680 "y.tab.c"
+    break;
+
+  case 91: /* pname: SCA  */
+#line 494 "grammar.y"
+                                { (yyval.i) = Q_SCA; }
+#line 2686 "y.tab.c"
+    break;
+
+  case 92: /* pname: MOPDL  */
+#line 495 "grammar.y"
+                                { (yyval.i) = Q_MOPDL; }
+#line 2692 "y.tab.c"
+    break;
+
+  case 93: /* pname: MOPRC  */
+#line 496 "grammar.y"
+                                { (yyval.i) = Q_MOPRC; }
+#line 2698 "y.tab.c"
+    break;
+
+  case 94: /* pname: IPV6  */
+#line 497 "grammar.y"
+                                { (yyval.i) = Q_IPV6; }
+#line 2704 "y.tab.c"
+    break;
+
+  case 95: /* pname: ICMPV6  */
+#line 498 "grammar.y"
+                                { (yyval.i) = Q_ICMPV6; }
+#line 2710 "y.tab.c"
+    break;
+
+  case 96: /* pname: AH  */
+#line 499 "grammar.y"
+                                { (yyval.i) = Q_AH; }
+#line 2716 "y.tab.c"
+    break;
+
+  case 97: /* pname: ESP  */
+#line 500 "grammar.y"
+                                { (yyval.i) = Q_ESP; }
+#line 2722 "y.tab.c"
+    break;
+
+  case 98: /* pname: ISO  */
+#line 501 "grammar.y"
+                                { (yyval.i) = Q_ISO; }
+#line 2728 "y.tab.c"
+    break;
+
+  case 99: /* pname: ESIS  */
+#line 502 "grammar.y"
+                                { (yyval.i) = Q_ESIS; }
+#line 2734 "y.tab.c"
+    break;
+
+  case 100: /* pname: ISIS  */
+#line 503 "grammar.y"
+                                { (yyval.i) = Q_ISIS; }
+#line 2740 "y.tab.c"
+    break;
+
+  case 101: /* pname: L1  */
+#line 504 "grammar.y"
+                                { (yyval.i) = Q_ISIS_L1; }
+#line 2746 "y.tab.c"
+    break;
+
+  case 102: /* pname: L2  */
+#line 505 "grammar.y"
+                                { (yyval.i) = Q_ISIS_L2; }
+#line 2752 "y.tab.c"
+    break;
+
+  case 103: /* pname: IIH  */
+#line 506 "grammar.y"
+                                { (yyval.i) = Q_ISIS_IIH; }
+#line 2758 "y.tab.c"
+    break;
+
+  case 104: /* pname: LSP  */
+#line 507 "grammar.y"
+                                { (yyval.i) = Q_ISIS_LSP; }
+#line 2764 "y.tab.c"
+    break;
+
+  case 105: /* pname: SNP  */
+#line 508 "grammar.y"
+                                { (yyval.i) = Q_ISIS_SNP; }
+#line 2770 "y.tab.c"
+    break;
+
+  case 106: /* pname: PSNP  */
+#line 509 "grammar.y"
+                                { (yyval.i) = Q_ISIS_PSNP; }
+#line 2776 "y.tab.c"
+    break;
+
+  case 107: /* pname: CSNP  */
+#line 510 "grammar.y"
+                                { (yyval.i) = Q_ISIS_CSNP; }
+#line 2782 "y.tab.c"
+    break;
+
+  case 108: /* pname: CLNP  */
+#line 511 "grammar.y"
+                                { (yyval.i) = Q_CLNP; }
+#line 2788 "y.tab.c"
+    break;
+
+  case 109: /* pname: STP  */
+#line 512 "grammar.y"
+                                { (yyval.i) = Q_STP; }
+#line 2794 "y.tab.c"
+    break;
+
+  case 110: /* pname: IPX  */
+#line 513 "grammar.y"
+                                { (yyval.i) = Q_IPX; }
+#line 2800 "y.tab.c"
+    break;
+
+  case 111: /* pname: NETBEUI  */
+#line 514 "grammar.y"
+                                { (yyval.i) = Q_NETBEUI; }
+#line 2806 "y.tab.c"
+    break;
+
+  case 112: /* pname: RADIO  */
+#line 515 "grammar.y"
+                                { (yyval.i) = Q_RADIO; }
+#line 2812 "y.tab.c"
+    break;
+
+  case 113: /* other: pqual TK_BROADCAST  */
+#line 517 "grammar.y"
+                                { (yyval.rblk) = gen_broadcast((yyvsp[-1].i)); }
+#line 2818 "y.tab.c"
+    break;
+
+  case 114: /* other: pqual TK_MULTICAST  */
+#line 518 "grammar.y"
+                                { (yyval.rblk) = gen_multicast((yyvsp[-1].i)); }
+#line 2824 "y.tab.c"
+    break;
+
+  case 115: /* other: LESS NUM  */
+#line 519 "grammar.y"
+                                { (yyval.rblk) = gen_less((yyvsp[0].i)); }
+#line 2830 "y.tab.c"
+    break;
+
+  case 116: /* other: GREATER NUM  */
+#line 520 "grammar.y"
+                                { (yyval.rblk) = gen_greater((yyvsp[0].i)); }
+#line 2836 "y.tab.c"
+    break;
+
+  case 117: /* other: CBYTE NUM byteop NUM  */
+#line 521 "grammar.y"
+                                { (yyval.rblk) = gen_byteop((yyvsp[-1].i), (yyvsp[-2].i), (yyvsp[0].i)); }
+#line 2842 "y.tab.c"
+    break;
+
+  case 118: /* other: INBOUND  */
+#line 522 "grammar.y"
+                                { (yyval.rblk) = gen_inbound(0); }
+#line 2848 "y.tab.c"
+    break;
+
+  case 119: /* other: OUTBOUND  */
+#line 523 "grammar.y"
+                                { (yyval.rblk) = gen_inbound(1); }
+#line 2854 "y.tab.c"
+    break;
+
+  case 120: /* other: SAMPLE NUM  */
+#line 524 "grammar.y"
+                                { (yyval.rblk) = gen_sample((yyvsp[0].i)); }
+#line 2860 "y.tab.c"
+    break;
+
+  case 121: /* other: SAMPLE rate HID  */
+#line 525 "grammar.y"
+                                { (yyval.rblk) = gen_sample_rate((yyvsp[0].s)); }
+#line 2866 "y.tab.c"
+    break;
+
+  case 122: /* other: SAMPLE rate NUM  */
+#line 526 "grammar.y"
+                                { (yyval.rblk) = gen_sample_rate_num((bpf_u_int32)(yyvsp[0].i)); }
+#line 2872 "y.tab.c"
+    break;
+
+  case 123: /* other: VLAN pnum  */
+#line 527 "grammar.y"
+                                { (yyval.rblk) = gen_vlan((yyvsp[0].i)); }
+#line 2878 "y.tab.c"
+    break;
+
+  case 124: /* other: VLAN  */
+#line 528 "grammar.y"
+                                { (yyval.rblk) = gen_vlan(-1); }
+#line 2884 "y.tab.c"
+    break;
+
+  case 125: /* other: MPLS pnum  */
+#line 529 "grammar.y"
+                                { (yyval.rblk) = gen_mpls((yyvsp[0].i)); }
+#line 2890 "y.tab.c"
+    break;
+
+  case 126: /* other: MPLS  */
+#line 530 "grammar.y"
+                                { (yyval.rblk) = gen_mpls(-1); }
+#line 2896 "y.tab.c"
+    break;
+
+  case 127: /* other: PPPOED  */
+#line 531 "grammar.y"
+                                { (yyval.rblk) = gen_pppoed(); }
+#line 2902 "y.tab.c"
+    break;
+
+  case 128: /* other: PPPOES  */
+#line 532 "grammar.y"
+                                { (yyval.rblk) = gen_pppoes(); }
+#line 2908 "y.tab.c"
+    break;
+
+  case 129: /* other: pfvar  */
+#line 533 "grammar.y"
+                                { (yyval.rblk) = (yyvsp[0].rblk); }
+#line 2914 "y.tab.c"
+    break;
+
+  case 130: /* other: pqual p80211  */
+#line 534 "grammar.y"
+                                { (yyval.rblk) = (yyvsp[0].rblk); }
+#line 2920 "y.tab.c"
+    break;
+
+  case 131: /* pfvar: PF_IFNAME ID  */
+#line 537 "grammar.y"
+                                { (yyval.rblk) = gen_pf_ifname((yyvsp[0].s)); }
+#line 2926 "y.tab.c"
+    break;
+
+  case 132: /* pfvar: PF_RSET ID  */
+#line 538 "grammar.y"
+                                { (yyval.rblk) = gen_pf_ruleset((yyvsp[0].s)); }
+#line 2932 "y.tab.c"
+    break;
+
+  case 133: /* pfvar: PF_RNR NUM  */
+#line 539 "grammar.y"
+                                { (yyval.rblk) = gen_pf_rnr((yyvsp[0].i)); }
+#line 2938 "y.tab.c"
+    break;
+
+  case 134: /* pfvar: PF_SRNR NUM  */
+#line 540 "grammar.y"
+                                { (yyval.rblk) = gen_pf_srnr((yyvsp[0].i)); }
+#line 2944 "y.tab.c"
+    break;
+
+  case 135: /* pfvar: PF_REASON reason  */
+#line 541 "grammar.y"
+                                { (yyval.rblk) = gen_pf_reason((yyvsp[0].i)); }
+#line 2950 "y.tab.c"
+    break;
+
+  case 136: /* pfvar: PF_ACTION action  */
+#line 542 "grammar.y"
+                                { (yyval.rblk) = gen_pf_action((yyvsp[0].i)); }
+#line 2956 "y.tab.c"
+    break;
+
+  case 137: /* p80211: TYPE type SUBTYPE subtype  */
+#line 546 "grammar.y"
+                                { (yyval.rblk) = gen_p80211_type((yyvsp[-2].i) | (yyvsp[0].i),
+					IEEE80211_FC0_TYPE_MASK |
+					IEEE80211_FC0_SUBTYPE_MASK);
+				}
+#line 2965 "y.tab.c"
+    break;
+
+  case 138: /* p80211: TYPE type  */
+#line 550 "grammar.y"
+                                { (yyval.rblk) = gen_p80211_type((yyvsp[0].i),
+					IEEE80211_FC0_TYPE_MASK);
+				}
+#line 2973 "y.tab.c"
+    break;
+
+  case 139: /* p80211: SUBTYPE type_subtype  */
+#line 553 "grammar.y"
+                                { (yyval.rblk) = gen_p80211_type((yyvsp[0].i),
+					IEEE80211_FC0_TYPE_MASK |
+					IEEE80211_FC0_SUBTYPE_MASK);
+				}
+#line 2982 "y.tab.c"
+    break;
+
+  case 140: /* p80211: DIR dir  */
+#line 557 "grammar.y"
+                                { (yyval.rblk) = gen_p80211_fcdir((yyvsp[0].i)); }
+#line 2988 "y.tab.c"
+    break;
+
+  case 142: /* type: ID  */
+#line 561 "grammar.y"
+                                { (yyval.i) = str2tok((yyvsp[0].s), ieee80211_types);
+				  if ((yyval.i) == -1)
+				  	bpf_error("unknown 802.11 type name");
+				}
+#line 2997 "y.tab.c"
+    break;
+
+  case 144: /* subtype: ID  */
+#line 568 "grammar.y"
+                                { const struct tok *types = NULL;
+				  int i;
+				  for (i = 0;; i++) {
+				  	if (ieee80211_type_subtypes[i].tok == NULL) {
+				  		/* Ran out of types */
+						bpf_error("unknown 802.11 type");
+						break;
+					}
+					if ((yyvsp[(-1) - (1)].i) == ieee80211_type_subtypes[i].type) {
+						types = ieee80211_type_subtypes[i].tok;
+						break;
+					}
+				  }
+
+				  (yyval.i) = str2tok((yyvsp[0].s), types);
+				  if ((yyval.i) == -1)
+					bpf_error("unknown 802.11 subtype name");
+				}
+#line 3020 "y.tab.c"
+    break;
+
+  case 145: /* type_subtype: ID  */
+#line 588 "grammar.y"
+                                { int i;
+				  for (i = 0;; i++) {
+				  	if (ieee80211_type_subtypes[i].tok == NULL) {
+				  		/* Ran out of types */
+						bpf_error("unknown 802.11 type name");
+						break;
+					}
+					(yyval.i) = str2tok((yyvsp[0].s), ieee80211_type_subtypes[i].tok);
+					if ((yyval.i) != -1) {
+						(yyval.i) |= ieee80211_type_subtypes[i].type;
+						break;
+					}
+				  }
+				}
+#line 3039 "y.tab.c"
+    break;
+
+  case 147: /* dir: ID  */
+#line 605 "grammar.y"
+                                { if (pcap_strcasecmp((yyvsp[0].s), "nods") == 0)
+					(yyval.i) = IEEE80211_FC1_DIR_NODS;
+				  else if (pcap_strcasecmp((yyvsp[0].s), "tods") == 0)
+					(yyval.i) = IEEE80211_FC1_DIR_TODS;
+				  else if (pcap_strcasecmp((yyvsp[0].s), "fromds") == 0)
+					(yyval.i) = IEEE80211_FC1_DIR_FROMDS;
+				  else if (pcap_strcasecmp((yyvsp[0].s), "dstods") == 0)
+					(yyval.i) = IEEE80211_FC1_DIR_DSTODS;
+				  else
+					bpf_error("unknown 802.11 direction");
+				}
+#line 3055 "y.tab.c"
+    break;
+
+  case 148: /* reason: NUM  */
+#line 618 "grammar.y"
+                                { (yyval.i) = (yyvsp[0].i); }
+#line 3061 "y.tab.c"
+    break;
+
+  case 149: /* reason: ID  */
+#line 619 "grammar.y"
+                                { (yyval.i) = pfreason_to_num((yyvsp[0].s)); }
+#line 3067 "y.tab.c"
+    break;
+
+  case 150: /* action: ID  */
+#line 622 "grammar.y"
+                                { (yyval.i) = pfaction_to_num((yyvsp[0].s)); }
+#line 3073 "y.tab.c"
+    break;
+
+  case 151: /* relop: '>'  */
+#line 625 "grammar.y"
+                                { (yyval.i) = BPF_JGT; }
+#line 3079 "y.tab.c"
+    break;
+
+  case 152: /* relop: GEQ  */
+#line 626 "grammar.y"
+                                { (yyval.i) = BPF_JGE; }
+#line 3085 "y.tab.c"
+    break;
+
+  case 153: /* relop: '='  */
+#line 627 "grammar.y"
+                                { (yyval.i) = BPF_JEQ; }
+#line 3091 "y.tab.c"
+    break;
+
+  case 154: /* irelop: LEQ  */
+#line 629 "grammar.y"
+                                { (yyval.i) = BPF_JGT; }
+#line 3097 "y.tab.c"
+    break;
+
+  case 155: /* irelop: '<'  */
+#line 630 "grammar.y"
+                                { (yyval.i) = BPF_JGE; }
+#line 3103 "y.tab.c"
+    break;
+
+  case 156: /* irelop: NEQ  */
+#line 631 "grammar.y"
+                                { (yyval.i) = BPF_JEQ; }
+#line 3109 "y.tab.c"
+    break;
+
+  case 157: /* arth: pnum  */
+#line 633 "grammar.y"
+                                { (yyval.a) = gen_loadi((yyvsp[0].i)); }
+#line 3115 "y.tab.c"
+    break;
+
+  case 159: /* narth: pname '[' arth ']'  */
+#line 636 "grammar.y"
+                                        { (yyval.a) = gen_load((yyvsp[-3].i), (yyvsp[-1].a), 1); }
+#line 3121 "y.tab.c"
+    break;
+
+  case 160: /* narth: pname '[' arth ':' NUM ']'  */
+#line 637 "grammar.y"
+                                        { (yyval.a) = gen_load((yyvsp[-5].i), (yyvsp[-3].a), (yyvsp[-1].i)); }
+#line 3127 "y.tab.c"
+    break;
+
+  case 161: /* narth: arth '+' arth  */
+#line 638 "grammar.y"
+                                        { (yyval.a) = gen_arth(BPF_ADD, (yyvsp[-2].a), (yyvsp[0].a)); }
+#line 3133 "y.tab.c"
+    break;
+
+  case 162: /* narth: arth '-' arth  */
+#line 639 "grammar.y"
+                                        { (yyval.a) = gen_arth(BPF_SUB, (yyvsp[-2].a), (yyvsp[0].a)); }
+#line 3139 "y.tab.c"
+    break;
+
+  case 163: /* narth: arth '*' arth  */
+#line 640 "grammar.y"
+                                        { (yyval.a) = gen_arth(BPF_MUL, (yyvsp[-2].a), (yyvsp[0].a)); }
+#line 3145 "y.tab.c"
+    break;
+
+  case 164: /* narth: arth '/' arth  */
+#line 641 "grammar.y"
+                                        { (yyval.a) = gen_arth(BPF_DIV, (yyvsp[-2].a), (yyvsp[0].a)); }
+#line 3151 "y.tab.c"
+    break;
+
+  case 165: /* narth: arth '&' arth  */
+#line 642 "grammar.y"
+                                        { (yyval.a) = gen_arth(BPF_AND, (yyvsp[-2].a), (yyvsp[0].a)); }
+#line 3157 "y.tab.c"
+    break;
+
+  case 166: /* narth: arth '|' arth  */
+#line 643 "grammar.y"
+                                        { (yyval.a) = gen_arth(BPF_OR, (yyvsp[-2].a), (yyvsp[0].a)); }
+#line 3163 "y.tab.c"
+    break;
+
+  case 167: /* narth: arth LSH arth  */
+#line 644 "grammar.y"
+                                        { (yyval.a) = gen_arth(BPF_LSH, (yyvsp[-2].a), (yyvsp[0].a)); }
+#line 3169 "y.tab.c"
+    break;
+
+  case 168: /* narth: arth RSH arth  */
+#line 645 "grammar.y"
+                                        { (yyval.a) = gen_arth(BPF_RSH, (yyvsp[-2].a), (yyvsp[0].a)); }
+#line 3175 "y.tab.c"
+    break;
+
+  case 169: /* narth: '-' arth  */
+#line 646 "grammar.y"
+                                        { (yyval.a) = gen_neg((yyvsp[0].a)); }
+#line 3181 "y.tab.c"
+    break;
+
+  case 170: /* narth: paren narth ')'  */
+#line 647 "grammar.y"
+                                        { (yyval.a) = (yyvsp[-1].a); }
+#line 3187 "y.tab.c"
+    break;
+
+  case 171: /* narth: LEN  */
+#line 648 "grammar.y"
+                                        { (yyval.a) = gen_loadlen(); }
+#line 3193 "y.tab.c"
+    break;
+
+  case 172: /* byteop: '&'  */
+#line 650 "grammar.y"
+                                { (yyval.i) = '&'; }
+#line 3199 "y.tab.c"
+    break;
+
+  case 173: /* byteop: '|'  */
+#line 651 "grammar.y"
+                                { (yyval.i) = '|'; }
+#line 3205 "y.tab.c"
+    break;
+
+  case 174: /* byteop: '<'  */
+#line 652 "grammar.y"
+                                { (yyval.i) = '<'; }
+#line 3211 "y.tab.c"
+    break;
+
+  case 175: /* byteop: '>'  */
+#line 653 "grammar.y"
+                                { (yyval.i) = '>'; }
+#line 3217 "y.tab.c"
+    break;
+
+  case 176: /* byteop: '='  */
+#line 654 "grammar.y"
+                                { (yyval.i) = '='; }
+#line 3223 "y.tab.c"
+    break;
+
+  case 178: /* pnum: paren pnum ')'  */
+#line 657 "grammar.y"
+                                { (yyval.i) = (yyvsp[-1].i); }
+#line 3229 "y.tab.c"
+    break;
+
+  case 179: /* atmtype: LANE  */
+#line 659 "grammar.y"
+                                { (yyval.i) = A_LANE; }
+#line 3235 "y.tab.c"
+    break;
+
+  case 180: /* atmtype: LLC  */
+#line 660 "grammar.y"
+                                { (yyval.i) = A_LLC; }
+#line 3241 "y.tab.c"
+    break;
+
+  case 181: /* atmtype: METAC  */
+#line 661 "grammar.y"
+                                { (yyval.i) = A_METAC;	}
+#line 3247 "y.tab.c"
+    break;
+
+  case 182: /* atmtype: BCC  */
+#line 662 "grammar.y"
+                                { (yyval.i) = A_BCC; }
+#line 3253 "y.tab.c"
+    break;
+
+  case 183: /* atmtype: OAMF4EC  */
+#line 663 "grammar.y"
+                                { (yyval.i) = A_OAMF4EC; }
+#line 3259 "y.tab.c"
+    break;
+
+  case 184: /* atmtype: OAMF4SC  */
+#line 664 "grammar.y"
+                                { (yyval.i) = A_OAMF4SC; }
+#line 3265 "y.tab.c"
+    break;
+
+  case 185: /* atmtype: SC  */
+#line 665 "grammar.y"
+                                { (yyval.i) = A_SC; }
+#line 3271 "y.tab.c"
+    break;
+
+  case 186: /* atmtype: ILMIC  */
+#line 666 "grammar.y"
+                                { (yyval.i) = A_ILMIC; }
+#line 3277 "y.tab.c"
+    break;
+
+  case 187: /* atmmultitype: OAM  */
+#line 668 "grammar.y"
+                                { (yyval.i) = A_OAM; }
+#line 3283 "y.tab.c"
+    break;
+
+  case 188: /* atmmultitype: OAMF4  */
+#line 669 "grammar.y"
+                                { (yyval.i) = A_OAMF4; }
+#line 3289 "y.tab.c"
+    break;
+
+  case 189: /* atmmultitype: CONNECTMSG  */
+#line 670 "grammar.y"
+                                { (yyval.i) = A_CONNECTMSG; }
+#line 3295 "y.tab.c"
+    break;
+
+  case 190: /* atmmultitype: METACONNECT  */
+#line 671 "grammar.y"
+                                { (yyval.i) = A_METACONNECT; }
+#line 3301 "y.tab.c"
+    break;
+
+  case 191: /* atmfield: VPI  */
+#line 674 "grammar.y"
+                                { (yyval.blk).atmfieldtype = A_VPI; }
+#line 3307 "y.tab.c"
+    break;
+
+  case 192: /* atmfield: VCI  */
+#line 675 "grammar.y"
+                                { (yyval.blk).atmfieldtype = A_VCI; }
+#line 3313 "y.tab.c"
+    break;
+
+  case 194: /* atmvalue: relop NUM  */
+#line 678 "grammar.y"
+                                { (yyval.blk).b = gen_atmfield_code((yyvsp[-2].blk).atmfieldtype, (bpf_int32)(yyvsp[0].i), (bpf_u_int32)(yyvsp[-1].i), 0); }
+#line 3319 "y.tab.c"
+    break;
+
+  case 195: /* atmvalue: irelop NUM  */
+#line 679 "grammar.y"
+                                { (yyval.blk).b = gen_atmfield_code((yyvsp[-2].blk).atmfieldtype, (bpf_int32)(yyvsp[0].i), (bpf_u_int32)(yyvsp[-1].i), 1); }
+#line 3325 "y.tab.c"
+    break;
+
+  case 196: /* atmvalue: paren atmlistvalue ')'  */
+#line 680 "grammar.y"
+                                 { (yyval.blk).b = (yyvsp[-1].blk).b; (yyval.blk).q = qerr; }
+#line 3331 "y.tab.c"
+    break;
+
+  case 197: /* atmfieldvalue: NUM  */
+#line 682 "grammar.y"
+                   {
+	(yyval.blk).atmfieldtype = (yyvsp[-1].blk).atmfieldtype;
+	if ((yyval.blk).atmfieldtype == A_VPI ||
+	    (yyval.blk).atmfieldtype == A_VCI)
+		(yyval.blk).b = gen_atmfield_code((yyval.blk).atmfieldtype, (bpf_int32) (yyvsp[0].i), BPF_JEQ, 0);
+	}
+#line 3342 "y.tab.c"
+    break;
+
+  case 199: /* atmlistvalue: atmlistvalue or atmfieldvalue  */
+#line 690 "grammar.y"
+                                        { gen_or((yyvsp[-2].blk).b, (yyvsp[0].blk).b); (yyval.blk) = (yyvsp[0].blk); }
+#line 3348 "y.tab.c"
+    break;
+
+  case 200: /* mtp2type: FISU  */
+#line 693 "grammar.y"
+                                { (yyval.i) = M_FISU; }
+#line 3354 "y.tab.c"
+    break;
+
+  case 201: /* mtp2type: LSSU  */
+#line 694 "grammar.y"
+                                { (yyval.i) = M_LSSU; }
+#line 3360 "y.tab.c"
+    break;
+
+  case 202: /* mtp2type: MSU  */
+#line 695 "grammar.y"
+                                { (yyval.i) = M_MSU; }
+#line 3366 "y.tab.c"
+    break;
+
+  case 203: /* mtp2type: HFISU  */
+#line 696 "grammar.y"
+                                { (yyval.i) = MH_FISU; }
+#line 3372 "y.tab.c"
+    break;
+
+  case 204: /* mtp2type: HLSSU  */
+#line 697 "grammar.y"
+                                { (yyval.i) = MH_LSSU; }
+#line 3378 "y.tab.c"
+    break;
+
+  case 205: /* mtp2type: HMSU  */
+#line 698 "grammar.y"
+                                { (yyval.i) = MH_MSU; }
+#line 3384 "y.tab.c"
+    break;
+
+  case 206: /* mtp3field: SIO  */
+#line 701 "grammar.y"
+                                { (yyval.blk).mtp3fieldtype = M_SIO; }
+#line 3390 "y.tab.c"
+    break;
+
+  case 207: /* mtp3field: OPC  */
+#line 702 "grammar.y"
+                                { (yyval.blk).mtp3fieldtype = M_OPC; }
+#line 3396 "y.tab.c"
+    break;
+
+  case 208: /* mtp3field: DPC  */
+#line 703 "grammar.y"
+                                { (yyval.blk).mtp3fieldtype = M_DPC; }
+#line 3402 "y.tab.c"
+    break;
+
+  case 209: /* mtp3field: SLS  */
+#line 704 "grammar.y"
+                                { (yyval.blk).mtp3fieldtype = M_SLS; }
+#line 3408 "y.tab.c"
+    break;
+
+  case 210: /* mtp3field: HSIO  */
+#line 705 "grammar.y"
+                                { (yyval.blk).mtp3fieldtype = MH_SIO; }
+#line 3414 "y.tab.c"
+    break;
+
+  case 211: /* mtp3field: HOPC  */
+#line 706 "grammar.y"
+                                { (yyval.blk).mtp3fieldtype = MH_OPC; }
+#line 3420 "y.tab.c"
+    break;
+
+  case 212: /* mtp3field: HDPC  */
+#line 707 "grammar.y"
+                                { (yyval.blk).mtp3fieldtype = MH_DPC; }
+#line 3426 "y.tab.c"
+    break;
+
+  case 213: /* mtp3field: HSLS  */
+#line 708 "grammar.y"
+                                { (yyval.blk).mtp3fieldtype = MH_SLS; }
+#line 3432 "y.tab.c"
+    break;
+
+  case 215: /* mtp3value: relop NUM  */
+#line 711 "grammar.y"
+                                { (yyval.blk).b = gen_mtp3field_code((yyvsp[-2].blk).mtp3fieldtype, (u_int)(yyvsp[0].i), (u_int)(yyvsp[-1].i), 0); }
+#line 3438 "y.tab.c"
+    break;
+
+  case 216: /* mtp3value: irelop NUM  */
+#line 712 "grammar.y"
+                                { (yyval.blk).b = gen_mtp3field_code((yyvsp[-2].blk).mtp3fieldtype, (u_int)(yyvsp[0].i), (u_int)(yyvsp[-1].i), 1); }
+#line 3444 "y.tab.c"
+    break;
+
+  case 217: /* mtp3value: paren mtp3listvalue ')'  */
+#line 713 "grammar.y"
+                                  { (yyval.blk).b = (yyvsp[-1].blk).b; (yyval.blk).q = qerr; }
+#line 3450 "y.tab.c"
+    break;
+
+  case 218: /* mtp3fieldvalue: NUM  */
+#line 715 "grammar.y"
+                    {
+	(yyval.blk).mtp3fieldtype = (yyvsp[-1].blk).mtp3fieldtype;
+	if ((yyval.blk).mtp3fieldtype == M_SIO ||
+	    (yyval.blk).mtp3fieldtype == M_OPC ||
+	    (yyval.blk).mtp3fieldtype == M_DPC ||
+	    (yyval.blk).mtp3fieldtype == M_SLS ||
+	    (yyval.blk).mtp3fieldtype == MH_SIO ||
+	    (yyval.blk).mtp3fieldtype == MH_OPC ||
+	    (yyval.blk).mtp3fieldtype == MH_DPC ||
+	    (yyval.blk).mtp3fieldtype == MH_SLS)
+		(yyval.blk).b = gen_mtp3field_code((yyval.blk).mtp3fieldtype, (u_int) (yyvsp[0].i), BPF_JEQ, 0);
+	}
+#line 3467 "y.tab.c"
+    break;
+
+  case 220: /* mtp3listvalue: mtp3listvalue or mtp3fieldvalue  */
+#line 729 "grammar.y"
+                                          { gen_or((yyvsp[-2].blk).b, (yyvsp[0].blk).b); (yyval.blk) = (yyvsp[0].blk); }
+#line 3473 "y.tab.c"
+    break;
+
+
+#line 3477 "y.tab.c"
+
+      default: break;
+    }
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
+
+  YYPOPSTACK (yylen);
+  yylen = 0;
+
+  *++yyvsp = yyval;
+
+  /* Now 'shift' the result of the reduction.  Determine what state
+     that goes to, based on the state we popped back to and the rule
+     number reduced by.  */
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
+
+  goto yynewstate;
+
+
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
+yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
+  /* If not already recovering from an error, report this error.  */
+  if (!yyerrstatus)
+    {
+      ++yynerrs;
+      yyerror (YY_("syntax error"));
+    }
+
+  if (yyerrstatus == 3)
+    {
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
+
+      if (yychar <= YYEOF)
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
+      else
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval);
+          yychar = YYEMPTY;
+        }
+    }
+
+  /* Else will try to reuse lookahead token after shifting the error
+     token.  */
+  goto yyerrlab1;
+
+
+/*---------------------------------------------------.
+| yyerrorlab -- error raised explicitly by YYERROR.  |
+`---------------------------------------------------*/
+yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
+
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYERROR.  */
+  YYPOPSTACK (yylen);
+  yylen = 0;
+  YY_STACK_PRINT (yyss, yyssp);
+  yystate = *yyssp;
+  goto yyerrlab1;
+
+
+/*-------------------------------------------------------------.
+| yyerrlab1 -- common code for both syntax error and YYERROR.  |
+`-------------------------------------------------------------*/
+yyerrlab1:
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
+
+  /* Pop stack until we find a state that shifts the error token.  */
+  for (;;)
+    {
+      yyn = yypact[yystate];
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
+
+      /* Pop the current state because it cannot handle the error token.  */
+      if (yyssp == yyss)
+        YYABORT;
+
+
+      yydestruct ("Error: popping",
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp);
+      YYPOPSTACK (1);
+      yystate = *yyssp;
+      YY_STACK_PRINT (yyss, yyssp);
+    }
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+
+  /* Shift the error token.  */
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
+
+  yystate = yyn;
+  goto yynewstate;
+
+
+/*-------------------------------------.
+| yyacceptlab -- YYACCEPT comes here.  |
+`-------------------------------------*/
+yyacceptlab:
+  yyresult = 0;
+  goto yyreturnlab;
+
+
+/*-----------------------------------.
+| yyabortlab -- YYABORT comes here.  |
+`-----------------------------------*/
+yyabortlab:
+  yyresult = 1;
+  goto yyreturnlab;
+
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
+yyexhaustedlab:
+  yyerror (YY_("memory exhausted"));
+  yyresult = 2;
+  goto yyreturnlab;
+
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != YYEMPTY)
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYABORT or YYACCEPT.  */
+  YYPOPSTACK (yylen);
+  YY_STACK_PRINT (yyss, yyssp);
+  while (yyssp != yyss)
+    {
+      yydestruct ("Cleanup: popping",
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp);
+      YYPOPSTACK (1);
+    }
+#ifndef yyoverflow
+  if (yyss != yyssa)
+    YYSTACK_FREE (yyss);
+#endif
+
+  return yyresult;
+}
+
+#line 731 "grammar.y"
+
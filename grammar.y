@@ -49,6 +49,7 @@ struct rtentry;
 #endif /* WIN32 */
 
 #include <stdio.h>
+#include <string.h>
 
 #include "pcap-int.h"
 
@@ -275,7 +276,7 @@ pfaction_to_num(const char *action)
 %token  ARP RARP IP SCTP TCP UDP ICMP IGMP IGRP PIM VRRP CARP
 %token  ATALK AARP DECNET LAT SCA MOPRC MOPDL
 %token  TK_BROADCAST TK_MULTICAST
-%token  NUM INBOUND OUTBOUND
+%token  NUM INBOUND OUTBOUND SAMPLE HDRONLY
 %token  PF_IFNAME PF_RSET PF_RNR PF_SRNR PF_REASON PF_ACTION
 %token	TYPE SUBTYPE DIR ADDR1 ADDR2 ADDR3 ADDR4 RA TA
 %token  LINK
@@ -318,6 +319,23 @@ prog:	  null expr
 	finish_parse($2.b);
 }
 	| null
+	| hdronly null expr
+{
+	finish_parse($3.b);
+}
+	| hdronly null
+{
+	finish_parse(NULL);
+}
+	;
+hdronly:  HDRONLY		{ gen_headers_only(); }
+	;
+/*
+ * "rate" in "sample rate R" isn't a keyword, so that it can still be
+ * used as a host name.
+ */
+rate:	  ID			{ if (strcmp($1, "rate") != 0)
+					bpf_error("expected \"rate\" after \"sample\", not %s", $1); }
 	;
 null:	  /* null */		{ $$.q = qerr; }
 	;
@@ -337,6 +355,7 @@ id:	  nid
 	| paren pid ')'		{ $$ = $2; }
 	;
 nid:	  ID			{ $$.b = gen_scode($1, $$.q = $<blk>0.q); }
+	| SAMPLE		{ $$.b = gen_scode("sample", $$.q = $<blk>0.q); }
 	| HID '/' NUM		{ $$.b = gen_mcode($1, NULL, $3,
 				    $$.q = $<blk>0.q); }
 	| HID NETMASK HID	{ $$.b = gen_mcode($1, $3, 0,
@@ -502,6 +521,9 @@ other:	  pqual TK_BROADCAST	{ $$ = gen_broadcast($1); }
 	| CBYTE NUM byteop NUM	{ $$ = gen_byteop($3, $2, $4); }
 	| INBOUND		{ $$ = gen_inbound(0); }
 	| OUTBOUND		{ $$ = gen_inbound(1); }
+	| SAMPLE NUM		{ $$ = gen_sample($2); }
+	| SAMPLE rate HID	{ $$ = gen_sample_rate($3); }
+	| SAMPLE rate NUM	{ $$ = gen_sample_rate_num((bpf_u_int32)$3); }
 	| VLAN pnum		{ $$ = gen_vlan($2); }
 	| VLAN			{ $$ = gen_vlan(-1); }
 	| MPLS pnum		{ $$ = gen_mpls($2); }
@@ -126,14 +126,213 @@ get_instance(const char *name)
 	return (n);
 }
 
+/*
+ * Can we open this interface for live capture?
+ *
+ * We do this check so that interfaces that are supplied by the
+ * interface enumeration mechanism we're using but that don't support
+ * packet capture aren't included in the list.  Loopback interfaces
+ * on Solaris are an example of this; we don't just omit loopback
+ * interfaces on all platforms because you *can* capture on loopback
+ * interfaces on some OSes.
+ *
+ * On OS X, we don't do this check if the device name begins with
+ * "wlt"; at least some versions of OS X offer monitor mode capturing
+ * by having a separate "monitor mode" device for each wireless
+ * adapter, rather than by implementing the ioctls that
+ * {Free,Net,Open,DragonFly}BSD provide.  Opening that device puts
+ * the adapter into monitor mode, which, at least for some adapters,
+ * causes them to deassociate from the network with which they're
+ * associated.
+ *
+ * Instead, we try to open the corresponding "en" device (so that we
+ * don't end up with, for users without sufficient privilege to open
+ * capture devices, a list of adapters that only includes the wlt
+ * devices).
+ *
+ * Returns 1 if we can open it, 0 if we can't, and -1 on an error.
+ */
+int
+can_open_if(const char *name, char *errbuf)
+{
+	pcap_t *p;
+	char open_errbuf[PCAP_ERRBUF_SIZE];
+
+#ifdef __APPLE__
+	if (strncmp(name, "wlt", 3) == 0) {
+		char *en_name;
+		size_t en_name_len;
+
+		/*
+		 * Try to allocate a buffer for the "en"
+		 * device's name.
+		 */
+		en_name_len = strlen(name) - 1;
+		en_name = malloc(en_name_len + 1);
+		if (en_name == NULL) {
+			(void)snprintf(errbuf, PCAP_ERRBUF_SIZE,
+			    "malloc: %s", pcap_strerror(errno));
+			return (-1);
+		}
+		strcpy(en_name, "en");
+		strcat(en_name, name + 3);
+		p = pcap_open_live(en_name, 68, 0, 0, open_errbuf);
+		free(en_name);
+	} else
+#endif /* __APPLE */
+	p = pcap_open_live(name, 68, 0, 0, open_errbuf);
+	if (p == NULL)
+		return (0);
+	pcap_close(p);
+	return (1);
+}
+
+/*
+ * Allocate a new entry for an interface, with no addresses, and fill
+ * it in.  It's not added to any list.
+ */
+pcap_if_t *
+new_if(const char *name, u_int flags, const char *description, char *errbuf)
+{
+	pcap_if_t *curdev;
+
+	curdev = malloc(sizeof(pcap_if_t));
+	if (curdev == NULL) {
+		(void)snprintf(errbuf, PCAP_ERRBUF_SIZE,
+		    "malloc: %s", pcap_strerror(errno));
+		return (NULL);
+	}
+
+	/*
+	 * Fill in the entry.
+	 */
+	curdev->next = NULL;
+	curdev->name = strdup(name);
+	if (curdev->name == NULL) {
+		(void)snprintf(errbuf, PCAP_ERRBUF_SIZE,
+		    "malloc: %s", pcap_strerror(errno));
+		free(curdev);
+		return (NULL);
+	}
+	if (description != NULL) {
+		/*
+		 * We have a description for this interface.
+		 */
+		curdev->description = strdup(description);
+		if (curdev->description == NULL) {
+			(void)snprintf(errbuf, PCAP_ERRBUF_SIZE,
+			    "malloc: %s", pcap_strerror(errno));
+			free(curdev->name);
+			free(curdev);
+			return (NULL);
+		}
+	} else {
+		/*
+		 * We don't.
+		 */
+		curdev->description = NULL;
+	}
+	curdev->addresses = NULL;	/* list starts out as empty */
+	curdev->flags = 0;
+	if (ISLOOPBACK(name, flags))
+		curdev->flags |= PCAP_IF_LOOPBACK;
+	return (curdev);
+}
+
+/*
+ * Compare two interfaces for the purpose of ordering the list of
+ * interfaces: non-loopback interfaces are arbitrarily treated as
+ * having interface numbers less than those of loopback interfaces,
+ * so the loopback interfaces are put at the end of the list, and
+ * interfaces of the same kind are ordered by instance number.
+ */
+static int
+compare_ifs(pcap_if_t *dev1, pcap_if_t *dev2)
+{
+	int instance1, instance2;
+
+	if ((dev1->flags & PCAP_IF_LOOPBACK) !=
+	    (dev2->flags & PCAP_IF_LOOPBACK))
+		return ((dev1->flags & PCAP_IF_LOOPBACK) ? 1 : -1);
+	instance1 = get_instance(dev1->name);
+	instance2 = get_instance(dev2->name);
+	if (instance1 < instance2)
+		return (-1);
+	if (instance1 > instance2)
+		return (1);
+	return (0);
+}
+
+/*
+ * Merge two lists of interfaces, each in order; when interfaces
+ * compare equal, the ones from "list1" come first.
+ */
+static pcap_if_t *
+merge_iflists(pcap_if_t *list1, pcap_if_t *list2)
+{
+	pcap_if_t *head, **tailp;
+
+	tailp = &head;
+	while (list1 != NULL && list2 != NULL) {
+		if (compare_ifs(list1, list2) <= 0) {
+			*tailp = list1;
+			list1 = list1->next;
+		} else {
+			*tailp = list2;
+			list2 = list2->next;
+		}
+		tailp = &(*tailp)->next;
+	}
+	*tailp = (list1 != NULL) ? list1 : list2;
+	return (head);
+}
+
+/*
+ * Sort a list of interfaces; this is a merge sort, so interfaces that
+ * compare equal stay in the order in which they appear in the list.
+ */
+static pcap_if_t *
+sort_iflist(pcap_if_t *list)
+{
+	pcap_if_t *slow, *fast, *second;
+
+	if (list == NULL || list->next == NULL)
+		return (list);
+
+	/*
+	 * Split the list in half.
+	 */
+	slow = list;
+	for (fast = list->next; fast != NULL && fast->next != NULL;
+	    fast = fast->next->next)
+		slow = slow->next;
+	second = slow->next;
+	slow->next = NULL;
+
+	return (merge_iflists(sort_iflist(list), sort_iflist(second)));
+}
+
+/*
+ * Add a list of new entries, none of which have the same name as an
+ * entry already in the list of interfaces, to the list of interfaces.
+ *
+ * Each entry ends up where add_or_find_if() would have put it had the
+ * entries been added one at a time, in the order in which they appear
+ * in "devlist", but this takes O(n log n) time rather than O(n^2) time,
+ * which matters on machines with thousands of interfaces.
+ */
+void
+add_iflist_to_iflist(pcap_if_t **alldevs, pcap_if_t *devlist)
+{
+	*alldevs = merge_iflists(*alldevs, sort_iflist(devlist));
+}
+
 int
 add_or_find_if(pcap_if_t **curdev_ret, pcap_if_t **alldevs, const char *name,
     u_int flags, const char *description, char *errbuf)
 {
-	pcap_t *p;
 	pcap_if_t *curdev, *prevdev, *nextdev;
 	int this_instance;
-	char open_errbuf[PCAP_ERRBUF_SIZE];
 
 	/*
 	 * Is there already an entry in the list for this interface?
@@ -148,57 +347,13 @@ add_or_find_if(pcap_if_t **curdev_ret, pcap_if_t **alldevs, const char *name,
 		 * No, we didn't find it.
 		 *
 		 * Can we open this interface for live capture?
-		 *
-		 * We do this check so that interfaces that are
-		 * supplied by the interface enumeration mechanism
-		 * we're using but that don't support packet capture
-		 * aren't included in the list.  Loopback interfaces
-		 * on Solaris are an example of this; we don't just
-		 * omit loopback interfaces on all platforms because
-		 * you *can* capture on loopback interfaces on some
-		 * OSes.
-		 *
-		 * On OS X, we don't do this check if the device
-		 * name begins with "wlt"; at least some versions
-		 * of OS X offer monitor mode capturing by having
-		 * a separate "monitor mode" device for each wireless
-		 * adapter, rather than by implementing the ioctls
-		 * that {Free,Net,Open,DragonFly}BSD provide.
-		 * Opening that device puts the adapter into monitor
-		 * mode, which, at least for some adapters, causes
-		 * them to deassociate from the network with which
-		 * they're associated.
-		 *
-		 * Instead, we try to open the corresponding "en"
-		 * device (so that we don't end up with, for users
-		 * without sufficient privilege to open capture
-		 * devices, a list of adapters that only includes
-		 * the wlt devices).
 		 */
-#ifdef __APPLE__
-		if (strncmp(name, "wlt", 3) == 0) {
-			char *en_name;
-			size_t en_name_len;
+		switch (can_open_if(name, errbuf)) {
 
-			/*
-			 * Try to allocate a buffer for the "en"
-			 * device's name.
-			 */
-			en_name_len = strlen(name) - 1;
-			en_name = malloc(en_name_len + 1);
-			if (en_name == NULL) {
-				(void)snprintf(errbuf, PCAP_ERRBUF_SIZE,
-				    "malloc: %s", pcap_strerror(errno));
-				return (-1);
-			}
-			strcpy(en_name, "en");
-			strcat(en_name, name + 3);
-			p = pcap_open_live(en_name, 68, 0, 0, open_errbuf);
-			free(en_name);
-		} else
-#endif /* __APPLE */
-		p = pcap_open_live(name, 68, 0, 0, open_errbuf);
-		if (p == NULL) {
+		case -1:
+			return (-1);
+
+		case 0:
 			/*
 			 * No.  Don't bother including it.
 			 * Don't treat this as an error, though.
@@ -206,52 +361,14 @@ add_or_find_if(pcap_if_t **curdev_ret, pcap_if_t **alldevs, const char *name,
 			*curdev_ret = NULL;
 			return (0);
 		}
-		pcap_close(p);
 
 		/*
 		 * Yes, we can open it.
 		 * Allocate a new entry.
 		 */
-		curdev = malloc(sizeof(pcap_if_t));
-		if (curdev == NULL) {
-			(void)snprintf(errbuf, PCAP_ERRBUF_SIZE,
-			    "malloc: %s", pcap_strerror(errno));
-			return (-1);
-		}
-
-		/*
-		 * Fill in the entry.
-		 */
-		curdev->next = NULL;
-		curdev->name = strdup(name);
-		if (curdev->name == NULL) {
-			(void)snprintf(errbuf, PCAP_ERRBUF_SIZE,
-			    "malloc: %s", pcap_strerror(errno));
-			free(curdev);
+		curdev = new_if(name, flags, description, errbuf);
+		if (curdev == NULL)
 			return (-1);
-		}
-		if (description != NULL) {
-			/*
-			 * We have a description for this interface.
-			 */
-			curdev->description = strdup(description);
-			if (curdev->description == NULL) {
-				(void)snprintf(errbuf, PCAP_ERRBUF_SIZE,
-				    "malloc: %s", pcap_strerror(errno));
-				free(curdev->name);
-				free(curdev);
-				return (-1);
-			}
-		} else {
-			/*
-			 * We don't.
-			 */
-			curdev->description = NULL;
-		}
-		curdev->addresses = NULL;	/* list starts out as empty */
-		curdev->flags = 0;
-		if (ISLOOPBACK(name, flags))
-			curdev->flags |= PCAP_IF_LOOPBACK;
 
 		/*
 		 * Add it to the list, in the appropriate location.
@@ -413,7 +530,6 @@ add_addr_to_iflist(pcap_if_t **alldevs, const char *name, u_int flags,
 {
 	pcap_if_t *curdev;
 	char *description = NULL;
-	pcap_addr_t *curaddr, *prevaddr, *nextaddr;
 #ifdef SIOCGIFDESCR
 	int s;
 	struct ifreq ifrdesc;
@@ -504,10 +620,23 @@ add_addr_to_iflist(pcap_if_t **alldevs, const char *name, u_int flags,
 		return (0);
 	}
 
+	return (add_addr_to_if(curdev, addr, addr_size, netmask, netmask_size,
+	    broadaddr, broadaddr_size, dstaddr, dstaddr_size, errbuf));
+}
+
+/*
+ * Add an entry for an address to the end of the list of addresses
+ * of an interface.
+ */
+int
+add_addr_to_if(pcap_if_t *curdev, struct sockaddr *addr, size_t addr_size,
+    struct sockaddr *netmask, size_t netmask_size,
+    struct sockaddr *broadaddr, size_t broadaddr_size,
+    struct sockaddr *dstaddr, size_t dstaddr_size, char *errbuf)
+{
+	pcap_addr_t *curaddr, *prevaddr, *nextaddr;
+
 	/*
-	 * "curdev" is an entry for this interface; add an entry for this
-	 * address to its list of addresses.
-	 *
 	 * Allocate the new entry and fill it in.
 	 */
 	curaddr = malloc(sizeof(pcap_addr_t));
@@ -125,65 +125,238 @@ static int n_edges;
 struct edge **edges;
 
 /*
- * A bit vector set representation of the dominators.
- * We round up the set size to the next power of two.
+ * Hash table of blocks, the chains of blocks in each bucket, and
+ * the block that replaces each block, used by intern_blocks().
  */
-static int nodewords;
-static int edgewords;
+static struct block **intern_hash;
+static u_int intern_hashsize;
+static struct block **intern_next;
+static struct block **intern_rep;
+
 struct block **levels;
-bpf_u_int32 *space;
-#define BITS_PER_WORD (8*sizeof(bpf_u_int32))
+
 /*
- * True if a is in uset {p}
+ * A tree representation of the dominators.
+ *
+ * Rather than a bit vector per node giving the set of nodes that
+ * dominate it, which takes space quadratic in the number of nodes,
+ * we keep the immediate dominator of each node, which gives a tree
+ * in which the dominators of a node are its ancestors.  So that we
+ * can find the nearest common ancestor of two nodes in logarithmic
+ * time while building the tree, each node also has pointers to its
+ * 2nd, 4th, 8th, ... ancestors.  Once the tree is built, we number
+ * the nodes in preorder, so that the descendants of a node are the
+ * nodes numbered from it to the last node in its subtree, and we can
+ * tell whether one node is an ancestor of another in constant time.
+ *
+ * The same representation is used for the dominators of blocks and
+ * for the dominators of edges.
  */
-#define SET_MEMBER(p, a) \
-((p)[(unsigned)(a) / BITS_PER_WORD] & (1 << ((unsigned)(a) % BITS_PER_WORD)))
+struct domtree {
+	int n;		/* number of nodes */
+	int nlog;	/* number of ancestor pointers per node */
+	int *depth;	/* depth of each node, or -1 if it's not in the tree */
+	int *up;	/* up[k * n + i] is the 2^k'th ancestor of node i */
+	int *idom;	/* nearest common dominator of the predecessors seen */
+	int *child;	/* first child of each node */
+	int *sibling;	/* next sibling of each node */
+	int *pre;	/* preorder number of each node */
+	int *last;	/* preorder number of the last node in its subtree */
+};
+#define DT_UP(t, k, i)	((t)->up[(k) * (t)->n + (i)])
+
+/*
+ * "idom" value for a node none of whose predecessors we've seen.
+ */
+#define DT_NONE	(-2)
+
+static struct domtree dom_tree;		/* dominators of blocks */
+static struct domtree edom_tree;	/* dominators of edges */
+
+static void
+dt_alloc(struct domtree *t, int n)
+{
+	t->n = n;
+	for (t->nlog = 1; (1 << t->nlog) < n; t->nlog++)
+		;
+	t->depth = (int *)malloc(n * sizeof(*t->depth));
+	t->up = (int *)malloc(n * t->nlog * sizeof(*t->up));
+	t->idom = (int *)malloc(n * sizeof(*t->idom));
+	t->child = (int *)malloc(n * sizeof(*t->child));
+	t->sibling = (int *)malloc(n * sizeof(*t->sibling));
+	t->pre = (int *)malloc(n * sizeof(*t->pre));
+	t->last = (int *)malloc(n * sizeof(*t->last));
+	if (t->depth == NULL || t->up == NULL || t->idom == NULL ||
+	    t->child == NULL || t->sibling == NULL || t->pre == NULL ||
+	    t->last == NULL)
+		bpf_error("malloc");
+}
+
+static void
+dt_free(struct domtree *t)
+{
+	free((void *)t->depth);
+	free((void *)t->up);
+	free((void *)t->idom);
+	free((void *)t->child);
+	free((void *)t->sibling);
+	free((void *)t->pre);
+	free((void *)t->last);
+}
+
+static void
+dt_reset(struct domtree *t)
+{
+	int i;
+
+	for (i = 0; i < t->n; i++) {
+		t->depth[i] = -1;
+		t->idom[i] = DT_NONE;
+	}
+}
 
 /*
- * Add 'a' to uset p.
+ * Add node 'i' to the tree, as a child of its immediate dominator,
+ * which is already in the tree, or as a root if it has none.
  */
-#define SET_INSERT(p, a) \
-(p)[(unsigned)(a) / BITS_PER_WORD] |= (1 << ((unsigned)(a) % BITS_PER_WORD))
+static void
+dt_insert(struct domtree *t, int i)
+{
+	int k, parent;
+
+	parent = t->idom[i];
+	if (parent < 0) {
+		t->depth[i] = 0;
+		parent = -1;
+	} else
+		t->depth[i] = t->depth[parent] + 1;
+	DT_UP(t, 0, i) = parent;
+	for (k = 1; k < t->nlog; k++) {
+		if (parent != -1)
+			parent = DT_UP(t, k - 1, parent);
+		DT_UP(t, k, i) = parent;
+	}
+}
 
 /*
- * Delete 'a' from uset p.
+ * Return the ancestor of node 'i' at the given depth, which must be
+ * no greater than the depth of 'i'.
  */
-#define SET_DELETE(p, a) \
-(p)[(unsigned)(a) / BITS_PER_WORD] &= ~(1 << ((unsigned)(a) % BITS_PER_WORD))
+static int
+dt_ancestor(struct domtree *t, int i, int depth)
+{
+	int k, delta;
+
+	delta = t->depth[i] - depth;
+	for (k = 0; delta != 0; k++, delta >>= 1)
+		if (delta & 1)
+			i = DT_UP(t, k, i);
+	return i;
+}
 
 /*
- * a := a intersect b
+ * Return the nearest common ancestor of nodes 'i' and 'j', or -1 if
+ * they're in different trees.
  */
-#define SET_INTERSECT(a, b, n)\
-{\
-	register bpf_u_int32 *_x = a, *_y = b;\
-	register int _n = n;\
-	while (--_n >= 0) *_x++ &= *_y++;\
+static int
+dt_nca(struct domtree *t, int i, int j)
+{
+	int k;
+
+	if (t->depth[i] > t->depth[j])
+		i = dt_ancestor(t, i, t->depth[j]);
+	else if (t->depth[j] > t->depth[i])
+		j = dt_ancestor(t, j, t->depth[i]);
+	if (i == j)
+		return i;
+	for (k = t->nlog; --k >= 0; ) {
+		if (DT_UP(t, k, i) != DT_UP(t, k, j)) {
+			i = DT_UP(t, k, i);
+			j = DT_UP(t, k, j);
+		}
+	}
+	return DT_UP(t, 0, i);
 }
 
 /*
- * a := a - b
+ * Note that node 'pred', which is in the tree, is a predecessor of
+ * node 'i'; the immediate dominator of 'i' is the nearest common
+ * ancestor of all its predecessors.
  */
-#define SET_SUBTRACT(a, b, n)\
-{\
-	register bpf_u_int32 *_x = a, *_y = b;\
-	register int _n = n;\
-	while (--_n >= 0) *_x++ &=~ *_y++;\
+static inline void
+dt_add_pred(struct domtree *t, int i, int pred)
+{
+	if (t->idom[i] == DT_NONE)
+		t->idom[i] = pred;
+	else if (t->idom[i] != -1)
+		t->idom[i] = dt_nca(t, t->idom[i], pred);
 }
 
 /*
- * a := a union b
+ * Number the nodes of the tree, once all of them have been inserted,
+ * in preorder.
  */
-#define SET_UNION(a, b, n)\
-{\
-	register bpf_u_int32 *_x = a, *_y = b;\
-	register int _n = n;\
-	while (--_n >= 0) *_x++ |= *_y++;\
+static void
+dt_number(struct domtree *t)
+{
+	int i, r, roots, parent, n;
+
+	roots = -1;
+	for (i = 0; i < t->n; i++)
+		t->child[i] = -1;
+	for (i = t->n; --i >= 0; ) {
+		if (t->depth[i] < 0)
+			continue;
+		parent = DT_UP(t, 0, i);
+		if (parent == -1) {
+			t->sibling[i] = roots;
+			roots = i;
+		} else {
+			t->sibling[i] = t->child[parent];
+			t->child[parent] = i;
+		}
+	}
+	n = 0;
+	for (r = roots; r != -1; r = t->sibling[r]) {
+		i = r;
+		for (;;) {
+			t->pre[i] = n++;
+			if (t->child[i] != -1) {
+				i = t->child[i];
+				continue;
+			}
+			/*
+			 * Go back up to the nearest node with a sibling
+			 * we haven't visited, finishing the subtrees on
+			 * the way.
+			 */
+			for (;;) {
+				t->last[i] = n - 1;
+				if (i == r || t->sibling[i] != -1)
+					break;
+				i = DT_UP(t, 0, i);
+			}
+			if (i == r)
+				break;
+			i = t->sibling[i];
+		}
+	}
 }
 
-static uset all_dom_sets;
-static uset all_closure_sets;
-static uset all_edge_sets;
+/*
+ * True if node 'i' dominates node 'j'.  A node that wasn't reachable
+ * from the root when the dominators were found is treated as being
+ * dominated by every node.
+ */
+static inline int
+dt_dominates(struct domtree *t, int i, int j)
+{
+	if (t->depth[j] < 0)
+		return 1;
+	if (t->depth[i] < 0)
+		return 0;
+	return t->pre[i] <= t->pre[j] && t->pre[j] <= t->last[i];
+}
 
 #ifndef MAX
 #define MAX(a,b) ((a)>(b)?(a):(b))
@@ -228,44 +401,43 @@ find_levels(struct block *root)
 /*
  * Find dominator relationships.
  * Assumes graph has been leveled.
+ *
+ * The levels give a topological order of the graph, so all the
+ * predecessors of a block are in the tree by the time we get to it.
  */
 static void
 find_dom(struct block *root)
 {
 	int i;
 	struct block *b;
-	bpf_u_int32 *x;
 
-	/*
-	 * Initialize sets to contain all nodes.
-	 */
-	x = all_dom_sets;
-	i = n_blocks * nodewords;
-	while (--i >= 0)
-		*x++ = ~0;
-	/* Root starts off empty. */
-	for (i = nodewords; --i >= 0;)
-		root->dom[i] = 0;
+	dt_reset(&dom_tree);
 
 	/* root->level is the highest level no found. */
 	for (i = root->level; i >= 0; --i) {
 		for (b = levels[i]; b; b = b->link) {
-			SET_INSERT(b->dom, b->id);
+			dt_insert(&dom_tree, b->id);
 			if (JT(b) == 0)
 				continue;
-			SET_INTERSECT(JT(b)->dom, b->dom, nodewords);
-			SET_INTERSECT(JF(b)->dom, b->dom, nodewords);
+			dt_add_pred(&dom_tree, JT(b)->id, b->id);
+			dt_add_pred(&dom_tree, JF(b)->id, b->id);
 		}
 	}
+	dt_number(&dom_tree);
 }
 
+/*
+ * True if block 'a' dominates block 'b'.
+ */
+#define DOMINATES(a, b)	dt_dominates(&dom_tree, (a)->id, (b)->id)
+
 static void
 propedom(struct edge *ep)
 {
-	SET_INSERT(ep->edom, ep->id);
+	dt_insert(&edom_tree, ep->id);
 	if (ep->succ) {
-		SET_INTERSECT(ep->succ->et.edom, ep->edom, edgewords);
-		SET_INTERSECT(ep->succ->ef.edom, ep->edom, edgewords);
+		dt_add_pred(&edom_tree, ep->succ->et.id, ep->id);
+		dt_add_pred(&edom_tree, ep->succ->ef.id, ep->id);
 	}
 }
 
@@ -277,53 +449,20 @@ static void
 find_edom(struct block *root)
 {
 	int i;
-	uset x;
 	struct block *b;
 
-	x = all_edge_sets;
-	for (i = n_edges * edgewords; --i >= 0; )
-		x[i] = ~0;
+	dt_reset(&edom_tree);
 
 	/* root->level is the highest level no found. */
-	memset(root->et.edom, 0, edgewords * sizeof(*(uset)0));
-	memset(root->ef.edom, 0, edgewords * sizeof(*(uset)0));
+	edom_tree.idom[root->et.id] = -1;
+	edom_tree.idom[root->ef.id] = -1;
 	for (i = root->level; i >= 0; --i) {
 		for (b = levels[i]; b != 0; b = b->link) {
 			propedom(&b->et);
 			propedom(&b->ef);
 		}
 	}
-}
-
-/*
- * Find the backwards transitive closure of the flow graph.  These sets
- * are backwards in the sense that we find the set of nodes that reach
- * a given node, not the set of nodes that can be reached by a node.
- *
- * Assumes graph has been leveled.
- */
-static void
-find_closure(struct block *root)
-{
-	int i;
-	struct block *b;
-
-	/*
-	 * Initialize sets to contain no nodes.
-	 */
-	memset((char *)all_closure_sets, 0,
-	      n_blocks * nodewords * sizeof(*all_closure_sets));
-
-	/* root->level is the highest level no found. */
-	for (i = root->level; i >= 0; --i) {
-		for (b = levels[i]; b; b = b->link) {
-			SET_INSERT(b->closure, b->id);
-			if (JT(b) == 0)
-				continue;
-			SET_UNION(JT(b)->closure, b->closure, nodewords);
-			SET_UNION(JF(b)->closure, b->closure, nodewords);
-		}
-	}
+	dt_number(&edom_tree);
 }
 
 /*
@@ -445,9 +584,11 @@ compute_local_ud(struct block *b)
 			def |= ATOMMASK(atom);
 		}
 	}
-	if (BPF_CLASS(b->s.code) == BPF_JMP) {
+	if (BPF_CLASS(b->s.code) == BPF_JMP ||
+	    BPF_CLASS(b->s.code) == BPF_RET) {
 		/*
-		 * XXX - what about RET?
+		 * A return of the accumulator, as in "headers-only"
+		 * programs, uses A just as a branch on it does.
 		 */
 		atom = atomuse(&b->s);
 		if (atom >= 0) {
@@ -925,6 +1066,16 @@ opt_stmt(struct stmt *s, int val[], int alter)
 	case BPF_LD|BPF_ABS|BPF_W:
 	case BPF_LD|BPF_ABS|BPF_H:
 	case BPF_LD|BPF_ABS|BPF_B:
+		/*
+		 * Each load of a random number yields a different
+		 * value, so it must neither be eliminated nor let
+		 * two "sample" tests be folded into one.
+		 */
+		if (s->k == BPF_AD_RANDOM) {
+			v = ++curval;
+			vstore(s, &val[A_ATOM], v, alter);
+			break;
+		}
 		v = F(s->code, s->k, 0L);
 		vstore(s, &val[A_ATOM], v, alter);
 		break;
@@ -1222,7 +1373,8 @@ opt_blk(struct block *b, int do_stmts)
 	if (do_stmts &&
 	    ((b->out_use == 0 && aval != 0 && b->val[A_ATOM] == aval &&
 	      xval != 0 && b->val[X_ATOM] == xval) ||
-	     BPF_CLASS(b->s.code) == BPF_RET)) {
+	     (BPF_CLASS(b->s.code) == BPF_RET &&
+	      BPF_RVAL(b->s.code) != BPF_A))) {
 		if (b->stmts != 0) {
 			b->stmts = 0;
 			done = 0;
@@ -1315,11 +1467,149 @@ fold_edge(struct block *child, struct edge *ep)
 	return 0;
 }
 
+/*
+ * An index of the edges that opt_j() might move an edge past, so that
+ * it needn't try every one of the edge's dominators.
+ *
+ * fold_edge() can only move an edge past a dominator whose branch has
+ * the same code and tests the same accumulator value as the successor
+ * of the edge; either the operands are the same too, or the dominator
+ * is the true branch of an equality test with a constant.  So we have
+ * an entry for each edge keyed by its code, A value, and operand value,
+ * and one for each true branch of a "jeq #k" keyed by its A value, and
+ * sort the entries by key and then by the order of the edges in the
+ * edge dominator tree.  The dominators of an edge that have a given key
+ * are then a chain of entries starting near where the edge would be.
+ */
+struct jentry {
+	int kind;	/* JE_OPERANDS or JE_JEQ */
+	int code;
+	int aval;
+	int oval;
+	int pre;	/* preorder number of the edge */
+	int id;		/* the edge */
+	int up;		/* nearest entry with the same key that dominates it */
+};
+#define JE_OPERANDS	0
+#define JE_JEQ		1
+
+static struct jentry *jindex;
+static int n_jindex;
+
+static int
+jentry_cmp(const void *a, const void *b)
+{
+	const struct jentry *x = (const struct jentry *)a;
+	const struct jentry *y = (const struct jentry *)b;
+
+	if (x->kind != y->kind)
+		return x->kind < y->kind ? -1 : 1;
+	if (x->code != y->code)
+		return x->code < y->code ? -1 : 1;
+	if (x->aval != y->aval)
+		return x->aval < y->aval ? -1 : 1;
+	if (x->oval != y->oval)
+		return x->oval < y->oval ? -1 : 1;
+	if (x->pre != y->pre)
+		return x->pre < y->pre ? -1 : 1;
+	return 0;
+}
+
+static void
+add_jentry(int kind, struct edge *ep)
+{
+	struct jentry *je = &jindex[n_jindex++];
+
+	je->kind = kind;
+	je->code = ep->pred->s.code;
+	je->aval = ep->pred->val[A_ATOM];
+	je->oval = kind == JE_JEQ ? 0 : ep->pred->oval;
+	je->id = ep->id;
+	je->pre = edom_tree.pre[ep->id];
+}
+
+static void
+make_jindex(struct block *root)
+{
+	int i, top;
+	struct block *b;
+	struct jentry *je;
+
+	n_jindex = 0;
+	for (i = root->level; i > 0; --i) {
+		for (b = levels[i]; b; b = b->link) {
+			add_jentry(JE_OPERANDS, &b->et);
+			add_jentry(JE_OPERANDS, &b->ef);
+			if (b->s.code == (BPF_JMP|BPF_JEQ|BPF_K))
+				add_jentry(JE_JEQ, &b->et);
+		}
+	}
+	qsort((void *)jindex, n_jindex, sizeof(*jindex), jentry_cmp);
+
+	/*
+	 * The dominators of an entry that have the same key are the
+	 * entries on the chain of dominators of the entry before it,
+	 * if that has the same key, that dominate this one.
+	 */
+	top = -1;
+	for (i = 0; i < n_jindex; i++) {
+		je = &jindex[i];
+		if (i > 0 && (je->kind != je[-1].kind ||
+		    je->code != je[-1].code || je->aval != je[-1].aval ||
+		    je->oval != je[-1].oval))
+			top = -1;
+		while (top != -1 &&
+		    !dt_dominates(&edom_tree, jindex[top].id, je->id))
+			top = jindex[top].up;
+		je->up = top;
+		top = i;
+	}
+}
+
+/*
+ * Return the nearest entry with the given key for an edge that
+ * dominates 'ep', or -1 if there isn't one.
+ */
+static int
+find_jentry(int kind, int code, int aval, int oval, struct edge *ep)
+{
+	struct jentry key;
+	int lo, hi, mid;
+
+	key.kind = kind;
+	key.code = code;
+	key.aval = aval;
+	key.oval = oval;
+	key.pre = edom_tree.pre[ep->id];
+
+	/*
+	 * Find the last entry that sorts no later than 'key'.
+	 */
+	lo = 0;
+	hi = n_jindex;
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (jentry_cmp(&jindex[mid], &key) <= 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	mid = lo - 1;
+	if (mid < 0 || jindex[mid].kind != kind || jindex[mid].code != code ||
+	    jindex[mid].aval != aval || jindex[mid].oval != oval)
+		return -1;
+	while (mid != -1 && !dt_dominates(&edom_tree, jindex[mid].id, ep->id))
+		mid = jindex[mid].up;
+	return mid;
+}
+
 static void
 opt_j(struct edge *ep)
 {
-	register int i, k;
-	register struct block *target;
+	register int k, j, best;
+	register struct block *target, *best_target;
+	struct block *child;
+	int kind;
 
 	if (JT(ep->succ) == 0)
 		return;
@@ -1338,35 +1628,47 @@ opt_j(struct edge *ep)
 	 * For each edge dominator that matches the successor of this
 	 * edge, promote the edge successor to the its grandchild.
 	 *
-	 * XXX We violate the set abstraction here in favor a reasonably
-	 * efficient loop.
+	 * We use the edge dominator with the lowest edge number that
+	 * we can move the edge past; the only ones we need to look at
+	 * are the ones in the index with the right keys.
 	 */
  top:
-	for (i = 0; i < edgewords; ++i) {
-		register bpf_u_int32 x = ep->edom[i];
-
-		while (x != 0) {
-			k = ffs(x) - 1;
-			x &=~ (1 << k);
-			k += i * BITS_PER_WORD;
-
-			target = fold_edge(ep->succ, edges[k]);
+	best = -1;
+	best_target = 0;
+	child = ep->succ;
+	for (kind = JE_OPERANDS; kind <= JE_JEQ; kind++) {
+		if (kind == JE_OPERANDS)
+			j = find_jentry(kind, child->s.code,
+			    child->val[A_ATOM], child->oval, ep);
+		else if (child->s.code == (BPF_JMP|BPF_JEQ|BPF_K))
+			j = find_jentry(kind, child->s.code,
+			    child->val[A_ATOM], 0, ep);
+		else
+			break;
+		for (; j != -1; j = jindex[j].up) {
+			k = jindex[j].id;
+			if (best != -1 && k > best)
+				continue;
+			target = fold_edge(child, edges[k]);
 			/*
 			 * Check that there is no data dependency between
 			 * nodes that will be violated if we move the edge.
 			 */
 			if (target != 0 && !use_conflict(ep->pred, target)) {
-				done = 0;
-				ep->succ = target;
-				if (JT(target) != 0)
-					/*
-					 * Start over unless we hit a leaf.
-					 */
-					goto top;
-				return;
+				best = k;
+				best_target = target;
 			}
 		}
 	}
+	if (best_target != 0) {
+		done = 0;
+		ep->succ = best_target;
+		if (JT(best_target) != 0)
+			/*
+			 * Start over unless we hit a leaf.
+			 */
+			goto top;
+	}
 }
 
 
@@ -1404,7 +1706,7 @@ or_pullup(struct block *b)
 		if (JT(*diffp) != JT(b))
 			return;
 
-		if (!SET_MEMBER((*diffp)->dom, b->id))
+		if (!DOMINATES(b, *diffp))
 			return;
 
 		if ((*diffp)->val[A_ATOM] != val)
@@ -1421,7 +1723,7 @@ or_pullup(struct block *b)
 		if (JT(*samep) != JT(b))
 			return;
 
-		if (!SET_MEMBER((*samep)->dom, b->id))
+		if (!DOMINATES(b, *samep))
 			return;
 
 		if ((*samep)->val[A_ATOM] == val)
@@ -1495,7 +1797,7 @@ and_pullup(struct block *b)
 		if (JF(*diffp) != JF(b))
 			return;
 
-		if (!SET_MEMBER((*diffp)->dom, b->id))
+		if (!DOMINATES(b, *diffp))
 			return;
 
 		if ((*diffp)->val[A_ATOM] != val)
@@ -1512,7 +1814,7 @@ and_pullup(struct block *b)
 		if (JF(*samep) != JF(b))
 			return;
 
-		if (!SET_MEMBER((*samep)->dom, b->id))
+		if (!DOMINATES(b, *samep))
 			return;
 
 		if ((*samep)->val[A_ATOM] == val)
@@ -1574,6 +1876,7 @@ opt_blks(struct block *root, int do_stmts)
 		 */
 		return;
 
+	make_jindex(root);
 	for (i = 1; i <= maxlevel; ++i) {
 		for (p = levels[i]; p; p = p->link) {
 			opt_j(&p->et);
@@ -1634,11 +1937,12 @@ opt_root(struct block **b)
 	(*b)->stmts = s;
 
 	/*
-	 * If the root node is a return, then there is no
-	 * point executing any statements (since the bpf machine
+	 * If the root node is a return of a constant, then there is
+	 * no point executing any statements (since the bpf machine
 	 * has no side effects).
 	 */
-	if (BPF_CLASS((*b)->s.code) == BPF_RET)
+	if (BPF_CLASS((*b)->s.code) == BPF_RET &&
+	    BPF_RVAL((*b)->s.code) != BPF_A)
 		(*b)->stmts = 0;
 }
 
@@ -1656,7 +1960,6 @@ opt_loop(struct block *root, int do_stmts)
 		done = 1;
 		find_levels(root);
 		find_dom(root);
-		find_closure(root);
 		find_ud(root);
 		find_edom(root);
 		opt_blks(root, do_stmts);
@@ -1699,29 +2002,6 @@ bpf_optimize(struct block **rootp)
 	opt_cleanup();
 }
 
-static void
-make_marks(struct block *p)
-{
-	if (!isMarked(p)) {
-		Mark(p);
-		if (BPF_CLASS(p->s.code) != BPF_RET) {
-			make_marks(JT(p));
-			make_marks(JF(p));
-		}
-	}
-}
-
-/*
- * Mark code array such that isMarked(i) is true
- * only for nodes that are alive.
- */
-static void
-mark_code(struct block *p)
-{
-	cur_mark += 1;
-	make_marks(p);
-}
-
 /*
  * True iff the two stmt lists load the same value from the packet into
  * the accumulator.
@@ -1756,47 +2036,86 @@ eq_blk(struct block *b0, struct block *b1)
 	return 0;
 }
 
+/*
+ * Hash the parts of a block that eq_blk() compares.
+ */
+static u_int
+hash_blk(struct block *b)
+{
+	struct slist *s;
+	u_int h;
+
+	h = (u_int)b->s.code * 31 + (u_int)b->s.k;
+	h = h * 31 + (u_int)(b->et.succ != 0 ? b->et.succ->id + 1 : 0);
+	h = h * 31 + (u_int)(b->ef.succ != 0 ? b->ef.succ->id + 1 : 0);
+	for (s = b->stmts; s != 0; s = s->next) {
+		if (s->s.code == NOP)
+			continue;
+		h = h * 31 + (u_int)s->s.code;
+		h = h * 31 + (u_int)s->s.k;
+	}
+	return h ^ (h >> 16);
+}
+
+/*
+ * Replace branches to each block that's reachable from the root with
+ * branches to the highest-numbered reachable block that's identical
+ * to it, until there are no identical blocks left.
+ *
+ * Two blocks can only be identical if their successors are, and
+ * blocks with the same successors are at the same level, so we can
+ * find all of them in one pass from the leaves up: by the time we get
+ * to a level, the blocks below it have been merged, and all we have
+ * to do is point the branches of the blocks at this level to the
+ * surviving blocks and then look for identical blocks at this level.
+ * We find those by hashing the blocks, rather than comparing each
+ * block with every other block.
+ */
 static void
 intern_blocks(struct block *root)
 {
-	struct block *p;
-	int i, j;
-	int done1; /* don't shadow global */
- top:
-	done1 = 1;
-	for (i = 0; i < n_blocks; ++i)
-		blocks[i]->link = 0;
+	struct block *p, *q, **qp;
+	int i;
+	u_int h;
 
-	mark_code(root);
+	find_levels(root);
+	memset((char *)intern_hash, 0, intern_hashsize * sizeof(*intern_hash));
 
-	for (i = n_blocks - 1; --i >= 0; ) {
-		if (!isMarked(blocks[i]))
-			continue;
-		for (j = i + 1; j < n_blocks; ++j) {
-			if (!isMarked(blocks[j]))
+	for (i = 0; i <= root->level; ++i) {
+		for (p = levels[i]; p; p = p->link) {
+			intern_rep[p->id] = p;
+			if (JT(p) == 0)
 				continue;
-			if (eq_blk(blocks[i], blocks[j])) {
-				blocks[i]->link = blocks[j]->link ?
-					blocks[j]->link : blocks[j];
-				break;
-			}
+			JT(p) = intern_rep[JT(p)->id];
+			JF(p) = intern_rep[JF(p)->id];
 		}
-	}
-	for (i = 0; i < n_blocks; ++i) {
-		p = blocks[i];
-		if (JT(p) == 0)
-			continue;
-		if (JT(p)->link) {
-			done1 = 0;
-			JT(p) = JT(p)->link;
+		/*
+		 * Put each block in the hash table unless there's an
+		 * identical one there already, in which case keep
+		 * whichever of the two has the higher number.
+		 */
+		for (p = levels[i]; p; p = p->link) {
+			h = hash_blk(p) & (intern_hashsize - 1);
+			for (qp = &intern_hash[h]; (q = *qp) != 0;
+			    qp = &intern_next[q->id])
+				if (eq_blk(p, q))
+					break;
+			if (q == 0) {
+				intern_next[p->id] = intern_hash[h];
+				intern_hash[h] = p;
+			} else if (p->id > q->id) {
+				intern_next[p->id] = intern_next[q->id];
+				*qp = p;
+			}
 		}
-		if (JF(p)->link) {
-			done1 = 0;
-			JF(p) = JF(p)->link;
+		for (p = levels[i]; p; p = p->link) {
+			h = hash_blk(p) & (intern_hashsize - 1);
+			for (q = intern_hash[h]; !eq_blk(p, q);
+			    q = intern_next[q->id])
+				;
+			intern_rep[p->id] = q;
 		}
 	}
-	if (!done1)
-		goto top;
 }
 
 static void
@@ -1805,7 +2124,12 @@ opt_cleanup(void)
 	free((void *)vnode_base);
 	free((void *)vmap);
 	free((void *)edges);
-	free((void *)space);
+	dt_free(&dom_tree);
+	dt_free(&edom_tree);
+	free((void *)jindex);
+	free((void *)intern_hash);
+	free((void *)intern_next);
+	free((void *)intern_rep);
 	free((void *)levels);
 	free((void *)blocks);
 }
@@ -1896,7 +2220,6 @@ count_stmts(struct block *p)
 static void
 opt_init(struct block *root)
 {
-	bpf_u_int32 *p;
 	int i, n, max_stmts;
 
 	/*
@@ -1924,33 +2247,18 @@ opt_init(struct block *root)
 	if (levels == NULL)
 		bpf_error("malloc");
 
-	edgewords = n_edges / (8 * sizeof(bpf_u_int32)) + 1;
-	nodewords = n_blocks / (8 * sizeof(bpf_u_int32)) + 1;
-
-	/* XXX */
-	space = (bpf_u_int32 *)malloc(2 * n_blocks * nodewords * sizeof(*space)
-				 + n_edges * edgewords * sizeof(*space));
-	if (space == NULL)
+	dt_alloc(&dom_tree, n_blocks);
+	dt_alloc(&edom_tree, n_edges);
+	/*
+	 * Each block has at most three entries in the index of edges
+	 * used by opt_j().
+	 */
+	jindex = (struct jentry *)malloc(3 * n_blocks * sizeof(*jindex));
+	if (jindex == NULL)
 		bpf_error("malloc");
-	p = space;
-	all_dom_sets = p;
-	for (i = 0; i < n; ++i) {
-		blocks[i]->dom = p;
-		p += nodewords;
-	}
-	all_closure_sets = p;
-	for (i = 0; i < n; ++i) {
-		blocks[i]->closure = p;
-		p += nodewords;
-	}
-	all_edge_sets = p;
 	for (i = 0; i < n; ++i) {
 		register struct block *b = blocks[i];
 
-		b->et.edom = p;
-		p += edgewords;
-		b->ef.edom = p;
-		p += edgewords;
 		b->et.id = i;
 		edges[i] = &b->et;
 		b->ef.id = n_blocks + i;
@@ -1958,6 +2266,20 @@ opt_init(struct block *root)
 		b->et.pred = b;
 		b->ef.pred = b;
 	}
+
+	/*
+	 * The hash table for intern_blocks() has at least twice as
+	 * many buckets as there are blocks.
+	 */
+	for (intern_hashsize = 1; intern_hashsize < 2 * n_blocks;
+	    intern_hashsize <<= 1)
+		;
+	intern_hash = (struct block **)malloc(intern_hashsize *
+	    sizeof(*intern_hash));
+	intern_next = (struct block **)malloc(n_blocks * sizeof(*intern_next));
+	intern_rep = (struct block **)malloc(n_blocks * sizeof(*intern_rep));
+	if (intern_hash == NULL || intern_next == NULL || intern_rep == NULL)
+		bpf_error("malloc");
 	max_stmts = 0;
 	for (i = 0; i < n; ++i)
 		max_stmts += slength(blocks[i]->stmts) + 1;
@@ -2000,15 +2322,21 @@ convert_code_r(struct block *p)
 	u_int off;
 	int extrajmps;		/* number of extra jumps inserted */
 	struct slist **offset = NULL;
+	int ret;
 
 	if (p == 0 || isMarked(p))
 		return (1);
 	Mark(p);
 
-	if (convert_code_r(JF(p)) == 0)
-		return (0);
-	if (convert_code_r(JT(p)) == 0)
-		return (0);
+	/*
+	 * If a branch in a successor is too long, keep going, so that
+	 * we find all the branches that are too long in one pass,
+	 * rather than one per pass.  Adding jumps only makes branches
+	 * longer, so each of those branches would have been found to
+	 * be too long in a later pass anyway.
+	 */
+	ret = convert_code_r(JF(p));
+	ret &= convert_code_r(JT(p));
 
 	slen = slength(p->stmts);
 	dst = ftail -= (slen + 1 + p->longjt + p->longjf);
@@ -2113,13 +2441,14 @@ filled:
 		    if (p->longjt == 0) {
 		    	/* mark this instruction and retry */
 			p->longjt++;
-			return(0);
+			ret = 0;
+		    } else if (ret) {
+			/* branch if T to following jump */
+			dst->jt = extrajmps;
+			extrajmps++;
+			dst[extrajmps].code = BPF_JMP|BPF_JA;
+			dst[extrajmps].k = off - extrajmps;
 		    }
-		    /* branch if T to following jump */
-		    dst->jt = extrajmps;
-		    extrajmps++;
-		    dst[extrajmps].code = BPF_JMP|BPF_JA;
-		    dst[extrajmps].k = off - extrajmps;
 		}
 		else
 		    dst->jt = off;
@@ -2129,19 +2458,20 @@ filled:
 		    if (p->longjf == 0) {
 		    	/* mark this instruction and retry */
 			p->longjf++;
-			return(0);
+			ret = 0;
+		    } else if (ret) {
+			/* branch if F to following jump */
+			/* if two jumps are inserted, F goes to second one */
+			dst->jf = extrajmps;
+			extrajmps++;
+			dst[extrajmps].code = BPF_JMP|BPF_JA;
+			dst[extrajmps].k = off - extrajmps;
 		    }
-		    /* branch if F to following jump */
-		    /* if two jumps are inserted, F goes to second one */
-		    dst->jf = extrajmps;
-		    extrajmps++;
-		    dst[extrajmps].code = BPF_JMP|BPF_JA;
-		    dst[extrajmps].k = off - extrajmps;
 		}
 		else
 		    dst->jf = off;
 	}
-	return (1);
+	return (ret);
 }
 
 
@@ -354,8 +354,8 @@ bt_read_linux(pcap_t *handle, int max_packets, pcap_handler callback, u_char *us
 	pkth.caplen+=sizeof(pcap_bluetooth_h4_header);
 	pkth.len = pkth.caplen;
 	if (handle->fcode.bf_insns == NULL ||
-	    bpf_filter(handle->fcode.bf_insns, &handle->buffer[handle->offset],
-	      pkth.len, pkth.caplen)) {
+	    pcap_filter_packet(handle->fcode.bf_insns,
+	      &handle->buffer[handle->offset], pkth.len, &pkth.caplen)) {
 		callback(user, &pkth, &handle->buffer[handle->offset]);
 		return 1;
 	}
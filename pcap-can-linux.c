@@ -32,6 +32,8 @@
  *
  */
 
+#define _GNU_SOURCE
+
 #ifdef HAVE_CONFIG_H
 #include "config.h"
 #endif
@@ -50,6 +52,8 @@
 #include <string.h>
 #include <sys/ioctl.h>
 #include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/uio.h>
 #include <net/if.h>
 #include <arpa/inet.h>
 
@@ -64,13 +68,67 @@
 #define AF_CAN PF_CAN
 #endif
 
+/*
+ * Headers from before CAN FD; a CAN FD frame is a CAN frame with up
+ * to 64 bytes of data, and the flags byte follows the length byte.
+ */
+#ifndef CANFD_MTU
+#define CANFD_MTU	72
+#endif
+#ifndef CAN_MTU
+#define CAN_MTU		16
+#endif
+#ifndef CANFD_FDF
+#define CANFD_FDF	0x04	/* set in the flags of a CAN FD frame */
+#endif
+
+#define CAN_HDRLEN	8	/* ID, length, flags, and two reserved bytes */
+
+/*
+ * Number of frames we ask for with one recvmmsg() call.
+ */
+#define CAN_BATCH	64
+
+/*
+ * The kernel takes at most this many CAN_RAW_FILTER entries from us;
+ * a program with more accepting paths than that is filtered only in
+ * userland.  CAN_WALK_BUDGET bounds the work we do looking for them.
+ */
+#define CAN_MAX_FILTERS	64
+#define CAN_WALK_BUDGET	4096
+
+#define CAN_CONTROL_LEN	(CMSG_SPACE(sizeof(struct timeval)) + \
+			 CMSG_SPACE(sizeof(u_int32_t)))
+
+#ifdef HAVE_RECVMMSG
+#define can_mmsghdr	mmsghdr
+#else
+struct can_mmsghdr {
+	struct msghdr	msg_hdr;
+	unsigned int	msg_len;
+};
+#endif
+
+struct pcap_can {
+	int	kernel_exact;	/* kernel filter matches exactly what fcode does */
+	u_int	drops;		/* SO_RXQ_OVFL count of frames the socket dropped */
+	struct can_mmsghdr msgs[CAN_BATCH];
+	struct iovec iov[CAN_BATCH];
+	union {
+		struct cmsghdr	align;
+		u_char		buf[CAN_CONTROL_LEN];
+	} control[CAN_BATCH];
+};
+
 /* forward declaration */
 static int can_activate(pcap_t *);
+static void can_cleanup_linux(pcap_t *);
 static int can_read_linux(pcap_t *, int , pcap_handler , u_char *);
 static int can_inject_linux(pcap_t *, const void *, size_t);
 static int can_setfilter_linux(pcap_t *, struct bpf_program *);
 static int can_setdirection_linux(pcap_t *, pcap_direction_t);
 static int can_stats_linux(pcap_t *, struct pcap_stat *);
+static int can_stats_ex_linux(pcap_t *, struct pcap_stat_ex *);
 
 int
 can_findalldevs(pcap_if_t **devlistp, char *errbuf)
@@ -138,10 +196,12 @@ can_activate(pcap_t* handle)
 {
 	struct sockaddr_can addr;
 	struct ifreq ifr;
+	struct pcap_can *cp;
+	int i, on = 1;
 
 	/* Initialize some components of the pcap structure. */
-	handle->bufsize = 24;
-	handle->offset = 8;
+	handle->bufsize = CAN_BATCH * CANFD_MTU;
+	handle->offset = 0;
 	handle->linktype = DLT_CAN_SOCKETCAN;
 	handle->read_op = can_read_linux;
 	handle->inject_op = can_inject_linux;
@@ -151,6 +211,8 @@ can_activate(pcap_t* handle)
 	handle->getnonblock_op = pcap_getnonblock_fd;
 	handle->setnonblock_op = pcap_setnonblock_fd;
 	handle->stats_op = can_stats_linux;
+	handle->stats_ex_op = can_stats_ex_linux;
+	handle->cleanup_op = can_cleanup_linux;
 
 	/* Create socket */
 	handle->fd = socket(PF_CAN, SOCK_RAW, CAN_RAW);
@@ -176,13 +238,63 @@ can_activate(pcap_t* handle)
 
 	/* allocate butter */
 	handle->buffer = malloc(handle->bufsize);
-	if (!handle->buffer)
+	cp = calloc(1, sizeof(*cp));
+	if (!handle->buffer || !cp)
 	{
 		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE, "Can't allocate dump buffer: %s",
 			pcap_strerror(errno));
+		free(cp);
 		pcap_cleanup_live_common(handle);
 		return PCAP_ERROR;
 	}
+	handle->md.can = cp;
+
+	/*
+	 * One CAN FD-sized slot, and a control buffer for the timestamp
+	 * and drop count, for each frame of a batch.
+	 */
+	for (i = 0; i < CAN_BATCH; i++)
+	{
+		cp->iov[i].iov_base = handle->buffer + i * CANFD_MTU;
+		cp->iov[i].iov_len = CANFD_MTU;
+		cp->msgs[i].msg_hdr.msg_iov = &cp->iov[i];
+		cp->msgs[i].msg_hdr.msg_iovlen = 1;
+		cp->msgs[i].msg_hdr.msg_control = cp->control[i].buf;
+	}
+
+	/*
+	 * Ask for CAN FD frames as well as classic ones; kernels that
+	 * don't support CAN FD just give us classic frames.
+	 */
+#ifdef CAN_RAW_FD_FRAMES
+	(void)setsockopt(handle->fd, SOL_CAN_RAW, CAN_RAW_FD_FRAMES,
+	    &on, sizeof(on));
+#endif
+
+	/*
+	 * Have the kernel timestamp each frame when it arrives rather
+	 * than when we get around to reading it, and tell us how many
+	 * frames it dropped because the socket buffer was full.
+	 */
+	(void)setsockopt(handle->fd, SOL_SOCKET, SO_TIMESTAMP,
+	    &on, sizeof(on));
+#ifdef SO_RXQ_OVFL
+	(void)setsockopt(handle->fd, SOL_SOCKET, SO_RXQ_OVFL,
+	    &on, sizeof(on));
+#endif
+
+	if (handle->opt.buffer_size != 0)
+	{
+		if (setsockopt(handle->fd, SOL_SOCKET, SO_RCVBUF,
+		    &handle->opt.buffer_size,
+		    sizeof(handle->opt.buffer_size)) == -1)
+		{
+			snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+				"SO_RCVBUF: %s", pcap_strerror(errno));
+			can_cleanup_linux(handle);
+			return PCAP_ERROR;
+		}
+	}
 
 	/* Bind to the socket */
 	addr.can_family = AF_CAN;
@@ -191,14 +303,14 @@ can_activate(pcap_t* handle)
 	{
 		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE, "Can't attach to device %d %d:%s",
 			handle->md.ifindex, errno, strerror(errno));
-		pcap_cleanup_live_common(handle);
+		can_cleanup_linux(handle);
 		return PCAP_ERROR;
 	}
 
 	if (handle->opt.rfmon)
 	{
 		/* Monitor mode doesn't apply to CAN devices. */
-		pcap_cleanup_live_common(handle);
+		can_cleanup_linux(handle);
 		return PCAP_ERROR;
 	}
 
@@ -208,57 +320,156 @@ can_activate(pcap_t* handle)
 }
 
 
+static void
+can_cleanup_linux(pcap_t *handle)
+{
+	free(handle->md.can);
+	handle->md.can = NULL;
+	pcap_cleanup_live_common(handle);
+}
+
+
+/*
+ * Read up to "want" frames into the batch slots; returns the number
+ * read or -1 with errno set.
+ */
+static int
+can_recv_batch(pcap_t *handle, int want)
+{
+	struct pcap_can *cp = handle->md.can;
+	int i;
+#ifndef HAVE_RECVMMSG
+	ssize_t n;
+#endif
+
+	for (i = 0; i < want; i++)
+	{
+		cp->msgs[i].msg_hdr.msg_controllen = CAN_CONTROL_LEN;
+		cp->msgs[i].msg_hdr.msg_flags = 0;
+	}
+#ifdef HAVE_RECVMMSG
+	/*
+	 * Block for the first frame only, then take whatever else
+	 * is already queued.
+	 */
+	return recvmmsg(handle->fd, cp->msgs, want, MSG_WAITFORONE, NULL);
+#else
+	n = recvmsg(handle->fd, &cp->msgs[0].msg_hdr, 0);
+	if (n == -1)
+		return -1;
+	cp->msgs[0].msg_len = n;
+	return 1;
+#endif
+}
+
+
 static int
 can_read_linux(pcap_t *handle, int max_packets, pcap_handler callback, u_char *user)
 {
-	struct msghdr msg;
+	struct pcap_can *cp = handle->md.can;
 	struct pcap_pkthdr pkth;
-	struct iovec iv;
+	struct cmsghdr *cmsg;
+	struct msghdr *mh;
 	struct can_frame* cf;
+	u_char *frame;
+	u_int datalen;
+	int n, i, want, got_ts, count = 0;
 
-	iv.iov_base = &handle->buffer[handle->offset];
-	iv.iov_len = handle->snapshot;
-
-	memset(&msg, 0, sizeof(msg));
-	msg.msg_iov = &iv;
-	msg.msg_iovlen = 1;
-	msg.msg_control = handle->buffer;
-	msg.msg_controllen = handle->offset;
+	want = CAN_BATCH;
+	if (max_packets > 0 && max_packets < want)
+		want = max_packets;
 
 	do
 	{
-		pkth.caplen = recvmsg(handle->fd, &msg, 0);
+		n = can_recv_batch(handle, want);
 		if (handle->break_loop)
 		{
 			handle->break_loop = 0;
 			return -2;
 		}
-	} while ((pkth.caplen == -1) && (errno == EINTR));
+	} while ((n == -1) && (errno == EINTR));
 
-	if (pkth.caplen < 0)
+	if (n < 0)
 	{
+		if (errno == EAGAIN || errno == EWOULDBLOCK)
+			return 0;
 		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE, "Can't receive packet %d:%s",
 			errno, strerror(errno));
 		return -1;
 	}
 
-	/* adjust capture len according to frame len */
-	cf = (struct can_frame*)&handle->buffer[8];
-	pkth.caplen -= 8 - cf->can_dlc;
-	pkth.len = pkth.caplen;
-
-	cf->can_id = htonl( cf->can_id );
-
-	if( -1 == gettimeofday(&pkth.ts, NULL) )
+	for (i = 0; i < n; i++)
 	{
-		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE, "Can't get time of day %d:%s",
-			errno, strerror(errno));
-		return -1;
-	}
+		mh = &cp->msgs[i].msg_hdr;
+		frame = handle->buffer + i * CANFD_MTU;
+		cf = (struct can_frame*)frame;
+
+		/*
+		 * The length byte is the DLC of a classic frame and the
+		 * data length of a CAN FD frame; the size of what we read
+		 * tells us which one we got.
+		 */
+		if (cp->msgs[i].msg_len == CANFD_MTU)
+		{
+			datalen = frame[4];
+			frame[5] |= CANFD_FDF;
+		}
+		else if (cp->msgs[i].msg_len == CAN_MTU)
+			datalen = frame[4];
+		else
+			continue;
+		if (datalen > cp->msgs[i].msg_len - CAN_HDRLEN)
+			datalen = cp->msgs[i].msg_len - CAN_HDRLEN;
+
+		cf->can_id = htonl( cf->can_id );
+
+		pkth.len = CAN_HDRLEN + datalen;
+		pkth.caplen = pkth.len;
+		if (pkth.caplen > (bpf_u_int32)handle->snapshot)
+			pkth.caplen = handle->snapshot;
+
+		got_ts = 0;
+		for (cmsg = CMSG_FIRSTHDR(mh); cmsg != NULL;
+		    cmsg = CMSG_NXTHDR(mh, cmsg))
+		{
+			if (cmsg->cmsg_level != SOL_SOCKET)
+				continue;
+			if (cmsg->cmsg_type == SCM_TIMESTAMP)
+			{
+				memcpy(&pkth.ts, CMSG_DATA(cmsg),
+				    sizeof(pkth.ts));
+				got_ts = 1;
+			}
+#ifdef SO_RXQ_OVFL
+			else if (cmsg->cmsg_type == SO_RXQ_OVFL)
+				memcpy(&cp->drops, CMSG_DATA(cmsg),
+				    sizeof(cp->drops));
+#endif
+		}
+		if (!got_ts && -1 == gettimeofday(&pkth.ts, NULL) )
+		{
+			snprintf(handle->errbuf, PCAP_ERRBUF_SIZE, "Can't get time of day %d:%s",
+				errno, strerror(errno));
+			return -1;
+		}
 
-	callback(user, &pkth, &handle->buffer[8]);
+		/*
+		 * If the kernel filter does everything the program does,
+		 * including not truncating the frame, don't run it again.
+		 */
+		if (handle->fcode.bf_insns == NULL || cp->kernel_exact ||
+		    pcap_filter_packet(handle->fcode.bf_insns, frame, pkth.len,
+		    &pkth.caplen))
+		{
+			handle->md.packets_read++;
+			callback(user, &pkth, frame);
+			count++;
+		}
+		else
+			handle->md.packets_filtered++;
+	}
 
-	return 1;
+	return count;
 }
 
 
@@ -275,18 +486,222 @@ can_inject_linux(pcap_t *handle, const void *buf, size_t size)
 static int
 can_stats_linux(pcap_t *handle, struct pcap_stat *stats)
 {
-	/* not yet implemented */
-	stats->ps_recv = 0;			 /* number of packets received */
-	stats->ps_drop = 0;			 /* number of packets dropped */
+	stats->ps_recv = (u_int)handle->md.packets_read; /* number of packets received */
+	stats->ps_drop = handle->md.can->drops;	 /* number of packets dropped */
 	stats->ps_ifdrop = 0;		 /* drops by interface -- only supported on some platforms */
 	return 0;
 }
 
 
 static int
-can_setfilter_linux(pcap_t *p, struct bpf_program *fp)
+can_stats_ex_linux(pcap_t *handle, struct pcap_stat_ex *stats)
 {
-	/* not yet implemented */
+	memset(stats, 0, sizeof(*stats));
+	stats->ps_recv = handle->md.packets_read + handle->md.packets_filtered;
+	stats->ps_drop = handle->md.can->drops;
+	stats->ps_accepted = handle->md.packets_read;
+	stats->ps_filtered = handle->md.packets_filtered;
+	return 0;
+}
+
+
+/*
+ * Walk every path through a filter program from instruction "pc",
+ * tracking whether the accumulator holds the CAN ID (loaded with
+ * "ld [0]") ANDed with "amask", and collecting, for each path that
+ * ends in a non-zero return, the ID/mask test that path makes into
+ * "filters".  A conditional jump we can't turn into such a test
+ * leaves both branches open; that, or a path ending with "ret a",
+ * means the kernel filter lets through more than the program does,
+ * and we clear "*exactp".  We also clear it if a path ends with a
+ * "ret #k" that's shorter than a frame, as the kernel filter can't
+ * truncate frames.  Returns -1 if the program has too many
+ * accepting paths, or is too expensive, to walk.
+ */
+static int
+can_walk_program(const struct bpf_insn *insns, u_int len, u_int pc,
+    int aknown, bpf_u_int32 amask, bpf_u_int32 mask, bpf_u_int32 id,
+    int approx, struct can_filter *filters, int *nfiltersp, int *exactp,
+    int *budgetp)
+{
+	const struct bpf_insn *p;
+	u_int jt, jf;
+
+	for (;;)
+	{
+		if (pc >= len || --*budgetp < 0)
+			return -1;
+		p = &insns[pc];
+		switch (BPF_CLASS(p->code))
+		{
+		case BPF_RET:
+			if (BPF_RVAL(p->code) == BPF_K && p->k == 0)
+				return 0;	/* rejects */
+			if (BPF_RVAL(p->code) != BPF_K)
+				approx = 1;	/* might reject */
+			else if (p->k < CANFD_MTU)
+			{
+				/*
+				 * Accepts, but cuts the frame short, which
+				 * only the userland filter does.
+				 */
+				*exactp = 0;
+			}
+			if (*nfiltersp == CAN_MAX_FILTERS)
+				return -1;
+			filters[*nfiltersp].can_id = id;
+			filters[*nfiltersp].can_mask = mask;
+			(*nfiltersp)++;
+			if (approx)
+				*exactp = 0;
+			return 0;
+
+		case BPF_LD:
+			aknown = (p->code == (BPF_LD|BPF_W|BPF_ABS) &&
+			    p->k == 0);
+			amask = 0xffffffff;
+			pc++;
+			break;
+
+		case BPF_ALU:
+			if (p->code == (BPF_ALU|BPF_AND|BPF_K))
+				amask &= p->k;
+			else
+				aknown = 0;
+			pc++;
+			break;
+
+		case BPF_MISC:
+			if (BPF_MISCOP(p->code) == BPF_TXA)
+				aknown = 0;
+			pc++;
+			break;
+
+		case BPF_JMP:
+			if (BPF_OP(p->code) == BPF_JA)
+			{
+				pc += 1 + p->k;
+				break;
+			}
+			jt = pc + 1 + p->jt;
+			jf = pc + 1 + p->jf;
+			if (jt == jf)
+			{
+				pc = jt;
+				break;
+			}
+			if (aknown && p->code == (BPF_JMP|BPF_JEQ|BPF_K))
+			{
+				/*
+				 * "ID & amask == k".  If a bit of k is outside
+				 * amask, or contradicts a bit this path has
+				 * already tested, the true branch can't be
+				 * taken, and the false branch tells us nothing
+				 * new.
+				 */
+				if ((p->k & ~amask) != 0 ||
+				    (p->k & mask & amask) != (id & mask & amask))
+				{
+					pc = jf;
+					break;
+				}
+				if ((mask & amask) == amask)
+				{
+					/* already tested; can't be false */
+					pc = jt;
+					break;
+				}
+				if (can_walk_program(insns, len, jt, aknown,
+				    amask, mask | amask, id | p->k, approx,
+				    filters, nfiltersp, exactp, budgetp) == -1)
+					return -1;
+				/*
+				 * "ID & amask != k" can't be expressed, but
+				 * needn't be if the true branch accepts at
+				 * once, as it does for "id1 or id2 or ...".
+				 */
+				if (jt >= len || insns[jt].code != (BPF_RET|BPF_K) ||
+				    insns[jt].k == 0)
+					approx = 1;
+				pc = jf;
+				break;
+			}
+			if (can_walk_program(insns, len, jt, aknown, amask,
+			    mask, id, 1, filters, nfiltersp, exactp,
+			    budgetp) == -1)
+				return -1;
+			approx = 1;
+			pc = jf;
+			break;
+
+		default:
+			/* BPF_LDX, BPF_ST, and BPF_STX leave A alone */
+			pc++;
+			break;
+		}
+	}
+}
+
+
+/*
+ * Install the filter in userland and, as CAN_RAW_FILTER entries
+ * matching at least the frames it accepts, in the kernel.
+ */
+static int
+can_setfilter_linux(pcap_t *handle, struct bpf_program *fp)
+{
+	struct pcap_can *cp = handle->md.can;
+	struct can_filter filters[CAN_MAX_FILTERS];
+	u_char frame[CANFD_MTU];
+	int i, nfilters = 0, exact = 1, budget = CAN_WALK_BUDGET;
+
+	if (install_bpf_program(handle, fp) < 0)
+		return -1;
+
+	if (fp->bf_len == 0 ||
+	    can_walk_program(fp->bf_insns, fp->bf_len, 0, 0, 0, 0, 0, 0,
+	    filters, &nfilters, &exact, &budget) == -1)
+	{
+		/* Let everything through and filter in userland. */
+		filters[0].can_id = 0;
+		filters[0].can_mask = 0;
+		nfilters = 1;
+		exact = 0;
+	}
+	for (i = 0; i < nfilters; i++)
+	{
+		/*
+		 * That bit of a filter's ID means "invert the filter";
+		 * it's the error frame flag in an ID, and we don't ask
+		 * for error frames, so the path can't match.
+		 */
+		if (filters[i].can_id & CAN_INV_FILTER)
+			filters[i--] = filters[--nfilters];
+	}
+
+	/*
+	 * Frames that arrived under the old filter are still queued;
+	 * stop the kernel from queueing more, throw those away, and
+	 * then put the new filter in place, so that we can trust the
+	 * kernel to have applied it to everything we read from now on.
+	 */
+	if (setsockopt(handle->fd, SOL_CAN_RAW, CAN_RAW_FILTER, NULL, 0) == -1)
+	{
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+			"Can't set CAN_RAW_FILTER: %s", pcap_strerror(errno));
+		return -1;
+	}
+	while (recv(handle->fd, frame, sizeof(frame), MSG_DONTWAIT) >= 0)
+		;
+	if (nfilters != 0 &&
+	    setsockopt(handle->fd, SOL_CAN_RAW, CAN_RAW_FILTER, filters,
+	    nfilters * sizeof(filters[0])) == -1)
+	{
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+			"Can't set CAN_RAW_FILTER: %s", pcap_strerror(errno));
+		return -1;
+	}
+	cp->kernel_exact = exact;
 	return 0;
 }
 
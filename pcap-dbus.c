@@ -83,7 +83,7 @@ dbus_read(pcap_t *handle, int max_packets, pcap_handler callback, u_char *user)
 
 		gettimeofday(&pkth.ts, NULL);
 		if (handle->fcode.bf_insns == NULL ||
-		    bpf_filter(handle->fcode.bf_insns, (u_char *)raw_msg, pkth.len, pkth.caplen)) {
+		    pcap_filter_packet(handle->fcode.bf_insns, (u_char *)raw_msg, pkth.len, &pkth.caplen)) {
 			handle->md.packets_read++;
 			callback(user, &pkth, (u_char *)raw_msg);
 			count++;
@@ -106,6 +106,15 @@ typedef enum {
  */
 struct pcap_sf {
 	FILE *rfile;
+	/*
+	 * For pcap_open_offline_mem(), the caller's buffer, which we
+	 * parse in place rather than reading from rfile, and how far
+	 * into it we've got.
+	 */
+	const u_char *mem;
+	size_t memlen;
+	size_t mempos;
+	int memcopy;		/* copy blocks before parsing them? */
 	int (*next_packet_op)(pcap_t *, struct pcap_pkthdr *, u_char **);
 	int swapped;
 	size_t hdrsize;
@@ -113,9 +122,9 @@ struct pcap_sf {
 	int version_major;
 	int version_minor;
 	bpf_u_int32 ifcount;	/* number of interfaces seen in this capture */
-	u_int tsresol;		/* time stamp resolution */
-	u_int tsscale;		/* scaling factor for resolution -> microseconds */
-	u_int64_t tsoffset;	/* time stamp offset */
+	bpf_u_int32 ifaces_size; /* size of the array of interface information */
+	struct pcap_ng_if *ifaces; /* array of interface information */
+	int readahead;		/* read ahead of the current block? */
 };
 
 /*
@@ -123,6 +132,8 @@ struct pcap_sf {
  */
 struct pcap_md {
 	struct pcap_stat stat;
+	u_int64_t packets_read;	/* count of packets that passed the filter */
+	u_int64_t packets_filtered; /* count of packets rejected by the userland filter */
 	/*XXX*/
 	int use_bpf;		/* using kernel filter */
 	u_long	TotPkts;	/* can't oflow for 79 hrs on ether */
@@ -139,7 +150,6 @@ struct pcap_md {
 	int	cooked;		/* using SOCK_DGRAM rather than SOCK_RAW */
 	int	ifindex;	/* interface index of device we're bound to */
 	int	lo_ifindex;	/* interface index of the loopback device */
-	u_int	packets_read;	/* count of packets read with recvfrom() */
 	bpf_u_int32 oldmode;	/* mode to restore when turning monitor mode off */
 	char	*mondevice;	/* mac80211 monitor device we created */
 	u_char	*mmapbuf;	/* memory-mapped region pointer */
@@ -149,6 +159,44 @@ struct pcap_md {
 	u_int	tp_hdrlen;	/* hdrlen of tpacket_hdr for mmaped ring */
 	u_char	*oneshot_buffer; /* buffer for copy of packet */
 	long	proc_dropped; /* packets reported dropped by /proc/net/dev */
+	u_int64_t kern_recv;	/* running total of PACKET_STATISTICS tp_packets */
+	u_int64_t kern_drop;	/* running total of PACKET_STATISTICS tp_drops */
+	u_int64_t if_drop;	/* running total of /proc/net/dev drops */
+	u_int64_t ring_full;	/* times we found the mmapped ring full */
+	u_int	filter_gen;	/* generation of the current filter */
+	u_int	*frame_gen;	/* generation of the filter each ring frame passed */
+	struct timeval swap_ts;	/* when the kernel filter was hot-swapped */
+	int	swap_pending;	/* packets from before the swap may remain */
+	int	breakloop_rfd;	/* readable when pcap_breakloop() is called */
+	int	breakloop_wfd;	/* written to by pcap_breakloop() */
+	u_int64_t spin_ns;	/* time spent busy-polling the ring */
+	u_int64_t sleeps;	/* times busy-polling gave up and slept */
+	u_int64_t *delay_hist;	/* histogram of packet delivery delays */
+	int	reader_pinned;	/* reading thread has been bound to capture_cpu */
+	int	overloaded;	/* shedding load until the ring drains */
+	u_int64_t overload_on;	/* times we started shedding load */
+	u_int64_t overload_off;	/* times we stopped shedding load */
+	struct bpf_insn *kern_insns; /* kernel filter to put back after shedding */
+	u_int	kern_len;	/* number of instructions in kern_insns */
+#ifdef PCAP_SUPPORT_XDP
+	struct pcap_xdp *xdp;	/* AF_XDP socket, rings, and UMEM */
+#endif
+#ifdef PCAP_SUPPORT_MULTI
+	struct pcap_multi *multi; /* member captures of a multi-interface capture */
+#endif
+#ifdef PCAP_SUPPORT_SHM
+	struct pcap_shm_reader *shm; /* our view of a shared-memory ring */
+#endif
+#ifdef PCAP_SUPPORT_CAN
+	struct pcap_can *can;	/* receive batch and kernel filter state */
+#endif
+#ifdef PCAP_SUPPORT_USB
+	struct pcap_usb *usb;	/* usbmon fetch vector and held events */
+#endif
+#ifdef PCAP_SUPPORT_NETFILTER
+	struct pcap_nfq *nfq;	/* NFQUEUE verdicts waiting to be sent */
+	struct pcap_nflog *nflog; /* NFLOG groups' packet sequence numbers */
+#endif
 #endif /* linux */
 
 #ifdef HAVE_DAG_API
@@ -213,6 +261,16 @@ struct pcap_opt {
 	int	promisc;
 	int	rfmon;
 	int	tstamp_type;
+	int	filter_hotswap;	/* replace kernel filters without draining */
+	int	busy_poll;	/* microseconds to spin before sleeping, or 0 */
+	int	ring_lock;	/* fault in and lock the capture ring */
+	int	numa_local;	/* allocate on the device's NUMA node */
+	int	capture_cpu;	/* CPU to bind the reading thread to, or -1 */
+	int	merge_order;	/* how to merge packets from several interfaces */
+	int	overload_high;	/* ring occupancy, in percent, at which to shed load, or 0 */
+	int	overload_low;	/* ring occupancy, in percent, at which to stop */
+	int	overload_snaplen; /* snapshot length while shedding load, or 0 */
+	int	overload_sample; /* keep 1 packet in this many while shedding load */
 };
 
 /*
@@ -228,21 +286,43 @@ struct pcap_opt {
 #define       PCAP_FDDIPAD 3
 #endif
 
+/*
+ * One packet of a batch handed to inject_batch_op.
+ *
+ * inject_batch_op sends packets from the start of the batch until it
+ * has sent them all or can't send any more, and returns the number it
+ * sent.  If the device is out of buffer space (ENOBUFS or EAGAIN)
+ * before anything is sent, it returns 0, so that the caller can wait
+ * and retry; it returns -1, with the error in p->errbuf, only if the
+ * first packet fails for any other reason.  A failure after that
+ * just ends the batch early, and the caller finds out about it when
+ * it retries the rest.
+ */
+struct pcap_inject_vec {
+	const void *buf;
+	size_t	size;
+};
+
 typedef int	(*activate_op_t)(pcap_t *);
 typedef int	(*can_set_rfmon_op_t)(pcap_t *);
 typedef int	(*read_op_t)(pcap_t *, int cnt, pcap_handler, u_char *);
 typedef int	(*inject_op_t)(pcap_t *, const void *, size_t);
+typedef int	(*inject_batch_op_t)(pcap_t *, const struct pcap_inject_vec *, int);
 typedef int	(*setfilter_op_t)(pcap_t *, struct bpf_program *);
 typedef int	(*setdirection_op_t)(pcap_t *, pcap_direction_t);
 typedef int	(*set_datalink_op_t)(pcap_t *, int);
 typedef int	(*getnonblock_op_t)(pcap_t *, char *);
 typedef int	(*setnonblock_op_t)(pcap_t *, int, char *);
 typedef int	(*stats_op_t)(pcap_t *, struct pcap_stat *);
+#if !defined(WIN32) && !defined(MSDOS)
+typedef int	(*stats_ex_op_t)(pcap_t *, struct pcap_stat_ex *);
+#endif
 #ifdef WIN32
 typedef int	(*setbuff_op_t)(pcap_t *, int);
 typedef int	(*setmode_op_t)(pcap_t *, int);
 typedef int	(*setmintocopy_op_t)(pcap_t *, int);
 #endif
+typedef void	(*breakloop_op_t)(pcap_t *);
 typedef void	(*cleanup_op_t)(pcap_t *);
 
 struct pcap {
@@ -294,9 +374,20 @@ struct pcap {
 	 */
 	u_char *pkt;
 
+	/*
+	 * Index of the interface on which the packet being handed to
+	 * the callback arrived, if the source knows it, or 0.
+	 */
+	bpf_u_int32 pkt_ifindex;
+
 	/* We're accepting only packets in this direction/these directions. */
 	pcap_direction_t direction;
 
+	/*
+	 * Duplicate suppression state, if pcap_setdedup() turned it on.
+	 */
+	struct pcap_dedup *dedup;
+
 	/*
 	 * Methods.
 	 */
@@ -304,12 +395,22 @@ struct pcap {
 	can_set_rfmon_op_t can_set_rfmon_op;
 	read_op_t read_op;
 	inject_op_t inject_op;
+
+	/*
+	 * Send several packets at once; returns the number sent, which
+	 * may be fewer than asked for if the device is out of buffer
+	 * space, or -1 on an error before anything was sent.
+	 */
+	inject_batch_op_t inject_batch_op;
 	setfilter_op_t setfilter_op;
 	setdirection_op_t setdirection_op;
 	set_datalink_op_t set_datalink_op;
 	getnonblock_op_t getnonblock_op;
 	setnonblock_op_t setnonblock_op;
 	stats_op_t stats_op;
+#if !defined(WIN32) && !defined(MSDOS)
+	stats_ex_op_t stats_ex_op;
+#endif
 
 	/*
 	 * Routine to use as callback for pcap_next()/pcap_next_ex().
@@ -325,6 +426,7 @@ struct pcap {
 	setmode_op_t setmode_op;
 	setmintocopy_op_t setmintocopy_op;
 #endif
+	breakloop_op_t breakloop_op;
 	cleanup_op_t cleanup_op;
 
 	/*
@@ -427,8 +529,14 @@ int	yylex(void);
 #define min(a, b) ((a) > (b) ? (b) : (a))
 #endif
 
+/*
+ * Is this pcap_t reading a savefile, from a file or from memory?
+ */
+#define PCAP_IS_SAVEFILE(p)	((p)->sf.rfile != NULL || (p)->sf.mem != NULL)
+
 /* XXX should these be in pcap.h? */
 int	pcap_offline_read(pcap_t *, int, pcap_handler, u_char *);
+size_t	sf_fread(pcap_t *, void *, size_t, FILE *);
 int	pcap_read(pcap_t *, int cnt, pcap_handler, u_char *);
 
 #ifndef HAVE_STRLCPY
@@ -458,6 +566,24 @@ int	pcap_getnonblock_fd(pcap_t *, char *);
 int	pcap_setnonblock_fd(pcap_t *p, int, char *);
 #endif
 
+#ifdef linux
+/*
+ * The descriptor Linux capture modules wait on, along with their own,
+ * so that pcap_breakloop() can wake up a thread waiting for packets;
+ * pcap_breakloop_fd() is the breakloop_op for those modules.
+ */
+int	pcap_breakloop_fd_open(pcap_t *);
+void	pcap_breakloop_fd_drain(pcap_t *);
+void	pcap_breakloop_fd_close(pcap_t *);
+void	pcap_breakloop_fd(pcap_t *);
+
+/*
+ * Bind the calling thread to opt.capture_cpu, and set md.reader_pinned
+ * if that works; Linux capture modules call this on their first read.
+ */
+int	pcap_pin_reader(pcap_t *);
+#endif
+
 /*
  * Internal interfaces for "pcap_create()".
  *
@@ -475,8 +601,13 @@ int	pcap_do_addexit(pcap_t *);
 void	pcap_add_to_pcaps_to_close(pcap_t *);
 void	pcap_remove_from_pcaps_to_close(pcap_t *);
 void	pcap_cleanup_live_common(pcap_t *);
+void	pcap_breakloop_common(pcap_t *);
+int	pcap_inject_batch_common(pcap_t *, const struct pcap_inject_vec *, int);
 int	pcap_not_initialized(pcap_t *);
 int	pcap_check_activated(pcap_t *);
+#if !defined(WIN32) && !defined(MSDOS)
+int	pcap_stats_ex_common(pcap_t *, struct pcap_stat_ex *);
+#endif
 
 /*
  * Internal interfaces for "pcap_findalldevs()".
@@ -489,6 +620,12 @@ int	pcap_check_activated(pcap_t *);
  *
  * "pcap_add_if()" adds an interface to the list of interfaces, for
  * use by various "find interfaces" routines.
+ *
+ * "new_if()", "add_addr_to_if()", and "add_iflist_to_iflist()" let
+ * a "find interfaces" routine that gets all the interfaces at once
+ * build its own list and add it to the list of interfaces in one
+ * step; "can_open_if()" is the check "add_or_find_if()" does before
+ * adding an interface.
  */
 int	pcap_findalldevs_interfaces(pcap_if_t **, char *);
 int	pcap_platform_finddevs(pcap_if_t **, char *);
@@ -499,12 +636,27 @@ int	pcap_add_if(pcap_if_t **, const char *, u_int, const char *, char *);
 struct sockaddr *dup_sockaddr(struct sockaddr *, size_t);
 int	add_or_find_if(pcap_if_t **, pcap_if_t **, const char *, u_int,
 	    const char *, char *);
+int	can_open_if(const char *, char *);
+pcap_if_t *new_if(const char *, u_int, const char *, char *);
+int	add_addr_to_if(pcap_if_t *, struct sockaddr *, size_t,
+	    struct sockaddr *, size_t, struct sockaddr *, size_t,
+	    struct sockaddr *, size_t, char *);
+void	add_iflist_to_iflist(pcap_if_t **, pcap_if_t *);
 
 #ifdef WIN32
 char	*pcap_win32strerror(void);
 #endif
 
 int	install_bpf_program(pcap_t *, struct bpf_program *);
+int	pcap_filter_packet(const struct bpf_insn *, const u_char *, u_int,
+	    bpf_u_int32 *);
+
+/*
+ * Duplicate suppression, in dedup.c.
+ */
+int	pcap_dedup_check(pcap_t *, const struct pcap_pkthdr *, const u_char *);
+u_int64_t pcap_dedup_count(pcap_t *);
+void	pcap_dedup_free(pcap_t *);
 
 int	pcap_strcasecmp(const char *, const char *);
 
@@ -139,6 +139,12 @@ static const char rcsid[] _U_ =
 #include <net/if_arp.h>
 #include <poll.h>
 #include <dirent.h>
+#include <time.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#ifdef HAVE_SYS_EVENTFD_H
+#include <sys/eventfd.h>
+#endif
 
 #include "pcap-int.h"
 #include "pcap/sll.h"
@@ -298,11 +304,17 @@ static int pcap_can_set_rfmon_linux(pcap_t *);
 static int pcap_read_linux(pcap_t *, int, pcap_handler, u_char *);
 static int pcap_read_packet(pcap_t *, pcap_handler, u_char *);
 static int pcap_inject_linux(pcap_t *, const void *, size_t);
+#ifdef HAVE_SENDMMSG
+static int pcap_inject_batch_linux(pcap_t *, const struct pcap_inject_vec *,
+    int);
+#endif
 static int pcap_stats_linux(pcap_t *, struct pcap_stat *);
+static int pcap_stats_ex_linux(pcap_t *, struct pcap_stat_ex *);
 static int pcap_setfilter_linux(pcap_t *, struct bpf_program *);
 static int pcap_setdirection_linux(pcap_t *, pcap_direction_t);
 static int pcap_set_datalink_linux(pcap_t *, int);
 static void pcap_cleanup_linux(pcap_t *);
+static int pcap_setnonblock_linux(pcap_t *, int, char *);
 
 union thdr {
 	struct tpacket_hdr	*h1;
@@ -315,6 +327,8 @@ union thdr {
 
 static void destroy_ring(pcap_t *handle);
 static int create_ring(pcap_t *handle, int *status);
+static int activate_mmap_ring(pcap_t *handle, int *status);
+static int linux_lock_ring(pcap_t *handle);
 static int prepare_tpacket_socket(pcap_t *handle);
 static void pcap_cleanup_linux_mmap(pcap_t *);
 static int pcap_read_linux_mmap(pcap_t *, int, pcap_handler , u_char *);
@@ -323,6 +337,10 @@ static int pcap_setnonblock_mmap(pcap_t *p, int nonblock, char *errbuf);
 static int pcap_getnonblock_mmap(pcap_t *p, char *errbuf);
 static void pcap_oneshot_mmap(u_char *user, const struct pcap_pkthdr *h,
     const u_char *bytes);
+static int linux_ring_used(pcap_t *handle);
+static int linux_check_overload(pcap_t *handle);
+static int linux_busy_poll_init(pcap_t *handle);
+static u_int64_t linux_delay_p99(pcap_t *handle);
 #endif
 
 /*
@@ -987,6 +1005,125 @@ linux_if_drops(const char * if_name)
 	return dropped_pkts;
 } 
 
+/*
+ * Get the NUMA node to which the device's hardware is attached, from
+ * /sys/class/net/{interface name}/device/numa_node; returns -1 if it's
+ * not known, as it isn't for virtual devices or on non-NUMA machines.
+ */
+static int
+linux_if_numa_node(const char *if_name)
+{
+	char path[PATH_MAX];
+	FILE *file;
+	int node;
+
+	snprintf(path, sizeof(path), "/sys/class/net/%s/device/numa_node",
+	    if_name);
+	file = fopen(path, "r");
+	if (file == NULL)
+		return -1;
+	if (fscanf(file, "%d", &node) != 1)
+		node = -1;
+	fclose(file);
+	return node;
+}
+
+#if defined(SYS_get_mempolicy) && defined(SYS_set_mempolicy)
+#ifndef MPOL_DEFAULT
+#define MPOL_DEFAULT	0
+#endif
+#ifndef MPOL_PREFERRED
+#define MPOL_PREFERRED	1
+#endif
+
+#define NUMA_MASK_LONGS	16	/* enough for 1024 nodes */
+#define NUMA_MASK_BITS	(NUMA_MASK_LONGS * 8 * sizeof(unsigned long))
+
+struct numa_policy {
+	int		saved;	/* 1 if we changed the policy */
+	int		mode;
+	unsigned long	mask[NUMA_MASK_LONGS];
+};
+
+/*
+ * Make this thread prefer to allocate memory, including the memory the
+ * kernel allocates for the ring on our behalf, on the given node,
+ * saving the current policy in "*policy"; failure just means we'll get
+ * memory from wherever the kernel would have put it anyway.
+ */
+static void
+linux_prefer_numa_node(int node, struct numa_policy *policy)
+{
+	unsigned long mask[NUMA_MASK_LONGS];
+
+	policy->saved = 0;
+	if (node < 0 || (size_t)node >= NUMA_MASK_BITS)
+		return;
+	if (syscall(SYS_get_mempolicy, &policy->mode, policy->mask,
+	    NUMA_MASK_BITS, NULL, 0) == -1)
+		return;
+	memset(mask, 0, sizeof(mask));
+	mask[node / (8 * sizeof(unsigned long))] |=
+	    1UL << (node % (8 * sizeof(unsigned long)));
+	if (syscall(SYS_set_mempolicy, MPOL_PREFERRED, mask,
+	    NUMA_MASK_BITS) == -1)
+		return;
+	policy->saved = 1;
+}
+
+static void
+linux_restore_numa_policy(struct numa_policy *policy)
+{
+	if (!policy->saved)
+		return;
+	if (policy->mode == MPOL_DEFAULT)
+		syscall(SYS_set_mempolicy, MPOL_DEFAULT, NULL, 0);
+	else
+		syscall(SYS_set_mempolicy, policy->mode, policy->mask,
+		    NUMA_MASK_BITS);
+}
+#else
+struct numa_policy {
+	int		saved;
+};
+
+static void
+linux_prefer_numa_node(int node _U_, struct numa_policy *policy)
+{
+	policy->saved = 0;
+}
+
+static void
+linux_restore_numa_policy(struct numa_policy *policy _U_)
+{
+}
+#endif
+
+/*
+ * If a CPU was chosen for the capture, bind the thread that reads
+ * packets to it the first time it reads, so that the packets are
+ * processed where the caller wants and, with a NUMA-local ring,
+ * near the memory they're in.  We only note that it's been done if
+ * it worked, so that if it fails, every read fails, rather than the
+ * capture quietly carrying on on the wrong CPU.
+ */
+int
+pcap_pin_reader(pcap_t *handle)
+{
+	cpu_set_t set;
+
+	CPU_ZERO(&set);
+	CPU_SET(handle->opt.capture_cpu, &set);
+	if (sched_setaffinity(0, sizeof(set), &set) == -1) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "can't bind capture thread to CPU %d: %s",
+		    handle->opt.capture_cpu, pcap_strerror(errno));
+		return -1;
+	}
+	handle->md.reader_pinned = 1;
+	return 0;
+}
+
 
 /*
  * With older kernels promiscuous mode is kind of interesting because we
@@ -1152,9 +1289,105 @@ static void	pcap_cleanup_linux( pcap_t *handle )
 		free(handle->md.device);
 		handle->md.device = NULL;
 	}
+	pcap_breakloop_fd_close(handle);
+	if (handle->md.kern_insns != NULL) {
+		free(handle->md.kern_insns);
+		handle->md.kern_insns = NULL;
+	}
+	if (handle->md.delay_hist != NULL) {
+		free(handle->md.delay_hist);
+		handle->md.delay_hist = NULL;
+	}
 	pcap_cleanup_live_common(handle);
 }
 
+/*
+ * Set up the descriptor that pcap_breakloop() makes readable, so that
+ * a thread waiting for packets can wait for it as well, and return as
+ * soon as pcap_breakloop() is called rather than when the next packet
+ * arrives or the timeout expires.  We use an eventfd if we have one,
+ * and a pipe otherwise.
+ *
+ * This, pcap_breakloop_fd_drain(), pcap_breakloop_fd_close(), and
+ * pcap_breakloop_fd(), as the breakloop_op, are used by all the Linux
+ * capture modules whose readers wait in poll() or epoll_wait().
+ */
+int
+pcap_breakloop_fd_open(pcap_t *handle)
+{
+	int fds[2];
+
+	handle->md.breakloop_rfd = -1;
+	handle->md.breakloop_wfd = -1;
+#ifdef HAVE_SYS_EVENTFD_H
+	fds[0] = eventfd(0, 0);
+	if (fds[0] != -1 && fcntl(fds[0], F_SETFL, O_NONBLOCK) != -1) {
+		handle->md.breakloop_rfd = fds[0];
+		handle->md.breakloop_wfd = fds[0];
+		return 0;
+	}
+	if (fds[0] != -1)
+		close(fds[0]);
+#endif
+	if (pipe(fds) == -1) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+			 "pipe: %s", pcap_strerror(errno));
+		return -1;
+	}
+	if (fcntl(fds[0], F_SETFL, O_NONBLOCK) == -1 ||
+	    fcntl(fds[1], F_SETFL, O_NONBLOCK) == -1) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+			 "fcntl: %s", pcap_strerror(errno));
+		close(fds[0]);
+		close(fds[1]);
+		return -1;
+	}
+	handle->md.breakloop_rfd = fds[0];
+	handle->md.breakloop_wfd = fds[1];
+	return 0;
+}
+
+/*
+ * Empty the pcap_breakloop() descriptor once we've woken up.
+ */
+void
+pcap_breakloop_fd_drain(pcap_t *handle)
+{
+	u_int64_t value;
+
+	while (read(handle->md.breakloop_rfd, &value, sizeof(value)) > 0)
+		;
+}
+
+void
+pcap_breakloop_fd_close(pcap_t *handle)
+{
+	if (handle->md.breakloop_rfd != -1) {
+		close(handle->md.breakloop_rfd);
+		if (handle->md.breakloop_wfd != handle->md.breakloop_rfd)
+			close(handle->md.breakloop_wfd);
+		handle->md.breakloop_rfd = -1;
+		handle->md.breakloop_wfd = -1;
+	}
+}
+
+void
+pcap_breakloop_fd(pcap_t *handle)
+{
+	u_int64_t value = 1;
+
+	pcap_breakloop_common(handle);
+
+	/*
+	 * Wake up the thread reading packets, if it's waiting.
+	 * If the write fails, it's because the eventfd counter or
+	 * the pipe is already full, and it'll wake up anyway.
+	 */
+	if (handle->md.breakloop_wfd != -1 &&
+	    write(handle->md.breakloop_wfd, &value, sizeof(value)) == -1)
+		return;
+}
+
 /*
  *  Get a handle for a live capture from the given device. You can
  *  pass NULL as device to get all packages (without link level
@@ -1171,15 +1404,23 @@ pcap_activate_linux(pcap_t *handle)
 
 	device = handle->opt.source;
 
+	handle->md.breakloop_rfd = -1;
+	handle->md.breakloop_wfd = -1;
+
 	handle->inject_op = pcap_inject_linux;
+#ifdef HAVE_SENDMMSG
+	handle->inject_batch_op = pcap_inject_batch_linux;
+#endif
 	handle->setfilter_op = pcap_setfilter_linux;
 	handle->setdirection_op = pcap_setdirection_linux;
 	handle->set_datalink_op = pcap_set_datalink_linux;
 	handle->getnonblock_op = pcap_getnonblock_fd;
-	handle->setnonblock_op = pcap_setnonblock_fd;
+	handle->setnonblock_op = pcap_setnonblock_linux;
 	handle->cleanup_op = pcap_cleanup_linux;
 	handle->read_op = pcap_read_linux;
 	handle->stats_op = pcap_stats_linux;
+	handle->stats_ex_op = pcap_stats_ex_linux;
+	handle->breakloop_op = pcap_breakloop_fd;
 
 	/*
 	 * The "any" device is a special device which causes us not
@@ -1211,6 +1452,25 @@ pcap_activate_linux(pcap_t *handle)
 	if (handle->opt.promisc)
 		handle->md.proc_dropped = linux_if_drops(handle->md.device);
 
+	if (pcap_breakloop_fd_open(handle) == -1) {
+		status = PCAP_ERROR;
+		goto fail;
+	}
+
+	if (handle->opt.capture_cpu >= 0) {
+		cpu_set_t set;
+
+		if (handle->opt.capture_cpu >= CPU_SETSIZE ||
+		    sched_getaffinity(0, sizeof(set), &set) == -1 ||
+		    !CPU_ISSET(handle->opt.capture_cpu, &set)) {
+			snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+			    "CPU %d isn't available for capturing",
+			    handle->opt.capture_cpu);
+			status = PCAP_ERROR;
+			goto fail;
+		}
+	}
+
 	/*
 	 * Current Linux kernels use the protocol family PF_PACKET to
 	 * allow direct access to all packets on the network while
@@ -1279,6 +1539,15 @@ pcap_activate_linux(pcap_t *handle)
 	 * We set up the socket, but not with memory-mapped access.
 	 */
 	status = 0;
+	if (handle->opt.ring_lock) {
+		/*
+		 * There's no ring to lock; tell the caller, rather than
+		 * letting them think their buffer won't be paged out.
+		 */
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "Can't lock the capture buffer without memory-mapped capture");
+		status = PCAP_WARNING;
+	}
 	if (handle->opt.buffer_size != 0) {
 		/*
 		 * Set the socket buffer size to the specified value.
@@ -1328,6 +1597,9 @@ pcap_read_linux(pcap_t *handle, int max_packets, pcap_handler callback, u_char *
 	 * Currently, on Linux only one packet is delivered per read,
 	 * so we don't loop.
 	 */
+	if (handle->opt.capture_cpu >= 0 && !handle->md.reader_pinned &&
+	    pcap_pin_reader(handle) == -1)
+		return PCAP_ERROR;
 	return pcap_read_packet(handle, callback, user);
 }
 
@@ -1338,6 +1610,82 @@ pcap_set_datalink_linux(pcap_t *handle, int dlt)
 	return 0;
 }
 
+/*
+ * When the kernel filter is hot-swapped, packets that passed the old
+ * filter aren't flushed, so we have to run the new filter on them in
+ * userland.  For the ring, the frame generations tell us which ones
+ * those are, but a packet that was being handed to the socket as we
+ * swapped can still show up after that; such a packet, like every
+ * packet queued on the socket before the swap, has a time stamp no
+ * later than the time at which the swap finished.  Return 1 if the
+ * packet with the given time stamp is one of those, and 0, and stop
+ * checking, once we see one time-stamped after the swap.
+ */
+static inline int
+linux_predates_swap(pcap_t *handle, u_int sec, u_int usec)
+{
+	if (!handle->md.swap_pending)
+		return 0;
+	if (sec > (u_int)handle->md.swap_ts.tv_sec ||
+	    (sec == (u_int)handle->md.swap_ts.tv_sec &&
+	     usec > (u_int)handle->md.swap_ts.tv_usec)) {
+		handle->md.swap_pending = 0;
+		return 0;
+	}
+	return 1;
+}
+
+/*
+ * There's no packet to read from the socket; if it's in blocking
+ * mode, wait until there is one, or until pcap_breakloop() is called.
+ * Returns 1 if the caller should try reading again, 0 if the socket
+ * is in non-blocking mode, and -1, with handle->errbuf set, on error.
+ */
+static int
+linux_wait_for_packet(pcap_t *handle)
+{
+	struct pollfd pollfds[2];
+
+	/*
+	 * A negative timeout means non-blocking mode; see
+	 * pcap_setnonblock_linux().
+	 */
+	if (handle->md.timeout < 0)
+		return 0;
+
+	pollfds[0].fd = handle->fd;
+	pollfds[0].events = POLLIN;
+	pollfds[1].fd = handle->md.breakloop_rfd;
+	pollfds[1].events = POLLIN;
+	if (poll(pollfds, 2, -1) == -1) {
+		if (errno == EINTR)
+			return 1;
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+			 "can't poll on packet socket: %s",
+			 pcap_strerror(errno));
+		return -1;
+	}
+	if (pollfds[1].revents & POLLIN)
+		pcap_breakloop_fd_drain(handle);
+	return 1;
+}
+
+/*
+ * Without memory-mapped access, set the socket's non-blocking mode,
+ * for the benefit of anyone reading from it directly, and note it as
+ * the memory-mapped code does, by negating the timeout, so that
+ * linux_wait_for_packet() needn't ask the socket.
+ */
+static int
+pcap_setnonblock_linux(pcap_t *p, int nonblock, char *errbuf)
+{
+	if (pcap_setnonblock_fd(p, nonblock, errbuf) == -1)
+		return -1;
+	if ((nonblock != 0) != (p->md.timeout < 0))
+		p->md.timeout = ~p->md.timeout;
+	return 0;
+}
+
 /*
  *  Read a packet from the socket calling the handler provided by
  *  the user. Returns the number of packets received or -1 if an
@@ -1366,6 +1714,8 @@ pcap_read_packet(pcap_t *handle, pcap_handler callback, u_char *userdata)
 	socklen_t		fromlen;
 #endif /* defined(HAVE_PACKET_AUXDATA) && defined(HAVE_LINUX_TPACKET_AUXDATA_TP_VLAN_TCI) */
 	int			packet_len, caplen;
+	int			run_bpf, have_ts;
+	int			recv_flags;
 	struct pcap_pkthdr	pcap_header;
 
 #ifdef HAVE_PF_PACKET_SOCKETS
@@ -1399,8 +1749,15 @@ pcap_read_packet(pcap_t *handle, pcap_handler callback, u_char *userdata)
 	 * receive from a socket that delivered ENETDOWN, and,
 	 * if we're using a memory-mapped buffer, we won't even
 	 * get notified of "network down" events.
+	 *
+	 * So that pcap_breakloop() can wake us up, we don't block in
+	 * the receive call itself; if there's no packet, we wait for
+	 * either a packet or a call to pcap_breakloop().
 	 */
 	bp = handle->buffer + handle->offset;
+	recv_flags = MSG_TRUNC;
+	if (handle->md.breakloop_rfd != -1)
+		recv_flags |= MSG_DONTWAIT;
 
 #if defined(HAVE_PACKET_AUXDATA) && defined(HAVE_LINUX_TPACKET_AUXDATA_TP_VLAN_TCI)
 	msg.msg_name		= &from;
@@ -1430,14 +1787,36 @@ pcap_read_packet(pcap_t *handle, pcap_handler callback, u_char *userdata)
 		}
 
 #if defined(HAVE_PACKET_AUXDATA) && defined(HAVE_LINUX_TPACKET_AUXDATA_TP_VLAN_TCI)
-		packet_len = recvmsg(handle->fd, &msg, MSG_TRUNC);
+		packet_len = recvmsg(handle->fd, &msg, recv_flags);
 #else /* defined(HAVE_PACKET_AUXDATA) && defined(HAVE_LINUX_TPACKET_AUXDATA_TP_VLAN_TCI) */
 		fromlen = sizeof(from);
 		packet_len = recvfrom(
 			handle->fd, bp + offset,
-			handle->bufsize - offset, MSG_TRUNC,
+			handle->bufsize - offset, recv_flags,
 			(struct sockaddr *) &from, &fromlen);
 #endif /* defined(HAVE_PACKET_AUXDATA) && defined(HAVE_LINUX_TPACKET_AUXDATA_TP_VLAN_TCI) */
+		if (packet_len == -1 && errno == EAGAIN &&
+		    (recv_flags & MSG_DONTWAIT)) {
+			switch (linux_wait_for_packet(handle)) {
+
+			case -1:
+				return PCAP_ERROR;
+
+			case 0:
+				/*
+				 * We're in non-blocking mode.
+				 */
+				errno = EAGAIN;
+				break;
+
+			case 1:
+				/*
+				 * Try again.
+				 */
+				errno = EINTR;
+				break;
+			}
+		}
 	} while (packet_len == -1 && errno == EINTR);
 
 	/* Check if an error occured */
@@ -1614,19 +1993,43 @@ pcap_read_packet(pcap_t *handle, pcap_handler callback, u_char *userdata)
 	if (caplen > handle->snapshot)
 		caplen = handle->snapshot;
 
+	/*
+	 * If the kernel filter was hot-swapped, and this packet might
+	 * have been queued before that, we need its time stamp to see
+	 * whether it did.
+	 */
+	if (handle->md.use_bpf && handle->md.swap_pending) {
+		if (ioctl(handle->fd, SIOCGSTAMP, &pcap_header.ts) == -1) {
+			snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+				 "SIOCGSTAMP: %s", pcap_strerror(errno));
+			return PCAP_ERROR;
+		}
+		run_bpf = linux_predates_swap(handle, pcap_header.ts.tv_sec,
+		    pcap_header.ts.tv_usec);
+		have_ts = 1;
+	} else {
+		run_bpf = !handle->md.use_bpf;
+		have_ts = 0;
+	}
+
 	/* Run the packet filter if not using kernel filter */
-	if (!handle->md.use_bpf && handle->fcode.bf_insns) {
-		if (bpf_filter(handle->fcode.bf_insns, bp,
-		                packet_len, caplen) == 0)
+	if (run_bpf && handle->fcode.bf_insns) {
+		bpf_u_int32 snap = caplen;
+
+		if (!pcap_filter_packet(handle->fcode.bf_insns, bp,
+		                packet_len, &snap))
 		{
 			/* rejected by filter */
+			handle->md.packets_filtered++;
 			return 0;
 		}
+		caplen = snap;
 	}
 
 	/* Fill in our own header data */
 
-	if (ioctl(handle->fd, SIOCGSTAMP, &pcap_header.ts) == -1) {
+	if (!have_ts &&
+	    ioctl(handle->fd, SIOCGSTAMP, &pcap_header.ts) == -1) {
 		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
 			 "SIOCGSTAMP: %s", pcap_strerror(errno));
 		return PCAP_ERROR;
@@ -1670,10 +2073,10 @@ pcap_read_packet(pcap_t *handle, pcap_handler callback, u_char *userdata)
 	 * We keep the count in "md.packets_read", and use that for
 	 * "ps_recv" if we can't get the statistics from the kernel.
 	 * We do that because, if we *can* get the statistics from
-	 * the kernel, we use "md.stat.ps_recv" and "md.stat.ps_drop"
+	 * the kernel, we use "md.kern_recv" and "md.kern_drop"
 	 * as running counts, as reading the statistics from the
 	 * kernel resets the kernel statistics, and if we directly
-	 * increment "md.stat.ps_recv" here, that means it will
+	 * increment "md.kern_recv" here, that means it will
 	 * count packets *twice* on systems where we can get kernel
 	 * statistics - once here, and once in pcap_stats_linux().
 	 */
@@ -1685,11 +2088,13 @@ pcap_read_packet(pcap_t *handle, pcap_handler callback, u_char *userdata)
 	return 1;
 }
 
+/*
+ * Make sure we can send on this handle; returns -1, with an error
+ * message in the handle's error buffer, if we can't.
+ */
 static int
-pcap_inject_linux(pcap_t *handle, const void *buf, size_t size)
+linux_check_inject(pcap_t *handle)
 {
-	int ret;
-
 #ifdef HAVE_PF_PACKET_SOCKETS
 	if (!handle->md.sock_packet) {
 		/* PF_PACKET socket */
@@ -1718,6 +2123,16 @@ pcap_inject_linux(pcap_t *handle, const void *buf, size_t size)
 		}
 	}
 #endif
+	return (0);
+}
+
+static int
+pcap_inject_linux(pcap_t *handle, const void *buf, size_t size)
+{
+	int ret;
+
+	if (linux_check_inject(handle) == -1)
+		return (-1);
 
 	ret = send(handle->fd, buf, size, 0);
 	if (ret == -1) {
@@ -1728,16 +2143,64 @@ pcap_inject_linux(pcap_t *handle, const void *buf, size_t size)
 	return (ret);
 }                           
 
+#ifdef HAVE_SENDMMSG
 /*
- *  Get the statistics for the given packet capture handle.
- *  Reports the number of dropped packets iff the kernel supports
- *  the PACKET_STATISTICS "getsockopt()" argument (2.4 and later
+ * Send a batch of packets with as few system calls as we can; see
+ * struct pcap_inject_vec in pcap-int.h for what we return.
+ */
+#define INJECT_MMSG_MAX	64
+
+static int
+pcap_inject_batch_linux(pcap_t *handle, const struct pcap_inject_vec *vec,
+    int n)
+{
+	struct mmsghdr msgs[INJECT_MMSG_MAX];
+	struct iovec iov[INJECT_MMSG_MAX];
+	int sent = 0, chunk, i, ret;
+
+	if (linux_check_inject(handle) == -1)
+		return (-1);
+
+	while (sent < n) {
+		chunk = n - sent;
+		if (chunk > INJECT_MMSG_MAX)
+			chunk = INJECT_MMSG_MAX;
+		memset(msgs, 0, chunk * sizeof(msgs[0]));
+		for (i = 0; i < chunk; i++) {
+			iov[i].iov_base = (void *)vec[sent + i].buf;
+			iov[i].iov_len = vec[sent + i].size;
+			msgs[i].msg_hdr.msg_iov = &iov[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+		}
+		ret = sendmmsg(handle->fd, msgs, chunk, 0);
+		if (ret == -1) {
+			if (errno == EINTR)
+				continue;
+			if (errno == ENOBUFS || errno == EAGAIN)
+				break;
+			if (sent != 0)
+				break;
+			snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+			    "sendmmsg: %s", pcap_strerror(errno));
+			return (-1);
+		}
+		sent += ret;
+		if (ret < chunk)
+			break;
+	}
+	return (sent);
+}
+#endif /* HAVE_SENDMMSG */
+
+/*
+ *  Update the running statistics for the given packet capture handle.
+ *  Returns 1 if the kernel supplied packet counts, 0 if it doesn't
+ *  support the PACKET_STATISTICS "getsockopt()" argument (2.4 and later
  *  kernels, and 2.2[.x] kernels with Alexey Kuznetzov's turbopacket
- *  patches); otherwise, that information isn't available, and we lie
- *  and report 0 as the count of dropped packets.
+ *  patches, do), and -1 on an error.
  */
 static int
-pcap_stats_linux(pcap_t *handle, struct pcap_stat *stats)
+linux_update_stats(pcap_t *handle)
 {
 #ifdef HAVE_TPACKET_STATS
 	struct tpacket_stats kstats;
@@ -1753,7 +2216,7 @@ pcap_stats_linux(pcap_t *handle, struct pcap_stat *stats)
 	{
 		if_dropped = handle->md.proc_dropped;
 		handle->md.proc_dropped = linux_if_drops(handle->md.device);
-		handle->md.stat.ps_ifdrop += (handle->md.proc_dropped - if_dropped);
+		handle->md.if_drop += (handle->md.proc_dropped - if_dropped);
 	}
 
 #ifdef HAVE_TPACKET_STATS
@@ -1809,10 +2272,9 @@ pcap_stats_linux(pcap_t *handle, struct pcap_stat *stats)
 		 *    getsockopt(handle->fd, SOL_PACKET, PACKET_STATISTICS, ....
 		 * resets the counters to zero.
 		 */
-		handle->md.stat.ps_recv += kstats.tp_packets;
-		handle->md.stat.ps_drop += kstats.tp_drops;
-		*stats = handle->md.stat;
-		return 0;
+		handle->md.kern_recv += kstats.tp_packets;
+		handle->md.kern_drop += kstats.tp_drops;
+		return 1;
 	}
 	else
 	{
@@ -1830,6 +2292,35 @@ pcap_stats_linux(pcap_t *handle, struct pcap_stat *stats)
 		}
 	}
 #endif
+	return 0;
+}
+
+/*
+ *  Get the statistics for the given packet capture handle.
+ *  Reports the number of dropped packets iff the kernel supports
+ *  the PACKET_STATISTICS "getsockopt()" argument; otherwise, that
+ *  information isn't available, and we lie and report 0 as the count
+ *  of dropped packets.
+ */
+static int
+pcap_stats_linux(pcap_t *handle, struct pcap_stat *stats)
+{
+	switch (linux_update_stats(handle)) {
+
+	case -1:
+		return -1;
+
+	case 1:
+		/*
+		 * The running totals are 64-bit; pcap_stats() reports
+		 * them modulo 2^32.
+		 */
+		stats->ps_recv = (u_int)handle->md.kern_recv;
+		stats->ps_drop = (u_int)handle->md.kern_drop;
+		stats->ps_ifdrop = (u_int)handle->md.if_drop;
+		return 0;
+	}
+
 	/*
 	 * On systems where the PACKET_STATISTICS "getsockopt()" argument
 	 * is not supported on PF_PACKET sockets:
@@ -1855,12 +2346,52 @@ pcap_stats_linux(pcap_t *handle, struct pcap_stat *stats)
 	 * how many the interface dropped, so we can return that.
 	 */
 	 
-	stats->ps_recv = handle->md.packets_read;
+	stats->ps_recv = (u_int)handle->md.packets_read;
 	stats->ps_drop = 0;
-	stats->ps_ifdrop = handle->md.stat.ps_ifdrop;
+	stats->ps_ifdrop = (u_int)handle->md.if_drop;
+	return 0;
+}
+
+/*
+ *  Get the extended statistics for the given packet capture handle,
+ *  with 64-bit counts and, for a memory-mapped capture, the state of
+ *  the ring.
+ */
+static int
+pcap_stats_ex_linux(pcap_t *handle, struct pcap_stat_ex *stats)
+{
+	int status;
+
+	status = linux_update_stats(handle);
+	if (status == -1)
+		return -1;
+
+	memset(stats, 0, sizeof(*stats));
+	if (status == 1) {
+		stats->ps_recv = handle->md.kern_recv;
+		stats->ps_drop = handle->md.kern_drop;
+	} else
+		stats->ps_recv = handle->md.packets_read;
+	stats->ps_ifdrop = handle->md.if_drop;
+	stats->ps_accepted = handle->md.packets_read;
+	stats->ps_filtered = handle->md.packets_filtered;
+#ifdef HAVE_PACKET_RING
+	if (handle->md.mmapbuf != NULL) {
+		stats->ps_ring_full = handle->md.ring_full;
+		stats->ps_ring_used = linux_ring_used(handle);
+		stats->ps_ring_size = handle->cc;
+	}
+	if (handle->md.delay_hist != NULL)
+		stats->ps_delay_p99 = linux_delay_p99(handle);
+	stats->ps_spin_ns = handle->md.spin_ns;
+	stats->ps_sleeps = handle->md.sleeps;
+	stats->ps_overload_on = handle->md.overload_on;
+	stats->ps_overload_off = handle->md.overload_off;
+#endif
 	return 0;
 }
 
+#ifndef HAVE_NETLINK_FINDALLDEVS
 /*
  * Get from "/sys/class/net" all interfaces listed there; if they're
  * already in the list of interfaces we have, that won't add another
@@ -2193,6 +2724,8 @@ scan_proc_net_dev(pcap_if_t **devlistp, char *errbuf)
 	return (ret);
 }
 
+#endif /* HAVE_NETLINK_FINDALLDEVS */
+
 /*
  * Description string for the "any" device.
  */
@@ -2201,6 +2734,7 @@ static const char any_descr[] = "Pseudo-device that captures on all interfaces";
 int
 pcap_platform_finddevs(pcap_if_t **alldevsp, char *errbuf)
 {
+#ifndef HAVE_NETLINK_FINDALLDEVS
 	int ret;
 
 	/*
@@ -2210,6 +2744,9 @@ pcap_platform_finddevs(pcap_if_t **alldevsp, char *errbuf)
 	 * and even getifaddrs() won't return information about
 	 * interfaces with no addresses, so you need to read "/sys/class/net"
 	 * to get the names of the rest of the interfaces.
+	 *
+	 * If we got the interfaces from rtnetlink, we already have all
+	 * of them, so we don't need to do this.
 	 */
 	ret = scan_sys_class_net(alldevsp, errbuf);
 	if (ret == -1)
@@ -2221,6 +2758,7 @@ pcap_platform_finddevs(pcap_if_t **alldevsp, char *errbuf)
 		if (scan_proc_net_dev(alldevsp, errbuf) == -1)
 			return (-1);
 	}
+#endif /* HAVE_NETLINK_FINDALLDEVS */
 
 	/*
 	 * Add the "any" device.
@@ -2379,6 +2917,26 @@ pcap_setfilter_linux_common(pcap_t *handle, struct bpf_program *filter,
 	if (!handle->md.use_bpf)
 		reset_kernel_filter(handle);
 
+	/*
+	 * Whatever filter we were shedding load with has now been
+	 * replaced.  If we may have to shed load later, keep the
+	 * kernel's version of the new filter, so that we can build
+	 * the filter to shed load with from it and put it back after.
+	 */
+	if (handle->md.overloaded) {
+		handle->md.overloaded = 0;
+		handle->md.overload_off++;
+	}
+	if (handle->md.kern_insns != NULL) {
+		free(handle->md.kern_insns);
+		handle->md.kern_insns = NULL;
+	}
+	if (handle->md.use_bpf && handle->opt.overload_high > 0) {
+		handle->md.kern_insns = (struct bpf_insn *)fcode.filter;
+		handle->md.kern_len = fcode.len;
+		fcode.filter = NULL;
+	}
+
 	/*
 	 * Free up the copy of the filter that was made by "fix_program()".
 	 */
@@ -3209,12 +3767,42 @@ activate_new(pcap_t *handle)
  */
 static int 
 activate_mmap(pcap_t *handle, int *status)
+{
+	int ret;
+	struct numa_policy policy;
+	const char *ring;
+
+	/*
+	 * PCAP_LINUX_RING=none turns off memory-mapped capture, so that
+	 * its performance can be compared with that of the other modes.
+	 */
+	ring = getenv("PCAP_LINUX_RING");
+	if (ring != NULL && strcmp(ring, "none") == 0)
+		return 0;
+
+	/*
+	 * If asked, allocate the ring and the buffers we use with it
+	 * on the NUMA node the device is attached to, so that the
+	 * device and we aren't reaching across nodes for packets.
+	 */
+	policy.saved = 0;
+	if (handle->opt.numa_local)
+		linux_prefer_numa_node(linux_if_numa_node(handle->md.device),
+		    &policy);
+	ret = activate_mmap_ring(handle, status);
+	linux_restore_numa_policy(&policy);
+	return ret;
+}
+
+static int
+activate_mmap_ring(pcap_t *handle, int *status)
 {
 	int ret;
 
 	/*
 	 * Attempt to allocate a buffer to hold the contents of one
-	 * packet, for use by the oneshot callback.
+	 * packet, for use by the oneshot callback; touch it, so that
+	 * it's allocated now, under the memory policy set above.
 	 */
 	handle->md.oneshot_buffer = malloc(handle->snapshot);
 	if (handle->md.oneshot_buffer == NULL) {
@@ -3224,6 +3812,7 @@ activate_mmap(pcap_t *handle, int *status)
 		*status = PCAP_ERROR;
 		return -1;
 	}
+	memset(handle->md.oneshot_buffer, 0, handle->snapshot);
 
 	if (handle->opt.buffer_size == 0) {
 		/* by default request 2M for the ring buffer */
@@ -3252,6 +3841,19 @@ activate_mmap(pcap_t *handle, int *status)
 		free(handle->md.oneshot_buffer);
 		return -1;
 	}
+	if (handle->opt.ring_lock && linux_lock_ring(handle) == -1) {
+		destroy_ring(handle);
+		free(handle->md.oneshot_buffer);
+		*status = PCAP_ERROR;
+		return -1;
+	}
+	if (handle->opt.busy_poll > 0 &&
+	    linux_busy_poll_init(handle) == -1) {
+		destroy_ring(handle);
+		free(handle->md.oneshot_buffer);
+		*status = PCAP_ERROR;
+		return -1;
+	}
 
 	/*
 	 * Success.  *status has been set either to 0 if there are no
@@ -3291,12 +3893,21 @@ prepare_tpacket_socket(pcap_t *handle)
 #ifdef HAVE_TPACKET2
 	socklen_t len;
 	int val;
+	const char *ring;
 #endif
 
 	handle->md.tp_version = TPACKET_V1;
 	handle->md.tp_hdrlen = sizeof(struct tpacket_hdr);
 
 #ifdef HAVE_TPACKET2
+	/*
+	 * PCAP_LINUX_RING=v1 sticks to version 1, as with kernels that
+	 * don't have version 2.
+	 */
+	ring = getenv("PCAP_LINUX_RING");
+	if (ring != NULL && strcmp(ring, "v1") == 0)
+		return 1;
+
 	/* Probe whether kernel supports TPACKET_V2 */
 	val = TPACKET_V2;
 	len = sizeof(val);
@@ -3660,11 +4271,51 @@ retry:
 		}
 	}
 
+	/*
+	 * All the frames belong to the kernel, so they'll only get
+	 * packets that passed the current filter.
+	 */
+	handle->md.filter_gen = 0;
+	handle->md.frame_gen = calloc(handle->cc,
+	    sizeof(*handle->md.frame_gen));
+	if (!handle->md.frame_gen) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "can't allocate ring of frame generations: %s",
+		    pcap_strerror(errno));
+
+		destroy_ring(handle);
+		*status = PCAP_ERROR;
+		return -1;
+	}
+
 	handle->bufsize = req.tp_frame_size;
 	handle->offset = 0;
 	return 1;
 }
 
+/*
+ * Fault in and lock the ring and the buffers we read it with, so that
+ * we don't take page faults on them when the first bursts of traffic
+ * come in, and they're never paged out.  The kernel maps all of the
+ * ring's pages in when it's mmapped, and never pages them out, so this
+ * matters most for our own buffers; they're unlocked when they're
+ * freed or unmapped.
+ */
+static int
+linux_lock_ring(pcap_t *handle)
+{
+	if (mlock(handle->md.mmapbuf, handle->md.mmapbuflen) == -1 ||
+	    mlock(handle->buffer, handle->cc * sizeof(union thdr *)) == -1 ||
+	    mlock(handle->md.frame_gen,
+	      handle->cc * sizeof(*handle->md.frame_gen)) == -1 ||
+	    mlock(handle->md.oneshot_buffer, handle->snapshot) == -1) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "can't lock rx ring in memory: %s", pcap_strerror(errno));
+		return -1;
+	}
+	return 0;
+}
+
 /* free all ring related resources*/
 static void
 destroy_ring(pcap_t *handle)
@@ -3681,6 +4332,11 @@ destroy_ring(pcap_t *handle)
 		munmap(handle->md.mmapbuf, handle->md.mmapbuflen);
 		handle->md.mmapbuf = NULL;
 	}
+
+	if (handle->md.frame_gen) {
+		free(handle->md.frame_gen);
+		handle->md.frame_gen = NULL;
+	}
 }
 
 /*
@@ -3776,6 +4432,333 @@ pcap_get_ring_frame(pcap_t *handle, int status)
 	return h.raw;
 }
 
+/*
+ * Has the kernel handed the frame at "offset" in the ring to us?
+ */
+static int
+linux_ring_frame_full(pcap_t *handle, int offset)
+{
+	union thdr h;
+
+	h.raw = ((union thdr **)handle->buffer)[offset];
+	switch (handle->md.tp_version) {
+	case TPACKET_V1:
+		return (h.h1->tp_status != TP_STATUS_KERNEL);
+#ifdef HAVE_TPACKET2
+	case TPACKET_V2:
+		return (h.h2->tp_status != TP_STATUS_KERNEL);
+#endif
+	}
+	return 0;
+}
+
+/*
+ * Count the frames that are waiting for us to read them.
+ */
+static int
+linux_ring_used(pcap_t *handle)
+{
+	int offset = handle->offset;
+	int n;
+
+	for (n = 0; n < handle->cc; n++) {
+		if (!linux_ring_frame_full(handle, offset))
+			break;
+		if (++offset >= handle->cc)
+			offset = 0;
+	}
+	return n;
+}
+
+/*
+ * Start shedding load: replace the kernel filter with one that also
+ * keeps only one packet in opt.overload_sample and cuts the packets it
+ * keeps to opt.overload_snaplen bytes.  We can only cut packets short
+ * if the whole filter runs in the kernel, as a userland filter might
+ * look past the new end of the packet.
+ */
+static int
+linux_overload_start(pcap_t *handle)
+{
+#ifdef SO_ATTACH_FILTER
+	struct sock_fprog fcode;
+	struct bpf_insn *insns, *p;
+	u_int len, i;
+	u_int snaplen = handle->opt.overload_snaplen;
+	int sample = handle->opt.overload_sample;
+	int have_kern = handle->md.use_bpf && handle->md.kern_insns != NULL;
+	int ret;
+
+	if (!have_kern && handle->fcode.bf_insns != NULL)
+		snaplen = 0;
+	if (snaplen == 0 && sample <= 1)
+		return 0;	/* nothing to shed */
+
+	len = have_kern ? handle->md.kern_len : 1;
+	if (sample > 1)
+		len += 3;
+	insns = malloc(len * sizeof(*insns));
+	if (insns == NULL) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "can't allocate load shedding filter: %s",
+		    pcap_strerror(errno));
+		return -1;
+	}
+	p = insns;
+	if (sample > 1) {
+		/*
+		 * Reject the packet unless a random number is below
+		 * 1/sample of its range; the original filter follows,
+		 * and, as jumps are relative, works unchanged.
+		 */
+		p->code = BPF_LD|BPF_W|BPF_ABS;
+		p->jt = p->jf = 0;
+		p->k = BPF_AD_RANDOM;
+		p++;
+		p->code = BPF_JMP|BPF_JGE|BPF_K;
+		p->jt = 0;
+		p->jf = 1;
+		p->k = (bpf_u_int32)(((u_int64_t)1 << 32) / sample);
+		p++;
+		p->code = BPF_RET|BPF_K;
+		p->jt = p->jf = 0;
+		p->k = 0;
+		p++;
+	}
+	if (have_kern) {
+		memcpy(p, handle->md.kern_insns,
+		    handle->md.kern_len * sizeof(*insns));
+		for (i = 0; i < handle->md.kern_len; i++, p++) {
+			if (snaplen != 0 && p->code == (BPF_RET|BPF_K) &&
+			    p->k > snaplen)
+				p->k = snaplen;
+		}
+	} else {
+		p->code = BPF_RET|BPF_K;
+		p->jt = p->jf = 0;
+		p->k = snaplen != 0 && snaplen < (u_int)handle->snapshot ?
+		    snaplen : (u_int)handle->snapshot;
+	}
+
+	/*
+	 * Attaching a filter replaces the old one in one step, and
+	 * the packets already in the ring passed a filter at least as
+	 * permissive as this one, so there's nothing to drain.
+	 */
+	fcode.len = len;
+	fcode.filter = (struct sock_filter *)insns;
+	ret = setsockopt(handle->fd, SOL_SOCKET, SO_ATTACH_FILTER,
+	    &fcode, sizeof(fcode));
+	free(insns);
+	if (ret == -1) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "can't attach load shedding filter: %s",
+		    pcap_strerror(errno));
+		return -1;
+	}
+	handle->md.overloaded = 1;
+	handle->md.overload_on++;
+#endif
+	return 0;
+}
+
+/*
+ * Stop shedding load: put back the filter the application set, or
+ * none, if it didn't set one that runs in the kernel.
+ */
+static int
+linux_overload_stop(pcap_t *handle)
+{
+#ifdef SO_ATTACH_FILTER
+	struct sock_fprog fcode;
+	int ret;
+
+	if (handle->md.use_bpf && handle->md.kern_insns != NULL) {
+		fcode.len = handle->md.kern_len;
+		fcode.filter = (struct sock_filter *)handle->md.kern_insns;
+		ret = setsockopt(handle->fd, SOL_SOCKET, SO_ATTACH_FILTER,
+		    &fcode, sizeof(fcode));
+	} else
+		ret = reset_kernel_filter(handle);
+	if (ret == -1) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "can't restore filter after shedding load: %s",
+		    pcap_strerror(errno));
+		return -1;
+	}
+	handle->md.overloaded = 0;
+	handle->md.overload_off++;
+#endif
+	return 0;
+}
+
+/*
+ * Start or stop shedding load as the ring fills up or drains.  The
+ * kernel fills frames in order starting at the one we'll read next, so
+ * the ring is at least "n" frames full if the "n"th frame from there
+ * is full, and at most "n" frames full if the frame after that is
+ * empty; that means we only look at one frame.
+ */
+static int
+linux_check_overload(pcap_t *handle)
+{
+	int mark;
+
+	if (!handle->md.overloaded) {
+		mark = handle->cc * handle->opt.overload_high / 100;
+		if (mark < 1)
+			mark = 1;
+		if (linux_ring_frame_full(handle,
+		    (handle->offset + mark - 1) % handle->cc))
+			return linux_overload_start(handle);
+	} else {
+		mark = handle->cc * handle->opt.overload_low / 100;
+		if (mark >= handle->cc)
+			mark = handle->cc - 1;
+		if (!linux_ring_frame_full(handle,
+		    (handle->offset + mark) % handle->cc))
+			return linux_overload_stop(handle);
+	}
+	return 0;
+}
+
+/*
+ * Tell the CPU we're spinning, so that it can save power and let other
+ * hardware threads on the core run; this also keeps the compiler from
+ * hoisting reads of the ring status words out of the spin loop.
+ */
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define linux_cpu_relax()	__asm__ __volatile__("pause" ::: "memory")
+#elif defined(__GNUC__) && (defined(__aarch64__) || defined(__arm__))
+#define linux_cpu_relax()	__asm__ __volatile__("yield" ::: "memory")
+#else
+#define linux_cpu_relax()	__asm__ __volatile__("" ::: "memory")
+#endif
+
+/*
+ * Delivery delays are kept in a log-linear histogram: values below 8
+ * nanoseconds each get their own bucket, and every power of 2 above
+ * that is split into 8 buckets, so a percentile is accurate to within
+ * 12.5%.
+ */
+#define DELAY_HIST_BUCKETS	(62 * 8)
+
+static int
+linux_busy_poll_init(pcap_t *handle)
+{
+#ifdef SO_BUSY_POLL
+	int usec = handle->opt.busy_poll;
+
+	/*
+	 * Ask the driver to poll the device queue for us as well;
+	 * this requires CAP_NET_ADMIN to go past the system default
+	 * and not all drivers support it, so failure is harmless.
+	 */
+	(void)setsockopt(handle->fd, SOL_SOCKET, SO_BUSY_POLL, &usec,
+	    sizeof(usec));
+#endif
+	handle->md.delay_hist = calloc(DELAY_HIST_BUCKETS,
+	    sizeof(*handle->md.delay_hist));
+	if (handle->md.delay_hist == NULL) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+			 "can't allocate delay histogram: %s",
+			 pcap_strerror(errno));
+		return -1;
+	}
+	return 0;
+}
+
+/*
+ * Spin, for at most the busy-poll time, waiting for the kernel to hand
+ * us the frame at the current position in the ring.  Returns 1 if it
+ * did and 0 if it didn't or if pcap_breakloop() was called, in which
+ * case the caller should fall back on sleeping in poll().
+ */
+static int
+linux_busy_poll(pcap_t *handle)
+{
+	struct timespec start, now;
+	u_int64_t limit, elapsed;
+	int i, ret = 0;
+
+	limit = (u_int64_t)handle->opt.busy_poll * 1000;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (;;) {
+		/*
+		 * Only look at the clock every so often; the status
+		 * word is in our cache until the kernel writes it.
+		 */
+		for (i = 0; i < 64; i++) {
+			if (pcap_get_ring_frame(handle, TP_STATUS_USER)) {
+				ret = 1;
+				break;
+			}
+			if (handle->break_loop)
+				break;
+			linux_cpu_relax();
+		}
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		elapsed = (u_int64_t)(now.tv_sec - start.tv_sec) * 1000000000 +
+		    now.tv_nsec - start.tv_nsec;
+		if (i < 64 || elapsed >= limit)
+			break;
+	}
+	handle->md.spin_ns += elapsed;
+	return ret;
+}
+
+/*
+ * Record how long after the given time stamp a packet was handed to
+ * the callback.
+ */
+static void
+linux_record_delay(pcap_t *handle, u_int sec, u_int nsec)
+{
+	struct timespec now;
+	u_int64_t ts, delay;
+	u_int bucket;
+	int msb;
+
+	clock_gettime(CLOCK_REALTIME, &now);
+	ts = (u_int64_t)sec * 1000000000 + nsec;
+	delay = (u_int64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+	delay = delay > ts ? delay - ts : 0;
+	if (delay < 8)
+		bucket = delay;
+	else {
+		msb = 63 - __builtin_clzll(delay);
+		bucket = (msb - 2) * 8 + ((delay >> (msb - 3)) & 7);
+	}
+	handle->md.delay_hist[bucket]++;
+}
+
+/*
+ * Return the upper bound of the histogram bucket that holds the 99th
+ * percentile of the delivery delays, or 0 if there aren't any.
+ */
+static u_int64_t
+linux_delay_p99(pcap_t *handle)
+{
+	u_int64_t total = 0, count = 0, need;
+	u_int bucket;
+	int msb;
+
+	for (bucket = 0; bucket < DELAY_HIST_BUCKETS; bucket++)
+		total += handle->md.delay_hist[bucket];
+	if (total == 0)
+		return 0;
+	need = total - total / 100;
+	for (bucket = 0; bucket < DELAY_HIST_BUCKETS; bucket++) {
+		count += handle->md.delay_hist[bucket];
+		if (count >= need)
+			break;
+	}
+	if (bucket < 8)
+		return bucket;
+	msb = bucket / 8 + 2;
+	return ((u_int64_t)(9 + bucket % 8) << (msb - 3)) - 1;
+}
+
 #ifndef POLLRDHUP
 #define POLLRDHUP 0
 #endif
@@ -3788,13 +4771,25 @@ pcap_read_linux_mmap(pcap_t *handle, int max_packets, pcap_handler callback,
 	int pkts = 0;
 	char c;
 
-	/* wait for frames availability.*/
-	if (!pcap_get_ring_frame(handle, TP_STATUS_USER)) {
-		struct pollfd pollinfo;
-		int ret;
+	if (handle->opt.capture_cpu >= 0 && !handle->md.reader_pinned &&
+	    pcap_pin_reader(handle) == -1)
+		return PCAP_ERROR;
 
-		pollinfo.fd = handle->fd;
-		pollinfo.events = POLLIN;
+	/*
+	 * Wait for frames availability; in busy-poll mode, spin for a
+	 * while before going to sleep.
+	 */
+	if (!pcap_get_ring_frame(handle, TP_STATUS_USER) &&
+	    !(handle->opt.busy_poll > 0 && handle->md.timeout >= 0 &&
+	      linux_busy_poll(handle))) {
+		struct pollfd pollinfo, pollfds[2];
+		int ret, nfds;
+
+		pollfds[0].fd = handle->fd;
+		pollfds[0].events = POLLIN;
+		pollfds[1].fd = handle->md.breakloop_rfd;
+		pollfds[1].events = POLLIN;
+		nfds = handle->md.breakloop_rfd != -1 ? 2 : 1;
 
 		if (handle->md.timeout == 0)
 			timeout = -1;	/* block forever */
@@ -3802,8 +4797,25 @@ pcap_read_linux_mmap(pcap_t *handle, int max_packets, pcap_handler callback,
 			timeout = handle->md.timeout;	/* block for that amount of time */
 		else
 			timeout = 0;	/* non-blocking mode - poll to pick up errors */
+		if (handle->opt.busy_poll > 0 && timeout != 0)
+			handle->md.sleeps++;
 		do {
-			ret = poll(&pollinfo, 1, timeout);
+			ret = poll(pollfds, nfds, timeout);
+			pollinfo = pollfds[0];
+			if (ret > 0 && nfds == 2 &&
+			    (pollfds[1].revents & POLLIN)) {
+				/*
+				 * pcap_breakloop() was called, either
+				 * now or since we last waited; in the
+				 * latter case, just wait again.
+				 */
+				pcap_breakloop_fd_drain(handle);
+				if (!handle->break_loop &&
+				    !(pollinfo.revents & POLLIN)) {
+					ret = -1;
+					continue;
+				}
+			}
 			if (ret < 0 && errno != EINTR) {
 				snprintf(handle->errbuf, PCAP_ERRBUF_SIZE, 
 					"can't poll on packet socket: %s",
@@ -3869,6 +4881,20 @@ pcap_read_linux_mmap(pcap_t *handle, int max_packets, pcap_handler callback,
 		} while (ret < 0);
 	}
 
+	/*
+	 * If the frame before the one we're about to read has also been
+	 * filled, the kernel has gone all the way around the ring, so
+	 * it was full, and packets arriving since then may have been
+	 * dropped.
+	 */
+	if (linux_ring_frame_full(handle, handle->offset == 0 ?
+	    handle->cc - 1 : handle->offset - 1))
+		handle->md.ring_full++;
+
+	if (handle->opt.overload_high > 0 &&
+	    linux_check_overload(handle) == -1)
+		return PCAP_ERROR;
+
 	/* non-positive values of max_packets are used to require all 
 	 * packets currently available in the ring */
 	while ((pkts < max_packets) || (max_packets <= 0)) {
@@ -3882,6 +4908,7 @@ pcap_read_linux_mmap(pcap_t *handle, int max_packets, pcap_handler callback,
 		unsigned int tp_snaplen;
 		unsigned int tp_sec;
 		unsigned int tp_usec;
+		unsigned int tp_nsec;
 
 		h.raw = pcap_get_ring_frame(handle, TP_STATUS_USER);
 		if (!h.raw)
@@ -3894,6 +4921,7 @@ pcap_read_linux_mmap(pcap_t *handle, int max_packets, pcap_handler callback,
 			tp_snaplen = h.h1->tp_snaplen;
 			tp_sec	   = h.h1->tp_sec;
 			tp_usec	   = h.h1->tp_usec;
+			tp_nsec	   = tp_usec * 1000;
 			break;
 #ifdef HAVE_TPACKET2
 		case TPACKET_V2:
@@ -3902,6 +4930,7 @@ pcap_read_linux_mmap(pcap_t *handle, int max_packets, pcap_handler callback,
 			tp_snaplen = h.h2->tp_snaplen;
 			tp_sec	   = h.h2->tp_sec;
 			tp_usec	   = h.h2->tp_nsec / 1000;
+			tp_nsec	   = h.h2->tp_nsec;
 			break;
 #endif
 		default:
@@ -3920,21 +4949,22 @@ pcap_read_linux_mmap(pcap_t *handle, int max_packets, pcap_handler callback,
 		}
 
 		/* run filter on received packet
-		 * If the kernel filtering is enabled we need to run the
-		 * filter until all the frames present into the ring 
-		 * at filter creation time are processed. 
-		 * In such case md.use_bpf is used as a counter for the 
-		 * packet we need to filter.
-		 * Note: alternatively it could be possible to stop applying 
-		 * the filter when the ring became empty, but it can possibly
-		 * happen a lot later... */
+		 * If the kernel filtering is enabled we still need to run
+		 * the filter on frames that were in the ring when the
+		 * filter was set, as they passed the old filter, if any;
+		 * those are the frames that don't have the generation
+		 * of the current filter.  See pcap_setfilter_linux_mmap(). */
 		bp = (unsigned char*)h.raw + tp_mac;
-		run_bpf = (!handle->md.use_bpf) || 
-			((handle->md.use_bpf>1) && handle->md.use_bpf--);
+		run_bpf = (!handle->md.use_bpf) ||
+			(handle->md.frame_gen[handle->offset] !=
+			    handle->md.filter_gen) ||
+			linux_predates_swap(handle, tp_sec, tp_usec);
 		if (run_bpf && handle->fcode.bf_insns && 
-				(bpf_filter(handle->fcode.bf_insns, bp,
-					tp_len, tp_snaplen) == 0))
+				!pcap_filter_packet(handle->fcode.bf_insns, bp,
+					tp_len, &tp_snaplen)) {
+			handle->md.packets_filtered++;
 			goto skip;
+		}
 
 		/*
 		 * Do checks based on packet direction.
@@ -4051,11 +5081,15 @@ pcap_read_linux_mmap(pcap_t *handle, int max_packets, pcap_handler callback,
 
 		/* pass the packet to the user */
 		pkts++;
+		if (handle->md.delay_hist != NULL &&
+		    handle->opt.tstamp_type != PCAP_TSTAMP_ADAPTER_UNSYNCED)
+			linux_record_delay(handle, tp_sec, tp_nsec);
 		callback(user, &pcaphdr, bp);
 		handle->md.packets_read++;
 
 skip:
 		/* next packet */
+		handle->md.frame_gen[handle->offset] = handle->md.filter_gen;
 		switch (handle->md.tp_version) {
 		case TPACKET_V1:
 			h.h1->tp_status = TP_STATUS_KERNEL;
@@ -4075,13 +5109,21 @@ skip:
 			return PCAP_ERROR_BREAK;
 		}
 	}
+
+	/*
+	 * Now that we've caught up, see whether we can stop shedding
+	 * load.
+	 */
+	if (handle->opt.overload_high > 0 &&
+	    linux_check_overload(handle) == -1)
+		return PCAP_ERROR;
 	return pkts;
 }
 
 static int 
 pcap_setfilter_linux_mmap(pcap_t *handle, struct bpf_program *filter)
 {
-	int n, offset;
+	int i, offset;
 	int ret;
 
 	/*
@@ -4094,28 +5136,24 @@ pcap_setfilter_linux_mmap(pcap_t *handle, struct bpf_program *filter)
 	if (ret < 0)
 		return ret;
 
-	/* if the kernel filter is enabled, we need to apply the filter on
-	 * all packets present into the ring. Get an upper bound of their number
+	/*
+	 * Start a new filter generation.  The frames the kernel owns
+	 * will be filled with packets that passed the new filter, so
+	 * they're in the new generation; the frames we haven't read
+	 * yet keep the generation they had, so that, if the kernel
+	 * filter is enabled, we apply the new filter to them when we
+	 * read them.
 	 */
-	if (!handle->md.use_bpf)
-		return ret;
-
-	/* walk the ring backward and count the free slot */
+	handle->md.filter_gen++;
 	offset = handle->offset;
-	if (--handle->offset < 0)
-		handle->offset = handle->cc - 1;
-	for (n=0; n < handle->cc; ++n) {
-		if (--handle->offset < 0)
-			handle->offset = handle->cc - 1;
-		if (!pcap_get_ring_frame(handle, TP_STATUS_KERNEL))
-			break;
+	for (i = 0; i < handle->cc; ++i) {
+		handle->offset = i;
+		if (pcap_get_ring_frame(handle, TP_STATUS_KERNEL))
+			handle->md.frame_gen[i] = handle->md.filter_gen;
 	}
 
 	/* be careful to not change current ring position */
 	handle->offset = offset;
-
-	/* store the number of packets currently present in the ring */
-	handle->md.use_bpf = 1 + (handle->cc - n);
 	return ret;
 }
 
@@ -5356,7 +6394,7 @@ fix_program(pcap_t *handle, struct sock_fprog *fcode, int is_mmapped)
 				 * rather than the contents of the
 				 * accumulator?
 				 */
-				if (BPF_MODE(p->code) == BPF_K) {
+				if (BPF_RVAL(p->code) == BPF_K) {
 					/*
 					 * Yes - if the value to be returned,
 					 * i.e. the snapshot length, is
@@ -5364,15 +6402,22 @@ fix_program(pcap_t *handle, struct sock_fprog *fcode, int is_mmapped)
 					 * 65535, so that the packet is
 					 * truncated by "recvfrom()",
 					 * not by the filter.
-					 *
-					 * XXX - there's nothing we can
-					 * easily do if it's getting the
-					 * value from the accumulator; we'd
-					 * have to insert code to force
-					 * non-zero values to be 65535.
 					 */
 					if (p->k != 0)
 						p->k = 65535;
+				} else {
+					/*
+					 * No - it's getting the value from
+					 * the accumulator, as "headers-only"
+					 * programs do.  If the kernel trimmed
+					 * the packet to that length,
+					 * "recvfrom()" would hand us the
+					 * trimmed length as the on-the-wire
+					 * length, so punt to userland, where
+					 * the filter's return value cuts
+					 * only the captured length.
+					 */
+					return 0;
 				}
 			}
 			break;
@@ -5419,7 +6464,15 @@ fix_offset(struct bpf_insn *p)
 	/*
 	 * What's the offset?
 	 */
-	if (p->k >= SLL_HDR_LEN) {
+	if ((bpf_int32)(p->k) < 0) {
+		/*
+		 * It's a negative offset, such as BPF_AD_RANDOM;
+		 * those refer to ancillary data rather than to the
+		 * packet, so they mean the same thing in cooked
+		 * mode, and must be left alone.
+		 */
+		return 0;
+	} else if (p->k >= SLL_HDR_LEN) {
 		/*
 		 * It's within the link-layer payload; that starts at an
 		 * offset of 0, as far as the kernel packet filter is
@@ -5439,7 +6492,7 @@ fix_offset(struct bpf_insn *p)
 		 * kernel offset for that field.
 		 */
 		p->k = SKF_AD_OFF + SKF_AD_PROTOCOL;
-	} else if ((bpf_int32)(p->k) > 0) {
+	} else {
 		/*
 		 * It's within the header, but it's not one of those
 		 * fields; we can't do that in the kernel, so punt
@@ -5458,6 +6511,28 @@ set_kernel_filter(pcap_t *handle, struct sock_fprog *fcode)
 	int ret;
 	int save_errno;
 
+	if (handle->opt.filter_hotswap) {
+		/*
+		 * Attaching a filter replaces the old one in a single
+		 * step, so no packets are lost in between.  We don't
+		 * drain the socket; instead we note when we swapped,
+		 * so that packets from before then can be checked with
+		 * the new filter in userland.  That only works if the
+		 * time stamps come from the same clock as the time of
+		 * day; if they don't, we only have the ring frame
+		 * generations to go on.
+		 */
+		ret = setsockopt(handle->fd, SOL_SOCKET, SO_ATTACH_FILTER,
+				 fcode, sizeof(*fcode));
+		if (ret == 0 &&
+		    handle->opt.tstamp_type != PCAP_TSTAMP_ADAPTER_UNSYNCED) {
+			gettimeofday(&handle->md.swap_ts, NULL);
+			handle->md.swap_pending = 1;
+		}
+		return ret;
+	}
+	handle->md.swap_pending = 0;
+
 	/*
 	 * The socket filter code doesn't discard all packets queued
 	 * up on the socket when the filter is changed; this means
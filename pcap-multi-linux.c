@@ -0,0 +1,731 @@
+/*
+ * Copyright (c) 1993, 1994, 1995, 1996, 1997
+ *	The Regents of the University of California.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that: (1) source code distributions
+ * retain the above copyright notice and this paragraph in its entirety, (2)
+ * distributions including binary code include the above copyright notice and
+ * this paragraph in its entirety in the documentation or other materials
+ * provided with the distribution, and (3) all advertising materials mentioning
+ * features or use of this software display the following acknowledgement:
+ * ``This product includes software developed by the University of California,
+ * Lawrence Berkeley Laboratory and its contributors.'' Neither the name of
+ * the University nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * pcap-multi-linux.c - capture on several interfaces at once on Linux
+ *
+ * A device name made of interface names separated by commas, such as
+ * "eth0,eth1,eth2", opens a capture on each of the interfaces, with
+ * its own ring, its own kernel filter, and its native link-layer
+ * header type, and hands out the packets from all of them through one
+ * pcap_t.  Unlike the "any" device, we don't capture on interfaces
+ * that weren't asked for, and we don't replace the link-layer headers
+ * with cooked headers; all the interfaces must therefore have the same
+ * link-layer header type.
+ *
+ * We wait for packets on all the interfaces with epoll, and merge them
+ * either by taking turns reading each interface that has packets, or
+ * in time stamp order, as selected with pcap_set_merge_order().  The
+ * index of the interface on which each packet arrived is available to
+ * pcap_loop_ex() and pcap_dispatch_ex() callbacks.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "pcap-int.h"
+
+#ifdef NEED_STRERROR_H
+#include "strerror.h"
+#endif
+
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/time.h>
+#include <net/if.h>
+
+#include "pcap-multi-linux.h"
+
+/*
+ * When merging in time stamp order with no limit on the number of
+ * packets, don't stay in the read routine forever if packets keep
+ * arriving; return after this many, so that pcap_loop() gets to
+ * check for pcap_breakloop() now and then.
+ */
+#define MULTI_TSTAMP_BATCH	256
+
+/*
+ * One of the interfaces being captured on.  When merging in time stamp
+ * order, each interface has the next packet it has for us, if any,
+ * copied to a buffer, so that we can pick the earliest of them.
+ */
+struct multi_member {
+	pcap_t		*p;
+	bpf_u_int32	ifindex;	/* interface index, or 0 if unknown */
+	int		ready;		/* epoll says there's something to read */
+	int		staged;		/* hdr and buf hold its next packet */
+	struct pcap_pkthdr hdr;
+	u_char		*buf;
+};
+
+struct pcap_multi {
+	struct multi_member *members;
+	int		nmembers;
+	int		next;		/* member to read first, round-robin */
+	int		nonblock;
+	struct epoll_event *events;	/* one per member, plus breakloop */
+	u_char		*oneshot_buffer;
+};
+
+/*
+ * What the callback we hand to the member captures needs to pass the
+ * packet on to the caller's callback.
+ */
+struct multi_cb {
+	pcap_t		*handle;
+	struct multi_member *m;
+	pcap_handler	callback;
+	u_char		*user;
+};
+
+/*
+ * Copy an error from a member capture, with the interface name, to
+ * the multi-interface handle.
+ */
+static void
+multi_member_error(pcap_t *handle, pcap_t *p)
+{
+	snprintf(handle->errbuf, PCAP_ERRBUF_SIZE, "%s: %s",
+	    p->opt.source, pcap_geterr(p));
+}
+
+/*
+ * Wait up to "timeout" milliseconds (forever if it's -1) for any of the
+ * interfaces to have packets, or for pcap_breakloop() to be called,
+ * and mark the interfaces that have packets as ready.  Returns the
+ * number of ready interfaces, or -1, with handle->errbuf set, on error.
+ */
+static int
+multi_wait(pcap_t *handle, int timeout)
+{
+	struct pcap_multi *multi = handle->md.multi;
+	int n, i, ready = 0;
+
+	n = epoll_wait(handle->fd, multi->events, multi->nmembers + 1,
+	    timeout);
+	if (n == -1) {
+		if (errno == EINTR)
+			return 0;
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "epoll_wait: %s", pcap_strerror(errno));
+		return -1;
+	}
+	for (i = 0; i < n; i++) {
+		if (multi->events[i].data.u32 == (u_int32_t)multi->nmembers) {
+			/*
+			 * pcap_breakloop() was called; empty the
+			 * descriptor, and let the caller see
+			 * handle->break_loop.
+			 */
+			pcap_breakloop_fd_drain(handle);
+			continue;
+		}
+		multi->members[multi->events[i].data.u32].ready = 1;
+		ready++;
+	}
+	return ready;
+}
+
+/*
+ * Wait for packets as pcap_dispatch() does: not at all in non-blocking
+ * mode, and otherwise until the timeout expires.
+ */
+static int
+multi_wait_blocking(pcap_t *handle)
+{
+	if (handle->md.multi->nonblock)
+		return 0;
+	return multi_wait(handle,
+	    handle->md.timeout > 0 ? handle->md.timeout : -1);
+}
+
+/*
+ * Callback for member captures when merging round-robin; pass the
+ * packet straight on, and, if the callback calls pcap_breakloop() on
+ * our handle, stop the member's loop, too.
+ */
+static void
+multi_deliver(u_char *user, const struct pcap_pkthdr *h, const u_char *bytes)
+{
+	struct multi_cb *cb = (struct multi_cb *)user;
+
+	cb->handle->pkt_ifindex = cb->m->ifindex;
+	cb->handle->md.packets_read++;
+	cb->callback(cb->user, h, bytes);
+	if (cb->handle->break_loop)
+		cb->m->p->break_loop = 1;
+}
+
+static int
+multi_read_roundrobin(pcap_t *handle, int max_packets, pcap_handler callback,
+    u_char *user)
+{
+	struct pcap_multi *multi = handle->md.multi;
+	struct multi_member *m;
+	struct multi_cb cb;
+	int ready, i, k, ret;
+	int count = 0;
+
+	ready = multi_wait(handle, 0);
+	if (ready == 0 && !handle->break_loop)
+		ready = multi_wait_blocking(handle);
+	if (ready == -1)
+		return PCAP_ERROR;
+	if (handle->break_loop) {
+		handle->break_loop = 0;
+		return PCAP_ERROR_BREAK;
+	}
+
+	cb.handle = handle;
+	cb.callback = callback;
+	cb.user = user;
+	for (k = 0; k < multi->nmembers; k++) {
+		i = (multi->next + k) % multi->nmembers;
+		m = &multi->members[i];
+		if (!m->ready)
+			continue;
+		m->ready = 0;
+		cb.m = m;
+		ret = pcap_dispatch(m->p,
+		    max_packets > 0 ? max_packets - count : -1,
+		    multi_deliver, (u_char *)&cb);
+		if (ret == PCAP_ERROR_BREAK) {
+			handle->break_loop = 0;
+			return PCAP_ERROR_BREAK;
+		}
+		if (ret < 0) {
+			multi_member_error(handle, m->p);
+			return PCAP_ERROR;
+		}
+		count += ret;
+		if (max_packets > 0 && count >= max_packets) {
+			/*
+			 * Start after this interface next time, so
+			 * that one busy interface can't starve the
+			 * others.
+			 */
+			multi->next = (i + 1) % multi->nmembers;
+			return count;
+		}
+	}
+	multi->next = (multi->next + 1) % multi->nmembers;
+	return count;
+}
+
+/*
+ * Callback for member captures when merging in time stamp order; keep
+ * the packet until we know whether it's the earliest one.
+ */
+static void
+multi_stage(u_char *user, const struct pcap_pkthdr *h, const u_char *bytes)
+{
+	struct multi_member *m = (struct multi_member *)user;
+
+	m->hdr = *h;
+	memcpy(m->buf, bytes, h->caplen);
+	m->staged = 1;
+}
+
+static int
+multi_read_tstamp(pcap_t *handle, int max_packets, pcap_handler callback,
+    u_char *user)
+{
+	struct pcap_multi *multi = handle->md.multi;
+	struct multi_member *m, *first;
+	int i, ret;
+	int count = 0;
+
+	if (max_packets <= 0)
+		max_packets = MULTI_TSTAMP_BATCH;
+	if (multi_wait(handle, 0) == -1)
+		return PCAP_ERROR;
+	for (;;) {
+		if (handle->break_loop) {
+			handle->break_loop = 0;
+			return PCAP_ERROR_BREAK;
+		}
+
+		/*
+		 * Get the next packet from every interface that
+		 * doesn't have one waiting and might have one, and
+		 * find the earliest of the packets we have.
+		 */
+		first = NULL;
+		for (i = 0; i < multi->nmembers; i++) {
+			m = &multi->members[i];
+			if (!m->staged && m->ready) {
+				ret = pcap_dispatch(m->p, 1, multi_stage,
+				    (u_char *)m);
+				if (ret < 0) {
+					multi_member_error(handle, m->p);
+					return PCAP_ERROR;
+				}
+				if (ret == 0)
+					m->ready = 0;
+			}
+			if (m->staged && (first == NULL ||
+			    timercmp(&m->hdr.ts, &first->hdr.ts, <)))
+				first = m;
+		}
+
+		if (first == NULL) {
+			/*
+			 * Nothing left on any interface.
+			 */
+			if (count != 0)
+				return count;
+			ret = multi_wait_blocking(handle);
+			if (ret == -1)
+				return PCAP_ERROR;
+			if (ret == 0 && !handle->break_loop)
+				return 0;
+			continue;
+		}
+
+		first->staged = 0;
+		handle->pkt_ifindex = first->ifindex;
+		handle->md.packets_read++;
+		callback(user, &first->hdr, first->buf);
+		if (++count >= max_packets)
+			return count;
+	}
+}
+
+/*
+ * pcap_next() and pcap_next_ex() expect the packet to stay around
+ * after the callback returns, but it's in a member's ring, or in a
+ * buffer we'll reuse for that member's next packet; copy it.
+ */
+static void
+multi_oneshot(u_char *user, const struct pcap_pkthdr *h, const u_char *bytes)
+{
+	struct oneshot_userdata *sp = (struct oneshot_userdata *)user;
+
+	*sp->hdr = *h;
+	memcpy(sp->pd->md.multi->oneshot_buffer, bytes, h->caplen);
+	*sp->pkt = sp->pd->md.multi->oneshot_buffer;
+}
+
+static int
+multi_inject_linux(pcap_t *handle, const void *buf _U_, size_t size _U_)
+{
+	snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+	    "Packets can't be sent on a multi-interface capture; "
+	    "open the interface to send on by itself");
+	return (-1);
+}
+
+/*
+ * The filter, direction, and link-layer header type apply to all the
+ * interfaces; each of them does its own filtering, in the kernel if
+ * it can.
+ */
+static int
+multi_setfilter_linux(pcap_t *handle, struct bpf_program *fp)
+{
+	struct pcap_multi *multi = handle->md.multi;
+	int i;
+
+	for (i = 0; i < multi->nmembers; i++) {
+		if (pcap_setfilter(multi->members[i].p, fp) == -1) {
+			multi_member_error(handle, multi->members[i].p);
+			return (-1);
+		}
+	}
+	return (0);
+}
+
+static int
+multi_setdirection_linux(pcap_t *handle, pcap_direction_t d)
+{
+	struct pcap_multi *multi = handle->md.multi;
+	int i;
+
+	for (i = 0; i < multi->nmembers; i++) {
+		if (pcap_setdirection(multi->members[i].p, d) == -1) {
+			multi_member_error(handle, multi->members[i].p);
+			return (-1);
+		}
+	}
+	return (0);
+}
+
+static int
+multi_set_datalink_linux(pcap_t *handle, int dlt)
+{
+	struct pcap_multi *multi = handle->md.multi;
+	int i;
+
+	for (i = 0; i < multi->nmembers; i++) {
+		if (pcap_set_datalink(multi->members[i].p, dlt) == -1) {
+			multi_member_error(handle, multi->members[i].p);
+			return (-1);
+		}
+	}
+	return (0);
+}
+
+static int
+multi_getnonblock_linux(pcap_t *handle, char *errbuf _U_)
+{
+	return (handle->md.multi->nonblock);
+}
+
+static int
+multi_setnonblock_linux(pcap_t *handle, int nonblock, char *errbuf _U_)
+{
+	/*
+	 * The member captures are always in non-blocking mode; it's
+	 * epoll_wait() that blocks, or not.
+	 */
+	handle->md.multi->nonblock = nonblock;
+	return (0);
+}
+
+/*
+ * The statistics are the totals for all the interfaces.
+ */
+static int
+multi_stats_linux(pcap_t *handle, struct pcap_stat *stats)
+{
+	struct pcap_multi *multi = handle->md.multi;
+	struct pcap_stat st;
+	int i;
+
+	memset(stats, 0, sizeof(*stats));
+	for (i = 0; i < multi->nmembers; i++) {
+		if (pcap_stats(multi->members[i].p, &st) == -1) {
+			multi_member_error(handle, multi->members[i].p);
+			return (-1);
+		}
+		stats->ps_recv += st.ps_recv;
+		stats->ps_drop += st.ps_drop;
+		stats->ps_ifdrop += st.ps_ifdrop;
+	}
+	return (0);
+}
+
+static int
+multi_stats_ex_linux(pcap_t *handle, struct pcap_stat_ex *stats)
+{
+	struct pcap_multi *multi = handle->md.multi;
+	struct pcap_stat_ex st;
+	int i;
+
+	memset(stats, 0, sizeof(*stats));
+	for (i = 0; i < multi->nmembers; i++) {
+		if (pcap_stats_ex(multi->members[i].p, &st) == -1) {
+			multi_member_error(handle, multi->members[i].p);
+			return (-1);
+		}
+		stats->ps_recv += st.ps_recv;
+		stats->ps_drop += st.ps_drop;
+		stats->ps_ifdrop += st.ps_ifdrop;
+		stats->ps_accepted += st.ps_accepted;
+		stats->ps_filtered += st.ps_filtered;
+		stats->ps_ring_full += st.ps_ring_full;
+		stats->ps_ring_used += st.ps_ring_used;
+		stats->ps_ring_size += st.ps_ring_size;
+		if (st.ps_delay_p99 > stats->ps_delay_p99)
+			stats->ps_delay_p99 = st.ps_delay_p99;
+		stats->ps_spin_ns += st.ps_spin_ns;
+		stats->ps_sleeps += st.ps_sleeps;
+		stats->ps_overload_on += st.ps_overload_on;
+		stats->ps_overload_off += st.ps_overload_off;
+	}
+	return (0);
+}
+
+static void
+multi_cleanup_linux(pcap_t *handle)
+{
+	struct pcap_multi *multi = handle->md.multi;
+	int i;
+
+	if (multi != NULL) {
+		for (i = 0; i < multi->nmembers; i++) {
+			if (multi->members[i].p != NULL)
+				pcap_close(multi->members[i].p);
+			free(multi->members[i].buf);
+		}
+		free(multi->members);
+		free(multi->events);
+		free(multi->oneshot_buffer);
+		free(multi);
+		handle->md.multi = NULL;
+	}
+	pcap_breakloop_fd_close(handle);
+	pcap_cleanup_live_common(handle);
+}
+
+/*
+ * Create, set up, and activate the capture on one of the interfaces,
+ * with the options set on the multi-interface handle, and add it to
+ * the set of descriptors we wait on.  Returns the status from
+ * activating it.
+ */
+static int
+multi_open_member(pcap_t *handle, int idx, const char *name)
+{
+	struct pcap_multi *multi = handle->md.multi;
+	struct multi_member *m = &multi->members[idx];
+	struct epoll_event ev;
+	pcap_t *p;
+	int status;
+	int fd;
+
+	p = pcap_create(name, handle->errbuf);
+	if (p == NULL)
+		return PCAP_ERROR;
+	m->p = p;
+	p->oldstyle = handle->oldstyle;
+	pcap_set_snaplen(p, handle->snapshot);
+	pcap_set_promisc(p, handle->opt.promisc);
+	pcap_set_rfmon(p, handle->opt.rfmon);
+	pcap_set_timeout(p, handle->md.timeout);
+	pcap_set_buffer_size(p, handle->opt.buffer_size);
+	pcap_set_filter_hotswap(p, handle->opt.filter_hotswap);
+	pcap_set_ring_lock(p, handle->opt.ring_lock);
+	pcap_set_numa_local(p, handle->opt.numa_local);
+	pcap_set_capture_cpu(p, handle->opt.capture_cpu);
+	pcap_set_overload_watermarks(p, handle->opt.overload_high,
+	    handle->opt.overload_low);
+	pcap_set_overload_shedding(p, handle->opt.overload_snaplen,
+	    handle->opt.overload_sample);
+
+	status = pcap_activate(p);
+	if (status < 0) {
+		multi_member_error(handle, p);
+		return status;
+	}
+	if (pcap_setnonblock(p, 1, handle->errbuf) == -1)
+		return PCAP_ERROR;
+	fd = pcap_get_selectable_fd(p);
+	if (fd == -1) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "%s: can't wait for packets on the interface", name);
+		return PCAP_ERROR;
+	}
+
+	m->ifindex = if_nametoindex(name);
+	m->buf = malloc(pcap_snapshot(p));
+	if (m->buf == NULL) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "malloc: %s", pcap_strerror(errno));
+		return PCAP_ERROR;
+	}
+
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN;
+	ev.data.u32 = idx;
+	if (epoll_ctl(handle->fd, EPOLL_CTL_ADD, fd, &ev) == -1) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "epoll_ctl: %s", pcap_strerror(errno));
+		return PCAP_ERROR;
+	}
+	return status;
+}
+
+static int
+multi_activate(pcap_t *handle)
+{
+	struct pcap_multi *multi;
+	struct epoll_event ev;
+	char *names, *name, *cp;
+	const char *dlt_name0, *dlt_name;
+	int *dlt_list;
+	int ret, warning = 0;
+	int status = PCAP_ERROR;
+	int snapshot = 0;
+	int i;
+
+	multi = calloc(1, sizeof(*multi));
+	if (multi == NULL) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "malloc: %s", pcap_strerror(errno));
+		return PCAP_ERROR;
+	}
+	handle->md.multi = multi;
+	handle->md.breakloop_rfd = -1;
+	handle->md.breakloop_wfd = -1;
+
+	if (handle->opt.merge_order == PCAP_MERGE_TSTAMP)
+		handle->read_op = multi_read_tstamp;
+	else
+		handle->read_op = multi_read_roundrobin;
+	handle->inject_op = multi_inject_linux;
+	handle->setfilter_op = multi_setfilter_linux;
+	handle->setdirection_op = multi_setdirection_linux;
+	handle->set_datalink_op = multi_set_datalink_linux;
+	handle->getnonblock_op = multi_getnonblock_linux;
+	handle->setnonblock_op = multi_setnonblock_linux;
+	handle->stats_op = multi_stats_linux;
+	handle->stats_ex_op = multi_stats_ex_linux;
+	handle->breakloop_op = pcap_breakloop_fd;
+	handle->cleanup_op = multi_cleanup_linux;
+	handle->oneshot_callback = multi_oneshot;
+
+	names = strdup(handle->opt.source);
+	if (names == NULL) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "malloc: %s", pcap_strerror(errno));
+		goto fail;
+	}
+	multi->nmembers = 1;
+	for (cp = names; *cp != '\0'; cp++)
+		if (*cp == ',')
+			multi->nmembers++;
+	multi->members = calloc(multi->nmembers, sizeof(*multi->members));
+	multi->events = calloc(multi->nmembers + 1, sizeof(*multi->events));
+	if (multi->members == NULL || multi->events == NULL) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "malloc: %s", pcap_strerror(errno));
+		free(names);
+		goto fail;
+	}
+
+	handle->fd = epoll_create(multi->nmembers + 1);
+	if (handle->fd == -1) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "epoll_create: %s", pcap_strerror(errno));
+		free(names);
+		goto fail;
+	}
+
+	/*
+	 * Open each of the interfaces.
+	 */
+	for (i = 0, name = names; i < multi->nmembers; i++, name = cp + 1) {
+		cp = strchr(name, ',');
+		if (cp != NULL)
+			*cp = '\0';
+		if (*name == '\0') {
+			snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+			    "Empty interface name in %s", handle->opt.source);
+			free(names);
+			goto fail;
+		}
+		ret = multi_open_member(handle, i, name);
+		if (ret < 0) {
+			free(names);
+			status = ret;
+			goto fail;
+		}
+		if (ret > 0 && warning == 0) {
+			/*
+			 * Report the first warning we get.
+			 */
+			warning = ret;
+			multi_member_error(handle, multi->members[i].p);
+		}
+		if (i != 0 && pcap_datalink(multi->members[i].p) !=
+		    pcap_datalink(multi->members[0].p)) {
+			dlt_name0 = pcap_datalink_val_to_name(
+			    pcap_datalink(multi->members[0].p));
+			dlt_name = pcap_datalink_val_to_name(
+			    pcap_datalink(multi->members[i].p));
+			snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+			    "%s and %s have different link-layer header types (%s and %s)",
+			    multi->members[0].p->opt.source, name,
+			    dlt_name0 != NULL ? dlt_name0 : "unknown",
+			    dlt_name != NULL ? dlt_name : "unknown");
+			free(names);
+			goto fail;
+		}
+		if (pcap_snapshot(multi->members[i].p) > snapshot)
+			snapshot = pcap_snapshot(multi->members[i].p);
+	}
+	free(names);
+
+	if (pcap_breakloop_fd_open(handle) == -1)
+		goto fail;
+	memset(&ev, 0, sizeof(ev));
+	ev.events = EPOLLIN;
+	ev.data.u32 = multi->nmembers;
+	if (epoll_ctl(handle->fd, EPOLL_CTL_ADD, handle->md.breakloop_rfd,
+	    &ev) == -1) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "epoll_ctl: %s", pcap_strerror(errno));
+		goto fail;
+	}
+
+	multi->oneshot_buffer = malloc(snapshot);
+	if (multi->oneshot_buffer == NULL) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "can't allocate oneshot buffer: %s", pcap_strerror(errno));
+		goto fail;
+	}
+
+	/*
+	 * The link-layer header types we can switch to are the ones
+	 * the first interface offers; setting one that another
+	 * interface doesn't offer fails.
+	 */
+	handle->linktype = pcap_datalink(multi->members[0].p);
+	i = pcap_list_datalinks(multi->members[0].p, &dlt_list);
+	if (i > 0) {
+		handle->dlt_list = (u_int *)dlt_list;
+		handle->dlt_count = i;
+	}
+	handle->snapshot = snapshot;
+	handle->selectable_fd = handle->fd;
+	return warning;
+
+fail:
+	multi_cleanup_linux(handle);
+	return status;
+}
+
+pcap_t *
+multi_create(const char *device, char *ebuf, int *is_ours)
+{
+	pcap_t *p;
+
+	/* Is it a list of interfaces? */
+	if (strchr(device, ',') == NULL) {
+		/* Nope */
+		*is_ours = 0;
+		return NULL;
+	}
+
+	/* OK, it's ours. */
+	*is_ours = 1;
+
+	p = pcap_create_common(device, ebuf);
+	if (p == NULL)
+		return (NULL);
+
+	p->activate_op = multi_activate;
+	return (p);
+}
+
+int
+multi_findalldevs(pcap_if_t **alldevsp _U_, char *err_str _U_)
+{
+	/*
+	 * Any set of interfaces can be captured on together;
+	 * there's nothing to list.
+	 */
+	return 0;
+}
@@ -72,30 +72,157 @@
 #define NFLOG_IFACE "nflog"
 #define NFQUEUE_IFACE "nfqueue"
 
+#define NETFILTER_MAX_GROUPS	64
+
+/*
+ * After the first message, we read as many more as are already
+ * queued, up to this many, before sending the verdicts for them.
+ */
+#define NETFILTER_BATCH		64
+
+#define NFQ_VERDICT_BUFSIZE	8192
+
+/*
+ * The kernel collects logged packets into a message of up to
+ * NFULA_CFG_NLBUFSIZ bytes, which must be between these sizes,
+ * before sending them to us.
+ */
+#define NFLOG_NLBUFSIZ_MIN	4096
+#define NFLOG_NLBUFSIZ_MAX	131072
+
+/* socket buffer size if the application doesn't choose one */
+#define NETFILTER_DEFAULT_RCVBUF	(2*1024*1024)
+
 typedef enum { OTHER = -1, NFLOG, NFQUEUE } nftype_t;
 
-static int nfqueue_send_verdict(const pcap_t *handle, u_int16_t group_id, u_int32_t id, u_int32_t verdict);
+/*
+ * Verdict state of an NFQUEUE capture.  Verdicts are collected in
+ * "vbuf" and sent to the kernel together, in one datagram.
+ */
+struct pcap_nfq {
+	int	async;		/* the application issues the verdicts */
+	int	batch_ok;	/* kernel supports NFQNL_MSG_VERDICT_BATCH */
+	int	cur_valid;	/* a packet is being passed to the callback */
+	u_int16_t cur_queue;	/* ...from this queue */
+	u_int32_t cur_id;	/* ...with this ID */
+	int	nseen;		/* queues with packets we've yet to accept */
+	struct {
+		u_int16_t queue;
+		u_int32_t id;	/* the most recent of those packets */
+	} seen[NETFILTER_MAX_GROUPS];
+	size_t	vlen;		/* bytes of verdicts waiting in vbuf */
+	char	vbuf[NFQ_VERDICT_BUFSIZE] __attribute__ ((aligned));
+};
 
+/*
+ * NFLOG state: the sequence number of the last packet from each
+ * group, from which we count the packets the kernel couldn't send us.
+ */
+struct pcap_nflog {
+	u_int64_t drops;	/* packets missing from the sequence */
+	int	ngroups;
+	struct {
+		u_int16_t group;
+		int	have_seq;
+		u_int32_t seq;
+	} groups[NETFILTER_MAX_GROUPS];
+};
+
+static int nfqueue_put_verdict(pcap_t *handle, u_int16_t msg_type, u_int16_t group_id, u_int32_t id, u_int32_t verdict);
+static int nfqueue_flush_verdicts(pcap_t *handle);
+
+/*
+ * Accept a packet the application won't see: in batch, with the other
+ * packets from its queue, if the application isn't issuing verdicts,
+ * otherwise by itself.
+ */
 static int
-netfilter_read_linux(pcap_t *handle, int max_packets, pcap_handler callback, u_char *user)
+nfqueue_accept(pcap_t *handle, u_int16_t group_id, u_int32_t id)
 {
-	const unsigned char *buf;
-	int count = 0;
-	int len;
+	struct pcap_nfq *nfq = handle->md.nfq;
+	int i;
 
-	/* ignore interrupt system call error */
-	do {
-		len = recv(handle->fd, handle->buffer, handle->bufsize, 0);
-		if (handle->break_loop) {
-			handle->break_loop = 0;
-			return -2;
-		}
-	} while ((len == -1) && (errno == EINTR));
+	if (nfq->async || !nfq->batch_ok)
+		return nfqueue_put_verdict(handle, NFQNL_MSG_VERDICT, group_id, id, NF_ACCEPT);
 
-	if (len < 0) {
-		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE, "Can't receive packet %d:%s", errno, pcap_strerror(errno));
-		return -1;
+	for (i = 0; i < nfq->nseen; i++) {
+		if (nfq->seen[i].queue == group_id)
+			break;
 	}
+	if (i == nfq->nseen) {
+		if (nfq->nseen == NETFILTER_MAX_GROUPS)
+			return nfqueue_put_verdict(handle, NFQNL_MSG_VERDICT, group_id, id, NF_ACCEPT);
+		nfq->seen[i].queue = group_id;
+		nfq->nseen++;
+	}
+	nfq->seen[i].id = id;
+	return 0;
+}
+
+/*
+ * Send the verdicts for everything read by this call; one
+ * NFQNL_MSG_VERDICT_BATCH per queue accepts all of its packets.
+ */
+static int
+nfqueue_end_batch(pcap_t *handle)
+{
+	struct pcap_nfq *nfq = handle->md.nfq;
+	int i;
+
+	for (i = 0; i < nfq->nseen; i++) {
+		if (nfqueue_put_verdict(handle, NFQNL_MSG_VERDICT_BATCH, nfq->seen[i].queue, nfq->seen[i].id, NF_ACCEPT) == -1)
+			return -1;
+	}
+	nfq->nseen = 0;
+	return nfqueue_flush_verdicts(handle);
+}
+
+static void
+nflog_check_seq(pcap_t *handle, u_int16_t group_id, const struct nfattr *attr)
+{
+	struct pcap_nflog *nflog = handle->md.nflog;
+	u_int32_t seq;
+	int i;
+
+	if (NFA_PAYLOAD(attr) < sizeof(seq))
+		return;
+	memcpy(&seq, NFA_DATA(attr), sizeof(seq));
+	seq = ntohl(seq);
+
+	for (i = 0; i < nflog->ngroups; i++) {
+		if (nflog->groups[i].group != group_id)
+			continue;
+		/* the kernel numbers each group's packets from 0 */
+		if (nflog->groups[i].have_seq)
+			nflog->drops += (u_int32_t)(seq - nflog->groups[i].seq - 1);
+		else
+			nflog->drops += seq;
+		nflog->groups[i].seq = seq;
+		nflog->groups[i].have_seq = 1;
+		return;
+	}
+}
+
+static u_int64_t
+netfilter_get_be64(const void *p)
+{
+	const u_char *cp = p;
+	u_int64_t v = 0;
+	int i;
+
+	for (i = 0; i < 8; i++)
+		v = (v << 8) | cp[i];
+	return v;
+}
+
+/*
+ * Process the netlink messages in the first "len" bytes of the buffer.
+ */
+static int
+netfilter_handle_msgs(pcap_t *handle, int len, pcap_handler callback, u_char *user)
+{
+	const unsigned char *buf;
+	int count = 0;
 
 	buf = handle->buffer;
 	while (len >= NLMSG_SPACE(0)) {
@@ -118,50 +245,59 @@ netfilter_read_linux(pcap_t *handle, int max_packets, pcap_handler callback, u_c
 
 		if (type != OTHER) {
 			const unsigned char *payload = NULL;
+			const struct nfattr *payload_attr = NULL;
+			const struct nfattr *ts_attr = NULL;
 			struct pcap_pkthdr pkth;
 
-			const struct nfgenmsg *nfg;
+			const struct nfgenmsg *nfg = NLMSG_DATA(nlh);
 			int id = 0;
+			int app_verdict = 0;
 
-			if (handle->linktype != DLT_NFLOG) {
-				const struct nfattr *payload_attr = NULL;
+			if (nlh->nlmsg_len < HDR_LENGTH) {
+				snprintf(handle->errbuf, PCAP_ERRBUF_SIZE, "Malformed message: (nlmsg_len: %u)", nlh->nlmsg_len);
+				return -1;
+			}
 
-				if (nlh->nlmsg_len < HDR_LENGTH) {
-					snprintf(handle->errbuf, PCAP_ERRBUF_SIZE, "Malformed message: (nlmsg_len: %u)", nlh->nlmsg_len);
-					return -1;
-				}
+			if (nlh->nlmsg_len > HDR_LENGTH) {
+				struct nfattr *attr = NFM_NFA(nfg);
+				int attr_len = nlh->nlmsg_len - NLMSG_ALIGN(HDR_LENGTH);
 
-				nfg = NLMSG_DATA(nlh);
-				if (nlh->nlmsg_len > HDR_LENGTH) {
-					struct nfattr *attr = NFM_NFA(nfg);
-					int attr_len = nlh->nlmsg_len - NLMSG_ALIGN(HDR_LENGTH);
-
-					while (NFA_OK(attr, attr_len)) {
-						if (type == NFQUEUE) {
-							switch (NFA_TYPE(attr)) {
-								case NFQA_PACKET_HDR:
-									{
-										const struct nfqnl_msg_packet_hdr *pkt_hdr = (const struct nfqnl_msg_packet_hdr *) NFA_DATA(attr);
-
-										id = ntohl(pkt_hdr->packet_id);
-										break;
-									}
-								case NFQA_PAYLOAD:
-									payload_attr = attr;
-									break;
-							}
+				while (NFA_OK(attr, attr_len)) {
+					if (type == NFQUEUE) {
+						switch (NFA_TYPE(attr)) {
+							case NFQA_PACKET_HDR:
+								{
+									const struct nfqnl_msg_packet_hdr *pkt_hdr = (const struct nfqnl_msg_packet_hdr *) NFA_DATA(attr);
 
-						} else if (type == NFLOG) {
-							switch (NFA_TYPE(attr)) {
-								case NFULA_PAYLOAD:
-									payload_attr = attr;
+									id = ntohl(pkt_hdr->packet_id);
 									break;
-							}
+								}
+							case NFQA_TIMESTAMP:
+								ts_attr = attr;
+								break;
+							case NFQA_PAYLOAD:
+								payload_attr = attr;
+								break;
+						}
+
+					} else if (type == NFLOG) {
+						switch (NFA_TYPE(attr)) {
+							case NFULA_TIMESTAMP:
+								ts_attr = attr;
+								break;
+							case NFULA_SEQ:
+								nflog_check_seq(handle, ntohs(nfg->res_id), attr);
+								break;
+							case NFULA_PAYLOAD:
+								payload_attr = attr;
+								break;
 						}
-						attr = NFA_NEXT(attr, attr_len);
 					}
+					attr = NFA_NEXT(attr, attr_len);
 				}
+			}
 
+			if (handle->linktype != DLT_NFLOG) {
 				if (payload_attr) {
 					payload = NFA_DATA(payload_attr);
 					pkth.len = pkth.caplen = NFA_PAYLOAD(payload_attr);
@@ -172,22 +308,49 @@ netfilter_read_linux(pcap_t *handle, int max_packets, pcap_handler callback, u_c
 				pkth.caplen = pkth.len = nlh->nlmsg_len-NLMSG_ALIGN(sizeof(struct nlmsghdr));
 			}
 
+			/*
+			 * Run the filter before doing anything else with the
+			 * packet, so that rejecting one costs little more
+			 * than the filter itself.
+			 */
+			if (payload && handle->fcode.bf_insns != NULL &&
+			    !pcap_filter_packet(handle->fcode.bf_insns, payload, pkth.len, &pkth.caplen)) {
+				handle->md.packets_filtered++;
+				payload = NULL;
+			}
+
 			if (payload) {
 				/* pkth.caplen = min (payload_len, handle->snapshot); */
 
-				gettimeofday(&pkth.ts, NULL);
-				if (handle->fcode.bf_insns == NULL ||
-						bpf_filter(handle->fcode.bf_insns, payload, pkth.len, pkth.caplen)) 
-				{
-					handle->md.packets_read++;
-					callback(user, &pkth, payload);
-					count++;
+				/*
+				 * Packets can wait in the kernel for the NFLOG
+				 * flush timeout, so use the time the kernel
+				 * gives, if it gives one.
+				 */
+				if (ts_attr != NULL && NFA_PAYLOAD(ts_attr) >= 16) {
+					pkth.ts.tv_sec = netfilter_get_be64(NFA_DATA(ts_attr));
+					pkth.ts.tv_usec = netfilter_get_be64((const u_char *)NFA_DATA(ts_attr) + 8);
+				} else
+					gettimeofday(&pkth.ts, NULL);
+
+				handle->md.packets_read++;
+				if (type == NFQUEUE) {
+					handle->md.nfq->cur_valid = 1;
+					handle->md.nfq->cur_queue = ntohs(nfg->res_id);
+					handle->md.nfq->cur_id = id;
+				}
+				callback(user, &pkth, payload);
+				count++;
+				if (type == NFQUEUE) {
+					handle->md.nfq->cur_valid = 0;
+					app_verdict = handle->md.nfq->async;
 				}
 			}
 
-			if (type == NFQUEUE) {
-				/* XXX, possible responses: NF_DROP, NF_ACCEPT, NF_STOLEN, NF_QUEUE, NF_REPEAT, NF_STOP */
-				nfqueue_send_verdict(handle, ntohs(nfg->res_id), id, NF_ACCEPT);
+			/* in async mode, the application gives the verdict */
+			if (type == NFQUEUE && !app_verdict) {
+				if (nfqueue_accept(handle, ntohs(nfg->res_id), id) == -1)
+					return -1;
 			}
 		}
 
@@ -201,6 +364,73 @@ netfilter_read_linux(pcap_t *handle, int max_packets, pcap_handler callback, u_c
 	return count;
 }
 
+static int
+netfilter_read_linux(pcap_t *handle, int max_packets, pcap_handler callback, u_char *user)
+{
+	struct pcap_nfq *nfq = handle->md.nfq;
+	int count = 0, msgs = 0;
+	int len, n;
+
+	if (handle->opt.capture_cpu >= 0 && !handle->md.reader_pinned &&
+	    pcap_pin_reader(handle) == -1)
+		return -1;
+
+	/*
+	 * Don't leave verdicts the application issued waiting while
+	 * we block.
+	 */
+	if (nfq != NULL && nfqueue_flush_verdicts(handle) == -1)
+		return -1;
+
+	if (handle->break_loop) {
+		handle->break_loop = 0;
+		return -2;
+	}
+
+	/*
+	 * ignore interrupt system call error, and ENOBUFS, which tells
+	 * us the kernel dropped messages for lack of room in the socket
+	 * buffer; for NFLOG, we count those from the sequence numbers.
+	 */
+	do {
+		len = recv(handle->fd, handle->buffer, handle->bufsize, 0);
+		if (handle->break_loop) {
+			handle->break_loop = 0;
+			return -2;
+		}
+	} while ((len == -1) && (errno == EINTR || errno == ENOBUFS));
+
+	if (len < 0) {
+		if (errno == EAGAIN || errno == EWOULDBLOCK)
+			return 0;
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE, "Can't receive packet %d:%s", errno, pcap_strerror(errno));
+		return -1;
+	}
+
+	for (;;) {
+		n = netfilter_handle_msgs(handle, len, callback, user);
+		if (n == -1)
+			return -1;
+		count += n;
+		if (++msgs == NETFILTER_BATCH || handle->break_loop ||
+		    (max_packets > 0 && count >= max_packets))
+			break;
+		do {
+			len = recv(handle->fd, handle->buffer, handle->bufsize, MSG_DONTWAIT);
+		} while ((len == -1) && (errno == ENOBUFS));
+		if (len < 0) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+				break;
+			snprintf(handle->errbuf, PCAP_ERRBUF_SIZE, "Can't receive packet %d:%s", errno, pcap_strerror(errno));
+			return -1;
+		}
+	}
+
+	if (nfq != NULL && nfqueue_end_batch(handle) == -1)
+		return -1;
+	return count;
+}
+
 static int
 netfilter_set_datalink(pcap_t *handle, int dlt)
 {
@@ -212,11 +442,22 @@ static int
 netfilter_stats_linux(pcap_t *handle, struct pcap_stat *stats)
 {
 	stats->ps_recv = handle->md.packets_read;
-	stats->ps_drop = 0;
+	stats->ps_drop = handle->md.nflog != NULL ? handle->md.nflog->drops : 0;
 	stats->ps_ifdrop = 0;
 	return 0;
 }
 
+static int
+netfilter_stats_ex_linux(pcap_t *handle, struct pcap_stat_ex *stats)
+{
+	memset(stats, 0, sizeof(*stats));
+	stats->ps_recv = handle->md.packets_read + handle->md.packets_filtered;
+	stats->ps_drop = handle->md.nflog != NULL ? handle->md.nflog->drops : 0;
+	stats->ps_accepted = handle->md.packets_read;
+	stats->ps_filtered = handle->md.packets_filtered;
+	return 0;
+}
+
 static int
 netfilter_inject_linux(pcap_t *handle, const void *buf, size_t size)
 {
@@ -230,20 +471,16 @@ struct my_nfattr {
 	void *data;
 };
 
-static int
-netfilter_send_config_msg(const pcap_t *handle, u_int16_t msg_type, int ack, u_int8_t family, u_int16_t res_id, const struct my_nfattr *mynfa)
+/*
+ * Build a message with "nfa_count" attributes at "buf", which must be
+ * suitably aligned; returns its length.
+ */
+static u_int32_t
+netfilter_put_msg(char *buf, u_int16_t msg_type, int ack, u_int8_t family, u_int16_t res_id, u_int32_t seq_id, const struct my_nfattr *mynfa, int nfa_count)
 {
-	char buf[1024] __attribute__ ((aligned));
-
 	struct nlmsghdr *nlh = (struct nlmsghdr *) buf;
 	struct nfgenmsg *nfg = (struct nfgenmsg *) (buf + sizeof(struct nlmsghdr));
-
-	struct sockaddr_nl snl;
-	static unsigned int seq_id;
-	
-	if (!seq_id)
-		seq_id = time(NULL);
-	++seq_id;
+	int i;
 
 	nlh->nlmsg_len = NLMSG_LENGTH(sizeof(struct nfgenmsg));
 	nlh->nlmsg_type = msg_type;
@@ -255,14 +492,32 @@ netfilter_send_config_msg(const pcap_t *handle, u_int16_t msg_type, int ack, u_i
 	nfg->version = NFNETLINK_V0;
 	nfg->res_id = htons(res_id);
 
-	if (mynfa) {
+	for (i = 0; i < nfa_count; i++) {
 		struct nfattr *nfa = (struct nfattr *) (buf + NLMSG_ALIGN(nlh->nlmsg_len));
 
-		nfa->nfa_type = mynfa->nfa_type;
-		nfa->nfa_len = NFA_LENGTH(mynfa->nfa_len);
-		memcpy(NFA_DATA(nfa), mynfa->data, mynfa->nfa_len);
+		nfa->nfa_type = mynfa[i].nfa_type;
+		nfa->nfa_len = NFA_LENGTH(mynfa[i].nfa_len);
+		memcpy(NFA_DATA(nfa), mynfa[i].data, mynfa[i].nfa_len);
 		nlh->nlmsg_len = NLMSG_ALIGN(nlh->nlmsg_len) + NFA_ALIGN(nfa->nfa_len);
 	}
+	return nlh->nlmsg_len;
+}
+
+static int
+netfilter_send_config_msg(const pcap_t *handle, u_int16_t msg_type, int ack, u_int8_t family, u_int16_t res_id, const struct my_nfattr *mynfa, int nfa_count)
+{
+	char buf[1024] __attribute__ ((aligned));
+
+	struct nlmsghdr *nlh = (struct nlmsghdr *) buf;
+
+	struct sockaddr_nl snl;
+	static unsigned int seq_id;
+	
+	if (!seq_id)
+		seq_id = time(NULL);
+	++seq_id;
+
+	netfilter_put_msg(buf, msg_type, ack, family, res_id, seq_id, mynfa, nfa_count);
 
 	memset(&snl, 0, sizeof(snl));
 	snl.nl_family = AF_NETLINK;
@@ -314,7 +569,7 @@ netfilter_send_config_msg(const pcap_t *handle, u_int16_t msg_type, int ack, u_i
 static int
 nflog_send_config_msg(const pcap_t *handle, u_int8_t family, u_int16_t group_id, const struct my_nfattr *mynfa)
 {
-	return netfilter_send_config_msg(handle, (NFNL_SUBSYS_ULOG << 8) | NFULNL_MSG_CONFIG, 1, family, group_id, mynfa);
+	return netfilter_send_config_msg(handle, (NFNL_SUBSYS_ULOG << 8) | NFULNL_MSG_CONFIG, 1, family, group_id, mynfa, 1);
 }
 
 static int
@@ -349,11 +604,50 @@ nflog_send_config_mode(const pcap_t *handle, u_int16_t group_id, u_int8_t copy_m
 }
 
 static int
-nfqueue_send_verdict(const pcap_t *handle, u_int16_t group_id, u_int32_t id, u_int32_t verdict)
+nflog_send_config_u32(const pcap_t *handle, u_int16_t group_id, u_int16_t type, u_int32_t value)
 {
+	struct my_nfattr nfa;
+
+	value = htonl(value);
+
+	nfa.data = &value;
+	nfa.nfa_type = type;
+	nfa.nfa_len = sizeof(value);
+
+	return nflog_send_config_msg(handle, AF_UNSPEC, group_id, &nfa);
+}
+
+static int
+nflog_send_config_flags(const pcap_t *handle, u_int16_t group_id, u_int16_t flags)
+{
+	struct my_nfattr nfa;
+
+	flags = htons(flags);
+
+	nfa.data = &flags;
+	nfa.nfa_type = NFULA_CFG_FLAGS;
+	nfa.nfa_len = sizeof(flags);
+
+	return nflog_send_config_msg(handle, AF_UNSPEC, group_id, &nfa);
+}
+
+/*
+ * Add a verdict to the ones waiting to be sent, sending those first if
+ * there's no room for it.  "msg_type" is NFQNL_MSG_VERDICT, for the
+ * packet with the given ID, or NFQNL_MSG_VERDICT_BATCH, for it and all
+ * earlier packets from the same queue.
+ */
+static int
+nfqueue_put_verdict(pcap_t *handle, u_int16_t msg_type, u_int16_t group_id, u_int32_t id, u_int32_t verdict)
+{
+	struct pcap_nfq *nfq = handle->md.nfq;
 	struct nfqnl_msg_verdict_hdr msg;
 	struct my_nfattr nfa;
 
+	if (nfq->vlen + NLMSG_SPACE(NFA_SPACE(sizeof(msg)) + sizeof(struct nfgenmsg)) > sizeof(nfq->vbuf) &&
+	    nfqueue_flush_verdicts(handle) == -1)
+		return -1;
+
 	msg.id = htonl(id);
 	msg.verdict = htonl(verdict);
 
@@ -361,13 +655,38 @@ nfqueue_send_verdict(const pcap_t *handle, u_int16_t group_id, u_int32_t id, u_i
 	nfa.nfa_type = NFQA_VERDICT_HDR;
 	nfa.nfa_len = sizeof(msg);
 
-	return netfilter_send_config_msg(handle, (NFNL_SUBSYS_QUEUE << 8) | NFQNL_MSG_VERDICT, 0, AF_UNSPEC, group_id, &nfa);
+	nfq->vlen += NLMSG_ALIGN(netfilter_put_msg(nfq->vbuf + nfq->vlen, (NFNL_SUBSYS_QUEUE << 8) | msg_type, 0, AF_UNSPEC, group_id, 0, &nfa, 1));
+	return 0;
+}
+
+static int
+nfqueue_flush_verdicts(pcap_t *handle)
+{
+	struct pcap_nfq *nfq = handle->md.nfq;
+	struct sockaddr_nl snl;
+	int ret;
+
+	if (nfq->vlen == 0)
+		return 0;
+
+	memset(&snl, 0, sizeof(snl));
+	snl.nl_family = AF_NETLINK;
+
+	do {
+		ret = sendto(handle->fd, nfq->vbuf, nfq->vlen, 0, (struct sockaddr *) &snl, sizeof(snl));
+	} while ((ret == -1) && (errno == EINTR));
+	nfq->vlen = 0;
+	if (ret == -1) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE, "Can't send verdicts: %s", pcap_strerror(errno));
+		return -1;
+	}
+	return 0;
 }
 
 static int
-nfqueue_send_config_msg(const pcap_t *handle, u_int8_t family, u_int16_t group_id, const struct my_nfattr *mynfa)
+nfqueue_send_config_msg(const pcap_t *handle, u_int8_t family, u_int16_t group_id, const struct my_nfattr *mynfa, int nfa_count)
 {
-	return netfilter_send_config_msg(handle, (NFNL_SUBSYS_QUEUE << 8) | NFQNL_MSG_CONFIG, 1, family, group_id, mynfa);
+	return netfilter_send_config_msg(handle, (NFNL_SUBSYS_QUEUE << 8) | NFQNL_MSG_CONFIG, 1, family, group_id, mynfa, nfa_count);
 }
 
 static int
@@ -383,7 +702,7 @@ nfqueue_send_config_cmd(const pcap_t *handle, u_int16_t group_id, u_int8_t cmd,
 	nfa.nfa_type = NFQA_CFG_CMD;
 	nfa.nfa_len = sizeof(msg);
 
-	return nfqueue_send_config_msg(handle, AF_UNSPEC, group_id, &nfa);
+	return nfqueue_send_config_msg(handle, AF_UNSPEC, group_id, &nfa, 1);
 }
 
 static int 
@@ -399,16 +718,76 @@ nfqueue_send_config_mode(const pcap_t *handle, u_int16_t group_id, u_int8_t copy
 	nfa.nfa_type = NFQA_CFG_PARAMS;
 	nfa.nfa_len = sizeof(msg);
 
-	return nfqueue_send_config_msg(handle, AF_UNSPEC, group_id, &nfa);
+	return nfqueue_send_config_msg(handle, AF_UNSPEC, group_id, &nfa, 1);
+}
+
+static int
+nfqueue_send_config_flags(const pcap_t *handle, u_int16_t group_id, u_int32_t flags, u_int32_t mask)
+{
+	struct my_nfattr nfa[2];
+
+	flags = htonl(flags);
+	mask = htonl(mask);
+
+	/* the kernel only looks at the flags given in the mask */
+	nfa[0].data = &mask;
+	nfa[0].nfa_type = NFQA_CFG_MASK;
+	nfa[0].nfa_len = sizeof(mask);
+	nfa[1].data = &flags;
+	nfa[1].nfa_type = NFQA_CFG_FLAGS;
+	nfa[1].nfa_len = sizeof(flags);
+
+	return nfqueue_send_config_msg(handle, AF_UNSPEC, group_id, nfa, 2);
+}
+
+/*
+ * See whether the kernel takes NFQNL_MSG_VERDICT_BATCH (added in 3.1),
+ * by sending one for a packet that can't exist; a kernel without it
+ * rejects the message type with EINVAL.
+ */
+static int
+nfqueue_probe_batch(const pcap_t *handle, u_int16_t group_id)
+{
+	struct nfqnl_msg_verdict_hdr msg;
+	struct my_nfattr nfa;
+
+	msg.id = htonl(0);
+	msg.verdict = htonl(NF_ACCEPT);
+
+	nfa.data = &msg;
+	nfa.nfa_type = NFQA_VERDICT_HDR;
+	nfa.nfa_len = sizeof(msg);
+
+	if (netfilter_send_config_msg(handle, (NFNL_SUBSYS_QUEUE << 8) | NFQNL_MSG_VERDICT_BATCH, 1, AF_UNSPEC, group_id, &nfa, 1) == 0)
+		return 1;
+	return errno != EINVAL;
+}
+
+static void
+netfilter_cleanup_linux(pcap_t *handle)
+{
+	if (handle->md.nflog != NULL) {
+		free(handle->md.nflog);
+		handle->md.nflog = NULL;
+	}
+	if (handle->md.nfq != NULL) {
+		/* don't drop the packets the application accepted */
+		(void)nfqueue_flush_verdicts(handle);
+		free(handle->md.nfq);
+		handle->md.nfq = NULL;
+	}
+	pcap_cleanup_live_common(handle);
 }
 
 static int
 netfilter_activate(pcap_t* handle)
 {
 	const char *dev = handle->opt.source;
-	unsigned short groups[32];
+	unsigned short groups[NETFILTER_MAX_GROUPS];
 	int group_count = 0;
 	nftype_t type = OTHER;
+	int fail_open = 0, cpu_fanout = 0;
+	int rcvbuf, nlbufsiz = 0;
 	int i;
 
  	if (strncmp(dev, NFLOG_IFACE, strlen(NFLOG_IFACE)) == 0) {
@@ -420,29 +799,52 @@ netfilter_activate(pcap_t* handle)
 		type = NFQUEUE;
 	}
  
+	/*
+	 * The groups are a comma-separated list of numbers and ranges
+	 * such as "0-7"; an NFQUEUE device can also have the flags
+	 * "fail-open", to have the kernel accept packets rather than
+	 * drop them when the queue is full, and "cpu-fanout", to read
+	 * only the queue that iptables' --queue-cpu-fanout sends the
+	 * packets handled by the capture CPU to.
+	 */
 	if (type != OTHER && *dev == ':') {
 		dev++;
 		while (*dev) {
-			long int group_id;
+			long int group_id, last_id;
 			char *end_dev;
 
-			if (group_count == 32) {
-				snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
-						"Maximum 32 netfilter groups! dev: %s", 
-						handle->opt.source);
-				return PCAP_ERROR;
-			}
-
-			group_id = strtol(dev, &end_dev, 0);
-			if (end_dev != dev) {
-				if (group_id < 0 || group_id > 65535) {
+			if (type == NFQUEUE && strncmp(dev, "fail-open", 9) == 0) {
+				fail_open = 1;
+				dev += 9;
+			} else if (type == NFQUEUE && strncmp(dev, "cpu-fanout", 10) == 0) {
+				cpu_fanout = 1;
+				dev += 10;
+			} else {
+				group_id = strtol(dev, &end_dev, 0);
+				if (end_dev == dev)
+					break;
+				last_id = group_id;
+				if (*end_dev == '-') {
+					dev = end_dev + 1;
+					last_id = strtol(dev, &end_dev, 0);
+					if (end_dev == dev)
+						break;
+				}
+				if (group_id < 0 || last_id > 65535 || last_id < group_id) {
 					snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
-							"Netfilter group range from 0 to 65535 (got %ld)",
-							group_id);
+							"Netfilter group range from 0 to 65535 (got %ld-%ld)",
+							group_id, last_id);
 					return PCAP_ERROR;
 				}
-
-				groups[group_count++] = (unsigned short) group_id;
+				for (; group_id <= last_id; group_id++) {
+					if (group_count == NETFILTER_MAX_GROUPS) {
+						snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+								"Maximum %d netfilter groups! dev: %s", 
+								NETFILTER_MAX_GROUPS, handle->opt.source);
+						return PCAP_ERROR;
+					}
+					groups[group_count++] = (unsigned short) group_id;
+				}
 				dev = end_dev;
 			}
 			if (*dev != ',')
@@ -464,8 +866,40 @@ netfilter_activate(pcap_t* handle)
 		group_count = 1;
 	}
 
+	if (cpu_fanout) {
+		/*
+		 * The kernel sends packets handled by CPU n to queue
+		 * first + n % count.
+		 */
+		if (handle->opt.capture_cpu < 0) {
+			snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+					"%s: cpu-fanout needs a capture CPU",
+					handle->opt.source);
+			return PCAP_ERROR;
+		}
+		groups[0] = groups[handle->opt.capture_cpu % group_count];
+		group_count = 1;
+	}
+
+	rcvbuf = handle->opt.buffer_size != 0 ? handle->opt.buffer_size : NETFILTER_DEFAULT_RCVBUF;
+
 	/* Initialize some components of the pcap structure. */
 	handle->bufsize = 128 + handle->snapshot;
+	if (type == NFLOG) {
+		/*
+		 * Have the kernel send as many packets at a time as
+		 * leaves room in the socket buffer for 16 such batches,
+		 * and make our buffer big enough for a whole batch.  The
+		 * kernel fills all of the memory it allocates for a
+		 * batch, which can be up to twice what we ask for.
+		 */
+		nlbufsiz = rcvbuf / 16;
+		if (nlbufsiz < NFLOG_NLBUFSIZ_MIN)
+			nlbufsiz = NFLOG_NLBUFSIZ_MIN;
+		if (nlbufsiz > NFLOG_NLBUFSIZ_MAX)
+			nlbufsiz = NFLOG_NLBUFSIZ_MAX;
+		handle->bufsize += 2 * nlbufsiz;
+	}
 	handle->offset = 0;
 	handle->read_op = netfilter_read_linux;
 	handle->inject_op = netfilter_inject_linux;
@@ -476,6 +910,8 @@ netfilter_activate(pcap_t* handle)
 	handle->getnonblock_op = pcap_getnonblock_fd;
 	handle->setnonblock_op = pcap_setnonblock_fd;
 	handle->stats_op = netfilter_stats_linux;
+	handle->stats_ex_op = netfilter_stats_ex_linux;
+	handle->cleanup_op = netfilter_cleanup_linux;
 
 	/* Create netlink socket */
 	handle->fd = socket(AF_NETLINK, SOCK_RAW, NETLINK_NETFILTER);
@@ -513,19 +949,58 @@ netfilter_activate(pcap_t* handle)
 			goto close_fail;
 		}
 
+		handle->md.nflog = calloc(1, sizeof(struct pcap_nflog));
+		if (handle->md.nflog == NULL) {
+			snprintf(handle->errbuf, PCAP_ERRBUF_SIZE, "Can't allocate group state: %s", pcap_strerror(errno));
+			goto close_fail;
+		}
+
 		/* Bind socket to the nflog groups */
 		for (i = 0; i < group_count; i++) {
 			if (nflog_send_config_cmd(handle, groups[i], NFULNL_CFG_CMD_BIND, AF_UNSPEC) < 0) {
 				snprintf(handle->errbuf, PCAP_ERRBUF_SIZE, "Can't listen on group group index: %s", pcap_strerror(errno));
 				goto close_fail;
 			}
+			handle->md.nflog->groups[handle->md.nflog->ngroups++].group = groups[i];
 
 			if (nflog_send_config_mode(handle, groups[i], NFULNL_COPY_PACKET, handle->snapshot) < 0) {
 				snprintf(handle->errbuf, PCAP_ERRBUF_SIZE, "NFULNL_COPY_PACKET: %s", pcap_strerror(errno));
 				goto close_fail;
 			}
+
+			/*
+			 * Send a batch when it's full, or when the capture
+			 * timeout has passed since the first packet in it;
+			 * with no timeout, the kernel's default of a
+			 * second applies.  Number the packets, so that we
+			 * can tell how many the kernel dropped.
+			 */
+			if (nflog_send_config_u32(handle, groups[i], NFULA_CFG_NLBUFSIZ, nlbufsiz) < 0) {
+				snprintf(handle->errbuf, PCAP_ERRBUF_SIZE, "NFULA_CFG_NLBUFSIZ: %s", pcap_strerror(errno));
+				goto close_fail;
+			}
+			if (nflog_send_config_u32(handle, groups[i], NFULA_CFG_QTHRESH, nlbufsiz / 64) < 0) {
+				snprintf(handle->errbuf, PCAP_ERRBUF_SIZE, "NFULA_CFG_QTHRESH: %s", pcap_strerror(errno));
+				goto close_fail;
+			}
+			if (handle->md.timeout > 0 &&
+			    nflog_send_config_u32(handle, groups[i], NFULA_CFG_TIMEOUT, (handle->md.timeout + 9) / 10) < 0) {
+				snprintf(handle->errbuf, PCAP_ERRBUF_SIZE, "NFULA_CFG_TIMEOUT: %s", pcap_strerror(errno));
+				goto close_fail;
+			}
+			if (nflog_send_config_flags(handle, groups[i], NFULNL_CFG_F_SEQ) < 0) {
+				snprintf(handle->errbuf, PCAP_ERRBUF_SIZE, "NFULA_CFG_FLAGS: %s", pcap_strerror(errno));
+				goto close_fail;
+			}
 		}
 
+		/*
+		 * The kernel only records when packets arrive if some
+		 * socket asks for timestamps.
+		 */
+		i = 1;
+		(void)setsockopt(handle->fd, SOL_SOCKET, SO_TIMESTAMP, &i, sizeof(i));
+
 	} else {
 		if (nfqueue_send_config_cmd(handle, 0, NFQNL_CFG_CMD_PF_UNBIND, AF_INET) < 0) {
 			snprintf(handle->errbuf, PCAP_ERRBUF_SIZE, "NFQNL_CFG_CMD_PF_UNBIND: %s", pcap_strerror(errno));
@@ -537,6 +1012,13 @@ netfilter_activate(pcap_t* handle)
 			goto close_fail;
 		}
 
+		handle->md.nfq = calloc(1, sizeof(struct pcap_nfq));
+		if (handle->md.nfq == NULL) {
+			snprintf(handle->errbuf, PCAP_ERRBUF_SIZE, "Can't allocate verdict buffer: %s", pcap_strerror(errno));
+			goto close_fail;
+		}
+		handle->md.nfq->batch_ok = nfqueue_probe_batch(handle, groups[0]);
+
 		/* Bind socket to the nfqueue groups */
 		for (i = 0; i < group_count; i++) {
 			if (nfqueue_send_config_cmd(handle, groups[i], NFQNL_CFG_CMD_BIND, AF_UNSPEC) < 0) {
@@ -548,6 +1030,11 @@ netfilter_activate(pcap_t* handle)
 				snprintf(handle->errbuf, PCAP_ERRBUF_SIZE, "NFQNL_COPY_PACKET: %s", pcap_strerror(errno));
 				goto close_fail;
 			}
+
+			if (fail_open && nfqueue_send_config_flags(handle, groups[i], NFQA_CFG_F_FAIL_OPEN, NFQA_CFG_F_FAIL_OPEN) < 0) {
+				snprintf(handle->errbuf, PCAP_ERRBUF_SIZE, "NFQA_CFG_F_FAIL_OPEN: %s", pcap_strerror(errno));
+				goto close_fail;
+			}
 		}
 	}
 
@@ -555,25 +1042,27 @@ netfilter_activate(pcap_t* handle)
 		/*
 		 * Monitor mode doesn't apply to netfilter devices.
 		 */
-		pcap_cleanup_live_common(handle);
+		netfilter_cleanup_linux(handle);
 		return PCAP_ERROR_RFMON_NOTSUP;
 	}
 
-	if (handle->opt.buffer_size != 0) {
-		/*
-		 * Set the socket buffer size to the specified value.
-		 */
-		if (setsockopt(handle->fd, SOL_SOCKET, SO_RCVBUF, &handle->opt.buffer_size, sizeof(handle->opt.buffer_size)) == -1) {
-			snprintf(handle->errbuf, PCAP_ERRBUF_SIZE, "SO_RCVBUF: %s", pcap_strerror(errno));
-			goto close_fail;
-		}
+	/*
+	 * Set the socket buffer size to the specified value, or to
+	 * our default, going past net.core.rmem_max if we can; if
+	 * the kernel runs out of room there, it drops packets.
+	 */
+	if (setsockopt(handle->fd, SOL_SOCKET, SO_RCVBUFFORCE, &rcvbuf, sizeof(rcvbuf)) == -1 &&
+	    setsockopt(handle->fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf)) == -1 &&
+	    handle->opt.buffer_size != 0) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE, "SO_RCVBUF: %s", pcap_strerror(errno));
+		goto close_fail;
 	}
 
 	handle->selectable_fd = handle->fd;
 	return 0;
 
 close_fail:
-	pcap_cleanup_live_common(handle);
+	netfilter_cleanup_linux(handle);
 	return PCAP_ERROR;
 }
 
@@ -643,3 +1132,70 @@ netfilter_findalldevs(pcap_if_t **alldevsp, char *err_str)
 		return -1;
 	return 0;
 }
+
+static struct pcap_nfq *
+nfqueue_handle(pcap_t *p)
+{
+	if (p->md.nfq == NULL) {
+		snprintf(p->errbuf, PCAP_ERRBUF_SIZE, "%s isn't an activated NFQUEUE capture", p->opt.source);
+		return NULL;
+	}
+	return p->md.nfq;
+}
+
+int
+pcap_nfqueue_set_async(pcap_t *p, int async)
+{
+	struct pcap_nfq *nfq = nfqueue_handle(p);
+
+	if (nfq == NULL)
+		return -1;
+	nfq->async = async;
+	return 0;
+}
+
+int
+pcap_nfqueue_get_id(pcap_t *p, u_int *queuep, bpf_u_int32 *idp)
+{
+	struct pcap_nfq *nfq = nfqueue_handle(p);
+
+	if (nfq == NULL)
+		return -1;
+	if (!nfq->cur_valid) {
+		snprintf(p->errbuf, PCAP_ERRBUF_SIZE, "No NFQUEUE packet is being processed");
+		return -1;
+	}
+	*queuep = nfq->cur_queue;
+	*idp = nfq->cur_id;
+	return 0;
+}
+
+int
+pcap_nfqueue_verdict(pcap_t *p, u_int queue, bpf_u_int32 id, u_int verdict)
+{
+	if (nfqueue_handle(p) == NULL)
+		return -1;
+	return nfqueue_put_verdict(p, NFQNL_MSG_VERDICT, queue, id, verdict);
+}
+
+int
+pcap_nfqueue_verdict_batch(pcap_t *p, u_int queue, bpf_u_int32 id, u_int verdict)
+{
+	struct pcap_nfq *nfq = nfqueue_handle(p);
+
+	if (nfq == NULL)
+		return -1;
+	if (!nfq->batch_ok) {
+		snprintf(p->errbuf, PCAP_ERRBUF_SIZE, "This kernel doesn't support batch verdicts");
+		return -1;
+	}
+	return nfqueue_put_verdict(p, NFQNL_MSG_VERDICT_BATCH, queue, id, verdict);
+}
+
+int
+pcap_nfqueue_flush(pcap_t *p)
+{
+	if (nfqueue_handle(p) == NULL)
+		return -1;
+	return nfqueue_flush_verdicts(p);
+}
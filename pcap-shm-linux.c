@@ -0,0 +1,791 @@
+/*
+ * Copyright (c) 1993, 1994, 1995, 1996, 1997
+ *	The Regents of the University of California.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that: (1) source code distributions
+ * retain the above copyright notice and this paragraph in its entirety, (2)
+ * distributions including binary code include the above copyright notice and
+ * this paragraph in its entirety in the documentation or other materials
+ * provided with the distribution, and (3) all advertising materials mentioning
+ * features or use of this software display the following acknowledgement:
+ * ``This product includes software developed by the University of California,
+ * Lawrence Berkeley Laboratory and its contributors.'' Neither the name of
+ * the University nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * pcap-shm-linux.c - shared-memory packet distribution on Linux
+ *
+ * When several programs capture on the same interface, each of them
+ * normally has its own ring, and the kernel copies every packet into
+ * every ring.  Instead, one program can capture, and hand the packets
+ * to pcap_shm_write(), which puts them into a named ring in shared
+ * memory; any number of other programs can then read them by opening
+ * "shm:<name>" as they would open any other device.
+ *
+ * The ring holds variable-length records, each with a header and the
+ * packet data, written by a single producer that never waits for the
+ * readers.  Each reader has its own position in the ring, its own
+ * filter, and its own count of packets it lost because it fell so far
+ * behind that the producer wrote over them.  There are no locks: the
+ * producer advances the "tail" of the ring, the oldest record still
+ * intact, before writing over any record, so a reader can tell, after
+ * reading a record, whether the producer could have changed it while
+ * it was being read, and if so discard it as lost.  Records carry
+ * sequence numbers, so that a reader knows how many it missed.
+ *
+ * Readers that find the ring empty sleep on a futex in the ring
+ * header, which the producer wakes when it adds packets, if any
+ * readers are asleep.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "pcap-int.h"
+
+#ifdef NEED_STRERROR_H
+#include "strerror.h"
+#endif
+
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include "pcap-shm-linux.h"
+
+#define SHM_IFACE	"shm:"
+
+/*
+ * The shared-memory object for ring "foo" is "/pcap-foo", which
+ * appears as /dev/shm/pcap-foo.
+ */
+#define SHM_PREFIX	"/pcap-"
+
+#define SHM_MAGIC	0x70636d72	/* "pcmr" */
+#define SHM_VERSION	1
+
+/*
+ * The ring header takes up the first page of the shared memory, and
+ * the records follow it.
+ */
+#define SHM_HDR_SIZE	4096
+
+/*
+ * Default size of the record area; bigger than the default for a
+ * PF_PACKET ring, as the slowest of several readers determines how
+ * much of the ring is in use.
+ */
+#define SHM_DEFAULT_SIZE	(8*1024*1024)
+
+/*
+ * Header of the ring, shared by the producer and all readers.  The
+ * producer writes "head" and "tail" for every packet, so they get a
+ * cache line of their own, away from the fields readers write.
+ */
+struct shm_ring {
+	u_int32_t	magic;
+	u_int32_t	version;
+	u_int32_t	linktype;
+	u_int32_t	snaplen;
+	u_int64_t	size;		/* bytes of records after the header */
+	u_int32_t	closed;		/* the producer has closed the ring */
+	u_int32_t	wake;		/* futex word, bumped to wake readers */
+	u_int32_t	waiters;	/* number of readers asleep on "wake" */
+	u_int32_t	pad0;
+	u_char		pad1[64 - 32];
+	u_int64_t	head;		/* where the next record will go */
+	u_int64_t	tail;		/* oldest record not written over */
+	u_int64_t	next_seq;	/* sequence number of the next record */
+};
+
+/*
+ * Header of a record.  Positions in the ring are byte offsets that
+ * only ever increase; a record's place in the record area is its
+ * position modulo the size of the area.  A record never wraps around
+ * the end of the area; instead, the producer fills the end of the
+ * area with a padding record, or, if there's not even room for a
+ * record header, leaves it unused, and starts again at the beginning.
+ */
+struct shm_rec {
+	u_int32_t	reclen;		/* bytes from this record to the next */
+	u_int32_t	caplen;
+	u_int32_t	len;
+	u_int32_t	usec;
+	u_int64_t	sec;
+	u_int64_t	seq;		/* sequence number, or SHM_SEQ_PAD */
+};
+
+#define SHM_SEQ_PAD	((u_int64_t)-1)
+
+#define SHM_ALIGN(n)	(((n) + 7) & ~(u_int64_t)7)
+
+/*
+ * The producer's side of a ring.  Only the producer changes the
+ * head and tail, so it keeps its own copies of them.
+ */
+struct pcap_shm {
+	char		name[NAME_MAX];	/* name of the shared-memory object */
+	struct shm_ring	*ring;
+	u_char		*data;		/* the record area */
+	size_t		maplen;
+	u_int64_t	size;
+	u_int64_t	head;
+	u_int64_t	tail;
+	u_int64_t	seq;
+	u_int32_t	snaplen;
+};
+
+/*
+ * A reader's side of a ring.
+ */
+struct pcap_shm_reader {
+	struct shm_ring	*ring;
+	u_char		*data;
+	size_t		maplen;
+	u_int64_t	size;
+	u_int64_t	pos;		/* position of the next record to read */
+	u_int64_t	next_seq;	/* sequence number we expect there */
+	int		seq_known;	/* we've read a record, so next_seq is valid */
+	u_int64_t	dropped;	/* records written over before we read them */
+	int		nonblock;
+};
+
+static int
+shm_futex(u_int32_t *uaddr, int op, u_int32_t val, const struct timespec *ts)
+{
+	return syscall(SYS_futex, uaddr, op, val, ts, NULL, 0);
+}
+
+/*
+ * Wake up all readers sleeping on the ring.
+ */
+static void
+shm_wake(struct shm_ring *ring)
+{
+	__atomic_add_fetch(&ring->wake, 1, __ATOMIC_SEQ_CST);
+	(void)shm_futex(&ring->wake, FUTEX_WAKE, INT_MAX, NULL);
+}
+
+/*
+ * Map the shared-memory object open on "fd", of "len" bytes.
+ */
+static void *
+shm_map(int fd, size_t len, char *errbuf)
+{
+	void *base;
+
+	base = mmap(NULL, len, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+	if (base == MAP_FAILED) {
+		snprintf(errbuf, PCAP_ERRBUF_SIZE,
+		    "can't mmap shared-memory ring: %s", pcap_strerror(errno));
+		return NULL;
+	}
+	return base;
+}
+
+/*
+ * Check that a ring name is one we can make a shared-memory object
+ * name out of.
+ */
+static int
+shm_check_name(const char *name, char *errbuf)
+{
+	if (name[0] == '\0' || strchr(name, '/') != NULL ||
+	    strlen(SHM_PREFIX) + strlen(name) >= NAME_MAX) {
+		snprintf(errbuf, PCAP_ERRBUF_SIZE,
+		    "\"%s\" isn't a valid shared-memory ring name", name);
+		return -1;
+	}
+	return 0;
+}
+
+pcap_shm_t *
+pcap_shm_open(pcap_t *p, const char *name, int size)
+{
+	pcap_shm_t *shm;
+	struct shm_ring *ring;
+	u_int64_t rsize;
+	int fd;
+
+	/*
+	 * If this pcap_t hasn't been activated, it doesn't have a
+	 * link-layer type or snapshot length, so we can't use it.
+	 */
+	if (!p->activated) {
+		snprintf(p->errbuf, PCAP_ERRBUF_SIZE,
+		    "%s: not-yet-activated pcap_t passed to pcap_shm_open",
+		    name);
+		return (NULL);
+	}
+	if (shm_check_name(name, p->errbuf) == -1)
+		return (NULL);
+
+	/*
+	 * The largest record has to fit in half the ring, so that
+	 * padding at the end never leaves it without room.
+	 */
+	rsize = size > 0 ? SHM_ALIGN((u_int64_t)size) : SHM_DEFAULT_SIZE;
+	if (rsize < 2 * SHM_ALIGN(sizeof(struct shm_rec) + p->snapshot)) {
+		snprintf(p->errbuf, PCAP_ERRBUF_SIZE,
+		    "%s: a ring of %d bytes is too small for a snapshot length of %d",
+		    name, size, p->snapshot);
+		return (NULL);
+	}
+
+	shm = calloc(1, sizeof(*shm));
+	if (shm == NULL) {
+		snprintf(p->errbuf, PCAP_ERRBUF_SIZE,
+		    "malloc: %s", pcap_strerror(errno));
+		return (NULL);
+	}
+	snprintf(shm->name, sizeof(shm->name), "%s%s", SHM_PREFIX, name);
+	shm->size = rsize;
+	shm->maplen = SHM_HDR_SIZE + rsize;
+	shm->snaplen = p->snapshot;
+
+	/*
+	 * Start with a new object, even if one is left over from a
+	 * producer that didn't close its ring; readers that still have
+	 * the old one mapped are unaffected.
+	 */
+	(void)shm_unlink(shm->name);
+	fd = shm_open(shm->name, O_RDWR|O_CREAT|O_EXCL, 0660);
+	if (fd == -1) {
+		snprintf(p->errbuf, PCAP_ERRBUF_SIZE,
+		    "%s: can't create shared-memory ring: %s", name,
+		    pcap_strerror(errno));
+		free(shm);
+		return (NULL);
+	}
+	if (ftruncate(fd, shm->maplen) == -1) {
+		snprintf(p->errbuf, PCAP_ERRBUF_SIZE,
+		    "%s: can't size shared-memory ring: %s", name,
+		    pcap_strerror(errno));
+		close(fd);
+		(void)shm_unlink(shm->name);
+		free(shm);
+		return (NULL);
+	}
+	ring = shm_map(fd, shm->maplen, p->errbuf);
+	close(fd);
+	if (ring == NULL) {
+		(void)shm_unlink(shm->name);
+		free(shm);
+		return (NULL);
+	}
+	shm->ring = ring;
+	shm->data = (u_char *)ring + SHM_HDR_SIZE;
+
+	ring->linktype = p->linktype;
+	ring->snaplen = p->snapshot;
+	ring->size = rsize;
+
+	/*
+	 * Readers check the magic number to see whether the ring is
+	 * ready, so set it last.
+	 */
+	ring->version = SHM_VERSION;
+	__atomic_store_n(&ring->magic, SHM_MAGIC, __ATOMIC_RELEASE);
+	return (shm);
+}
+
+void
+pcap_shm_write(u_char *user, const struct pcap_pkthdr *h, const u_char *sp)
+{
+	pcap_shm_t *shm = (pcap_shm_t *)user;
+	struct shm_ring *ring = shm->ring;
+	struct shm_rec *rec;
+	u_int64_t off, rem, skip, n, toff, trem;
+	u_int32_t caplen;
+
+	caplen = h->caplen;
+	if (caplen > shm->snaplen)
+		caplen = shm->snaplen;
+	n = SHM_ALIGN(sizeof(struct shm_rec) + caplen);
+
+	/*
+	 * If the record doesn't fit before the end of the record area,
+	 * skip to the beginning.
+	 */
+	off = shm->head % shm->size;
+	rem = shm->size - off;
+	skip = rem < n ? rem : 0;
+
+	/*
+	 * Move the tail past every record we're about to write over,
+	 * and make sure readers can see that before we write.
+	 */
+	if (shm->tail + shm->size < shm->head + skip + n) {
+		do {
+			toff = shm->tail % shm->size;
+			trem = shm->size - toff;
+			rec = (struct shm_rec *)(shm->data + toff);
+			if (trem < sizeof(struct shm_rec) ||
+			    rec->seq == SHM_SEQ_PAD)
+				shm->tail += trem;
+			else
+				shm->tail += rec->reclen;
+		} while (shm->tail + shm->size < shm->head + skip + n);
+		__atomic_store_n(&ring->tail, shm->tail, __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+	}
+
+	if (skip != 0) {
+		if (rem >= sizeof(struct shm_rec)) {
+			rec = (struct shm_rec *)(shm->data + off);
+			rec->reclen = rem;
+			rec->seq = SHM_SEQ_PAD;
+		}
+		off = 0;
+	}
+	rec = (struct shm_rec *)(shm->data + off);
+	rec->reclen = n;
+	rec->caplen = caplen;
+	rec->len = h->len;
+	rec->sec = h->ts.tv_sec;
+	rec->usec = h->ts.tv_usec;
+	rec->seq = shm->seq++;
+	memcpy(rec + 1, sp, caplen);
+
+	/*
+	 * Publish the record, and then wake up any readers that went
+	 * to sleep before they could see it.  Both the store and the
+	 * load have to be sequentially consistent, so that either we
+	 * see a reader's count of waiters or it sees the new head.
+	 */
+	shm->head += skip + n;
+	__atomic_store_n(&ring->next_seq, shm->seq, __ATOMIC_RELAXED);
+	__atomic_store_n(&ring->head, shm->head, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&ring->waiters, __ATOMIC_SEQ_CST) != 0)
+		shm_wake(ring);
+}
+
+void
+pcap_shm_close(pcap_shm_t *shm)
+{
+	/*
+	 * Tell readers we're gone, and remove the name, so that no
+	 * more readers can open the ring; readers that have it open
+	 * can still read what's left in it.
+	 */
+	__atomic_store_n(&shm->ring->closed, 1, __ATOMIC_SEQ_CST);
+	shm_wake(shm->ring);
+	(void)shm_unlink(shm->name);
+	munmap(shm->ring, shm->maplen);
+	free(shm);
+}
+
+/*
+ * Wait for the producer to add packets after "pos", for the timeout to
+ * expire, or for pcap_breakloop() to be called.
+ */
+static int
+shm_wait(pcap_t *handle, u_int64_t pos)
+{
+	struct shm_ring *ring = handle->md.shm->ring;
+	struct timespec ts, *tsp = NULL;
+	u_int32_t wake;
+	int ret = 0;
+
+	if (handle->md.timeout > 0) {
+		ts.tv_sec = handle->md.timeout / 1000;
+		ts.tv_nsec = (handle->md.timeout % 1000) * 1000000;
+		tsp = &ts;
+	}
+
+	/*
+	 * Say we're going to sleep before checking for packets; see
+	 * pcap_shm_write().
+	 */
+	__atomic_add_fetch(&ring->waiters, 1, __ATOMIC_SEQ_CST);
+	wake = __atomic_load_n(&ring->wake, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&ring->head, __ATOMIC_SEQ_CST) == pos &&
+	    !__atomic_load_n(&ring->closed, __ATOMIC_SEQ_CST) &&
+	    !handle->break_loop) {
+		if (shm_futex(&ring->wake, FUTEX_WAIT, wake, tsp) == -1 &&
+		    errno != EAGAIN && errno != EINTR && errno != ETIMEDOUT) {
+			snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+			    "can't wait on shared-memory ring: %s",
+			    pcap_strerror(errno));
+			ret = -1;
+		}
+	}
+	__atomic_sub_fetch(&ring->waiters, 1, __ATOMIC_SEQ_CST);
+	return ret;
+}
+
+/*
+ * Has the producer written over, or started writing over, the record
+ * at "pos"?
+ */
+static inline int
+shm_overrun(struct shm_ring *ring, u_int64_t pos)
+{
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	return __atomic_load_n(&ring->tail, __ATOMIC_RELAXED) > pos;
+}
+
+static int
+shm_read_linux(pcap_t *handle, int max_packets, pcap_handler callback,
+    u_char *user)
+{
+	struct pcap_shm_reader *shm = handle->md.shm;
+	struct shm_ring *ring = shm->ring;
+	struct shm_rec rec;
+	struct pcap_pkthdr pkth;
+	u_int64_t head, tail, off, rem;
+	u_char *bp;
+	int count = 0;
+	int accepted;
+
+	head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	if (head == shm->pos) {
+		if (handle->break_loop) {
+			handle->break_loop = 0;
+			return PCAP_ERROR_BREAK;
+		}
+		if (__atomic_load_n(&ring->closed, __ATOMIC_ACQUIRE)) {
+			snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+			    "The shared-memory ring was closed by its producer");
+			return PCAP_ERROR;
+		}
+		if (shm->nonblock)
+			return 0;
+		if (shm_wait(handle, shm->pos) == -1)
+			return PCAP_ERROR;
+		if (handle->break_loop) {
+			handle->break_loop = 0;
+			return PCAP_ERROR_BREAK;
+		}
+		head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	}
+
+	while (shm->pos < head) {
+		/*
+		 * If we've fallen so far behind that the producer has
+		 * written over the next record, skip to the oldest one
+		 * left; the sequence numbers tell us how many we lost.
+		 * The producer moves the tail before the head, so the
+		 * head we see now is past the tail.
+		 */
+		tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+		if (tail > shm->pos) {
+			shm->pos = tail;
+			head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+			continue;
+		}
+
+		off = shm->pos % shm->size;
+		rem = shm->size - off;
+		if (rem < sizeof(struct shm_rec)) {
+			shm->pos += rem;
+			continue;
+		}
+		memcpy(&rec, shm->data + off, sizeof(rec));
+		if (shm_overrun(ring, shm->pos))
+			continue;
+		if (rec.seq == SHM_SEQ_PAD) {
+			shm->pos += rem;
+			continue;
+		}
+		if (rec.reclen < sizeof(rec) || rec.reclen > rem ||
+		    rec.caplen > rec.reclen - sizeof(rec)) {
+			snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+			    "The shared-memory ring is corrupt");
+			return PCAP_ERROR;
+		}
+
+		/*
+		 * Run the filter on the packet in place, copy it if it
+		 * passes, and then check whether it was being written
+		 * over as we did so; if so, it's lost.
+		 */
+		bp = shm->data + off + sizeof(rec);
+		pkth.ts.tv_sec = rec.sec;
+		pkth.ts.tv_usec = rec.usec;
+		pkth.len = rec.len;
+		pkth.caplen = rec.caplen;
+		if (pkth.caplen > (bpf_u_int32)handle->snapshot)
+			pkth.caplen = handle->snapshot;
+		accepted = handle->fcode.bf_insns == NULL ||
+		    pcap_filter_packet(handle->fcode.bf_insns, bp, pkth.len,
+		      &pkth.caplen);
+		if (accepted)
+			memcpy(handle->buffer, bp, pkth.caplen);
+		if (shm_overrun(ring, shm->pos))
+			continue;
+
+		if (shm->seq_known && rec.seq != shm->next_seq)
+			shm->dropped += rec.seq - shm->next_seq;
+		shm->next_seq = rec.seq + 1;
+		shm->seq_known = 1;
+		shm->pos += rec.reclen;
+
+		if (accepted) {
+			handle->md.packets_read++;
+			callback(user, &pkth, handle->buffer);
+			count++;
+		} else
+			handle->md.packets_filtered++;
+
+		if (handle->break_loop) {
+			handle->break_loop = 0;
+			return PCAP_ERROR_BREAK;
+		}
+		if (max_packets > 0 && count >= max_packets)
+			break;
+	}
+	return count;
+}
+
+static int
+shm_inject_linux(pcap_t *handle, const void *buf _U_, size_t size _U_)
+{
+	snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+	    "Packets can't be sent on a shared-memory ring");
+	return (-1);
+}
+
+static int
+shm_stats_linux(pcap_t *handle, struct pcap_stat *stats)
+{
+	struct pcap_shm_reader *shm = handle->md.shm;
+
+	stats->ps_recv = handle->md.packets_read + handle->md.packets_filtered +
+	    shm->dropped;
+	stats->ps_drop = shm->dropped;
+	stats->ps_ifdrop = 0;
+	return (0);
+}
+
+static int
+shm_stats_ex_linux(pcap_t *handle, struct pcap_stat_ex *stats)
+{
+	struct pcap_shm_reader *shm = handle->md.shm;
+	u_int64_t next_seq;
+
+	memset(stats, 0, sizeof(*stats));
+	stats->ps_recv = handle->md.packets_read + handle->md.packets_filtered +
+	    shm->dropped;
+	stats->ps_drop = shm->dropped;
+	stats->ps_accepted = handle->md.packets_read;
+	stats->ps_filtered = handle->md.packets_filtered;
+	if (shm->seq_known) {
+		next_seq = __atomic_load_n(&shm->ring->next_seq,
+		    __ATOMIC_RELAXED);
+		if (next_seq > shm->next_seq)
+			stats->ps_ring_used = next_seq - shm->next_seq;
+	}
+	return (0);
+}
+
+static int
+shm_getnonblock_linux(pcap_t *handle, char *errbuf _U_)
+{
+	return (handle->md.shm->nonblock);
+}
+
+static int
+shm_setnonblock_linux(pcap_t *handle, int nonblock, char *errbuf _U_)
+{
+	handle->md.shm->nonblock = nonblock;
+	return (0);
+}
+
+static void
+shm_breakloop_linux(pcap_t *handle)
+{
+	/*
+	 * Readers of the ring sleep on its futex rather than in poll(),
+	 * so there's no pcap_breakloop() descriptor to write to; wake
+	 * up the thread reading packets, if it's waiting, through the
+	 * futex instead.  That wakes up other readers of the ring, too,
+	 * but they just go back to sleep.
+	 */
+	pcap_breakloop_fd(handle);
+	if (handle->md.shm != NULL)
+		shm_wake(handle->md.shm->ring);
+}
+
+static void
+shm_cleanup_linux(pcap_t *handle)
+{
+	struct pcap_shm_reader *shm = handle->md.shm;
+
+	if (shm != NULL) {
+		if (shm->ring != NULL)
+			munmap(shm->ring, shm->maplen);
+		free(shm);
+		handle->md.shm = NULL;
+	}
+	pcap_breakloop_fd_close(handle);
+	pcap_cleanup_live_common(handle);
+}
+
+static int
+shm_activate(pcap_t *handle)
+{
+	struct pcap_shm_reader *shm;
+	struct shm_ring *ring;
+	const char *name;
+	char path[NAME_MAX];
+	struct stat st;
+	int fd;
+	int status = PCAP_ERROR;
+
+	name = handle->opt.source + sizeof SHM_IFACE - 1;
+	if (shm_check_name(name, handle->errbuf) == -1)
+		return PCAP_ERROR;
+
+	if (handle->opt.rfmon) {
+		/*
+		 * Monitor mode doesn't apply to shared-memory rings.
+		 */
+		return PCAP_ERROR_RFMON_NOTSUP;
+	}
+
+	shm = calloc(1, sizeof(*shm));
+	if (shm == NULL) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "malloc: %s", pcap_strerror(errno));
+		return PCAP_ERROR;
+	}
+	handle->md.shm = shm;
+	handle->md.breakloop_rfd = -1;
+	handle->md.breakloop_wfd = -1;
+
+	handle->read_op = shm_read_linux;
+	handle->inject_op = shm_inject_linux;
+	handle->setfilter_op = install_bpf_program; /* no kernel filtering */
+	handle->setdirection_op = NULL;
+	handle->set_datalink_op = NULL;
+	handle->getnonblock_op = shm_getnonblock_linux;
+	handle->setnonblock_op = shm_setnonblock_linux;
+	handle->stats_op = shm_stats_linux;
+	handle->stats_ex_op = shm_stats_ex_linux;
+	handle->breakloop_op = shm_breakloop_linux;
+	handle->cleanup_op = shm_cleanup_linux;
+
+	snprintf(path, sizeof(path), "%s%s", SHM_PREFIX, name);
+	fd = shm_open(path, O_RDWR, 0);
+	if (fd == -1) {
+		if (errno == ENOENT) {
+			snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+			    "There's no shared-memory ring named %s", name);
+			status = PCAP_ERROR_NO_SUCH_DEVICE;
+		} else if (errno == EACCES) {
+			snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+			    "Can't open shared-memory ring %s: %s", name,
+			    pcap_strerror(errno));
+			status = PCAP_ERROR_PERM_DENIED;
+		} else
+			snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+			    "Can't open shared-memory ring %s: %s", name,
+			    pcap_strerror(errno));
+		goto fail;
+	}
+	if (fstat(fd, &st) == -1) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "fstat: %s", pcap_strerror(errno));
+		close(fd);
+		goto fail;
+	}
+	if (st.st_size < SHM_HDR_SIZE) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "%s isn't a shared-memory packet ring, or isn't ready yet",
+		    name);
+		close(fd);
+		goto fail;
+	}
+	shm->maplen = st.st_size;
+	ring = shm_map(fd, shm->maplen, handle->errbuf);
+	close(fd);
+	if (ring == NULL)
+		goto fail;
+	shm->ring = ring;
+	if (__atomic_load_n(&ring->magic, __ATOMIC_ACQUIRE) != SHM_MAGIC ||
+	    ring->version != SHM_VERSION ||
+	    SHM_HDR_SIZE + ring->size != shm->maplen) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "%s isn't a shared-memory packet ring, or isn't ready yet",
+		    name);
+		goto fail;
+	}
+	shm->data = (u_char *)ring + SHM_HDR_SIZE;
+	shm->size = ring->size;
+
+	/*
+	 * Start with the next packet the producer writes.
+	 */
+	shm->pos = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+	handle->linktype = ring->linktype;
+	if (handle->snapshot <= 0 ||
+	    handle->snapshot > (int)ring->snaplen)
+		handle->snapshot = ring->snaplen;
+	handle->bufsize = handle->snapshot;
+	handle->buffer = malloc(handle->bufsize);
+	if (handle->buffer == NULL) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "malloc: %s", pcap_strerror(errno));
+		goto fail;
+	}
+	handle->offset = 0;
+
+	/*
+	 * There's no descriptor to wait on.
+	 */
+	handle->selectable_fd = -1;
+	return 0;
+
+fail:
+	shm_cleanup_linux(handle);
+	return status;
+}
+
+pcap_t *
+shm_create(const char *device, char *ebuf, int *is_ours)
+{
+	pcap_t *p;
+
+	/* Does it begin with SHM_IFACE? */
+	if (strncmp(device, SHM_IFACE, sizeof SHM_IFACE - 1) != 0) {
+		/* Nope */
+		*is_ours = 0;
+		return NULL;
+	}
+
+	/* OK, it's ours. */
+	*is_ours = 1;
+
+	p = pcap_create_common(device, ebuf);
+	if (p == NULL)
+		return (NULL);
+
+	p->activate_op = shm_activate;
+	return (p);
+}
+
+int
+shm_findalldevs(pcap_if_t **alldevsp _U_, char *err_str _U_)
+{
+	/*
+	 * Rings come and go with the programs that produce them;
+	 * we don't list them.
+	 */
+	return 0;
+}
@@ -60,6 +60,7 @@ static const char rcsid[] _U_ =
 #include <netinet/in.h>
 #include <sys/ioctl.h>
 #include <sys/mman.h>
+#include <poll.h>
 #ifdef HAVE_LINUX_USBDEVICE_FS_H
 /*
  * We might need <linux/compiler.h> to define __user for
@@ -116,15 +117,49 @@ struct mon_bin_mfetch {
 #define MON_IOCX_MFETCH _IOWR(MON_IOC_MAGIC, 7, struct mon_bin_mfetch)
 #define MON_IOCH_MFLUSH _IO(MON_IOC_MAGIC, 8)
 
+/*
+ * Limits the kernel puts on the size of the usbmon ring; it rejects
+ * MON_IOCT_RING_SIZE requests outside them with EINVAL.
+ */
+#define MON_RING_SIZE_MIN	(8*1024)
+#define MON_RING_SIZE_MAX	(1200*1024)
+
+/*
+ * How often, in milliseconds, to look for new events while all the
+ * events in the ring are held.
+ */
+#define USB_HOLD_POLL_MS	10
+
 #define MON_BIN_SETUP 	0x1 /* setup hdr is present*/
 #define MON_BIN_SETUP_ZERO 	0x2 /* setup buffer is not available */
 #define MON_BIN_DATA_ZERO 	0x4 /* data buffer is not available */
 #define MON_BIN_ERROR 	0x8
 
+/*
+ * Number of events fetched by the first MON_IOCX_MFETCH; the batch
+ * doubles while the ring keeps filling it, and halves again once the
+ * ring drains, up to one event per minimum-sized ring slot.
+ */
+#define VEC_SIZE 32
+
+/*
+ * State of a memory-mapped capture: the vector of ring offsets
+ * filled in by MON_IOCX_MFETCH, and the events that have been
+ * fetched but not yet flushed from the ring.
+ */
+struct pcap_usb {
+	int	hold;		/* keep delivered events until pcap_usb_release() */
+	int	batch;		/* current number of events to fetch */
+	int	maxvec;		/* number of entries in vec */
+	int	nheld;		/* events fetched but not flushed */
+	int32_t	*vec;		/* ring offsets of fetched events */
+};
+
 /* forward declaration */
 static int usb_activate(pcap_t *);
 static int usb_stats_linux(pcap_t *, struct pcap_stat *);
 static int usb_stats_linux_bin(pcap_t *, struct pcap_stat *);
+static int usb_stats_ex_linux_bin(pcap_t *, struct pcap_stat_ex *);
 static int usb_read_linux(pcap_t *, int , pcap_handler , u_char *);
 static int usb_read_linux_bin(pcap_t *, int , pcap_handler , u_char *);
 static int usb_read_linux_mmap(pcap_t *, int , pcap_handler , u_char *);
@@ -204,14 +239,42 @@ usb_findalldevs(pcap_if_t **alldevsp, char *err_str)
 static 
 int usb_mmap(pcap_t* handle)
 {
+	struct pcap_usb *usb;
 	int len = ioctl(handle->fd, MON_IOCQ_RING_SIZE);
 	if (len < 0) 
 		return 0;
 
+	/*
+	 * Every event takes at least a mmapped header's worth of the
+	 * ring, so this many offsets is enough for a fetch of
+	 * everything the ring can hold.
+	 */
+	usb = malloc(sizeof(*usb));
+	if (usb == NULL)
+		return 0;
+	usb->hold = 0;
+	usb->batch = VEC_SIZE;
+	usb->nheld = 0;
+	usb->maxvec = len / sizeof(pcap_usb_header_mmapped) + 1;
+	if (usb->maxvec < VEC_SIZE)
+		usb->maxvec = VEC_SIZE;
+	usb->vec = malloc(usb->maxvec * sizeof(int32_t));
+	if (usb->vec == NULL) {
+		free(usb);
+		return 0;
+	}
+
 	handle->md.mmapbuflen = len;
 	handle->md.mmapbuf = mmap(0, handle->md.mmapbuflen, PROT_READ,
 	    MAP_SHARED, handle->fd, 0);
-	return handle->md.mmapbuf != MAP_FAILED;
+	if (handle->md.mmapbuf == MAP_FAILED) {
+		handle->md.mmapbuf = NULL;
+		free(usb->vec);
+		free(usb);
+		return 0;
+	}
+	handle->md.usb = usb;
+	return 1;
 }
 
 #define CTRL_TIMEOUT    (5*1000)        /* milliseconds */
@@ -330,6 +393,7 @@ static int
 usb_activate(pcap_t* handle)
 {
 	char 		full_path[USB_LINE_LEN];
+	int		ring_size;
 
 	/* Initialize some components of the pcap structure. */
 	handle->bufsize = handle->snapshot;
@@ -364,10 +428,29 @@ usb_activate(pcap_t* handle)
 			return PCAP_ERROR_RFMON_NOTSUP;
 		}
 
+		/*
+		 * If a buffer size was specified, resize the kernel's
+		 * ring to match; both the mmapped and the copying
+		 * interfaces read from that ring.  The kernel only
+		 * allows a limited range of sizes, and applications
+		 * often ask for more than it allows, so clamp the size
+		 * to that range, and, if the kernel still rejects it,
+		 * just keep the ring it gave us.
+		 */
+		if (handle->opt.buffer_size != 0) {
+			ring_size = handle->opt.buffer_size;
+			if (ring_size < MON_RING_SIZE_MIN)
+				ring_size = MON_RING_SIZE_MIN;
+			if (ring_size > MON_RING_SIZE_MAX)
+				ring_size = MON_RING_SIZE_MAX;
+			(void)ioctl(handle->fd, MON_IOCT_RING_SIZE, ring_size);
+		}
+
 		/* binary api is available, try to use fast mmap access */
 		if (usb_mmap(handle)) {
 			handle->linktype = DLT_USB_LINUX_MMAPPED;
 			handle->stats_op = usb_stats_linux_bin;
+			handle->stats_ex_op = usb_stats_ex_linux_bin;
 			handle->read_op = usb_read_linux_mmap;
 			handle->cleanup_op = usb_cleanup_linux_mmap;
 			probe_devices(handle->md.ifindex);
@@ -382,6 +465,7 @@ usb_activate(pcap_t* handle)
 
 		/* can't mmap, use plain binary interface access */
 		handle->stats_op = usb_stats_linux_bin;
+		handle->stats_ex_op = usb_stats_ex_linux_bin;
 		handle->read_op = usb_read_linux_bin;
 		probe_devices(handle->md.ifindex);
 	}
@@ -637,12 +721,13 @@ got:
 		pkth.caplen = handle->snapshot;
 
 	if (handle->fcode.bf_insns == NULL ||
-	    bpf_filter(handle->fcode.bf_insns, handle->buffer,
-	      pkth.len, pkth.caplen)) {
+	    pcap_filter_packet(handle->fcode.bf_insns, handle->buffer,
+	      pkth.len, &pkth.caplen)) {
 		handle->md.packets_read++;
 		callback(user, &pkth, handle->buffer);
 		return 1;
 	}
+	handle->md.packets_filtered++;
 	return 0;	/* didn't pass filter */
 }
 
@@ -756,6 +841,79 @@ usb_stats_linux_bin(pcap_t *handle, struct pcap_stat *stats)
 	return 0;
 }
 
+/*
+ * The binary interface also tells us how many events are sitting in
+ * the kernel's buffer waiting to be read.
+ */
+static int
+usb_stats_ex_linux_bin(pcap_t *handle, struct pcap_stat_ex *stats)
+{
+	int ret;
+	struct mon_bin_stats st;
+	ret = ioctl(handle->fd, MON_IOCG_STATS, &st);
+	if (ret < 0)
+	{
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+			"Can't read stats from fd %d:%s ", handle->fd, strerror(errno));
+		return -1;
+	}
+
+	memset(stats, 0, sizeof(*stats));
+	stats->ps_recv = handle->md.packets_read + handle->md.packets_filtered +
+	    st.queued;
+	stats->ps_drop = st.dropped;
+	stats->ps_accepted = handle->md.packets_read;
+	stats->ps_filtered = handle->md.packets_filtered;
+	stats->ps_ring_used = st.queued;
+	return 0;
+}
+
+/*
+ * Wait for events that haven't been delivered yet while every event
+ * in the ring is held.  The kernel only blocks in MON_IOCX_MFETCH, and
+ * only reports the descriptor as readable, while the ring is empty,
+ * and held events are still in the ring, so we have to look at the
+ * number of queued events every so often instead.
+ *
+ * Returns 1 if there are new events, 0 if the read timeout expired or
+ * we're in non-blocking mode, -1 on error, and -2 if pcap_breakloop()
+ * was called.
+ */
+static int
+usb_wait_unheld(pcap_t *handle)
+{
+	struct pcap_usb *usb = handle->md.usb;
+	struct mon_bin_stats st;
+	int waited = 0;
+
+	switch (pcap_getnonblock_fd(handle, handle->errbuf)) {
+
+	case -1:
+		return -1;
+
+	case 1:
+		return 0;
+	}
+	for (;;) {
+		if (handle->break_loop) {
+			handle->break_loop = 0;
+			return -2;
+		}
+		if (ioctl(handle->fd, MON_IOCG_STATS, &st) < 0) {
+			snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+			    "Can't read stats from fd %d: %s", handle->fd,
+			    strerror(errno));
+			return -1;
+		}
+		if ((int)st.queued > usb->nheld)
+			return 1;
+		if (handle->md.timeout > 0 && waited >= handle->md.timeout)
+			return 0;
+		(void)poll(NULL, 0, USB_HOLD_POLL_MS);
+		waited += USB_HOLD_POLL_MS;
+	}
+}
+
 /*
  * see <linux-kernel-source>/Documentation/usb/usbmon.txt and 
  * <linux-kernel-source>/drivers/usb/mon/mon_bin.c binary ABI
@@ -803,49 +961,75 @@ usb_read_linux_bin(pcap_t *handle, int max_packets, pcap_handler callback, u_cha
 	pkth.ts.tv_usec = info.hdr->ts_usec;
 
 	if (handle->fcode.bf_insns == NULL ||
-	    bpf_filter(handle->fcode.bf_insns, handle->buffer,
-	      pkth.len, pkth.caplen)) {
+	    pcap_filter_packet(handle->fcode.bf_insns, handle->buffer,
+	      pkth.len, &pkth.caplen)) {
 		handle->md.packets_read++;
 		callback(user, &pkth, handle->buffer);
 		return 1;
 	}
 
+	handle->md.packets_filtered++;
 	return 0;	/* didn't pass filter */
 }
 
 /*
  * see <linux-kernel-source>/Documentation/usb/usbmon.txt and 
  * <linux-kernel-source>/drivers/usb/mon/mon_bin.c binary ABI
+ *
+ * MON_IOCX_MFETCH always fetches starting at the oldest event that
+ * hasn't been flushed, so while events are being held for the
+ * application we ask for the held ones again and skip over them.
  */
-#define VEC_SIZE 32
 static int
 usb_read_linux_mmap(pcap_t *handle, int max_packets, pcap_handler callback, u_char *user)
 {
+	struct pcap_usb *usb = handle->md.usb;
 	struct mon_bin_mfetch fetch;
-	int32_t vec[VEC_SIZE];
 	struct pcap_pkthdr pkth;
 	pcap_usb_header* hdr;
-	int nflush = 0;
 	int packets = 0;
 	int clen, max_clen;
 
 	max_clen = handle->snapshot - sizeof(pcap_usb_header);
 
 	for (;;) {
-		int i, ret;
+		int i, ret, skip, nnew;
 		int limit = max_packets - packets;
 		if (limit <= 0)
-			limit = VEC_SIZE;
-		if (limit > VEC_SIZE)
-			limit = VEC_SIZE;
+			limit = usb->batch;
+		if (limit > usb->batch)
+			limit = usb->batch;
+
+		skip = usb->hold ? usb->nheld : 0;
+		if (limit > usb->maxvec - skip)
+			limit = usb->maxvec - skip;
+		if (limit <= 0) {
+			/*
+			 * The whole ring is being held; wait for the
+			 * application to release some of it.
+			 */
+			if (packets != 0)
+				break;
+			ret = usb_wait_unheld(handle);
+			if (ret <= 0)
+				return ret;
+			continue;
+		}
 
 		/* try to fetch as many events as possible*/
-		fetch.offvec = vec;
-		fetch.nfetch = limit;
-		fetch.nflush = nflush;
+		fetch.offvec = usb->vec;
+		fetch.nfetch = skip + limit;
+		fetch.nflush = usb->hold ? 0 : usb->nheld;
 		/* ignore interrupt system call errors */
 		do {
 			ret = ioctl(handle->fd, MON_IOCX_MFETCH, &fetch);
+			/*
+			 * The kernel flushes before it waits for
+			 * events, so don't flush again on a retry.
+			 */
+			if (!usb->hold)
+				usb->nheld = 0;
+			fetch.nflush = 0;
 			if (handle->break_loop)
 			{
 				handle->break_loop = 0;
@@ -855,18 +1039,45 @@ usb_read_linux_mmap(pcap_t *handle, int max_packets, pcap_handler callback, u_ch
 		if (ret < 0)
 		{
 			if (errno == EAGAIN)
-				return 0;	/* no data there */
+				return packets;	/* no data there */
 
 			snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
 			    "Can't mfetch fd %d: %s", handle->fd, strerror(errno));
 			return -1;
 		}
 
+		/*
+		 * When everything in the ring is already held the
+		 * kernel won't wait for more, so we have to; if we
+		 * have already delivered some, let the application
+		 * release them instead.
+		 */
+		nnew = fetch.nfetch - skip;
+		if (nnew <= 0) {
+			if (packets != 0)
+				break;
+			ret = usb_wait_unheld(handle);
+			if (ret <= 0)
+				return ret;
+			continue;
+		}
+
+		/*
+		 * Grow the batch while the ring has more waiting than
+		 * we asked for, and shrink it again as it drains.
+		 */
+		if (nnew == limit && limit == usb->batch) {
+			usb->batch *= 2;
+			if (usb->batch > usb->maxvec)
+				usb->batch = usb->maxvec;
+		} else if (nnew < usb->batch / 4 && usb->batch > VEC_SIZE)
+			usb->batch /= 2;
+
 		/* keep track of processed events, we will flush them later */
-		nflush = fetch.nfetch;
-		for (i=0; i<fetch.nfetch; ++i) {
+		usb->nheld += nnew;
+		for (i = skip; i < fetch.nfetch; ++i) {
 			/* discard filler */
-			hdr = (pcap_usb_header*) &handle->md.mmapbuf[vec[i]];
+			hdr = (pcap_usb_header*) &handle->md.mmapbuf[usb->vec[i]];
 			if (hdr->event_type == '@') 
 				continue;
 
@@ -883,12 +1094,13 @@ usb_read_linux_mmap(pcap_t *handle, int max_packets, pcap_handler callback, u_ch
 			pkth.ts.tv_usec = hdr->ts_usec;
 
 			if (handle->fcode.bf_insns == NULL ||
-			    bpf_filter(handle->fcode.bf_insns, (u_char*) hdr,
-			      pkth.len, pkth.caplen)) {
+			    pcap_filter_packet(handle->fcode.bf_insns, (u_char*) hdr,
+			      pkth.len, &pkth.caplen)) {
 				handle->md.packets_read++;
 				callback(user, &pkth, (u_char*) hdr);
 				packets++;
-			}
+			} else
+				handle->md.packets_filtered++;
 		}
 
 		/* with max_packets <= 0 we stop afer the first chunk*/
@@ -897,10 +1109,54 @@ usb_read_linux_mmap(pcap_t *handle, int max_packets, pcap_handler callback, u_ch
 	}
 
 	/* flush pending events*/
-	ioctl(handle->fd, MON_IOCH_MFLUSH, nflush);
+	if (!usb->hold && usb->nheld != 0) {
+		ioctl(handle->fd, MON_IOCH_MFLUSH, usb->nheld);
+		usb->nheld = 0;
+	}
 	return packets;
 }
 
+static struct pcap_usb *
+usb_mmap_handle(pcap_t *p)
+{
+	if (p->md.usb == NULL) {
+		snprintf(p->errbuf, PCAP_ERRBUF_SIZE,
+		    "%s isn't an activated memory-mapped usbmon capture",
+		    p->opt.source);
+		return NULL;
+	}
+	return p->md.usb;
+}
+
+int
+pcap_usb_set_hold(pcap_t *p, int hold)
+{
+	struct pcap_usb *usb = usb_mmap_handle(p);
+
+	if (usb == NULL)
+		return -1;
+	usb->hold = hold;
+	return 0;
+}
+
+int
+pcap_usb_release(pcap_t *p)
+{
+	struct pcap_usb *usb = usb_mmap_handle(p);
+
+	if (usb == NULL)
+		return -1;
+	if (usb->nheld != 0) {
+		if (ioctl(p->fd, MON_IOCH_MFLUSH, usb->nheld) < 0) {
+			snprintf(p->errbuf, PCAP_ERRBUF_SIZE,
+			    "Can't flush fd %d: %s", p->fd, strerror(errno));
+			return -1;
+		}
+		usb->nheld = 0;
+	}
+	return 0;
+}
+
 static void
 usb_cleanup_linux_mmap(pcap_t* handle)
 {
@@ -909,5 +1165,10 @@ usb_cleanup_linux_mmap(pcap_t* handle)
 		munmap(handle->md.mmapbuf, handle->md.mmapbuflen);
 		handle->md.mmapbuf = NULL;
 	}
+	if (handle->md.usb != NULL) {
+		free(handle->md.usb->vec);
+		free(handle->md.usb);
+		handle->md.usb = NULL;
+	}
 	pcap_cleanup_live_common(handle);
 }
@@ -0,0 +1,946 @@
+/*
+ * Copyright (c) 1993, 1994, 1995, 1996, 1997
+ *	The Regents of the University of California.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that: (1) source code distributions
+ * retain the above copyright notice and this paragraph in its entirety, (2)
+ * distributions including binary code include the above copyright notice and
+ * this paragraph in its entirety in the documentation or other materials
+ * provided with the distribution, and (3) all advertising materials mentioning
+ * features or use of this software display the following acknowledgement:
+ * ``This product includes software developed by the University of California,
+ * Lawrence Berkeley Laboratory and its contributors.'' Neither the name of
+ * the University nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * pcap-xdp-linux.c - AF_XDP capture on Linux
+ *
+ * Devices named "xdp:<interface>" or "xdp:<interface>:<queue>" capture
+ * the packets that arrive on one receive queue of the interface (queue
+ * 0 by default) through an AF_XDP socket.  We attach a small XDP
+ * program to the interface that redirects the packets on that queue to
+ * our socket; the driver puts them straight into a region of our
+ * memory (the UMEM) shared with the kernel, with no copying if the
+ * driver supports zero-copy mode, and with a single copy otherwise.
+ *
+ * Note that, unlike a PF_PACKET capture, this steals the packets:
+ * packets on the captured queue are not passed to the network stack.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include "pcap-int.h"
+
+#ifdef NEED_STRERROR_H
+#include "strerror.h"
+#endif
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <net/if.h>
+#include <net/if_arp.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <linux/if_link.h>
+#include <linux/if_xdp.h>
+
+/*
+ * <linux/bpf.h> has its own, eBPF, "struct bpf_insn", which would
+ * clash with ours.
+ */
+#define bpf_insn	ebpf_insn
+#include <linux/bpf.h>
+#undef bpf_insn
+
+#include "pcap-xdp-linux.h"
+
+#define XDP_IFACE	"xdp:"
+
+#ifndef SOL_XDP
+#define SOL_XDP		283
+#endif
+
+#ifndef AF_XDP
+#define AF_XDP		44
+#endif
+
+/*
+ * UMEM frames have to be a power of 2 in size, between 2K and the
+ * page size; in copy mode, the kernel puts XDP_PACKET_HEADROOM bytes
+ * of headroom before the packet in the frame.
+ */
+#define XDP_FRAME_SIZE_MIN	2048
+#define XDP_FRAME_SIZE_MAX	4096
+#define XDP_HEADROOM		256
+
+/*
+ * Don't let rings get too small to keep up.
+ */
+#define XDP_RING_MIN		64
+
+/*
+ * One of the four rings shared with the kernel: the fill and
+ * completion rings, through which we hand UMEM frames to the kernel
+ * for received packets and get back frames of sent packets, and the
+ * RX and TX rings, through which the kernel hands us received packets
+ * and we hand it packets to send.
+ */
+struct xdp_ring {
+	u_int32_t	*producer;
+	u_int32_t	*consumer;
+	u_int32_t	*flags;
+	void		*descs;
+	u_int32_t	mask;
+	void		*map;
+	size_t		maplen;
+};
+
+struct pcap_xdp {
+	char		ifname[IFNAMSIZ];
+	int		ifindex;
+	u_int		queue;
+	u_char		*umem;		/* frames shared with the kernel */
+	size_t		umem_len;
+	u_int		frame_size;
+	u_int		nframes;	/* frames in each of RX and TX halves */
+	struct xdp_ring	rx, tx, fill, comp;
+	u_int64_t	*tx_free;	/* stack of free TX frames */
+	u_int		tx_nfree;
+	int		map_fd;		/* XSKMAP of queue to socket */
+	int		prog_fd;	/* XDP program redirecting to it */
+	int		link_fd;	/* attachment of program to interface */
+	int		promisc_fd;	/* holds the interface in promiscuous mode */
+	int		nonblock;
+	int		zerocopy;	/* driver hands us packets without copying */
+	int		generic;	/* program runs in generic (skb) mode */
+	u_char		*oneshot_buffer;
+};
+
+static inline u_int32_t
+xdp_load_acquire(u_int32_t *p)
+{
+	return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static inline void
+xdp_store_release(u_int32_t *p, u_int32_t v)
+{
+	__atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+static int
+xdp_bpf(int cmd, union bpf_attr *attr)
+{
+	return syscall(SYS_bpf, cmd, attr, sizeof(*attr));
+}
+
+/*
+ * Wait for packets to arrive, for the timeout to expire, or for
+ * pcap_breakloop() to be called.
+ * Returns 0 when the caller should look at the RX ring again, and -1,
+ * with handle->errbuf set, on error.
+ */
+static int
+xdp_wait(pcap_t *handle)
+{
+	struct pollfd pfd[2];
+	int ret;
+
+	pfd[0].fd = handle->fd;
+	pfd[0].events = POLLIN;
+	pfd[0].revents = 0;
+	pfd[1].fd = handle->md.breakloop_rfd;
+	pfd[1].events = POLLIN;
+	pfd[1].revents = 0;
+	ret = poll(pfd, 2, handle->md.timeout > 0 ? handle->md.timeout : -1);
+	if (ret == -1) {
+		if (errno == EINTR)
+			return 0;
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "can't poll on AF_XDP socket: %s", pcap_strerror(errno));
+		return -1;
+	}
+	if (ret > 0 && (pfd[0].revents & (POLLERR|POLLHUP|POLLNVAL))) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "error condition on AF_XDP socket");
+		return -1;
+	}
+	if (pfd[1].revents & POLLIN)
+		pcap_breakloop_fd_drain(handle);
+	return 0;
+}
+
+static int
+xdp_read_linux(pcap_t *handle, int max_packets, pcap_handler callback,
+    u_char *user)
+{
+	struct pcap_xdp *xdp = handle->md.xdp;
+	struct xdp_desc *desc;
+	u_int64_t *fill;
+	struct pcap_pkthdr pkth;
+	u_int32_t cons, prod, fprod, n, i;
+	int count = 0;
+	u_char *bp;
+
+	cons = *xdp->rx.consumer;
+	prod = xdp_load_acquire(xdp->rx.producer);
+	if (prod == cons) {
+		if (handle->break_loop) {
+			handle->break_loop = 0;
+			return PCAP_ERROR_BREAK;
+		}
+		if (xdp->nonblock)
+			return 0;
+		if (xdp_wait(handle) == -1)
+			return PCAP_ERROR;
+		if (handle->break_loop) {
+			handle->break_loop = 0;
+			return PCAP_ERROR_BREAK;
+		}
+		prod = xdp_load_acquire(xdp->rx.producer);
+		if (prod == cons)
+			return 0;
+	}
+
+	n = prod - cons;
+	if (max_packets > 0 && n > (u_int32_t)max_packets)
+		n = max_packets;
+
+	/*
+	 * Refill policy: every frame we take off the RX ring goes back
+	 * on the fill ring as soon as the batch is done.  The fill ring
+	 * is as big as the RX half of the UMEM, so there's always room,
+	 * and the kernel never has fewer frames to fill than we've left
+	 * unread.
+	 */
+	desc = xdp->rx.descs;
+	fill = xdp->fill.descs;
+	fprod = *xdp->fill.producer;
+	for (i = 0; i < n; ) {
+		struct xdp_desc *d = &desc[(cons + i) & xdp->rx.mask];
+
+		bp = xdp->umem + d->addr;
+		fill[(fprod + i) & xdp->fill.mask] =
+		    d->addr & ~(u_int64_t)(xdp->frame_size - 1);
+		i++;
+
+		gettimeofday(&pkth.ts, NULL);
+		pkth.len = d->len;
+		pkth.caplen = d->len;
+		if (pkth.caplen > (bpf_u_int32)handle->snapshot)
+			pkth.caplen = handle->snapshot;
+		if (handle->fcode.bf_insns == NULL ||
+		    pcap_filter_packet(handle->fcode.bf_insns, bp, pkth.len,
+		      &pkth.caplen)) {
+			handle->md.packets_read++;
+			callback(user, &pkth, bp);
+			count++;
+		} else
+			handle->md.packets_filtered++;
+
+		if (handle->break_loop)
+			break;
+	}
+	xdp_store_release(xdp->rx.consumer, cons + i);
+	xdp_store_release(xdp->fill.producer, fprod + i);
+
+	/*
+	 * If the driver ran out of frames to fill and went to sleep,
+	 * wake it up; poll() would do that too, but we might not get
+	 * there before the next burst.
+	 */
+	if (*xdp->fill.flags & XDP_RING_NEED_WAKEUP)
+		(void)recvfrom(handle->fd, NULL, 0, MSG_DONTWAIT, NULL, NULL);
+
+	if (handle->break_loop) {
+		handle->break_loop = 0;
+		return PCAP_ERROR_BREAK;
+	}
+	return count;
+}
+
+/*
+ * pcap_next() and pcap_next_ex() expect the packet to stay around
+ * after the callback returns, but its frame goes back to the kernel
+ * then; copy it, as the memory-mapped PF_PACKET code does.
+ */
+static void
+xdp_oneshot(u_char *user, const struct pcap_pkthdr *h, const u_char *bytes)
+{
+	struct oneshot_userdata *sp = (struct oneshot_userdata *)user;
+
+	*sp->hdr = *h;
+	memcpy(sp->pd->md.xdp->oneshot_buffer, bytes, h->caplen);
+	*sp->pkt = sp->pd->md.xdp->oneshot_buffer;
+}
+
+/*
+ * Take the frames of packets the kernel has finished sending off the
+ * completion ring and put them back on the free list.
+ */
+static void
+xdp_reap_tx(struct pcap_xdp *xdp)
+{
+	u_int64_t *comp = xdp->comp.descs;
+	u_int32_t cons, prod;
+
+	cons = *xdp->comp.consumer;
+	prod = xdp_load_acquire(xdp->comp.producer);
+	while (cons != prod) {
+		xdp->tx_free[xdp->tx_nfree++] = comp[cons & xdp->comp.mask];
+		cons++;
+	}
+	xdp_store_release(xdp->comp.consumer, cons);
+}
+
+static int
+xdp_inject_linux(pcap_t *handle, const void *buf, size_t size)
+{
+	struct pcap_xdp *xdp = handle->md.xdp;
+	struct xdp_desc *desc;
+	u_int32_t prod;
+	u_int64_t addr;
+
+	if (size > xdp->frame_size) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "packet too big to send on AF_XDP socket: %lu bytes",
+		    (unsigned long)size);
+		return (-1);
+	}
+
+	xdp_reap_tx(xdp);
+	if (xdp->tx_nfree == 0) {
+		/*
+		 * Everything's in flight; give the kernel a push and
+		 * see if that frees anything up.
+		 */
+		(void)sendto(handle->fd, NULL, 0, MSG_DONTWAIT, NULL, 0);
+		xdp_reap_tx(xdp);
+		if (xdp->tx_nfree == 0) {
+			snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+			    "no free transmit buffers on AF_XDP socket");
+			return (-1);
+		}
+	}
+
+	addr = xdp->tx_free[--xdp->tx_nfree];
+	memcpy(xdp->umem + addr, buf, size);
+	desc = xdp->tx.descs;
+	prod = *xdp->tx.producer;
+	desc[prod & xdp->tx.mask].addr = addr;
+	desc[prod & xdp->tx.mask].len = size;
+	desc[prod & xdp->tx.mask].options = 0;
+	xdp_store_release(xdp->tx.producer, prod + 1);
+
+	/*
+	 * In copy mode, the kernel only sends when we tell it to; in
+	 * zero-copy mode, only when the driver asks for it.
+	 */
+	if (!xdp->zerocopy || (*xdp->tx.flags & XDP_RING_NEED_WAKEUP)) {
+		if (sendto(handle->fd, NULL, 0, MSG_DONTWAIT, NULL, 0) == -1 &&
+		    errno != EAGAIN && errno != EBUSY && errno != ENOBUFS) {
+			snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+			    "send: %s", pcap_strerror(errno));
+			return (-1);
+		}
+	}
+	return (size);
+}
+
+static int
+xdp_get_stats(pcap_t *handle, struct xdp_statistics *st)
+{
+	socklen_t len = sizeof(*st);
+
+	memset(st, 0, sizeof(*st));
+	if (getsockopt(handle->fd, SOL_XDP, XDP_STATISTICS, st, &len) == -1) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "XDP_STATISTICS: %s", pcap_strerror(errno));
+		return (-1);
+	}
+	return (0);
+}
+
+static int
+xdp_stats_linux(pcap_t *handle, struct pcap_stat *stats)
+{
+	struct xdp_statistics st;
+
+	if (xdp_get_stats(handle, &st) == -1)
+		return (-1);
+	stats->ps_drop = st.rx_dropped + st.rx_ring_full;
+	stats->ps_recv = handle->md.packets_read + handle->md.packets_filtered +
+	    stats->ps_drop;
+	stats->ps_ifdrop = st.rx_fill_ring_empty_descs;
+	return (0);
+}
+
+static int
+xdp_stats_ex_linux(pcap_t *handle, struct pcap_stat_ex *stats)
+{
+	struct pcap_xdp *xdp = handle->md.xdp;
+	struct xdp_statistics st;
+
+	if (xdp_get_stats(handle, &st) == -1)
+		return (-1);
+	memset(stats, 0, sizeof(*stats));
+	stats->ps_drop = st.rx_dropped + st.rx_ring_full;
+	stats->ps_recv = handle->md.packets_read + handle->md.packets_filtered +
+	    stats->ps_drop;
+	stats->ps_ifdrop = st.rx_fill_ring_empty_descs;
+	stats->ps_accepted = handle->md.packets_read;
+	stats->ps_filtered = handle->md.packets_filtered;
+	stats->ps_ring_full = st.rx_ring_full;
+	stats->ps_ring_used = xdp_load_acquire(xdp->rx.producer) -
+	    *xdp->rx.consumer;
+	stats->ps_ring_size = xdp->rx.mask + 1;
+	return (0);
+}
+
+static int
+xdp_getnonblock_linux(pcap_t *handle, char *errbuf _U_)
+{
+	return (handle->md.xdp->nonblock);
+}
+
+static int
+xdp_setnonblock_linux(pcap_t *handle, int nonblock, char *errbuf _U_)
+{
+	handle->md.xdp->nonblock = nonblock;
+	return (0);
+}
+
+static void
+xdp_unmap_ring(struct xdp_ring *ring)
+{
+	if (ring->map != NULL) {
+		munmap(ring->map, ring->maplen);
+		ring->map = NULL;
+	}
+}
+
+static void
+xdp_cleanup_linux(pcap_t *handle)
+{
+	struct pcap_xdp *xdp = handle->md.xdp;
+
+	if (xdp != NULL) {
+		/*
+		 * Closing the link detaches the program from the
+		 * interface; the program and map go away when their
+		 * last descriptors are closed.
+		 */
+		if (xdp->link_fd != -1)
+			close(xdp->link_fd);
+		if (xdp->prog_fd != -1)
+			close(xdp->prog_fd);
+		if (xdp->map_fd != -1)
+			close(xdp->map_fd);
+		if (xdp->promisc_fd != -1)
+			close(xdp->promisc_fd);
+		xdp_unmap_ring(&xdp->rx);
+		xdp_unmap_ring(&xdp->tx);
+		xdp_unmap_ring(&xdp->fill);
+		xdp_unmap_ring(&xdp->comp);
+		if (handle->fd != -1) {
+			close(handle->fd);
+			handle->fd = -1;
+		}
+		if (xdp->umem != NULL)
+			munmap(xdp->umem, xdp->umem_len);
+		free(xdp->tx_free);
+		free(xdp->oneshot_buffer);
+		free(xdp);
+		handle->md.xdp = NULL;
+	}
+	pcap_breakloop_fd_close(handle);
+	pcap_cleanup_live_common(handle);
+}
+
+/*
+ * Map one of the rings, given its offsets and the page offset at which
+ * the kernel makes it available, and the size of its entries.
+ */
+static int
+xdp_map_ring(pcap_t *handle, struct xdp_ring *ring,
+    const struct xdp_ring_offset *off, off_t pgoff, u_int nentries,
+    size_t entsize)
+{
+	ring->maplen = off->desc + nentries * entsize;
+	ring->map = mmap(NULL, ring->maplen, PROT_READ|PROT_WRITE,
+	    MAP_SHARED|MAP_POPULATE, handle->fd, pgoff);
+	if (ring->map == MAP_FAILED) {
+		ring->map = NULL;
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "can't mmap AF_XDP ring: %s", pcap_strerror(errno));
+		return (-1);
+	}
+	ring->producer = (u_int32_t *)((u_char *)ring->map + off->producer);
+	ring->consumer = (u_int32_t *)((u_char *)ring->map + off->consumer);
+	ring->flags = (u_int32_t *)((u_char *)ring->map + off->flags);
+	ring->descs = (u_char *)ring->map + off->desc;
+	ring->mask = nentries - 1;
+	return (0);
+}
+
+/*
+ * Set up the UMEM and the four rings on the socket, and map them.
+ */
+static int
+xdp_setup_rings(pcap_t *handle)
+{
+	struct pcap_xdp *xdp = handle->md.xdp;
+	struct xdp_umem_reg reg;
+	struct xdp_mmap_offsets off;
+	socklen_t optlen;
+	u_int64_t *fill;
+	u_int i;
+
+	xdp->umem_len = (size_t)2 * xdp->nframes * xdp->frame_size;
+	xdp->umem = mmap(NULL, xdp->umem_len, PROT_READ|PROT_WRITE,
+	    MAP_PRIVATE|MAP_ANONYMOUS|MAP_POPULATE, -1, 0);
+	if (xdp->umem == MAP_FAILED) {
+		xdp->umem = NULL;
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "can't allocate AF_XDP UMEM: %s", pcap_strerror(errno));
+		return (-1);
+	}
+
+	memset(&reg, 0, sizeof(reg));
+	reg.addr = (u_int64_t)(unsigned long)xdp->umem;
+	reg.len = xdp->umem_len;
+	reg.chunk_size = xdp->frame_size;
+	reg.headroom = 0;
+	if (setsockopt(handle->fd, SOL_XDP, XDP_UMEM_REG, &reg,
+	    sizeof(reg)) == -1) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "XDP_UMEM_REG: %s", pcap_strerror(errno));
+		return (-1);
+	}
+	if (setsockopt(handle->fd, SOL_XDP, XDP_UMEM_FILL_RING,
+	      &xdp->nframes, sizeof(xdp->nframes)) == -1 ||
+	    setsockopt(handle->fd, SOL_XDP, XDP_UMEM_COMPLETION_RING,
+	      &xdp->nframes, sizeof(xdp->nframes)) == -1 ||
+	    setsockopt(handle->fd, SOL_XDP, XDP_RX_RING,
+	      &xdp->nframes, sizeof(xdp->nframes)) == -1 ||
+	    setsockopt(handle->fd, SOL_XDP, XDP_TX_RING,
+	      &xdp->nframes, sizeof(xdp->nframes)) == -1) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "can't create AF_XDP rings: %s", pcap_strerror(errno));
+		return (-1);
+	}
+
+	optlen = sizeof(off);
+	if (getsockopt(handle->fd, SOL_XDP, XDP_MMAP_OFFSETS, &off,
+	    &optlen) == -1) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "XDP_MMAP_OFFSETS: %s", pcap_strerror(errno));
+		return (-1);
+	}
+	if (optlen != sizeof(off)) {
+		/*
+		 * Kernels before 5.4 don't have ring flags, so we
+		 * couldn't tell when the driver needs waking up.
+		 */
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "AF_XDP capture needs a newer kernel");
+		return (-1);
+	}
+	if (xdp_map_ring(handle, &xdp->rx, &off.rx, XDP_PGOFF_RX_RING,
+	      xdp->nframes, sizeof(struct xdp_desc)) == -1 ||
+	    xdp_map_ring(handle, &xdp->tx, &off.tx, XDP_PGOFF_TX_RING,
+	      xdp->nframes, sizeof(struct xdp_desc)) == -1 ||
+	    xdp_map_ring(handle, &xdp->fill, &off.fr,
+	      XDP_UMEM_PGOFF_FILL_RING, xdp->nframes,
+	      sizeof(u_int64_t)) == -1 ||
+	    xdp_map_ring(handle, &xdp->comp, &off.cr,
+	      XDP_UMEM_PGOFF_COMPLETION_RING, xdp->nframes,
+	      sizeof(u_int64_t)) == -1)
+		return (-1);
+
+	/*
+	 * The first half of the UMEM is for received packets; hand all
+	 * of it to the kernel.  The second half is for packets we send.
+	 */
+	fill = xdp->fill.descs;
+	for (i = 0; i < xdp->nframes; i++)
+		fill[i] = (u_int64_t)i * xdp->frame_size;
+	xdp_store_release(xdp->fill.producer, xdp->nframes);
+
+	xdp->tx_free = malloc(xdp->nframes * sizeof(*xdp->tx_free));
+	if (xdp->tx_free == NULL) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "can't allocate AF_XDP transmit list: %s",
+		    pcap_strerror(errno));
+		return (-1);
+	}
+	for (i = 0; i < xdp->nframes; i++)
+		xdp->tx_free[i] = (u_int64_t)(xdp->nframes + i) *
+		    xdp->frame_size;
+	xdp->tx_nfree = xdp->nframes;
+	return (0);
+}
+
+/*
+ * Load an XDP program that redirects packets on each receive queue to
+ * the AF_XDP socket in that queue's slot of an XSKMAP, and passes them
+ * to the network stack if there isn't one, and attach it to the
+ * interface, in driver mode if the driver supports XDP and in generic
+ * mode, which works on any device, including veth devices, if not.
+ */
+static int
+xdp_attach_prog(pcap_t *handle)
+{
+	struct pcap_xdp *xdp = handle->md.xdp;
+	union bpf_attr attr;
+	struct ebpf_insn prog[6];
+
+	memset(&attr, 0, sizeof(attr));
+	attr.map_type = BPF_MAP_TYPE_XSKMAP;
+	attr.key_size = sizeof(u_int32_t);
+	attr.value_size = sizeof(u_int32_t);
+	attr.max_entries = xdp->queue + 1;
+	xdp->map_fd = xdp_bpf(BPF_MAP_CREATE, &attr);
+	if (xdp->map_fd == -1) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "can't create XSKMAP: %s", pcap_strerror(errno));
+		return (-1);
+	}
+
+	/*
+	 * r2 = ctx->rx_queue_index;
+	 * return bpf_redirect_map(map, r2, XDP_PASS);
+	 */
+	memset(prog, 0, sizeof(prog));
+	prog[0].code = BPF_LDX | BPF_MEM | BPF_W;
+	prog[0].dst_reg = BPF_REG_2;
+	prog[0].src_reg = BPF_REG_1;
+	prog[0].off = offsetof(struct xdp_md, rx_queue_index);
+	prog[1].code = BPF_LD | BPF_DW | BPF_IMM;
+	prog[1].dst_reg = BPF_REG_1;
+	prog[1].src_reg = BPF_PSEUDO_MAP_FD;
+	prog[1].imm = xdp->map_fd;
+	/* prog[2] is the second half of the 64-bit load */
+	prog[3].code = BPF_ALU64 | BPF_MOV | BPF_K;
+	prog[3].dst_reg = BPF_REG_3;
+	prog[3].imm = XDP_PASS;
+	prog[4].code = BPF_JMP | BPF_CALL;
+	prog[4].imm = BPF_FUNC_redirect_map;
+	prog[5].code = BPF_JMP | BPF_EXIT;
+
+	memset(&attr, 0, sizeof(attr));
+	attr.prog_type = BPF_PROG_TYPE_XDP;
+	attr.insns = (u_int64_t)(unsigned long)prog;
+	attr.insn_cnt = sizeof(prog) / sizeof(prog[0]);
+	attr.license = (u_int64_t)(unsigned long)"Dual BSD/GPL";
+	xdp->prog_fd = xdp_bpf(BPF_PROG_LOAD, &attr);
+	if (xdp->prog_fd == -1) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "can't load XDP program: %s", pcap_strerror(errno));
+		return (-1);
+	}
+
+	memset(&attr, 0, sizeof(attr));
+	attr.link_create.prog_fd = xdp->prog_fd;
+	attr.link_create.target_fd = xdp->ifindex;
+	attr.link_create.attach_type = BPF_XDP;
+	attr.link_create.flags = XDP_FLAGS_DRV_MODE;
+	xdp->link_fd = xdp_bpf(BPF_LINK_CREATE, &attr);
+	if (xdp->link_fd == -1 && errno != EBUSY && errno != EEXIST) {
+		attr.link_create.flags = XDP_FLAGS_SKB_MODE;
+		xdp->link_fd = xdp_bpf(BPF_LINK_CREATE, &attr);
+		xdp->generic = 1;
+	}
+	if (xdp->link_fd == -1) {
+		if (errno == EBUSY || errno == EEXIST)
+			snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+			    "%s already has an XDP program attached",
+			    xdp->ifname);
+		else
+			snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+			    "can't attach XDP program: %s",
+			    pcap_strerror(errno));
+		return (-1);
+	}
+	return (0);
+}
+
+/*
+ * Bind the socket to the queue, in zero-copy mode if the driver can
+ * do it and in copy mode if it can't, and put it in the XSKMAP.
+ */
+static int
+xdp_bind(pcap_t *handle)
+{
+	struct pcap_xdp *xdp = handle->md.xdp;
+	struct sockaddr_xdp sxdp;
+	union bpf_attr attr;
+	u_int32_t key, value;
+	int ret = -1;
+
+	memset(&sxdp, 0, sizeof(sxdp));
+	sxdp.sxdp_family = AF_XDP;
+	sxdp.sxdp_ifindex = xdp->ifindex;
+	sxdp.sxdp_queue_id = xdp->queue;
+	if (!xdp->generic) {
+		sxdp.sxdp_flags = XDP_ZEROCOPY | XDP_USE_NEED_WAKEUP;
+		ret = bind(handle->fd, (struct sockaddr *)&sxdp, sizeof(sxdp));
+		xdp->zerocopy = (ret == 0);
+	}
+	if (ret == -1) {
+		sxdp.sxdp_flags = XDP_COPY | XDP_USE_NEED_WAKEUP;
+		ret = bind(handle->fd, (struct sockaddr *)&sxdp, sizeof(sxdp));
+	}
+	if (ret == -1) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "can't bind AF_XDP socket to queue %u of %s: %s",
+		    xdp->queue, xdp->ifname, pcap_strerror(errno));
+		return (-1);
+	}
+
+	key = xdp->queue;
+	value = handle->fd;
+	memset(&attr, 0, sizeof(attr));
+	attr.map_fd = xdp->map_fd;
+	attr.key = (u_int64_t)(unsigned long)&key;
+	attr.value = (u_int64_t)(unsigned long)&value;
+	attr.flags = BPF_ANY;
+	if (xdp_bpf(BPF_MAP_UPDATE_ELEM, &attr) == -1) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "can't add AF_XDP socket to XSKMAP: %s",
+		    pcap_strerror(errno));
+		return (-1);
+	}
+	return (0);
+}
+
+/*
+ * Put the interface in promiscuous mode for as long as we have it open;
+ * the kernel takes it out again when the socket is closed.
+ */
+static int
+xdp_set_promisc(pcap_t *handle)
+{
+	struct pcap_xdp *xdp = handle->md.xdp;
+	struct packet_mreq mr;
+
+	xdp->promisc_fd = socket(PF_PACKET, SOCK_RAW, 0);
+	if (xdp->promisc_fd == -1) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "socket: %s", pcap_strerror(errno));
+		return (-1);
+	}
+	memset(&mr, 0, sizeof(mr));
+	mr.mr_ifindex = xdp->ifindex;
+	mr.mr_type = PACKET_MR_PROMISC;
+	if (setsockopt(xdp->promisc_fd, SOL_PACKET, PACKET_ADD_MEMBERSHIP,
+	    &mr, sizeof(mr)) == -1) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "setsockopt: %s", pcap_strerror(errno));
+		return (-1);
+	}
+	return (0);
+}
+
+static int
+xdp_activate(pcap_t *handle)
+{
+	struct pcap_xdp *xdp;
+	const char *dev;
+	const char *cp;
+	char *end;
+	struct ifreq ifr;
+	size_t len;
+	u_long queue = 0;
+	u_int frames;
+	int fd;
+	int status = PCAP_ERROR;
+
+	/*
+	 * Get the interface name, and the queue number, if any.
+	 */
+	dev = handle->opt.source + sizeof XDP_IFACE - 1;
+	cp = strchr(dev, ':');
+	len = cp != NULL ? (size_t)(cp - dev) : strlen(dev);
+	if (len == 0 || len >= IFNAMSIZ) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "Can't get interface name from %s", handle->opt.source);
+		return PCAP_ERROR;
+	}
+	if (cp != NULL) {
+		queue = strtoul(cp + 1, &end, 10);
+		if (end == cp + 1 || *end != '\0' || queue > 65535) {
+			snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+			    "Can't get queue number from %s",
+			    handle->opt.source);
+			return PCAP_ERROR;
+		}
+	}
+
+	if (handle->opt.rfmon) {
+		/*
+		 * Monitor mode doesn't apply to AF_XDP captures.
+		 */
+		return PCAP_ERROR_RFMON_NOTSUP;
+	}
+
+	xdp = calloc(1, sizeof(*xdp));
+	if (xdp == NULL) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "malloc: %s", pcap_strerror(errno));
+		return PCAP_ERROR;
+	}
+	memcpy(xdp->ifname, dev, len);
+	xdp->ifname[len] = '\0';
+	xdp->queue = queue;
+	xdp->map_fd = -1;
+	xdp->prog_fd = -1;
+	xdp->link_fd = -1;
+	xdp->promisc_fd = -1;
+	handle->md.xdp = xdp;
+	handle->md.breakloop_rfd = -1;
+	handle->md.breakloop_wfd = -1;
+
+	handle->read_op = xdp_read_linux;
+	handle->inject_op = xdp_inject_linux;
+	handle->setfilter_op = install_bpf_program; /* no kernel filtering */
+	handle->setdirection_op = NULL;
+	handle->set_datalink_op = NULL;
+	handle->getnonblock_op = xdp_getnonblock_linux;
+	handle->setnonblock_op = xdp_setnonblock_linux;
+	handle->stats_op = xdp_stats_linux;
+	handle->stats_ex_op = xdp_stats_ex_linux;
+	handle->breakloop_op = pcap_breakloop_fd;
+	handle->cleanup_op = xdp_cleanup_linux;
+	handle->oneshot_callback = xdp_oneshot;
+
+	handle->fd = socket(AF_XDP, SOCK_RAW, 0);
+	if (handle->fd == -1) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "Can't create AF_XDP socket: %s", pcap_strerror(errno));
+		goto fail;
+	}
+
+	/*
+	 * We can only capture on Ethernet devices, and the frames have
+	 * to be big enough for the largest packet the device can get.
+	 */
+	memset(&ifr, 0, sizeof(ifr));
+	strncpy(ifr.ifr_name, xdp->ifname, sizeof(ifr.ifr_name));
+	fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (fd == -1 || ioctl(fd, SIOCGIFINDEX, &ifr) == -1) {
+		if (errno == ENODEV) {
+			snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+			    "%s: No such device exists", xdp->ifname);
+			status = PCAP_ERROR_NO_SUCH_DEVICE;
+		} else
+			snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+			    "SIOCGIFINDEX: %s", pcap_strerror(errno));
+		if (fd != -1)
+			close(fd);
+		goto fail;
+	}
+	xdp->ifindex = ifr.ifr_ifindex;
+	if (ioctl(fd, SIOCGIFHWADDR, &ifr) == -1 ||
+	    ifr.ifr_hwaddr.sa_family != ARPHRD_ETHER) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "%s isn't an Ethernet device", xdp->ifname);
+		close(fd);
+		goto fail;
+	}
+	xdp->frame_size = XDP_FRAME_SIZE_MIN;
+	if (ioctl(fd, SIOCGIFMTU, &ifr) == 0 &&
+	    ifr.ifr_mtu + ETH_HLEN + 4 + XDP_HEADROOM > XDP_FRAME_SIZE_MIN)
+		xdp->frame_size = XDP_FRAME_SIZE_MAX;
+	close(fd);
+
+	/*
+	 * The buffer size is the size of the receive half of the UMEM;
+	 * by default, use 2M, as for PF_PACKET rings.  The rings have
+	 * to be a power of 2 in size.
+	 */
+	if (handle->opt.buffer_size == 0)
+		handle->opt.buffer_size = 2*1024*1024;
+	frames = handle->opt.buffer_size / xdp->frame_size;
+	for (xdp->nframes = XDP_RING_MIN; xdp->nframes * 2 <= frames; )
+		xdp->nframes *= 2;
+
+	xdp->oneshot_buffer = malloc(handle->snapshot);
+	if (xdp->oneshot_buffer == NULL) {
+		snprintf(handle->errbuf, PCAP_ERRBUF_SIZE,
+		    "can't allocate oneshot buffer: %s", pcap_strerror(errno));
+		goto fail;
+	}
+
+	if (pcap_breakloop_fd_open(handle) == -1)
+		goto fail;
+
+	if (xdp_setup_rings(handle) == -1 ||
+	    xdp_attach_prog(handle) == -1 ||
+	    xdp_bind(handle) == -1)
+		goto fail;
+
+	if (handle->opt.promisc && xdp_set_promisc(handle) == -1)
+		goto fail;
+
+	handle->linktype = DLT_EN10MB;
+	handle->bufsize = xdp->frame_size;
+	handle->offset = 0;
+	handle->selectable_fd = handle->fd;
+	return 0;
+
+fail:
+	xdp_cleanup_linux(handle);
+	return status;
+}
+
+pcap_t *
+xdp_create(const char *device, char *ebuf, int *is_ours)
+{
+	pcap_t *p;
+
+	/* Does it begin with XDP_IFACE? */
+	if (strncmp(device, XDP_IFACE, sizeof XDP_IFACE - 1) != 0) {
+		/* Nope */
+		*is_ours = 0;
+		return NULL;
+	}
+
+	/* OK, it's ours. */
+	*is_ours = 1;
+
+	p = pcap_create_common(device, ebuf);
+	if (p == NULL)
+		return (NULL);
+
+	p->activate_op = xdp_activate;
+	return (p);
+}
+
+int
+xdp_findalldevs(pcap_if_t **alldevsp _U_, char *err_str _U_)
+{
+	/*
+	 * Any Ethernet interface can be opened as "xdp:<interface>";
+	 * rather than listing every interface twice, we don't list
+	 * them at all.
+	 */
+	return 0;
+}
@@ -72,6 +72,7 @@ static const char rcsid[] _U_ =
 #endif
 
 #include "pcap-int.h"
+#include "flowhash.h"
 
 #ifdef HAVE_DAG_API
 #include "pcap-dag.h"
@@ -105,6 +106,18 @@ static const char rcsid[] _U_ =
 #include "pcap-netfilter-linux.h"
 #endif
 
+#ifdef PCAP_SUPPORT_XDP
+#include "pcap-xdp-linux.h"
+#endif
+
+#ifdef PCAP_SUPPORT_MULTI
+#include "pcap-multi-linux.h"
+#endif
+
+#ifdef PCAP_SUPPORT_SHM
+#include "pcap-shm-linux.h"
+#endif
+
 #ifdef PCAP_SUPPORT_DBUS
 #include "pcap-dbus.h"
 #endif
@@ -226,7 +239,7 @@ pcap_next_ex(pcap_t *p, struct pcap_pkthdr **pkt_header,
 	/* Saves a pointer to the packet headers */
 	*pkt_header= &p->pcap_header;
 
-	if (p->sf.rfile != NULL) {
+	if (PCAP_IS_SAVEFILE(p)) {
 		int status;
 
 		/* We are on an offline capture */
@@ -328,8 +341,21 @@ struct capture_source_type {
 #ifdef PCAP_SUPPORT_NETFILTER
 	{ netfilter_findalldevs, netfilter_create },
 #endif
+#ifdef PCAP_SUPPORT_XDP
+	{ xdp_findalldevs, xdp_create },
+#endif
+#ifdef PCAP_SUPPORT_SHM
+	{ shm_findalldevs, shm_create },
+#endif
 #ifdef PCAP_SUPPORT_DBUS
 	{ dbus_findalldevs, dbus_create },
+#endif
+#ifdef PCAP_SUPPORT_MULTI
+	/*
+	 * This must come last, as other types of device, such as
+	 * netfilter devices, can have commas in their names.
+	 */
+	{ multi_findalldevs, multi_create },
 #endif
 	{ NULL, NULL }
 };
@@ -443,18 +469,36 @@ initialize_ops(pcap_t *p)
 	 */
 	p->read_op = (read_op_t)pcap_not_initialized;
 	p->inject_op = (inject_op_t)pcap_not_initialized;
+	/*
+	 * Backends that can't send more than one packet per call
+	 * can leave this alone.
+	 */
+	p->inject_batch_op = pcap_inject_batch_common;
 	p->setfilter_op = (setfilter_op_t)pcap_not_initialized;
 	p->setdirection_op = (setdirection_op_t)pcap_not_initialized;
 	p->set_datalink_op = (set_datalink_op_t)pcap_not_initialized;
 	p->getnonblock_op = (getnonblock_op_t)pcap_not_initialized;
 	p->setnonblock_op = (setnonblock_op_t)pcap_not_initialized;
 	p->stats_op = (stats_op_t)pcap_not_initialized;
+#if !defined(WIN32) && !defined(MSDOS)
+	/*
+	 * Backends that can't supply more than pcap_stats() supplies
+	 * can leave this alone.
+	 */
+	p->stats_ex_op = pcap_stats_ex_common;
+#endif
 #ifdef WIN32
 	p->setbuff_op = (setbuff_op_t)pcap_not_initialized;
 	p->setmode_op = (setmode_op_t)pcap_not_initialized;
 	p->setmintocopy_op = (setmintocopy_op_t)pcap_not_initialized;
 #endif
 
+	/*
+	 * Backends that can't be woken up from a wait for packets by
+	 * anything other than a signal can leave this alone.
+	 */
+	p->breakloop_op = pcap_breakloop_common;
+
 	/*
 	 * Default cleanup operation - implementations can override
 	 * this, but should call pcap_cleanup_live_common() after
@@ -511,6 +555,16 @@ pcap_create_common(const char *source, char *ebuf)
 	p->opt.promisc = 0;
 	p->opt.buffer_size = 0;
 	p->opt.tstamp_type = -1;	/* default to not setting time stamp type */
+	p->opt.filter_hotswap = 0;
+	p->opt.busy_poll = 0;
+	p->opt.ring_lock = 0;
+	p->opt.numa_local = 0;
+	p->opt.capture_cpu = -1;
+	p->opt.merge_order = PCAP_MERGE_ROUNDROBIN;
+	p->opt.overload_high = 0;
+	p->opt.overload_low = 0;
+	p->opt.overload_snaplen = 128;
+	p->opt.overload_sample = 0;
 	return (p);
 }
 
@@ -605,6 +659,100 @@ pcap_set_buffer_size(pcap_t *p, int buffer_size)
 	return (0);
 }
 
+int
+pcap_set_filter_hotswap(pcap_t *p, int hotswap)
+{
+	if (pcap_check_activated(p))
+		return (PCAP_ERROR_ACTIVATED);
+	p->opt.filter_hotswap = hotswap;
+	return (0);
+}
+
+int
+pcap_set_busy_poll(pcap_t *p, int usec)
+{
+	if (pcap_check_activated(p))
+		return (PCAP_ERROR_ACTIVATED);
+	if (usec < 0)
+		usec = 0;
+	p->opt.busy_poll = usec;
+	return (0);
+}
+
+int
+pcap_set_ring_lock(pcap_t *p, int lock)
+{
+	if (pcap_check_activated(p))
+		return (PCAP_ERROR_ACTIVATED);
+	p->opt.ring_lock = lock;
+	return (0);
+}
+
+int
+pcap_set_numa_local(pcap_t *p, int local)
+{
+	if (pcap_check_activated(p))
+		return (PCAP_ERROR_ACTIVATED);
+	p->opt.numa_local = local;
+	return (0);
+}
+
+int
+pcap_set_capture_cpu(pcap_t *p, int cpu)
+{
+	if (pcap_check_activated(p))
+		return (PCAP_ERROR_ACTIVATED);
+	if (cpu < 0)
+		cpu = -1;
+	p->opt.capture_cpu = cpu;
+	return (0);
+}
+
+int
+pcap_set_merge_order(pcap_t *p, int order)
+{
+	if (pcap_check_activated(p))
+		return (PCAP_ERROR_ACTIVATED);
+	if (order != PCAP_MERGE_ROUNDROBIN && order != PCAP_MERGE_TSTAMP) {
+		snprintf(p->errbuf, PCAP_ERRBUF_SIZE,
+		    "unknown merge order %d", order);
+		return (PCAP_ERROR);
+	}
+	p->opt.merge_order = order;
+	return (0);
+}
+
+int
+pcap_set_overload_watermarks(pcap_t *p, int high, int low)
+{
+	if (pcap_check_activated(p))
+		return (PCAP_ERROR_ACTIVATED);
+	if (high != 0 && (high > 100 || low < 0 || low >= high)) {
+		snprintf(p->errbuf, PCAP_ERRBUF_SIZE,
+		    "invalid overload watermarks %d and %d", high, low);
+		return (PCAP_ERROR);
+	}
+	p->opt.overload_high = high;
+	p->opt.overload_low = low;
+	return (0);
+}
+
+int
+pcap_set_overload_shedding(pcap_t *p, int snaplen, int sample)
+{
+	if (pcap_check_activated(p))
+		return (PCAP_ERROR_ACTIVATED);
+	if (snaplen < 0 || sample < 0) {
+		snprintf(p->errbuf, PCAP_ERRBUF_SIZE,
+		    "invalid overload snapshot length %d or sample %d",
+		    snaplen, sample);
+		return (PCAP_ERROR);
+	}
+	p->opt.overload_snaplen = snaplen;
+	p->opt.overload_sample = sample;
+	return (0);
+}
+
 int
 pcap_activate(pcap_t *p)
 {
@@ -714,7 +862,7 @@ pcap_loop(pcap_t *p, int cnt, pcap_handler callback, u_char *user)
 	register int n;
 
 	for (;;) {
-		if (p->sf.rfile != NULL) {
+		if (PCAP_IS_SAVEFILE(p)) {
 			/*
 			 * 0 means EOF, so don't loop if we get 0.
 			 */
@@ -738,11 +886,66 @@ pcap_loop(pcap_t *p, int cnt, pcap_handler callback, u_char *user)
 	}
 }
 
+/*
+ * Callback used by pcap_loop_ex() and pcap_dispatch_ex() to build the
+ * extended header for a packet.
+ */
+struct pcap_ex_arg {
+	pcap_t *p;
+	pcap_handler_ex callback;
+	u_char *user;
+};
+
+static void
+pcap_ex_callback(u_char *user, const struct pcap_pkthdr *h,
+    const u_char *pkt)
+{
+	struct pcap_ex_arg *arg = (struct pcap_ex_arg *)user;
+	struct pcap_pkthdr_ex hdr;
+
+	hdr.hdr = *h;
+	hdr.flags = 0;
+	if (flowhash(arg->p->linktype, pkt, h->caplen, &hdr.flowhash))
+		hdr.flags |= PCAP_PKTHDR_FLOWHASH;
+	hdr.ifindex = arg->p->pkt_ifindex;
+	if (hdr.ifindex != 0)
+		hdr.flags |= PCAP_PKTHDR_IFINDEX;
+	(*arg->callback)(arg->user, &hdr, pkt);
+}
+
+int
+pcap_dispatch_ex(pcap_t *p, int cnt, pcap_handler_ex callback, u_char *user)
+{
+	struct pcap_ex_arg arg;
+
+	arg.p = p;
+	arg.callback = callback;
+	arg.user = user;
+	return (pcap_dispatch(p, cnt, pcap_ex_callback, (u_char *)&arg));
+}
+
+int
+pcap_loop_ex(pcap_t *p, int cnt, pcap_handler_ex callback, u_char *user)
+{
+	struct pcap_ex_arg arg;
+
+	arg.p = p;
+	arg.callback = callback;
+	arg.user = user;
+	return (pcap_loop(p, cnt, pcap_ex_callback, (u_char *)&arg));
+}
+
 /*
  * Force the loop in "pcap_read()" or "pcap_read_offline()" to terminate.
  */
 void
 pcap_breakloop(pcap_t *p)
+{
+	p->breakloop_op(p);
+}
+
+void
+pcap_breakloop_common(pcap_t *p)
 {
 	p->break_loop = 1;
 }
@@ -1459,6 +1662,127 @@ pcap_stats_dead(pcap_t *p, struct pcap_stat *ps _U_)
 	return (-1);
 }
 
+#if !defined(WIN32) && !defined(MSDOS)
+int
+pcap_stats_ex(pcap_t *p, struct pcap_stat_ex *ps)
+{
+	if (p->stats_ex_op(p, ps) == -1)
+		return (-1);
+	ps->ps_dedup = pcap_dedup_count(p);
+	return (0);
+}
+
+/*
+ * Extended statistics for a backend that has nothing to report beyond
+ * what pcap_stats() and the common packet counts supply.
+ */
+int
+pcap_stats_ex_common(pcap_t *p, struct pcap_stat_ex *ps)
+{
+	struct pcap_stat st;
+
+	if (p->stats_op(p, &st) == -1)
+		return (-1);
+	memset(ps, 0, sizeof(*ps));
+	ps->ps_recv = st.ps_recv;
+	ps->ps_drop = st.ps_drop;
+	ps->ps_ifdrop = st.ps_ifdrop;
+	ps->ps_accepted = p->md.packets_read;
+	ps->ps_filtered = p->md.packets_filtered;
+	return (0);
+}
+#endif
+
+#ifndef PCAP_SUPPORT_SHM
+/*
+ * Shared-memory rings aren't supported on this platform.
+ */
+pcap_shm_t *
+pcap_shm_open(pcap_t *p, const char *name _U_, int size _U_)
+{
+	snprintf(p->errbuf, PCAP_ERRBUF_SIZE,
+	    "Shared-memory rings aren't supported on this platform");
+	return (NULL);
+}
+
+void
+pcap_shm_close(pcap_shm_t *shm _U_)
+{
+}
+
+void
+pcap_shm_write(u_char *user _U_, const struct pcap_pkthdr *h _U_,
+    const u_char *sp _U_)
+{
+}
+#endif
+
+#ifndef PCAP_SUPPORT_NETFILTER
+/*
+ * NFQUEUE captures aren't supported on this platform.
+ */
+static int
+pcap_nfqueue_unsupported(pcap_t *p)
+{
+	snprintf(p->errbuf, PCAP_ERRBUF_SIZE,
+	    "NFQUEUE captures aren't supported on this platform");
+	return (-1);
+}
+
+int
+pcap_nfqueue_set_async(pcap_t *p, int async _U_)
+{
+	return (pcap_nfqueue_unsupported(p));
+}
+
+int
+pcap_nfqueue_get_id(pcap_t *p, u_int *queuep _U_, bpf_u_int32 *idp _U_)
+{
+	return (pcap_nfqueue_unsupported(p));
+}
+
+int
+pcap_nfqueue_verdict(pcap_t *p, u_int queue _U_, bpf_u_int32 id _U_,
+    u_int verdict _U_)
+{
+	return (pcap_nfqueue_unsupported(p));
+}
+
+int
+pcap_nfqueue_verdict_batch(pcap_t *p, u_int queue _U_, bpf_u_int32 id _U_,
+    u_int verdict _U_)
+{
+	return (pcap_nfqueue_unsupported(p));
+}
+
+int
+pcap_nfqueue_flush(pcap_t *p)
+{
+	return (pcap_nfqueue_unsupported(p));
+}
+#endif
+
+#ifndef PCAP_SUPPORT_USB
+/*
+ * Memory-mapped usbmon captures aren't supported on this platform.
+ */
+int
+pcap_usb_set_hold(pcap_t *p, int hold _U_)
+{
+	snprintf(p->errbuf, PCAP_ERRBUF_SIZE,
+	    "USB captures aren't supported on this platform");
+	return (-1);
+}
+
+int
+pcap_usb_release(pcap_t *p)
+{
+	snprintf(p->errbuf, PCAP_ERRBUF_SIZE,
+	    "USB captures aren't supported on this platform");
+	return (-1);
+}
+#endif
+
 #ifdef WIN32
 int
 pcap_setbuff(pcap_t *p, int dim)
@@ -1638,11 +1962,16 @@ pcap_open_dead(int linktype, int snaplen)
 	p->snapshot = snaplen;
 	p->linktype = linktype;
 	p->stats_op = pcap_stats_dead;
+#if !defined(WIN32) && !defined(MSDOS)
+	p->stats_ex_op = pcap_stats_ex_common;
+#endif
 #ifdef WIN32
 	p->setbuff_op = pcap_setbuff_dead;
 	p->setmode_op = pcap_setmode_dead;
 	p->setmintocopy_op = pcap_setmintocopy_dead;
 #endif
+	p->inject_batch_op = pcap_inject_batch_common;
+	p->breakloop_op = pcap_breakloop_common;
 	p->cleanup_op = pcap_cleanup_dead;
 	p->activated = 1;
 	return (p);
@@ -1672,11 +2001,40 @@ pcap_inject(pcap_t *p, const void *buf, size_t size)
 	return (p->inject_op(p, buf, size));
 }
 
+/*
+ * Send a batch of packets one at a time with inject_op, stopping at
+ * the first failure; see struct pcap_inject_vec in pcap-int.h for
+ * what we return.
+ */
+int
+pcap_inject_batch_common(pcap_t *p, const struct pcap_inject_vec *vec, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++) {
+		/*
+		 * Not every inject_op sets errno when it fails (the
+		 * savefile one doesn't), so don't let a stale value
+		 * look like a full buffer.
+		 */
+		errno = 0;
+		if (p->inject_op(p, vec[i].buf, vec[i].size) == -1) {
+			if (i != 0)
+				return (i);
+			if (errno == ENOBUFS || errno == EAGAIN)
+				return (0);
+			return (-1);
+		}
+	}
+	return (n);
+}
+
 void
 pcap_close(pcap_t *p)
 {
 	if (p->opt.source != NULL)
 		free(p->opt.source);
+	pcap_dedup_free(p);
 	p->cleanup_op(p);
 	free(p);
 }
@@ -1699,6 +2057,28 @@ pcap_offline_filter(const struct bpf_program *fp, const struct pcap_pkthdr *h,
 		return (0);
 }
 
+/*
+ * Run a filter program in userland on a packet for a capture backend.
+ * Returns 0 if the filter rejects the packet; otherwise, if the filter
+ * returned a snapshot length shorter than "*caplenp", cuts "*caplenp"
+ * down to it, so that programs such as "headers-only" ones, which
+ * return an amount computed from the packet, trim the packets they
+ * accept just as they do when run in the kernel.
+ */
+int
+pcap_filter_packet(const struct bpf_insn *fcode, const u_char *pkt,
+    u_int len, bpf_u_int32 *caplenp)
+{
+	u_int snap;
+
+	snap = bpf_filter(fcode, pkt, len, *caplenp);
+	if (snap == 0)
+		return (0);
+	if (snap < *caplenp)
+		*caplenp = snap;
+	return (1);
+}
+
 /*
  * We make the version string static, and return a pointer to it, rather
  * than exporting the version string directly.  On at least some UNIXes,
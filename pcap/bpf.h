@@ -1303,6 +1303,14 @@ extern u_int bpf_filter();
  */
 #define BPF_MEMWORDS 16
 
+/*
+ * Offset which, in a BPF_LD|BPF_W|BPF_ABS instruction, loads a random
+ * 32-bit number rather than packet data.  It's the Linux socket
+ * filter's SKF_AD_OFF + SKF_AD_RANDOM, so that programs using it can
+ * be run in the Linux kernel as well as by bpf_filter().
+ */
+#define BPF_AD_RANDOM	((bpf_u_int32)(-0x1000 + 56))
+
 #ifdef __cplusplus
 }
 #endif
@@ -80,6 +80,8 @@ typedef	u_int bpf_u_int32;
 
 typedef struct pcap pcap_t;
 typedef struct pcap_dumper pcap_dumper_t;
+typedef struct pcap_memdumper pcap_memdumper_t;
+typedef struct pcap_shm pcap_shm_t;
 typedef struct pcap_if pcap_if_t;
 typedef struct pcap_addr pcap_addr_t;
 
@@ -165,6 +167,19 @@ struct pcap_pkthdr {
 	bpf_u_int32 len;	/* length this packet (off wire) */
 };
 
+/*
+ * Extended per-packet header, as handed to a pcap_handler_ex.
+ */
+struct pcap_pkthdr_ex {
+	struct pcap_pkthdr hdr;	/* the regular packet header */
+	bpf_u_int32 flowhash;	/* symmetric flow hash, if PCAP_PKTHDR_FLOWHASH */
+	bpf_u_int32 flags;
+	bpf_u_int32 ifindex;	/* arrival interface index, if PCAP_PKTHDR_IFINDEX */
+};
+
+#define PCAP_PKTHDR_FLOWHASH	0x00000001	/* flowhash is valid */
+#define PCAP_PKTHDR_IFINDEX	0x00000002	/* ifindex is valid */
+
 /*
  * As returned by the pcap_stats()
  */
@@ -208,6 +223,26 @@ struct pcap_stat_ex {
        u_long  tx_heartbeat_errors;
        u_long  tx_window_errors;
      };
+#elif !defined(WIN32)
+/*
+ * As returned by the pcap_stats_ex()
+ */
+struct pcap_stat_ex {
+	u_int64_t ps_recv;	/* number of packets received */
+	u_int64_t ps_drop;	/* number of packets dropped by the capture mechanism */
+	u_int64_t ps_ifdrop;	/* number of packets dropped by the interface */
+	u_int64_t ps_accepted;	/* number of packets that passed the filter */
+	u_int64_t ps_filtered;	/* number of packets rejected by the userland filter */
+	u_int64_t ps_ring_full;	/* number of times the capture ring was found full */
+	u_int64_t ps_ring_used;	/* number of ring entries waiting to be read */
+	u_int64_t ps_ring_size;	/* number of entries in the ring, or 0 if none */
+	u_int64_t ps_delay_p99;	/* 99th percentile delivery delay, in nanoseconds */
+	u_int64_t ps_spin_ns;	/* nanoseconds spent busy-polling */
+	u_int64_t ps_sleeps;	/* times busy-polling gave up and slept */
+	u_int64_t ps_overload_on;  /* times load shedding started */
+	u_int64_t ps_overload_off; /* times load shedding stopped */
+	u_int64_t ps_dedup;	/* number of packets dropped as duplicates */
+};
 #endif
 
 /*
@@ -236,6 +271,8 @@ struct pcap_addr {
 
 typedef void (*pcap_handler)(u_char *, const struct pcap_pkthdr *,
 			     const u_char *);
+typedef void (*pcap_handler_ex)(u_char *, const struct pcap_pkthdr_ex *,
+			     const u_char *);
 
 /*
  * Error codes for the pcap API.
@@ -281,6 +318,14 @@ int	pcap_set_rfmon(pcap_t *, int);
 int	pcap_set_timeout(pcap_t *, int);
 int	pcap_set_tstamp_type(pcap_t *, int);
 int	pcap_set_buffer_size(pcap_t *, int);
+int	pcap_set_filter_hotswap(pcap_t *, int);
+int	pcap_set_busy_poll(pcap_t *, int);
+int	pcap_set_ring_lock(pcap_t *, int);
+int	pcap_set_numa_local(pcap_t *, int);
+int	pcap_set_capture_cpu(pcap_t *, int);
+int	pcap_set_merge_order(pcap_t *, int);
+int	pcap_set_overload_watermarks(pcap_t *, int, int);
+int	pcap_set_overload_shedding(pcap_t *, int, int);
 int	pcap_activate(pcap_t *);
 
 int	pcap_list_tstamp_types(pcap_t *, int **);
@@ -333,6 +378,13 @@ const char *pcap_tstamp_type_val_to_description(int);
 #define PCAP_TSTAMP_ADAPTER		3	/* device-provided, synced with the system clock */
 #define PCAP_TSTAMP_ADAPTER_UNSYNCED	4	/* device-provided, not synced with the system clock */
 
+/*
+ * How packets from the interfaces of a multi-interface capture, such
+ * as "eth0,eth1", are merged.
+ */
+#define PCAP_MERGE_ROUNDROBIN	0	/* take turns reading each interface */
+#define PCAP_MERGE_TSTAMP	1	/* deliver in time stamp order */
+
 pcap_t	*pcap_open_live(const char *, int, int, int, char *);
 pcap_t	*pcap_open_dead(int, int);
 pcap_t	*pcap_open_offline(const char *, char *);
@@ -347,10 +399,13 @@ static pcap_t *pcap_fopen_offline(FILE *, char *);
 #else /*WIN32*/
 pcap_t	*pcap_fopen_offline(FILE *, char *);
 #endif /*WIN32*/
+pcap_t	*pcap_open_offline_mem(const void *, size_t, char *);
 
 void	pcap_close(pcap_t *);
 int	pcap_loop(pcap_t *, int, pcap_handler, u_char *);
 int	pcap_dispatch(pcap_t *, int, pcap_handler, u_char *);
+int	pcap_loop_ex(pcap_t *, int, pcap_handler_ex, u_char *);
+int	pcap_dispatch_ex(pcap_t *, int, pcap_handler_ex, u_char *);
 const u_char*
 	pcap_next(pcap_t *, struct pcap_pkthdr *);
 int 	pcap_next_ex(pcap_t *, struct pcap_pkthdr **, const u_char **);
@@ -358,6 +413,7 @@ void	pcap_breakloop(pcap_t *);
 int	pcap_stats(pcap_t *, struct pcap_stat *);
 int	pcap_setfilter(pcap_t *, struct bpf_program *);
 int 	pcap_setdirection(pcap_t *, pcap_direction_t);
+int	pcap_setdedup(pcap_t *, int, int);
 int	pcap_getnonblock(pcap_t *, char *);
 int	pcap_setnonblock(pcap_t *, int, char *);
 int	pcap_inject(pcap_t *, const void *, size_t);
@@ -398,6 +454,31 @@ int	pcap_dump_flush(pcap_dumper_t *);
 void	pcap_dump_close(pcap_dumper_t *);
 void	pcap_dump(u_char *, const struct pcap_pkthdr *, const u_char *);
 
+pcap_memdumper_t *pcap_dump_open_mem(pcap_t *);
+const u_char *pcap_dump_mem_buffer(pcap_memdumper_t *, size_t *);
+void	pcap_dump_mem_reset(pcap_memdumper_t *);
+void	pcap_dump_mem_close(pcap_memdumper_t *);
+void	pcap_dump_mem(u_char *, const struct pcap_pkthdr *, const u_char *);
+
+pcap_shm_t *pcap_shm_open(pcap_t *, const char *, int);
+void	pcap_shm_close(pcap_shm_t *);
+void	pcap_shm_write(u_char *, const struct pcap_pkthdr *, const u_char *);
+
+/*
+ * Verdicts for packets read from an NFQUEUE capture.
+ */
+#define PCAP_NFQ_DROP	0
+#define PCAP_NFQ_ACCEPT	1
+
+int	pcap_nfqueue_set_async(pcap_t *, int);
+int	pcap_nfqueue_get_id(pcap_t *, u_int *, bpf_u_int32 *);
+int	pcap_nfqueue_verdict(pcap_t *, u_int, bpf_u_int32, u_int);
+int	pcap_nfqueue_verdict_batch(pcap_t *, u_int, bpf_u_int32, u_int);
+int	pcap_nfqueue_flush(pcap_t *);
+
+int	pcap_usb_set_hold(pcap_t *, int);
+int	pcap_usb_release(pcap_t *);
+
 int	pcap_findalldevs(pcap_if_t **, char *);
 void	pcap_freealldevs(pcap_if_t *);
 
@@ -453,6 +534,75 @@ u_long pcap_mac_packets (void);
  */
 
 int	pcap_get_selectable_fd(pcap_t *);
+int	pcap_stats_ex(pcap_t *, struct pcap_stat_ex *);
+
+/*
+ * Dispatching packets to worker threads, with all the packets of a
+ * flow going to the same worker.
+ */
+typedef struct pcap_flowdisp pcap_flowdisp_t;
+typedef void (*pcap_flowdisp_handler)(u_char *, int,
+			     const struct pcap_pkthdr *, const u_char *);
+
+/*
+ * Flags for pcap_flowdisp_create().
+ */
+#define PCAP_FLOWDISP_DROP	0x00000001	/* drop, rather than wait, if a worker falls behind */
+
+/*
+ * Per-worker statistics.
+ */
+struct pcap_flowdisp_stat {
+	u_int64_t fs_recv;	/* number of packets queued to the worker */
+	u_int64_t fs_delivered;	/* number of packets handed to the callback */
+	u_int64_t fs_drop;	/* number of packets dropped because the ring was full */
+	u_int64_t fs_waits;	/* number of times we waited for room in the ring */
+};
+
+pcap_flowdisp_t *pcap_flowdisp_create(pcap_t *, int, int, int,
+	    pcap_flowdisp_handler, u_char *, char *);
+int	pcap_flowdisp_loop(pcap_flowdisp_t *, int);
+int	pcap_flowdisp_stats(pcap_flowdisp_t *, int, struct pcap_flowdisp_stat *);
+void	pcap_flowdisp_close(pcap_flowdisp_t *);
+
+/*
+ * Replaying the packets from one pcap_t, usually a savefile, on
+ * another, paced from their time stamps or at a fixed rate.
+ */
+typedef struct pcap_replay pcap_replay_t;
+
+/*
+ * Pacing modes for pcap_replay_create().
+ */
+#define PCAP_REPLAY_ORIGINAL	0	/* time stamps, sped up by a factor of "rate" */
+#define PCAP_REPLAY_PPS		1	/* "rate" packets per second */
+#define PCAP_REPLAY_BPS		2	/* "rate" bits per second */
+#define PCAP_REPLAY_TOPSPEED	3	/* as fast as the device will take them */
+
+/*
+ * Replay statistics.  The target figures are what the pacing mode asked
+ * for; the others are what we actually achieved.  Rates are measured
+ * from the first packet sent to the last one.
+ */
+struct pcap_replay_stat {
+	u_int64_t rs_sent;		/* number of packets sent */
+	u_int64_t rs_bytes;		/* number of bytes sent */
+	u_int64_t rs_retries;		/* number of times the device was out of buffer space */
+	u_int64_t rs_elapsed_ns;	/* time from the first packet to the last */
+	u_int64_t rs_target_ns;		/* scheduled time from the first packet to the last */
+	u_int64_t rs_pps;		/* packets per second */
+	u_int64_t rs_bps;		/* bits per second */
+	u_int64_t rs_target_pps;	/* scheduled packets per second */
+	u_int64_t rs_target_bps;	/* scheduled bits per second */
+	u_int64_t rs_late_avg_ns;	/* average time a packet went out after it was due */
+	u_int64_t rs_late_max_ns;	/* longest time a packet went out after it was due */
+};
+
+pcap_replay_t *pcap_replay_create(pcap_t *, pcap_t *, int, double, int,
+	    char *);
+int	pcap_replay_run(pcap_replay_t *, int);
+int	pcap_replay_stats(pcap_replay_t *, struct pcap_replay_stat *);
+void	pcap_replay_close(pcap_replay_t *);
 
 #endif /* WIN32/MSDOS/UN*X */
 
@@ -0,0 +1,488 @@
+/*
+ * Copyright (c) 1993, 1994, 1995, 1996, 1997
+ *	The Regents of the University of California.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that: (1) source code distributions
+ * retain the above copyright notice and this paragraph in its entirety, (2)
+ * distributions including binary code include the above copyright notice and
+ * this paragraph in its entirety in the documentation or other materials
+ * provided with the distribution, and (3) all advertising materials mentioning
+ * features or use of this software display the following acknowledgement:
+ * ``This product includes software developed by the University of California,
+ * Lawrence Berkeley Laboratory and its contributors.'' Neither the name of
+ * the University nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * replay.c - send the packets read from one pcap_t, usually a savefile,
+ * on another, paced from their time stamps or at a fixed rate
+ *
+ * Each packet gets a due time, relative to when the first packet was
+ * sent, from the pacing mode.  We sleep until shortly before the first
+ * packet of a batch is due and spin the rest of the way, then send it
+ * along with any following packets that are also due, so that at high
+ * rates we make one system call for many packets but never send a
+ * packet early.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#ifdef WIN32
+#include <pcap-stdinc.h>
+#else /* WIN32 */
+#if HAVE_INTTYPES_H
+#include <inttypes.h>
+#elif HAVE_STDINT_H
+#include <stdint.h>
+#endif
+#ifdef HAVE_SYS_BITYPES_H
+#include <sys/bitypes.h>
+#endif
+#include <sys/types.h>
+#endif /* WIN32 */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "pcap-int.h"
+
+#ifdef HAVE_OS_PROTO_H
+#include "os-proto.h"
+#endif
+
+#if !defined(WIN32) && !defined(MSDOS) && defined(CLOCK_MONOTONIC)
+
+#define NSEC_PER_SEC	1000000000ULL
+
+/*
+ * How long before a packet is due we stop sleeping and start spinning;
+ * timer wakeups are rarely more accurate than this.
+ */
+#define REPLAY_SPIN_NS	50000
+
+/*
+ * Longest we sleep at a time, so that pcap_breakloop() from another
+ * thread gets noticed during long gaps between packets.
+ */
+#define REPLAY_MAX_SLEEP_NS	100000000
+
+/*
+ * How long we wait before retrying when the device is out of buffer
+ * space.
+ */
+#define REPLAY_RETRY_NS	20000
+
+#define REPLAY_DEFAULT_BATCH	32
+#define REPLAY_MAX_BATCH	1024
+
+struct pcap_replay {
+	pcap_t	*src;
+	pcap_t	*dst;
+	int	mode;
+	double	rate;
+	int	batch;
+
+	/*
+	 * Packets are copied into fixed-size slots, because pcap_next_ex()
+	 * reuses its buffer.  The first packet read that isn't due yet
+	 * is held back to start the next batch.
+	 */
+	u_char	*slab;
+	u_int	slotsize;
+	struct pcap_inject_vec *vec;
+	u_int64_t *due;
+	int	held;		/* slot holding that packet, or 0 */
+	int	eof;
+
+	int	started;
+	u_int64_t start_ns;	/* when the first packet was due */
+	struct timeval ts0;	/* time stamp of the first packet */
+	u_int64_t scheduled;	/* packets scheduled so far */
+	u_int64_t sched_bytes;	/* bytes scheduled so far */
+
+	u_int64_t sent;
+	u_int64_t bytes;
+	u_int64_t retries;
+	u_int	last_size;	/* size of the last packet sent */
+	u_int64_t last_due;	/* due time of the last packet sent */
+	u_int64_t last_sent;	/* time the last packet was sent */
+	u_int64_t late_total;
+	u_int64_t late_max;
+};
+
+static u_int64_t
+replay_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((u_int64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec);
+}
+
+/*
+ * Wait until the given time; returns -2 if pcap_breakloop() was called
+ * on the source while we were waiting, 0 otherwise.
+ */
+static int
+replay_wait(pcap_replay_t *rp, u_int64_t when)
+{
+	struct timespec ts;
+	u_int64_t now, left;
+
+	for (;;) {
+		if (rp->src->break_loop) {
+			rp->src->break_loop = 0;
+			return (-2);
+		}
+		now = replay_now();
+		if (now >= when)
+			return (0);
+		left = when - now;
+		if (left <= REPLAY_SPIN_NS)
+			continue;
+		left -= REPLAY_SPIN_NS;
+		if (left > REPLAY_MAX_SLEEP_NS)
+			left = REPLAY_MAX_SLEEP_NS;
+		ts.tv_sec = left / NSEC_PER_SEC;
+		ts.tv_nsec = left % NSEC_PER_SEC;
+		(void)nanosleep(&ts, NULL);
+	}
+}
+
+/*
+ * Work out when a packet with the given header is due, relative to the
+ * start of the replay.
+ */
+static u_int64_t
+replay_schedule(pcap_replay_t *rp, const struct pcap_pkthdr *h, u_int size)
+{
+	u_int64_t off = 0;
+	double delta;
+
+	switch (rp->mode) {
+
+	case PCAP_REPLAY_ORIGINAL:
+		delta = (double)(h->ts.tv_sec - rp->ts0.tv_sec) * 1e9 +
+		    (double)(h->ts.tv_usec - rp->ts0.tv_usec) * 1e3;
+		/*
+		 * A time stamp earlier than the first one means the
+		 * packet is due now.
+		 */
+		if (delta > 0)
+			off = (u_int64_t)(delta / rp->rate);
+		break;
+
+	case PCAP_REPLAY_PPS:
+		off = (u_int64_t)((double)rp->scheduled * 1e9 / rp->rate);
+		break;
+
+	case PCAP_REPLAY_BPS:
+		off = (u_int64_t)((double)rp->sched_bytes * 8e9 / rp->rate);
+		break;
+
+	case PCAP_REPLAY_TOPSPEED:
+		break;
+	}
+	rp->scheduled++;
+	rp->sched_bytes += size;
+	return (rp->start_ns + off);
+}
+
+/*
+ * Read the next packet into the given slot.  Returns 1 if we got one,
+ * 0 at the end of the input, and -1 or -2 as pcap_next_ex() does.
+ */
+static int
+replay_read(pcap_replay_t *rp, int slot)
+{
+	struct pcap_pkthdr *h;
+	const u_char *data;
+	u_char *buf;
+	u_int size;
+	int status;
+
+	if (rp->src->break_loop) {
+		rp->src->break_loop = 0;
+		return (-2);
+	}
+	status = pcap_next_ex(rp->src, &h, &data);
+	if (status == -2 && PCAP_IS_SAVEFILE(rp->src)) {
+		/*
+		 * End of the savefile.
+		 */
+		rp->eof = 1;
+		return (0);
+	}
+	if (status <= 0) {
+		/*
+		 * An error, pcap_breakloop(), or, for a live capture,
+		 * the timeout expiring, in which case we just try
+		 * again.
+		 */
+		return (status);
+	}
+
+	size = h->caplen;
+	if (size > rp->slotsize)
+		size = rp->slotsize;
+	buf = rp->slab + (size_t)slot * rp->slotsize;
+	memcpy(buf, data, size);
+	rp->vec[slot].buf = buf;
+	rp->vec[slot].size = size;
+
+	if (!rp->started) {
+		rp->started = 1;
+		rp->start_ns = replay_now();
+		rp->ts0 = h->ts;
+	}
+	rp->due[slot] = replay_schedule(rp, h, size);
+	return (1);
+}
+
+/*
+ * Send the first "n" slots, retrying while the device is out of buffer
+ * space.  Returns 0 or -1 (with the error in the destination's error
+ * buffer) or -2 if pcap_breakloop() was called on the source.
+ */
+static int
+replay_send(pcap_replay_t *rp, int n)
+{
+	u_int64_t now, late;
+	int done = 0, ret, i;
+
+	now = replay_now();
+	while (done < n) {
+		ret = rp->dst->inject_batch_op(rp->dst, &rp->vec[done],
+		    n - done);
+		if (ret == -1)
+			return (-1);
+		for (i = done; i < done + ret; i++) {
+			/*
+			 * At top speed, everything is due at the start, so
+			 * lateness would just be the time since then.
+			 */
+			if (rp->mode != PCAP_REPLAY_TOPSPEED) {
+				late = now > rp->due[i] ? now - rp->due[i] : 0;
+				rp->late_total += late;
+				if (late > rp->late_max)
+					rp->late_max = late;
+			}
+			rp->bytes += rp->vec[i].size;
+			rp->last_size = rp->vec[i].size;
+			rp->last_due = rp->due[i];
+		}
+		rp->sent += ret;
+		done += ret;
+		if (done < n) {
+			rp->retries++;
+			ret = replay_wait(rp, replay_now() + REPLAY_RETRY_NS);
+			if (ret != 0)
+				return (ret);
+			now = replay_now();
+		}
+	}
+	rp->last_sent = now;
+	return (0);
+}
+
+pcap_replay_t *
+pcap_replay_create(pcap_t *src, pcap_t *dst, int mode, double rate,
+    int batch, char *errbuf)
+{
+	pcap_replay_t *rp;
+
+	if (mode < PCAP_REPLAY_ORIGINAL || mode > PCAP_REPLAY_TOPSPEED) {
+		snprintf(errbuf, PCAP_ERRBUF_SIZE,
+		    "%d is not a valid replay mode", mode);
+		return (NULL);
+	}
+	if (mode != PCAP_REPLAY_TOPSPEED && !(rate > 0)) {
+		snprintf(errbuf, PCAP_ERRBUF_SIZE,
+		    "The replay rate must be greater than 0");
+		return (NULL);
+	}
+	if (batch <= 0)
+		batch = REPLAY_DEFAULT_BATCH;
+	if (batch > REPLAY_MAX_BATCH)
+		batch = REPLAY_MAX_BATCH;
+
+	rp = malloc(sizeof(*rp));
+	if (rp == NULL) {
+		snprintf(errbuf, PCAP_ERRBUF_SIZE, "malloc: %s",
+		    pcap_strerror(errno));
+		return (NULL);
+	}
+	memset(rp, 0, sizeof(*rp));
+	rp->src = src;
+	rp->dst = dst;
+	rp->mode = mode;
+	rp->rate = rate;
+	rp->batch = batch;
+	rp->slotsize = src->snapshot > 0 ? src->snapshot : 65535;
+	rp->slab = malloc((size_t)batch * rp->slotsize);
+	rp->vec = malloc(batch * sizeof(*rp->vec));
+	rp->due = malloc(batch * sizeof(*rp->due));
+	if (rp->slab == NULL || rp->vec == NULL || rp->due == NULL) {
+		snprintf(errbuf, PCAP_ERRBUF_SIZE, "malloc: %s",
+		    pcap_strerror(errno));
+		pcap_replay_close(rp);
+		return (NULL);
+	}
+	return (rp);
+}
+
+/*
+ * Send up to "cnt" packets, or all of them if "cnt" is 0 or less.
+ * Returns the number sent, which is less than "cnt" only at the end of
+ * the input; -1 on an error, with the message in the source's error
+ * buffer if reading failed and in the destination's if sending did; or
+ * -2 if pcap_breakloop() was called on the source.
+ */
+int
+pcap_replay_run(pcap_replay_t *rp, int cnt)
+{
+	u_int64_t before = rp->sent;
+	int n, status;
+
+	while (cnt <= 0 || rp->sent - before < (u_int64_t)cnt) {
+		n = 0;
+		if (rp->held) {
+			/*
+			 * The packet we held back last time starts this
+			 * batch.
+			 */
+			memcpy(rp->slab, rp->vec[rp->held].buf,
+			    rp->vec[rp->held].size);
+			rp->vec[0].buf = rp->slab;
+			rp->vec[0].size = rp->vec[rp->held].size;
+			rp->due[0] = rp->due[rp->held];
+			rp->held = 0;
+			n = 1;
+		} else if (!rp->eof) {
+			status = replay_read(rp, 0);
+			if (status < 0)
+				return (status);
+			n = status;
+		}
+		if (n == 0) {
+			if (rp->eof)
+				break;
+			continue;
+		}
+
+		status = replay_wait(rp, rp->due[0]);
+		if (status != 0)
+			return (status);
+
+		/*
+		 * Fill the rest of the batch with packets that are already
+		 * due, holding back the first one that isn't.
+		 */
+		while (n < rp->batch && !rp->eof &&
+		    (cnt <= 0 || rp->sent - before + n < (u_int64_t)cnt)) {
+			status = replay_read(rp, n);
+			if (status < 0)
+				return (status);
+			if (status == 0)
+				break;
+			if (rp->due[n] > replay_now()) {
+				rp->held = n;
+				break;
+			}
+			n++;
+		}
+
+		status = replay_send(rp, n);
+		if (status != 0)
+			return (status);
+	}
+	return ((int)(rp->sent - before));
+}
+
+int
+pcap_replay_stats(pcap_replay_t *rp, struct pcap_replay_stat *rs)
+{
+	u_int64_t span_bytes;
+
+	memset(rs, 0, sizeof(*rs));
+	rs->rs_sent = rp->sent;
+	rs->rs_bytes = rp->bytes;
+	rs->rs_retries = rp->retries;
+	if (rp->sent == 0)
+		return (0);
+	rs->rs_elapsed_ns = rp->last_sent - rp->start_ns;
+	rs->rs_target_ns = rp->last_due - rp->start_ns;
+	rs->rs_late_avg_ns = rp->late_total / rp->sent;
+	rs->rs_late_max_ns = rp->late_max;
+
+	/*
+	 * The rates are over the interval from the first packet going out
+	 * to the last one going out, so they don't count the last packet
+	 * or its bytes.
+	 */
+	span_bytes = rp->bytes - rp->last_size;
+	if (rs->rs_elapsed_ns != 0) {
+		rs->rs_pps = (u_int64_t)((double)(rp->sent - 1) * 1e9 /
+		    rs->rs_elapsed_ns);
+		rs->rs_bps = (u_int64_t)((double)span_bytes * 8e9 /
+		    rs->rs_elapsed_ns);
+	}
+	if (rs->rs_target_ns != 0) {
+		rs->rs_target_pps = (u_int64_t)((double)(rp->sent - 1) * 1e9 /
+		    rs->rs_target_ns);
+		rs->rs_target_bps = (u_int64_t)((double)span_bytes * 8e9 /
+		    rs->rs_target_ns);
+	}
+	return (0);
+}
+
+void
+pcap_replay_close(pcap_replay_t *rp)
+{
+	if (rp->slab != NULL)
+		free(rp->slab);
+	if (rp->vec != NULL)
+		free(rp->vec);
+	if (rp->due != NULL)
+		free(rp->due);
+	free(rp);
+}
+
+#else /* !WIN32 && !MSDOS && CLOCK_MONOTONIC */
+
+pcap_replay_t *
+pcap_replay_create(pcap_t *src _U_, pcap_t *dst _U_, int mode _U_,
+    double rate _U_, int batch _U_, char *errbuf)
+{
+	snprintf(errbuf, PCAP_ERRBUF_SIZE,
+	    "Replaying packets isn't supported on this platform");
+	return (NULL);
+}
+
+int
+pcap_replay_run(pcap_replay_t *rp _U_, int cnt _U_)
+{
+	return (-1);
+}
+
+int
+pcap_replay_stats(pcap_replay_t *rp _U_, struct pcap_replay_stat *rs _U_)
+{
+	return (-1);
+}
+
+void
+pcap_replay_close(pcap_replay_t *rp _U_)
+{
+}
+
+#endif /* !WIN32 && !MSDOS && CLOCK_MONOTONIC */
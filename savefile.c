@@ -114,6 +114,22 @@ sf_stats(pcap_t *p, struct pcap_stat *ps)
 	return (-1);
 }
 
+#if !defined(WIN32) && !defined(MSDOS)
+/*
+ * Nothing is ever dropped when reading a savefile, but we can say
+ * how many packets we've read and how many the filter rejected.
+ */
+static int
+sf_stats_ex(pcap_t *p, struct pcap_stat_ex *ps)
+{
+	memset(ps, 0, sizeof(*ps));
+	ps->ps_recv = p->md.packets_read + p->md.packets_filtered;
+	ps->ps_accepted = p->md.packets_read;
+	ps->ps_filtered = p->md.packets_filtered;
+	return (0);
+}
+#endif
+
 #ifdef WIN32
 static int
 sf_setbuff(pcap_t *p, int dim)
@@ -163,10 +179,12 @@ sf_setdirection(pcap_t *p, pcap_direction_t d)
 static void
 sf_cleanup(pcap_t *p)
 {
-	if (p->sf.rfile != stdin)
+	if (p->sf.rfile != NULL && p->sf.rfile != stdin)
 		(void)fclose(p->sf.rfile);
 	if (p->buffer != NULL)
 		free(p->buffer);
+	if (p->sf.ifaces != NULL)
+		free(p->sf.ifaces);
 	pcap_freecode(&p->fcode);
 }
 
@@ -238,20 +256,71 @@ static int (*check_headers[])(pcap_t *, bpf_u_int32, FILE *, char *) = {
 
 #define	N_FILE_TYPES	(sizeof check_headers / sizeof check_headers[0])
 
+/*
+ * Read from a savefile, which is either the stream "fp" or, if we're
+ * reading from memory, the caller's buffer, in which case "fp" is NULL;
+ * returns what fread() would.
+ */
+size_t
+sf_fread(pcap_t *p, void *buf, size_t size, FILE *fp)
+{
+	size_t left;
+
+	if (p->sf.mem == NULL)
+		return (fread(buf, 1, size, fp));
+	left = p->sf.memlen - p->sf.mempos;
+	if (size > left)
+		size = left;
+	memcpy(buf, p->sf.mem + p->sf.mempos, size);
+	p->sf.mempos += size;
+	return (size);
+}
+
+static pcap_t *sf_open_common(pcap_t *, FILE *, char *);
+
 #ifdef WIN32
 static
 #endif
 pcap_t *
 pcap_fopen_offline(FILE *fp, char *errbuf)
 {
-	register pcap_t *p;
-	bpf_u_int32 magic;
-	size_t amt_read;
-	u_int i;
+	pcap_t *p;
 
 	p = pcap_create_common("(savefile)", errbuf);
 	if (p == NULL)
 		return (NULL);
+	return (sf_open_common(p, fp, errbuf));
+}
+
+/*
+ * Read a savefile that's already in memory.  The packets handed to the
+ * callback point into "buf", which must stay valid, and unchanged, until
+ * the pcap_t is closed.
+ */
+pcap_t *
+pcap_open_offline_mem(const void *buf, size_t len, char *errbuf)
+{
+	pcap_t *p;
+
+	p = pcap_create_common("(savefile)", errbuf);
+	if (p == NULL)
+		return (NULL);
+	p->sf.mem = buf;
+	p->sf.memlen = len;
+	p->sf.mempos = 0;
+	return (sf_open_common(p, NULL, errbuf));
+}
+
+/*
+ * Finish opening a savefile; "fp" is NULL if we're reading from memory.
+ * Frees "p" on failure.
+ */
+static pcap_t *
+sf_open_common(pcap_t *p, FILE *fp, char *errbuf)
+{
+	bpf_u_int32 magic;
+	size_t amt_read;
+	u_int i;
 
 	/*
 	 * Read the first 4 bytes of the file; the network analyzer dump
@@ -260,9 +329,9 @@ pcap_fopen_offline(FILE *fp, char *errbuf)
 	 * Windows Sniffer, and Microsoft Network Monitor) all have magic
 	 * numbers that are unique in their first 4 bytes.
 	 */
-	amt_read = fread((char *)&magic, 1, sizeof(magic), fp);
+	amt_read = sf_fread(p, (char *)&magic, sizeof(magic), fp);
 	if (amt_read != sizeof(magic)) {
-		if (ferror(fp)) {
+		if (fp != NULL && ferror(fp)) {
 			snprintf(errbuf, PCAP_ERRBUF_SIZE,
 			    "error reading dump file: %s",
 			    pcap_strerror(errno));
@@ -317,22 +386,28 @@ found:
 	 * You can't do "select()" on anything other than sockets in
 	 * Windows, so, on Win32 systems, we don't have "selectable_fd".
 	 */
-	p->selectable_fd = fileno(fp);
+	if (fp != NULL)
+		p->selectable_fd = fileno(fp);
 #endif
 
 	p->read_op = pcap_offline_read;
 	p->inject_op = sf_inject;
+	p->inject_batch_op = pcap_inject_batch_common;
 	p->setfilter_op = install_bpf_program;
 	p->setdirection_op = sf_setdirection;
 	p->set_datalink_op = NULL;	/* we don't support munging link-layer headers */
 	p->getnonblock_op = sf_getnonblock;
 	p->setnonblock_op = sf_setnonblock;
 	p->stats_op = sf_stats;
+#if !defined(WIN32) && !defined(MSDOS)
+	p->stats_ex_op = sf_stats_ex;
+#endif
 #ifdef WIN32
 	p->setbuff_op = sf_setbuff;
 	p->setmode_op = sf_setmode;
 	p->setmintocopy_op = sf_setmintocopy;
 #endif
+	p->breakloop_op = pcap_breakloop_common;
 	p->cleanup_op = sf_cleanup;
 	p->activated = 1;
 
@@ -383,11 +458,15 @@ pcap_offline_read(pcap_t *p, int cnt, pcap_handler callback, u_char *user)
 		}
 
 		if ((fcode = p->fcode.bf_insns) == NULL ||
-		    bpf_filter(fcode, data, h.len, h.caplen)) {
+		    pcap_filter_packet(fcode, data, h.len, &h.caplen)) {
+			p->md.packets_read++;
+			if (p->dedup != NULL && pcap_dedup_check(p, &h, data))
+				continue;
 			(*callback)(user, &h, data);
 			if (++n >= cnt && cnt > 0)
 				break;
-		}
+		} else
+			p->md.packets_filtered++;
 	}
 	/*XXX this breaks semantics tcpslice expects */
 	return (n);
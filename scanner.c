@@ -0,0 +1,226 @@
+#include "config.h"
+#include <ctype.h>
+#include <string.h>
+#include <stdlib.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include "pcap-int.h"
+#include "gencode.h"
+#include <pcap/namedb.h>
+#include "tokdefs.h"
+#define yylval pcap_lval
+extern YYSTYPE yylval;
+static const char *in;
+struct kw { const char *s; int t; };
+static struct kw kws[] = {
+{"dst", DST},
+{"src", SRC},
+{"link", LINK},
+{"ether", LINK},
+{"ppp", LINK},
+{"slip", LINK},
+{"fddi", LINK},
+{"tr", LINK},
+{"wlan", LINK},
+{"arp", ARP},
+{"rarp", RARP},
+{"ip", IP},
+{"sctp", SCTP},
+{"tcp", TCP},
+{"udp", UDP},
+{"icmp", ICMP},
+{"igmp", IGMP},
+{"igrp", IGRP},
+{"pim", PIM},
+{"vrrp", VRRP},
+{"carp", CARP},
+{"radio", RADIO},
+{"ip6", IPV6},
+{"icmp6", ICMPV6},
+{"ah", AH},
+{"esp", ESP},
+{"atalk", ATALK},
+{"aarp", AARP},
+{"decnet", DECNET},
+{"lat", LAT},
+{"sca", SCA},
+{"moprc", MOPRC},
+{"mopdl", MOPDL},
+{"iso", ISO},
+{"esis", ESIS},
+{"es-is", ESIS},
+{"isis", ISIS},
+{"is-is", ISIS},
+{"l1", L1},
+{"l2", L2},
+{"iih", IIH},
+{"lsp", LSP},
+{"snp", SNP},
+{"csnp", CSNP},
+{"psnp", PSNP},
+{"clnp", CLNP},
+{"stp", STP},
+{"ipx", IPX},
+{"netbeui", NETBEUI},
+{"host", HOST},
+{"net", NET},
+{"mask", NETMASK},
+{"port", PORT},
+{"portrange", PORTRANGE},
+{"proto", PROTO},
+{"protochain", PROTOCHAIN},
+{"gateway", GATEWAY},
+{"type", TYPE},
+{"subtype", SUBTYPE},
+{"direction", DIR},
+{"dir", DIR},
+{"address1", ADDR1},
+{"addr1", ADDR1},
+{"address2", ADDR2},
+{"addr2", ADDR2},
+{"address3", ADDR3},
+{"addr3", ADDR3},
+{"address4", ADDR4},
+{"addr4", ADDR4},
+{"ra", RA},
+{"ta", TA},
+{"less", LESS},
+{"greater", GREATER},
+{"byte", CBYTE},
+{"broadcast", TK_BROADCAST},
+{"multicast", TK_MULTICAST},
+{"and", AND},
+{"or", OR},
+{"not", '!'},
+{"len", LEN},
+{"length", LEN},
+{"inbound", INBOUND},
+{"outbound", OUTBOUND},
+{"sample", SAMPLE},
+{"headers-only", HDRONLY},
+{"vlan", VLAN},
+{"mpls", MPLS},
+{"pppoed", PPPOED},
+{"pppoes", PPPOES},
+{"lane", LANE},
+{"llc", LLC},
+{"metac", METAC},
+{"bcc", BCC},
+{"oam", OAM},
+{"oamf4", OAMF4},
+{"oamf4ec", OAMF4EC},
+{"oamf4sc", OAMF4SC},
+{"sc", SC},
+{"ilmic", ILMIC},
+{"vpi", VPI},
+{"vci", VCI},
+{"connectmsg", CONNECTMSG},
+{"metaconnect", METACONNECT},
+{"on", PF_IFNAME},
+{"ifname", PF_IFNAME},
+{"rset", PF_RSET},
+{"ruleset", PF_RSET},
+{"rnr", PF_RNR},
+{"rulenum", PF_RNR},
+{"srnr", PF_SRNR},
+{"subrulenum", PF_SRNR},
+{"reason", PF_REASON},
+{"action", PF_ACTION},
+{"fisu", FISU},
+{"lssu", LSSU},
+{"lsu", LSSU},
+{"msu", MSU},
+{"hfisu", HFISU},
+{"hlssu", HLSSU},
+{"hmsu", HMSU},
+{"sio", SIO},
+{"opc", OPC},
+{"dpc", DPC},
+{"sls", SLS},
+{"hsio", HSIO},
+{"hopc", HOPC},
+{"hdpc", HDPC},
+{"hsls", HSLS},
+{0,0}};
+struct kn { const char *s; int v; };
+static struct kn kns[] = {
+{"icmptype", 0},
+{"icmpcode", 1},
+{"icmp-echoreply", 0},
+{"icmp-unreach", 3},
+{"icmp-sourcequench", 4},
+{"icmp-redirect", 5},
+{"icmp-echo", 8},
+{"icmp-routeradvert", 9},
+{"icmp-routersolicit", 10},
+{"icmp-timxceed", 11},
+{"icmp-paramprob", 12},
+{"icmp-tstamp", 13},
+{"icmp-tstampreply", 14},
+{"icmp-ireq", 15},
+{"icmp-ireqreply", 16},
+{"icmp-maskreq", 17},
+{"icmp-maskreply", 18},
+{"tcpflags", 13},
+{"tcp-fin", 0x01},
+{"tcp-syn", 0x02},
+{"tcp-rst", 0x04},
+{"tcp-push", 0x08},
+{"tcp-ack", 0x10},
+{"tcp-urg", 0x20},
+{0,0}};
+
+int pcap_lex(void);
+int yylex(void) { return pcap_lex(); }
+void lex_init(const char *b) { in = b; }
+void lex_cleanup(void) { }
+int yywrap(void) { return 1; }
+static int isidc(int c) { return isalnum(c) || c=='-' || c=='_' || c=='.' || c==':'; }
+int pcap_lex(void)
+{
+	char buf[512]; int n = 0; int i;
+	while (*in && isspace((unsigned char)*in)) in++;
+	if (!*in) return 0;
+	if (!strncmp(in, ">=", 2)) { in += 2; return GEQ; }
+	if (!strncmp(in, "<=", 2)) { in += 2; return LEQ; }
+	if (!strncmp(in, "!=", 2)) { in += 2; return NEQ; }
+	if (!strncmp(in, "==", 2)) { in += 2; return '='; }
+	if (!strncmp(in, "<<", 2)) { in += 2; return LSH; }
+	if (!strncmp(in, ">>", 2)) { in += 2; return RSH; }
+	if (!strncmp(in, "&&", 2)) { in += 2; return AND; }
+	if (!strncmp(in, "||", 2)) { in += 2; return OR; }
+	if (*in == '\\') { in++; while (*in && !isspace((unsigned char)*in) && !strchr("!()", *in)) buf[n++] = *in++; buf[n]=0; yylval.s = sdup(buf); return ID; }
+	if (in[0] == '.' && isdigit((unsigned char)in[1])) { n = 1; while (isdigit((unsigned char)in[n])) n++; memcpy(buf, in, n); buf[n] = 0; in += n; yylval.s = sdup(buf); return HID; }
+	if (!isalnum((unsigned char)*in) && !(in[0] == 0x3a && in[1] == 0x3a)) return *in++;
+	/* greedy identifier-ish token; trim trailing '-' that are operators */
+	while (isidc((unsigned char)in[n]) && n < 500) n++;
+	memcpy(buf, in, n); buf[n] = 0;
+	/* keywords (need exact match) */
+	for (i = 0; kws[i].s; i++) if (!strcmp(buf, kws[i].s)) { in += n; return kws[i].t; }
+	for (i = 0; kws[i].s; i++) ;
+	for (i = 0; kns[i].s; i++) if (!strcmp(buf, kns[i].s)) { in += n; yylval.i = kns[i].v; return NUM; }
+	if (strchr(buf, ':')) {
+		int colons = 0; char *p;
+		for (p = buf; *p; p++) if (*p == ':') colons++;
+		if (colons == 5 && strlen(buf) <= 17 && !strstr(buf, "::")) { in += n; yylval.e = pcap_ether_aton(buf); return EID; }
+		{ struct addrinfo h, *r; memset(&h,0,sizeof h); h.ai_family = AF_INET6; h.ai_flags = AI_NUMERICHOST;
+		  if (getaddrinfo(buf, NULL, &h, &r) == 0) { freeaddrinfo(r); in += n; yylval.s = sdup(buf); return HID6; } }
+		/* fall back: cut at colon */
+		n = strchr(buf, ':') - buf; buf[n] = 0;
+	}
+	{
+		char *p; int dots = 0, alldig = 1;
+		for (p = buf; *p; p++) { if (*p == '.') dots++; else if (!isxdigit((unsigned char)*p) && !(p==buf+1 && (*p=='x'||*p=='X'))) alldig = 0; }
+		if (isdigit((unsigned char)buf[0])) {
+			int dec = 1; for (p = buf; *p; p++) if (!isdigit((unsigned char)*p) && *p != '.') dec = 0;
+			if (dots == 0 && (dec || alldig)) { in += n; yylval.i = (int)strtoul(buf, NULL, 0); return NUM; }
+			if (dots >= 1 && dots <= 3 && dec) { in += n; yylval.s = sdup(buf); return HID; }
+		}
+	}
+	/* trim trailing '-' / '.' */
+	while (n > 1 && (buf[n-1] == '-' || buf[n-1] == '.' || buf[n-1] == '_')) n--;
+	buf[n] = 0;
+	for (i = 0; kws[i].s; i++) if (!strcmp(buf, kws[i].s)) { in += n; return kws[i].t; }
+	in += n; yylval.s = sdup(buf); return ID;
+}
@@ -42,9 +42,11 @@ static const char rcsid[] _U_ =
 #include <sys/bitypes.h>
 #endif
 #include <sys/types.h>
+#include <sys/stat.h>
 #endif /* WIN32 */
 
 #include <errno.h>
+#include <limits.h>
 #include <memory.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -201,18 +203,60 @@ struct block_cursor {
 	bpf_u_int32	block_type;
 };
 
+/*
+ * Per-interface information, for the interfaces described by the IDBs
+ * in the current section.
+ *
+ * The way to convert an interface's time stamps to seconds and
+ * microseconds is worked out when its IDB is read, so that, for the
+ * common resolutions, converting a packet's time stamp requires no
+ * division by a value that's only known at run time.
+ */
+struct pcap_ng_if {
+	u_int64_t	tsresol;	/* time stamp resolution */
+	u_int64_t	tsscale;	/* scaling factor for resolution -> microseconds */
+	u_int64_t	tsoffset;	/* time stamp offset */
+	u_int		tsshift;	/* log2 of resolution, if it's a power of 2 */
+	int		scale_type;	/* how to scale the time stamp */
+};
+
+/*
+ * Values for scale_type.
+ */
+#define PASS_THROUGH	0	/* resolution is microseconds */
+#define SCALE_NSEC	1	/* resolution is nanoseconds */
+#define SCALE_BINARY	2	/* resolution is a negative power of 2 */
+#define SCALE_UP	3	/* resolution is lower than microseconds */
+#define SCALE_DOWN	4	/* resolution is higher than microseconds */
+
+/*
+ * Size of the read-ahead buffer used when reading a regular file.
+ * Blocks are parsed in place in that buffer, so, for most blocks,
+ * there's no separate read for the block header and block body.
+ */
+#define READAHEAD_BUFSIZE	(256*1024)
+
+/*
+ * Maximum block size we'll accept.
+ *
+ * We choose 16MB as "too big", for now, so that we handle "reasonably"
+ * large buffers but don't chew up all the memory if we read a malformed
+ * file.
+ */
+#define MAX_BLOCKSIZE	(16*1024*1024)
+
 static int pcap_ng_next_packet(pcap_t *p, struct pcap_pkthdr *hdr,
     u_char **data);
 
 static int
-read_bytes(FILE *fp, void *buf, size_t bytes_to_read, int fail_on_eof,
-    char *errbuf)
+read_bytes(FILE *fp, pcap_t *p, void *buf, size_t bytes_to_read,
+    int fail_on_eof, char *errbuf)
 {
 	size_t amt_read;
 
-	amt_read = fread(buf, 1, bytes_to_read, fp);
+	amt_read = sf_fread(p, buf, bytes_to_read, fp);
 	if (amt_read != bytes_to_read) {
-		if (ferror(fp)) {
+		if (fp != NULL && ferror(fp)) {
 			snprintf(errbuf, PCAP_ERRBUF_SIZE,
 			    "error reading dump file: %s",
 			    pcap_strerror(errno));
@@ -229,15 +273,109 @@ read_bytes(FILE *fp, void *buf, size_t bytes_to_read, int fail_on_eof,
 	return (1);
 }
 
+/*
+ * Make sure that at least needed bytes of the file, starting at p->bp,
+ * are in the buffer, reading more of the file if necessary.
+ *
+ * If we're reading a regular file, we fill as much of the buffer as we
+ * can, so that most blocks don't require a read of their own; otherwise,
+ * we read only what we need, so that we don't block waiting for data
+ * from a pipe that hasn't been written yet.
+ */
+static int
+fill_buffer(FILE *fp, pcap_t *p, size_t needed, int fail_on_eof,
+    char *errbuf)
+{
+	size_t avail, to_read, amt_read;
+	u_char *bigger_buffer;
+
+	avail = p->cc;
+	if (avail >= needed)
+		return (1);
+
+	if (p->sf.mem != NULL) {
+		/*
+		 * The whole file is already in memory, right after what's
+		 * in the buffer, so we just make more of it visible;
+		 * p->cc is an int, so we can't make all of a huge file
+		 * visible at once.
+		 */
+		to_read = p->sf.memlen - p->sf.mempos;
+		if (to_read > (size_t)INT_MAX - avail)
+			to_read = (size_t)INT_MAX - avail;
+		p->cc += to_read;
+		p->sf.mempos += to_read;
+		if ((size_t)p->cc < needed) {
+			if (p->cc == 0 && !fail_on_eof)
+				return (0);	/* EOF */
+			snprintf(errbuf, PCAP_ERRBUF_SIZE,
+			    "truncated dump file; tried to read %lu bytes, only got %lu",
+			    (unsigned long)needed,
+			    (unsigned long)p->cc);
+			return (-1);
+		}
+		return (1);
+	}
+
+	/*
+	 * Move what's left of the data to the beginning of the buffer.
+	 */
+	if (avail != 0 && p->bp != p->buffer)
+		memmove(p->buffer, p->bp, avail);
+	p->bp = p->buffer;
+
+	/*
+	 * Is the buffer big enough?
+	 */
+	if ((size_t)p->bufsize < needed) {
+		/*
+		 * No - make it big enough.
+		 */
+		bigger_buffer = realloc(p->buffer, needed);
+		if (bigger_buffer == NULL) {
+			snprintf(errbuf, PCAP_ERRBUF_SIZE, "out of memory");
+			return (-1);
+		}
+		p->buffer = bigger_buffer;
+		p->bp = bigger_buffer;
+		p->bufsize = needed;
+	}
+
+	if (p->sf.readahead)
+		to_read = p->bufsize - avail;
+	else
+		to_read = needed - avail;
+	amt_read = fread(p->buffer + avail, 1, to_read, fp);
+	p->cc = avail + amt_read;
+	if ((size_t)p->cc < needed) {
+		if (ferror(fp)) {
+			snprintf(errbuf, PCAP_ERRBUF_SIZE,
+			    "error reading dump file: %s",
+			    pcap_strerror(errno));
+		} else {
+			if (p->cc == 0 && !fail_on_eof)
+				return (0);	/* EOF */
+			snprintf(errbuf, PCAP_ERRBUF_SIZE,
+			    "truncated dump file; tried to read %lu bytes, only got %lu",
+			    (unsigned long)needed,
+			    (unsigned long)p->cc);
+		}
+		return (-1);
+	}
+	return (1);
+}
+
 static int
 read_block(FILE *fp, pcap_t *p, struct block_cursor *cursor, char *errbuf)
 {
 	int status;
 	struct block_header bhdr;
+	u_char *block, *bigger_buffer;
 
-	status = read_bytes(fp, &bhdr, sizeof(bhdr), 0, errbuf);
+	status = fill_buffer(fp, p, sizeof(bhdr), 0, errbuf);
 	if (status <= 0)
 		return (status);	/* error or EOF */
+	memcpy(&bhdr, p->bp, sizeof(bhdr));
 
 	if (p->sf.swapped) {
 		bhdr.block_type = SWAPLONG(bhdr.block_type);
@@ -246,15 +384,11 @@ read_block(FILE *fp, pcap_t *p, struct block_cursor *cursor, char *errbuf)
 
 	/*
 	 * Is this block "too big"?
-	 *
-	 * We choose 16MB as "too big", for now, so that we handle
-	 * "reasonably" large buffers but don't chew up all the
-	 * memory if we read a malformed file.
 	 */
-	if (bhdr.total_length > 16*1024*1024) {
+	if (bhdr.total_length > MAX_BLOCKSIZE) {
 		snprintf(errbuf, PCAP_ERRBUF_SIZE,
 		    "pcap-ng block size %u > maximum %u",
-		    bhdr.total_length, 16*1024*1024);
+		    bhdr.total_length, MAX_BLOCKSIZE);
 		    return (-1);
 	}
 
@@ -272,35 +406,54 @@ read_block(FILE *fp, pcap_t *p, struct block_cursor *cursor, char *errbuf)
 	}
 
 	/*
-	 * Is the buffer big enough?
+	 * Blocks are parsed in place, so they must all start on a
+	 * 4-byte boundary in the buffer; the spec requires that
+	 * block lengths be a multiple of 4.
 	 */
-	if (p->bufsize < bhdr.total_length) {
-		/*
-		 * No - make it big enough.
-		 */
-		p->buffer = realloc(p->buffer, bhdr.total_length);
-		if (p->buffer == NULL) {
-			snprintf(errbuf, PCAP_ERRBUF_SIZE, "out of memory");
-			return (-1);
-		}
+	if ((bhdr.total_length % 4) != 0) {
+		snprintf(errbuf, PCAP_ERRBUF_SIZE,
+		    "block in pcap-ng dump file has a length of %u that is not a multiple of 4",
+		    bhdr.total_length);
+		return (-1);
 	}
 
 	/*
-	 * Copy the stuff we've read to the buffer, and read the rest
-	 * of the block.
+	 * Get the rest of the block into the buffer.
 	 */
-	memcpy(p->buffer, &bhdr, sizeof(bhdr));
-	if (read_bytes(fp, p->buffer + sizeof(bhdr),
-	    bhdr.total_length - sizeof(bhdr), 1, errbuf) == -1)
+	if (fill_buffer(fp, p, bhdr.total_length, 1, errbuf) == -1)
 		return (-1);
 
 	/*
-	 * Initialize the cursor.
+	 * If we're parsing blocks in our caller's buffer but can't
+	 * parse them in place, because they're byte-swapped in place or
+	 * aren't aligned, copy the block into our own buffer first.
 	 */
-	cursor->data = p->buffer + sizeof(bhdr);
+	if (p->sf.memcopy) {
+		if ((size_t)p->bufsize < bhdr.total_length) {
+			bigger_buffer = realloc(p->buffer, bhdr.total_length);
+			if (bigger_buffer == NULL) {
+				snprintf(errbuf, PCAP_ERRBUF_SIZE,
+				    "out of memory");
+				return (-1);
+			}
+			p->buffer = bigger_buffer;
+			p->bufsize = bhdr.total_length;
+		}
+		memcpy(p->buffer, p->bp, bhdr.total_length);
+		block = p->buffer;
+	} else
+		block = p->bp;
+
+	/*
+	 * Initialize the cursor, and consume the block; it remains
+	 * valid until the next block is read.
+	 */
+	cursor->data = block + sizeof(bhdr);
 	cursor->data_remaining = bhdr.total_length - sizeof(bhdr) -
 	    sizeof(struct block_trailer);
 	cursor->block_type = bhdr.block_type;
+	p->bp += bhdr.total_length;
+	p->cc -= bhdr.total_length;
 	return (1);
 }
 
@@ -377,8 +530,8 @@ get_optvalue_from_block_data(struct block_cursor *cursor,
 }
 
 static int
-process_idb_options(pcap_t *p, struct block_cursor *cursor, u_int *tsresol,
-    u_int64_t *tsoffset, char *errbuf)
+process_idb_options(pcap_t *p, struct block_cursor *cursor,
+    struct pcap_ng_if *ifp, char *errbuf)
 {
 	struct option_header *opthdr;
 	void *optvalue;
@@ -386,6 +539,14 @@ process_idb_options(pcap_t *p, struct block_cursor *cursor, u_int *tsresol,
 	u_char tsresol_opt;
 	u_int i;
 
+	/*
+	 * Set the default time stamp resolution and offset.
+	 */
+	ifp->tsresol = 1000000;		/* microsecond resolution */
+	ifp->tsshift = 0;		/* not a power of 2 */
+	ifp->tsoffset = 0;		/* absolute timestamps */
+	ifp->scale_type = PASS_THROUGH;
+
 	saw_tsresol = 0;
 	saw_tsoffset = 0;
 	while (cursor->data_remaining != 0) {
@@ -436,21 +597,31 @@ process_idb_options(pcap_t *p, struct block_cursor *cursor, u_int *tsresol,
 				return (-1);
 			}
 			saw_tsresol = 1;
-			tsresol_opt = *(u_int *)optvalue;
+			tsresol_opt = *(u_char *)optvalue;
 			if (tsresol_opt & 0x80) {
 				/*
 				 * Resolution is negative power of 2.
 				 */
-				*tsresol = 1 << (tsresol_opt & 0x7F);
+				ifp->tsshift = tsresol_opt & 0x7F;
+				if (ifp->tsshift > 63)
+					ifp->tsresol = 0;
+				else
+					ifp->tsresol = (u_int64_t)1 << ifp->tsshift;
 			} else {
 				/*
-				 * Resolution is negative power of 10.
+				 * Resolution is negative power of 10;
+				 * 10^19 is the largest that fits in 64
+				 * bits.
 				 */
-				*tsresol = 1;
-				for (i = 0; i < tsresol_opt; i++)
-					*tsresol *= 10;
+				ifp->tsresol = 1;
+				if (tsresol_opt > 19)
+					ifp->tsresol = 0;
+				else {
+					for (i = 0; i < tsresol_opt; i++)
+						ifp->tsresol *= 10;
+				}
 			}
-			if (*tsresol == 0) {
+			if (ifp->tsresol == 0) {
 				/*
 				 * Resolution is too high.
 				 */
@@ -480,9 +651,9 @@ process_idb_options(pcap_t *p, struct block_cursor *cursor, u_int *tsresol,
 				return (-1);
 			}
 			saw_tsoffset = 1;
-			memcpy(tsoffset, optvalue, sizeof(*tsoffset));
+			memcpy(&ifp->tsoffset, optvalue, sizeof(ifp->tsoffset));
 			if (p->sf.swapped)
-				*tsoffset = SWAPLL(*tsoffset);
+				ifp->tsoffset = SWAPLL(ifp->tsoffset);
 			break;
 
 		default:
@@ -491,6 +662,95 @@ process_idb_options(pcap_t *p, struct block_cursor *cursor, u_int *tsresol,
 	}
 
 done:
+	/*
+	 * Work out how to convert the sub-second part of the time
+	 * stamp to microseconds.
+	 */
+	if (ifp->tsresol == 1000000) {
+		/*
+		 * Microsecond resolution; nothing to do.
+		 */
+		ifp->scale_type = PASS_THROUGH;
+		ifp->tsscale = 1;
+	} else if (ifp->tsresol == 1000000000) {
+		/*
+		 * Nanosecond resolution; scale down by a constant.
+		 */
+		ifp->scale_type = SCALE_NSEC;
+		ifp->tsscale = 1000;
+	} else if (ifp->tsshift != 0) {
+		/*
+		 * Negative power of 2; use shifts and masks.
+		 */
+		ifp->scale_type = SCALE_BINARY;
+		ifp->tsscale = 1;
+	} else if (ifp->tsresol > 1000000) {
+		/*
+		 * Higher than microsecond resolution;
+		 * scale down to microseconds.
+		 */
+		ifp->scale_type = SCALE_DOWN;
+		ifp->tsscale = (ifp->tsresol / 1000000);
+	} else {
+		/*
+		 * Lower than microsecond resolution;
+		 * scale up to microseconds.
+		 */
+		ifp->scale_type = SCALE_UP;
+		ifp->tsscale = (1000000 / ifp->tsresol);
+	}
+	return (0);
+}
+
+/*
+ * Add an entry for the interface described by an IDB to the table of
+ * interfaces for this section, and process the IDB's options to fill
+ * it in.  The table only grows when it's full, so this doesn't allocate
+ * anything for most IDBs.
+ */
+static int
+add_interface(pcap_t *p, struct block_cursor *cursor, char *errbuf)
+{
+	struct pcap_ng_if *new_ifaces;
+	bpf_u_int32 new_ifaces_size;
+
+	if (p->sf.ifcount >= p->sf.ifaces_size) {
+		/*
+		 * The table is full; double its size.
+		 */
+		if (p->sf.ifaces_size >=
+		    0x7FFFFFFF / sizeof (struct pcap_ng_if)) {
+			snprintf(errbuf, PCAP_ERRBUF_SIZE,
+			    "more than %u interfaces in the file",
+			    p->sf.ifaces_size);
+			return (-1);
+		}
+		if (p->sf.ifaces_size == 0)
+			new_ifaces_size = 1;
+		else
+			new_ifaces_size = p->sf.ifaces_size * 2;
+		new_ifaces = realloc(p->sf.ifaces,
+		    new_ifaces_size * sizeof (struct pcap_ng_if));
+		if (new_ifaces == NULL) {
+			snprintf(errbuf, PCAP_ERRBUF_SIZE, "out of memory");
+			return (-1);
+		}
+		p->sf.ifaces = new_ifaces;
+		p->sf.ifaces_size = new_ifaces_size;
+	}
+
+	/*
+	 * Now look for various time stamp options, so we know how to
+	 * interpret the time stamps for this interface.
+	 */
+	if (process_idb_options(p, cursor, &p->sf.ifaces[p->sf.ifcount],
+	    errbuf) == -1)
+		return (-1);
+
+	/*
+	 * Count this interface.
+	 */
+	p->sf.ifcount++;
 	return (0);
 }
 
@@ -538,9 +798,9 @@ pcap_ng_check_header(pcap_t *p, bpf_u_int32 magic, FILE *fp, char *errbuf)
 	 * fixed-length portion of the SHB, and look for the byte-order
 	 * magic value.
 	 */
-	amt_read = fread(&total_length, 1, sizeof(total_length), fp);
+	amt_read = sf_fread(p, &total_length, sizeof(total_length), fp);
 	if (amt_read < sizeof(total_length)) {
-		if (ferror(fp)) {
+		if (fp != NULL && ferror(fp)) {
 			snprintf(errbuf, PCAP_ERRBUF_SIZE,
 			    "error reading dump file: %s",
 			    pcap_strerror(errno));
@@ -553,9 +813,10 @@ pcap_ng_check_header(pcap_t *p, bpf_u_int32 magic, FILE *fp, char *errbuf)
 		 */
 		return (0);
 	}
-	amt_read = fread(&byte_order_magic, 1, sizeof(byte_order_magic), fp);
+	amt_read = sf_fread(p, &byte_order_magic, sizeof(byte_order_magic),
+	    fp);
 	if (amt_read < sizeof(byte_order_magic)) {
-		if (ferror(fp)) {
+		if (fp != NULL && ferror(fp)) {
 			snprintf(errbuf, PCAP_ERRBUF_SIZE,
 			    "error reading dump file: %s",
 			    pcap_strerror(errno));
@@ -591,19 +852,38 @@ pcap_ng_check_header(pcap_t *p, bpf_u_int32 magic, FILE *fp, char *errbuf)
 		return (-1);
 	}
 
+	/*
+	 * If this is a regular file, we can read ahead of the block
+	 * we're processing without worrying about blocking.
+	 */
+#if !defined(WIN32) && !defined(MSDOS)
+	{
+		struct stat statb;
+
+		if (fp != NULL && fstat(fileno(fp), &statb) == 0 &&
+		    S_ISREG(statb.st_mode))
+			p->sf.readahead = 1;
+	}
+#endif
+
 	/*
 	 * Allocate a buffer into which to read blocks.  We default to
 	 * the maximum of:
 	 *
 	 *	the total length of the SHB for which we read the header;
 	 *
-	 *	2K, which should be more than large enough for an Enhanced
-	 *	Packet Block containing a full-size Ethernet frame, and
-	 *	leaving room for some options.
+	 *	READAHEAD_BUFSIZE if we're reading ahead, so that we can
+	 *	read many blocks at a time, or 2K if we're not, which
+	 *	should be more than large enough for an Enhanced Packet
+	 *	Block containing a full-size Ethernet frame, and leaving
+	 *	room for some options.
 	 *
 	 * If we find a bigger block, we reallocate the buffer.
 	 */
-	p->bufsize = 2048;
+	if (p->sf.readahead)
+		p->bufsize = READAHEAD_BUFSIZE;
+	else
+		p->bufsize = 2048;
 	if (p->bufsize < total_length)
 		p->bufsize = total_length;
 	p->buffer = malloc(p->bufsize);
@@ -621,7 +901,7 @@ pcap_ng_check_header(pcap_t *p, bpf_u_int32 magic, FILE *fp, char *errbuf)
 	bhdrp->block_type = magic;
 	bhdrp->total_length = total_length;
 	shbp->byte_order_magic = byte_order_magic;
-	if (read_bytes(fp,
+	if (read_bytes(fp, p,
 	    p->buffer + (sizeof(magic) + sizeof(total_length) + sizeof(byte_order_magic)),
 	    total_length - (sizeof(magic) + sizeof(total_length) + sizeof(byte_order_magic)),
 	    1, errbuf) == -1)
@@ -648,11 +928,21 @@ pcap_ng_check_header(pcap_t *p, bpf_u_int32 magic, FILE *fp, char *errbuf)
 	p->sf.version_minor = shbp->minor_version;
 
 	/*
-	 * Set the default time stamp resolution and offset.
+	 * We're done with the SHB; the rest of the file is read into
+	 * the buffer as we go.
 	 */
-	p->sf.tsresol = 1000000;	/* microsecond resolution */
-	p->sf.tsscale = 1;		/* multiply by 1 to scale to microseconds */
-	p->sf.tsoffset = 0;		/* absolute timestamps */
+	p->bp = p->buffer;
+	p->cc = 0;
+	if (p->sf.mem != NULL) {
+		/*
+		 * The rest of the file is in our caller's buffer, and
+		 * fill_buffer() treats that as the buffer.  We parse
+		 * blocks in place if we can.
+		 */
+		p->bp = (u_char *)p->sf.mem + p->sf.mempos;
+		if (p->sf.swapped || ((unsigned long)p->sf.mem & 3) != 0)
+			p->sf.memcopy = 1;
+	}
 
 	/*
 	 * Now start looking for an Interface Description Block.
@@ -691,36 +981,10 @@ pcap_ng_check_header(pcap_t *p, bpf_u_int32 magic, FILE *fp, char *errbuf)
 			}
 
 			/*
-			 * Count this interface.
+			 * Add it to the table of interfaces.
 			 */
-			p->sf.ifcount++;
-
-			/*
-			 * Now look for various time stamp options, so
-			 * we know how to interpret the time stamps.
-			 */
-			if (process_idb_options(p, &cursor, &p->sf.tsresol,
-			    &p->sf.tsoffset, errbuf) == -1)
+			if (add_interface(p, &cursor, errbuf) == -1)
 				goto fail;
-
-			/*
-			 * Compute the scaling factor to convert the
-			 * sub-second part of the time stamp to
-			 * microseconds.
-			 */
-			if (p->sf.tsresol > 1000000) {
-				/*
-				 * Higher than microsecond resolution;
-				 * scale down to microseconds.
-				 */
-				p->sf.tsscale = (p->sf.tsresol / 1000000);
-			} else {
-				/*
-				 * Lower than microsecond resolution;
-				 * scale up to microseconds.
-				 */
-				p->sf.tsscale = (1000000 / p->sf.tsresol);
-			}
 			goto done;
 
 		case BT_EPB:
@@ -754,6 +1018,8 @@ done:
 	return (1);
 
 fail:
+	free(p->sf.ifaces);
+	p->sf.ifaces = NULL;
 	free(p->buffer);
 	return (-1);
 }
@@ -774,9 +1040,8 @@ pcap_ng_next_packet(pcap_t *p, struct pcap_pkthdr *hdr, u_char **data)
 	bpf_u_int32 interface_id = 0xFFFFFFFF;
 	struct interface_description_block *idbp;
 	struct section_header_block *shbp;
+	struct pcap_ng_if *ifp;
 	FILE *fp = p->sf.rfile;
-	u_int tsresol;
-	u_int64_t tsoffset;
 	u_int64_t t, sec, frac;
 
 	/*
@@ -929,37 +1194,12 @@ pcap_ng_next_packet(pcap_t *p, struct pcap_pkthdr *hdr, u_char **data)
 			}
 
 			/*
-			 * Count this interface.
-			 */
-			p->sf.ifcount++;
-
-			/*
-			 * Set the default time stamp resolution and offset.
+			 * Add it to the table of interfaces; each
+			 * interface can have its own time stamp
+			 * resolution and offset.
 			 */
-			tsresol = 1000000;	/* microsecond resolution */
-			tsoffset = 0;		/* absolute timestamps */
-
-			/*
-			 * Now look for various time stamp options, to
-			 * make sure they're the same.
-			 *
-			 * XXX - we could, in theory, handle multiple
-			 * different resolutions and offsets, but we
-			 * don't do so for now.
-			 */
-			if (process_idb_options(p, &cursor, &tsresol, &tsoffset,
-			    p->errbuf) == -1)
-				return (-1);
-			if (tsresol != p->sf.tsresol) {
-				snprintf(p->errbuf, PCAP_ERRBUF_SIZE,
-				    "an interface has a time stamp resolution different from the time stamp resolution of the first interface");
+			if (add_interface(p, &cursor, p->errbuf) == -1)
 				return (-1);
-			}
-			if (tsoffset != p->sf.tsoffset) {
-				snprintf(p->errbuf, PCAP_ERRBUF_SIZE,
-				    "an interface has a time stamp offset different from the time stamp offset of the first interface");
-				return (-1);
-			}
 			break;
 
 		case BT_SHB:
@@ -1062,21 +1302,60 @@ found:
 	/*
 	 * Convert the time stamp to a struct timeval.
 	 */
-	sec = t / p->sf.tsresol + p->sf.tsoffset;
-	frac = t % p->sf.tsresol;
-	if (p->sf.tsresol > 1000000) {
+	ifp = &p->sf.ifaces[interface_id];
+	switch (ifp->scale_type) {
+
+	case PASS_THROUGH:
+		/*
+		 * Microsecond resolution; dividing by a constant
+		 * doesn't require a division instruction.
+		 */
+		sec = t / 1000000;
+		frac = t % 1000000;
+		break;
+
+	case SCALE_NSEC:
+		/*
+		 * Nanosecond resolution; likewise.
+		 */
+		sec = t / 1000000000;
+		frac = (t % 1000000000) / 1000;
+		break;
+
+	case SCALE_BINARY:
+		/*
+		 * Resolution is 2^-tsshift; scale the fraction to
+		 * microseconds, dropping low-order bits first if
+		 * multiplying by 10^6 could overflow.
+		 */
+		sec = t >> ifp->tsshift;
+		frac = t & (ifp->tsresol - 1);
+		if (ifp->tsshift > 44)
+			frac = ((frac >> (ifp->tsshift - 44)) * 1000000) >> 44;
+		else
+			frac = (frac * 1000000) >> ifp->tsshift;
+		break;
+
+	case SCALE_DOWN:
 		/*
 		 * Higher than microsecond resolution; scale down to
 		 * microseconds.
 		 */
-		frac /= p->sf.tsscale;
-	} else {
+		sec = t / ifp->tsresol;
+		frac = (t % ifp->tsresol) / ifp->tsscale;
+		break;
+
+	case SCALE_UP:
+	default:
 		/*
 		 * Lower than microsecond resolution; scale up to
 		 * microseconds.
 		 */
-		frac *= p->sf.tsscale;
+		sec = t / ifp->tsresol;
+		frac = (t % ifp->tsresol) * ifp->tsscale;
+		break;
 	}
+	sec += ifp->tsoffset;
 	hdr->ts.tv_sec = sec;
 	hdr->ts.tv_usec = frac;
 
@@ -149,10 +149,10 @@ pcap_check_header(pcap_t *p, bpf_u_int32 magic, FILE *fp, char *errbuf)
 	 * the rest of the header.
 	 */
 	hdr.magic = magic;
-	amt_read = fread(((char *)&hdr) + sizeof hdr.magic, 1,
+	amt_read = sf_fread(p, ((char *)&hdr) + sizeof hdr.magic,
 	    sizeof(hdr) - sizeof(hdr.magic), fp);
 	if (amt_read != sizeof(hdr) - sizeof(hdr.magic)) {
-		if (ferror(fp)) {
+		if (fp != NULL && ferror(fp)) {
 			snprintf(errbuf, PCAP_ERRBUF_SIZE,
 			    "error reading dump file: %s",
 			    pcap_strerror(errno));
@@ -306,9 +306,9 @@ pcap_next_packet(pcap_t *p, struct pcap_pkthdr *hdr, u_char **data)
 	 * unpatched libpcap we only read as many bytes as the regular
 	 * header has.
 	 */
-	amt_read = fread(&sf_hdr, 1, p->sf.hdrsize, fp);
+	amt_read = sf_fread(p, &sf_hdr, p->sf.hdrsize, fp);
 	if (amt_read != p->sf.hdrsize) {
-		if (ferror(fp)) {
+		if (fp != NULL && ferror(fp)) {
 			snprintf(p->errbuf, PCAP_ERRBUF_SIZE,
 			    "error reading dump file: %s",
 			    pcap_strerror(errno));
@@ -361,7 +361,40 @@ pcap_next_packet(pcap_t *p, struct pcap_pkthdr *hdr, u_char **data)
 		break;
 	}
 
-	if (hdr->caplen > p->bufsize) {
+	if (p->sf.mem != NULL) {
+		/*
+		 * The packet's already in memory, so hand back a pointer
+		 * to it rather than copying it, keeping at most
+		 * p->bufsize bytes of it as we do when reading a file.
+		 */
+		if (hdr->caplen > p->bufsize && hdr->caplen > 65535) {
+			snprintf(p->errbuf, PCAP_ERRBUF_SIZE,
+			    "bogus savefile header");
+			return (-1);
+		}
+		if (hdr->caplen > p->sf.memlen - p->sf.mempos) {
+			snprintf(p->errbuf, PCAP_ERRBUF_SIZE,
+			    "truncated dump file; tried to read %u captured bytes, only got %lu",
+			    hdr->caplen,
+			    (unsigned long)(p->sf.memlen - p->sf.mempos));
+			return (-1);
+		}
+		*data = (u_char *)p->sf.mem + p->sf.mempos;
+		p->sf.mempos += hdr->caplen;
+		if (hdr->caplen > p->bufsize)
+			hdr->caplen = p->bufsize;
+
+		/*
+		 * Pseudo-headers are byte-swapped in place, and the
+		 * buffer belongs to our caller, so those packets have
+		 * to be copied.
+		 */
+		if (p->sf.swapped && (p->linktype == DLT_USB_LINUX ||
+		    p->linktype == DLT_USB_LINUX_MMAPPED)) {
+			memcpy(p->buffer, *data, hdr->caplen);
+			*data = p->buffer;
+		}
+	} else if (hdr->caplen > p->bufsize) {
 		/*
 		 * This can happen due to Solaris 2.3 systems tripping
 		 * over the BUFMOD problem and not setting the snapshot
@@ -412,6 +445,7 @@ pcap_next_packet(pcap_t *p, struct pcap_pkthdr *hdr, u_char **data)
 		 */
 		hdr->caplen = p->bufsize;
 		memcpy(p->buffer, (char *)tp, p->bufsize);
+		*data = p->buffer;
 	} else {
 		/* read the packet itself */
 		amt_read = fread(p->buffer, 1, hdr->caplen, fp);
@@ -427,8 +461,8 @@ pcap_next_packet(pcap_t *p, struct pcap_pkthdr *hdr, u_char **data)
 			}
 			return (-1);
 		}
+		*data = p->buffer;
 	}
-	*data = p->buffer;
 
 	if (p->sf.swapped) {
 		/*
@@ -451,19 +485,26 @@ pcap_next_packet(pcap_t *p, struct pcap_pkthdr *hdr, u_char **data)
 	return (0);
 }
 
+static void
+sf_make_header(struct pcap_file_header *hdr, int linktype, int thiszone,
+    int snaplen)
+{
+	hdr->magic = TCPDUMP_MAGIC;
+	hdr->version_major = PCAP_VERSION_MAJOR;
+	hdr->version_minor = PCAP_VERSION_MINOR;
+
+	hdr->thiszone = thiszone;
+	hdr->snaplen = snaplen;
+	hdr->sigfigs = 0;
+	hdr->linktype = linktype;
+}
+
 static int
 sf_write_header(FILE *fp, int linktype, int thiszone, int snaplen)
 {
 	struct pcap_file_header hdr;
 
-	hdr.magic = TCPDUMP_MAGIC;
-	hdr.version_major = PCAP_VERSION_MAJOR;
-	hdr.version_minor = PCAP_VERSION_MINOR;
-
-	hdr.thiszone = thiszone;
-	hdr.snaplen = snaplen;
-	hdr.sigfigs = 0;
-	hdr.linktype = linktype;
+	sf_make_header(&hdr, linktype, thiszone, snaplen);
 
 	if (fwrite((char *)&hdr, sizeof(hdr), 1, fp) != 1)
 		return (-1);
@@ -616,3 +657,127 @@ pcap_dump_close(pcap_dumper_t *p)
 #endif
 	(void)fclose((FILE *)p);
 }
+
+/*
+ * Dumping to a buffer in memory, which grows as needed.
+ */
+#define MEMDUMP_INITIAL_SIZE	65536
+
+struct pcap_memdumper {
+	u_char	*buf;
+	size_t	len;		/* bytes of buf in use */
+	size_t	size;		/* bytes allocated for buf */
+	int	nomem;		/* we couldn't grow buf, so packets were lost */
+};
+
+pcap_memdumper_t *
+pcap_dump_open_mem(pcap_t *p)
+{
+	pcap_memdumper_t *md;
+	int linktype;
+
+	if (!p->activated) {
+		snprintf(p->errbuf, PCAP_ERRBUF_SIZE,
+		    "memory: not-yet-activated pcap_t passed to pcap_dump_open_mem");
+		return (NULL);
+	}
+	linktype = dlt_to_linktype(p->linktype);
+	if (linktype == -1) {
+		snprintf(p->errbuf, PCAP_ERRBUF_SIZE,
+		    "memory: link-layer type %d isn't supported in savefiles",
+		    p->linktype);
+		return (NULL);
+	}
+	linktype |= p->linktype_ext;
+
+	md = malloc(sizeof(*md));
+	if (md == NULL) {
+		snprintf(p->errbuf, PCAP_ERRBUF_SIZE, "malloc: %s",
+		    pcap_strerror(errno));
+		return (NULL);
+	}
+	md->size = MEMDUMP_INITIAL_SIZE;
+	md->buf = malloc(md->size);
+	if (md->buf == NULL) {
+		snprintf(p->errbuf, PCAP_ERRBUF_SIZE, "malloc: %s",
+		    pcap_strerror(errno));
+		free(md);
+		return (NULL);
+	}
+	sf_make_header((struct pcap_file_header *)md->buf, linktype,
+	    p->tzoff, p->snapshot);
+	md->len = sizeof(struct pcap_file_header);
+	md->nomem = 0;
+	return (md);
+}
+
+/*
+ * Append a packet to the buffer.
+ */
+void
+pcap_dump_mem(u_char *user, const struct pcap_pkthdr *h, const u_char *sp)
+{
+	pcap_memdumper_t *md = (pcap_memdumper_t *)user;
+	struct pcap_sf_pkthdr sf_hdr;
+	size_t needed, newsize;
+	u_char *newbuf;
+
+	if (md->nomem)
+		return;
+	needed = md->len + sizeof(sf_hdr) + h->caplen;
+	if (needed > md->size) {
+		newsize = md->size;
+		while (newsize < needed)
+			newsize *= 2;
+		newbuf = realloc(md->buf, newsize);
+		if (newbuf == NULL) {
+			md->nomem = 1;
+			return;
+		}
+		md->buf = newbuf;
+		md->size = newsize;
+	}
+
+	sf_hdr.ts.tv_sec  = h->ts.tv_sec;
+	sf_hdr.ts.tv_usec = h->ts.tv_usec;
+	sf_hdr.caplen     = h->caplen;
+	sf_hdr.len        = h->len;
+	memcpy(md->buf + md->len, &sf_hdr, sizeof(sf_hdr));
+	memcpy(md->buf + md->len + sizeof(sf_hdr), sp, h->caplen);
+	md->len = needed;
+}
+
+/*
+ * Return the savefile dumped so far, and its length; the pointer is
+ * valid until the next call to pcap_dump_mem(), pcap_dump_mem_reset()
+ * or pcap_dump_mem_close().  Returns NULL if packets were lost because
+ * we ran out of memory.
+ */
+const u_char *
+pcap_dump_mem_buffer(pcap_memdumper_t *md, size_t *lenp)
+{
+	if (md->nomem) {
+		*lenp = 0;
+		return (NULL);
+	}
+	*lenp = md->len;
+	return (md->buf);
+}
+
+/*
+ * Discard the packets dumped so far, keeping the file header and the
+ * memory allocated for the buffer.
+ */
+void
+pcap_dump_mem_reset(pcap_memdumper_t *md)
+{
+	md->len = sizeof(struct pcap_file_header);
+	md->nomem = 0;
+}
+
+void
+pcap_dump_mem_close(pcap_memdumper_t *md)
+{
+	free(md->buf);
+	free(md);
+}
@@ -0,0 +1,604 @@
+/*
+ * Copyright (c) 1988, 1989, 1990, 1991, 1992, 1993, 1994, 1995, 1996, 1997, 2000
+ *	The Regents of the University of California.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that: (1) source code distributions
+ * retain the above copyright notice and this paragraph in its entirety, (2)
+ * distributions including binary code include the above copyright notice and
+ * this paragraph in its entirety in the documentation or other materials
+ * provided with the distribution, and (3) all advertising materials mentioning
+ * features or use of this software display the following acknowledgement:
+ * ``This product includes software developed by the University of California,
+ * Lawrence Berkeley Laboratory and its contributors.'' Neither the name of
+ * the University nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/*
+ * capturebench - measure live capture throughput on Linux.
+ *
+ * A child process sends synthetic UDP packets with pcap_inject() on one
+ * end of a veth pair while we capture them on the other end, once for
+ * each combination of capture mode, kernel filter, buffer size and
+ * packet size.  For each run we report the rate at which packets were
+ * sent and captured, the drops reported by pcap_stats(), the CPU time
+ * the capturing process used, and how many times per second it was woken
+ * up.  The output is one tab-separated line per run, after header lines
+ * starting with "#".
+ *
+ * The modes are:
+ *
+ *	v2	memory-mapped, TPACKET_V2 (the default on current kernels);
+ *	v1	memory-mapped, TPACKET_V1;
+ *	nommap	recvfrom() on the packet socket;
+ *	cooked	memory-mapped on the "any" device, which captures in
+ *		cooked mode; only incoming packets are captured.
+ *
+ * The ring version, and whether the ring is used at all, are chosen
+ * with the PCAP_LINUX_RING environment variable; see README.linux.
+ *
+ * Ring slots are sized for the snapshot length, so with the default of
+ * 65535 a 2MB ring holds only a few dozen packets; -S sets a smaller one.
+ *
+ * Creating the veth pair needs the "ip" command and CAP_NET_ADMIN;
+ * capturing and sending need CAP_NET_RAW.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <pcap.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#ifndef HAVE___ATTRIBUTE__
+#define __attribute__(x)
+#endif
+
+static char *program_name;
+
+/* Forwards */
+static void usage(void) __attribute__((noreturn));
+static void error(const char *, ...)
+    __attribute__((noreturn, format (printf, 1, 2)));
+
+extern int optind;
+extern int opterr;
+extern char *optarg;
+
+#define BENCH_PORT	9		/* UDP discard */
+#define BENCH_FILTER	"udp dst port 9"
+#define SAMPLE_FILTER	"udp dst port 9 and sample 4"
+#define BENCH_MAGIC	"pcapbench"
+#define MAGIC_OFF	(14 + 20 + 8)	/* Ethernet + IPv4 + UDP */
+#define MAX_LIST	16
+
+/*
+ * Kernel filter settings.
+ */
+#define FILTER_NONE	0
+#define FILTER_KERNEL	1
+#define FILTER_SAMPLE	2
+
+static const char *filter_names[] = { "none", "kernel", "sample" };
+
+static char txdev[64], rxdev[64];
+static int created;
+
+static double
+now(void)
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return (tv.tv_sec + tv.tv_usec / 1e6);
+}
+
+static double
+tv_secs(const struct timeval *tv)
+{
+	return (tv->tv_sec + tv->tv_usec / 1e6);
+}
+
+/*
+ * Parse a comma-separated list of numbers.
+ */
+static int
+parse_list(const char *arg, int *list, const char *what)
+{
+	char *copy, *cp, *tok, *end;
+	int n;
+
+	copy = strdup(arg);
+	if (copy == NULL)
+		error("strdup: %s", pcap_strerror(errno));
+	n = 0;
+	for (cp = copy; (tok = strtok(cp, ",")) != NULL; cp = NULL) {
+		if (n == MAX_LIST)
+			error("too many %s values", what);
+		list[n] = strtol(tok, &end, 0);
+		if (end == tok || *end != '\0' || list[n] <= 0)
+			error("invalid %s %s", what, tok);
+		n++;
+	}
+	free(copy);
+	return (n);
+}
+
+static void
+run_cmd(const char *fmt, ...)
+{
+	char cmd[256];
+	va_list ap;
+
+	va_start(ap, fmt);
+	(void)vsnprintf(cmd, sizeof(cmd), fmt, ap);
+	va_end(ap);
+	if (system(cmd) != 0)
+		error("\"%s\" failed", cmd);
+}
+
+static void
+destroy_veth(void)
+{
+	char cmd[128];
+
+	if (created) {
+		snprintf(cmd, sizeof(cmd), "ip link del %s", txdev);
+		(void)system(cmd);
+		created = 0;
+	}
+}
+
+static void
+sigexit(int sig)
+{
+	destroy_veth();
+	signal(sig, SIG_DFL);
+	raise(sig);
+}
+
+static void
+create_veth(void)
+{
+	run_cmd("ip link add name %s type veth peer name %s", txdev, rxdev);
+	created = 1;
+	atexit(destroy_veth);
+	signal(SIGINT, sigexit);
+	signal(SIGTERM, sigexit);
+	run_cmd("ip link set %s up", txdev);
+	run_cmd("ip link set %s up", rxdev);
+
+	/*
+	 * Give the links a moment to come up; packets sent before
+	 * the carrier is up are dropped.
+	 */
+	usleep(500000);
+}
+
+static void
+put_short(u_char *p, u_int v)
+{
+	p[0] = (v >> 8) & 0xff;
+	p[1] = v & 0xff;
+}
+
+/*
+ * Send "size"-byte packets on txdev at "rate" packets per second, or as
+ * fast as we can if "rate" is 0, for "secs" seconds, and write the
+ * number sent to "fd".
+ */
+static void
+sender(int size, int rate, double secs, int fd)
+{
+	char errbuf[PCAP_ERRBUF_SIZE];
+	u_char pkt[65536];
+	pcap_t *pd;
+	u_long sent, failed;
+	double start, t;
+	u_char *ip;
+
+	pd = pcap_open_live(txdev, 65535, 0, 1000, errbuf);
+	if (pd == NULL)
+		error("%s", errbuf);
+
+	memset(pkt, 0, size);
+	memset(pkt, 0xff, 6);
+	pkt[6] = 0x02;
+	put_short(pkt + 12, 0x0800);
+	ip = pkt + 14;
+	ip[0] = 0x45;
+	put_short(ip + 2, size - 14);
+	ip[8] = 64;
+	ip[9] = 17;
+	ip[12] = 192;
+	ip[13] = 0;
+	ip[14] = 2;
+	ip[15] = 1;
+	ip[16] = 192;
+	ip[17] = 0;
+	ip[18] = 2;
+	ip[19] = 2;
+	put_short(ip + 20, 1024);
+	put_short(ip + 22, BENCH_PORT);
+	put_short(ip + 24, size - 14 - 20);
+	memcpy(pkt + MAGIC_OFF, BENCH_MAGIC, sizeof(BENCH_MAGIC) - 1);
+
+	sent = 0;
+	failed = 0;
+	start = now();
+	for (;;) {
+		t = now() - start;
+		if (t >= secs)
+			break;
+		if (rate != 0 && sent >= t * rate) {
+			/*
+			 * Ahead of schedule; sleep briefly, unless
+			 * the next packet is due within 50us.
+			 */
+			if ((sent - t * rate) / rate > 50e-6)
+				usleep(20);
+			continue;
+		}
+		if (pcap_inject(pd, pkt, size) == -1) {
+			/*
+			 * The veth queue is full; try again.
+			 */
+			failed++;
+			continue;
+		}
+		sent++;
+	}
+	pcap_close(pd);
+	(void)write(fd, &sent, sizeof(sent));
+	_exit(0);
+}
+
+static u_long captured;
+static pcap_t *capture_pd;
+static int snaplen = 65535;
+
+static void
+sigchld(int sig _U_)
+{
+	if (capture_pd != NULL)
+		pcap_breakloop(capture_pd);
+}
+
+static void
+count_packet(u_char *user, const struct pcap_pkthdr *h, const u_char *pkt)
+{
+	size_t off = *(size_t *)user;
+
+	/*
+	 * Count only our packets; without a filter, other traffic on
+	 * the device is captured as well.
+	 */
+	if (h->caplen >= off + sizeof(BENCH_MAGIC) - 1 &&
+	    memcmp(pkt + off, BENCH_MAGIC, sizeof(BENCH_MAGIC) - 1) == 0)
+		captured++;
+}
+
+static void
+run(const char *mode, int filter, int bufsize_kb, int size, int rate,
+    double secs)
+{
+	char errbuf[PCAP_ERRBUF_SIZE];
+	struct bpf_program fcode;
+	struct pcap_stat ps;
+	struct rusage ru0, ru1;
+	pcap_t *pd;
+	const char *dev;
+	int fds[2], status, n;
+	pid_t pid;
+	u_long sent, wakeups;
+	double start, elapsed, last, cpu;
+	size_t off;
+
+	/*
+	 * Pick the ring version, or no ring, for this run.
+	 */
+	if (strcmp(mode, "v1") == 0)
+		setenv("PCAP_LINUX_RING", "v1", 1);
+	else if (strcmp(mode, "nommap") == 0)
+		setenv("PCAP_LINUX_RING", "none", 1);
+	else
+		unsetenv("PCAP_LINUX_RING");
+
+	if (strcmp(mode, "cooked") == 0) {
+		dev = "any";
+		off = 16 + 20 + 8;	/* cooked header + IPv4 + UDP */
+	} else {
+		dev = rxdev;
+		off = MAGIC_OFF;
+	}
+
+	pd = pcap_create(dev, errbuf);
+	if (pd == NULL)
+		error("%s", errbuf);
+	if (pcap_set_snaplen(pd, snaplen) != 0 ||
+	    pcap_set_timeout(pd, 100) != 0 ||
+	    pcap_set_buffer_size(pd, bufsize_kb * 1024) != 0)
+		error("%s: can't set options", dev);
+	status = pcap_activate(pd);
+	if (status < 0)
+		error("%s: %s", dev, pcap_geterr(pd));
+	if (strcmp(mode, "cooked") == 0 &&
+	    pcap_setdirection(pd, PCAP_D_IN) != 0)
+		error("%s: %s", dev, pcap_geterr(pd));
+	if (filter != FILTER_NONE) {
+		if (pcap_compile(pd, &fcode,
+		    filter == FILTER_SAMPLE ? SAMPLE_FILTER : BENCH_FILTER, 1,
+		    PCAP_NETMASK_UNKNOWN) < 0 ||
+		    pcap_setfilter(pd, &fcode) < 0)
+			error("%s: %s", dev, pcap_geterr(pd));
+		pcap_freecode(&fcode);
+	}
+
+	if (pipe(fds) < 0)
+		error("pipe: %s", pcap_strerror(errno));
+	captured = 0;
+	wakeups = 0;
+	capture_pd = pd;
+	getrusage(RUSAGE_SELF, &ru0);
+	start = now();
+	pid = fork();
+	if (pid < 0)
+		error("fork: %s", pcap_strerror(errno));
+	if (pid == 0) {
+		/*
+		 * Leave removing the veth pair to the parent.
+		 */
+		signal(SIGINT, SIG_DFL);
+		signal(SIGTERM, SIG_DFL);
+		close(fds[0]);
+		pcap_close(pd);
+		sender(size, rate, secs, fds[1]);
+		/* NOTREACHED */
+	}
+	close(fds[1]);
+
+	/*
+	 * Capture until the sender is done; SIGCHLD breaks us out of
+	 * pcap_dispatch(), as the read doesn't time out in all modes.
+	 * Then read, without blocking, until nothing more has arrived
+	 * for a little while, to get what's still in the buffer.
+	 */
+	for (;;) {
+		n = pcap_dispatch(pd, -1, count_packet, (u_char *)&off);
+		if (n == PCAP_ERROR_BREAK)
+			break;
+		if (n < 0)
+			error("%s: %s", dev, pcap_geterr(pd));
+		wakeups++;
+	}
+	if (waitpid(pid, &status, 0) < 0)
+		error("waitpid: %s", pcap_strerror(errno));
+	if (pcap_setnonblock(pd, 1, errbuf) < 0)
+		error("%s", errbuf);
+	last = now();
+	while (now() - last < 0.2) {
+		n = pcap_dispatch(pd, -1, count_packet, (u_char *)&off);
+		if (n < 0)
+			error("%s: %s", dev, pcap_geterr(pd));
+		if (n > 0) {
+			wakeups++;
+			last = now();
+		} else
+			usleep(1000);
+	}
+	elapsed = now() - start;
+	getrusage(RUSAGE_SELF, &ru1);
+
+	if (pcap_stats(pd, &ps) < 0)
+		error("%s: %s", dev, pcap_geterr(pd));
+	if (read(fds[0], &sent, sizeof(sent)) != sizeof(sent))
+		error("sender failed");
+	close(fds[0]);
+	capture_pd = NULL;
+	pcap_close(pd);
+
+	cpu = tv_secs(&ru1.ru_utime) - tv_secs(&ru0.ru_utime) +
+	    tv_secs(&ru1.ru_stime) - tv_secs(&ru0.ru_stime);
+	printf("%s\t%s\t%d\t%d\t%lu\t%.0f\t%lu\t%.0f\t%u\t%.1f\t%.0f\t%.0f\n",
+	    mode, filter_names[filter], bufsize_kb, size, sent,
+	    sent / secs, captured, captured / secs, ps.ps_drop,
+	    100.0 * cpu / elapsed,
+	    (ru1.ru_nvcsw - ru0.ru_nvcsw + ru1.ru_nivcsw - ru0.ru_nivcsw) /
+	    elapsed, wakeups / elapsed);
+	fflush(stdout);
+}
+
+int
+main(int argc, char **argv)
+{
+	char *cp;
+	int op, i, j, k, f;
+	char *modes, *mode, *devs;
+	int sizes[MAX_LIST], nsizes;
+	int bufsizes[MAX_LIST], nbufsizes;
+	int filters[2], nfilters;
+	int rate;
+	double secs;
+
+	modes = strdup("v2,v1,nommap,cooked");
+	sizes[0] = 64;
+	sizes[1] = 1500;
+	nsizes = 2;
+	bufsizes[0] = 2048;
+	nbufsizes = 1;
+	filters[0] = FILTER_NONE;
+	filters[1] = FILTER_KERNEL;
+	nfilters = 2;
+	rate = 0;
+	secs = 2.0;
+	devs = NULL;
+
+	if ((cp = strrchr(argv[0], '/')) != NULL)
+		program_name = cp + 1;
+	else
+		program_name = argv[0];
+
+	opterr = 0;
+	while ((op = getopt(argc, argv, "B:d:f:m:r:S:s:t:")) != -1) {
+		switch (op) {
+
+		case 'B':
+			nbufsizes = parse_list(optarg, bufsizes,
+			    "buffer size");
+			break;
+
+		case 'd':
+			devs = optarg;
+			break;
+
+		case 'f':
+			if (strcmp(optarg, "both") == 0) {
+				filters[0] = FILTER_NONE;
+				filters[1] = FILTER_KERNEL;
+				nfilters = 2;
+			} else if (strcmp(optarg, "none") == 0) {
+				filters[0] = FILTER_NONE;
+				nfilters = 1;
+			} else if (strcmp(optarg, "kernel") == 0) {
+				filters[0] = FILTER_KERNEL;
+				nfilters = 1;
+			} else if (strcmp(optarg, "sample") == 0) {
+				/*
+				 * Only a quarter of the packets should be
+				 * captured; checks that the kernel, which
+				 * does the sampling, gets "sample" right in
+				 * every mode, including cooked mode.
+				 */
+				filters[0] = FILTER_SAMPLE;
+				nfilters = 1;
+			} else
+				error("invalid filter setting %s", optarg);
+			break;
+
+		case 'm':
+			free(modes);
+			modes = strdup(optarg);
+			break;
+
+		case 'r':
+			rate = atoi(optarg);
+			if (rate < 0)
+				error("invalid rate %s", optarg);
+			break;
+
+		case 'S':
+			snaplen = atoi(optarg);
+			if (snaplen <= 0)
+				error("invalid snapshot length %s", optarg);
+			break;
+
+		case 's':
+			nsizes = parse_list(optarg, sizes, "packet size");
+			for (i = 0; i < nsizes; i++)
+				if (sizes[i] < MAGIC_OFF + 16 ||
+				    sizes[i] > 65535)
+					error("packet size %d out of range",
+					    sizes[i]);
+			break;
+
+		case 't':
+			secs = atof(optarg);
+			if (secs <= 0)
+				error("invalid duration %s", optarg);
+			break;
+
+		default:
+			usage();
+			/* NOTREACHED */
+		}
+	}
+	if (optind != argc)
+		usage();
+	if (modes == NULL)
+		error("strdup: %s", pcap_strerror(errno));
+
+	if (devs != NULL) {
+		/*
+		 * Use an existing pair, "txdev:rxdev".
+		 */
+		cp = strchr(devs, ':');
+		if (cp == NULL || (size_t)(cp - devs) >= sizeof(txdev) ||
+		    strlen(cp + 1) >= sizeof(rxdev))
+			error("invalid device pair %s", devs);
+		memcpy(txdev, devs, cp - devs);
+		txdev[cp - devs] = '\0';
+		strcpy(rxdev, cp + 1);
+	} else {
+		snprintf(txdev, sizeof(txdev), "pcapb%d", (int)getpid() % 10000);
+		snprintf(rxdev, sizeof(rxdev), "pcapb%dp", (int)getpid() % 10000);
+		create_veth();
+	}
+
+	signal(SIGCHLD, sigchld);
+	printf("# %s\ttx=%s\trx=%s\trate=%d\tsnaplen=%d\tseconds=%g\n",
+	    pcap_lib_version(), txdev, rxdev, rate, snaplen, secs);
+	printf("# mode\tfilter\tbuffer_kb\tsize\tsent\tsent_pps\tcaptured\tcaptured_pps\tdrops\tcpu_pct\tcsw_per_s\twakeups_per_s\n");
+
+	for (mode = strtok(modes, ","); mode != NULL;
+	    mode = strtok(NULL, ",")) {
+		if (strcmp(mode, "v2") != 0 && strcmp(mode, "v1") != 0 &&
+		    strcmp(mode, "nommap") != 0 &&
+		    strcmp(mode, "cooked") != 0)
+			error("unknown mode %s", mode);
+		for (f = 0; f < nfilters; f++)
+			for (j = 0; j < nbufsizes; j++)
+				for (k = 0; k < nsizes; k++)
+					run(mode, filters[f], bufsizes[j],
+					    sizes[k], rate, secs);
+	}
+	free(modes);
+	exit(0);
+}
+
+/* VARARGS */
+static void
+error(const char *fmt, ...)
+{
+	va_list ap;
+
+	(void)fprintf(stderr, "%s: ", program_name);
+	va_start(ap, fmt);
+	(void)vfprintf(stderr, fmt, ap);
+	va_end(ap);
+	if (*fmt) {
+		fmt += strlen(fmt);
+		if (fmt[-1] != '\n')
+			(void)fputc('\n', stderr);
+	}
+	exit(1);
+	/* NOTREACHED */
+}
+
+static void
+usage(void)
+{
+	(void)fprintf(stderr, "%s, with %s\n", program_name,
+	    pcap_lib_version());
+	(void)fprintf(stderr,
+	    "Usage: %s [ -B buffer_kb,... ] [ -d txdev:rxdev ] [ -f both|none|kernel|sample ]\n"
+	    "\t[ -m v2,v1,nommap,cooked ] [ -r pps ] [ -S snaplen ]\n"
+	    "\t[ -s size,... ] [ -t seconds ]\n",
+	    program_name);
+	exit(1);
+}
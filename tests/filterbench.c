@@ -0,0 +1,790 @@
+/*
+ * Copyright (c) 1988, 1989, 1990, 1991, 1992, 1993, 1994, 1995, 1996, 1997, 2000
+ *	The Regents of the University of California.  All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that: (1) source code distributions
+ * retain the above copyright notice and this paragraph in its entirety, (2)
+ * distributions including binary code include the above copyright notice and
+ * this paragraph in its entirety in the documentation or other materials
+ * provided with the distribution, and (3) all advertising materials mentioning
+ * features or use of this software display the following acknowledgement:
+ * ``This product includes software developed by the University of California,
+ * Lawrence Berkeley Laboratory and its contributors.'' Neither the name of
+ * the University nor the names of its contributors may be used to endorse
+ * or promote products derived from this software without specific prior
+ * written permission.
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+ * WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/*
+ * filterbench - measure how fast filter expressions compile and run.
+ *
+ * For each expression in a corpus, report the time pcap_compile() takes,
+ * the size of the optimized and unoptimized programs, the time
+ * bpf_filter() takes per packet over a packet mix, the number of
+ * instructions it executes per packet, and the percentage of packets the
+ * filter accepts.  The output is one tab-separated line per expression,
+ * after a header line starting with "#", so that runs can be compared
+ * with diff, join or a spreadsheet.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <pcap.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/time.h>
+
+#ifndef HAVE___ATTRIBUTE__
+#define __attribute__(x)
+#endif
+
+static char *program_name;
+
+/* Forwards */
+static void usage(void) __attribute__((noreturn));
+static void error(const char *, ...)
+    __attribute__((noreturn, format (printf, 1, 2)));
+
+extern int optind;
+extern int opterr;
+extern char *optarg;
+
+/*
+ * The built-in corpus, from simple expressions up to generated
+ * policies; a name of the form "policy-N" is generated with N terms.
+ */
+static const struct {
+	const char *name;
+	const char *expr;
+} corpus[] = {
+	{ "empty",		"" },
+	{ "ip",			"ip" },
+	{ "host",		"host 10.0.0.1" },
+	{ "net",		"net 10.1.0.0/16" },
+	{ "port",		"port 80" },
+	{ "tcp-port",		"tcp port 443" },
+	{ "portrange",		"udp portrange 5000-6000" },
+	{ "host-port",		"host 10.0.0.1 and tcp port 80" },
+	{ "tcp-flags",		"tcp[tcpflags] & (tcp-syn|tcp-fin) != 0" },
+	{ "not-ssh",		"not (tcp port 22)" },
+	{ "ip6-host",		"ip6 host 2001:db8::1" },
+	{ "vlan",		"vlan and udp port 53" },
+	{ "frag",		"ip[6:2] & 0x3fff != 0" },
+	{ "len",		"greater 200 and less 1000" },
+	{ "headers-only",	"headers-only tcp or udp" },
+	{ "multi-host",		"host 10.0.0.1 or host 10.0.0.2 or host 10.0.0.3 or host 10.0.0.4" },
+	{ "policy-16",		NULL },
+	{ "policy-256",		NULL },
+	{ "policy-1024",	NULL },
+};
+#define CORPUS_SIZE	(sizeof(corpus) / sizeof(corpus[0]))
+
+/*
+ * A policy of "n" terms, each matching a host and a port, as generated
+ * by a firewall front end.
+ */
+static char *
+gen_policy(int n)
+{
+	char *buf, *cp;
+	size_t size;
+	int i;
+
+	size = (size_t)n * 64 + 1;
+	buf = malloc(size);
+	if (buf == NULL)
+		error("malloc: %s", pcap_strerror(errno));
+	cp = buf;
+	*cp = '\0';
+	for (i = 0; i < n; i++) {
+		cp += snprintf(cp, size - (cp - buf),
+		    "%s(src host 10.%d.%d.%d and tcp dst port %d)",
+		    i == 0 ? "" : " or ", (i >> 16) & 0xff, (i >> 8) & 0xff,
+		    i & 0xff, 1024 + i % 4096);
+	}
+	return (buf);
+}
+
+/*
+ * The packet mix.
+ */
+struct packet {
+	struct pcap_pkthdr hdr;
+	u_char *data;
+};
+
+static struct packet *packets;
+static int npackets;
+
+/*
+ * A simple LCG, so that the synthetic mix is the same on every run.
+ */
+static u_int
+mix_random(void)
+{
+	static u_int seed = 1;
+
+	seed = seed * 1103515245 + 12345;
+	return (seed >> 8);
+}
+
+static void
+put_short(u_char *p, u_int v)
+{
+	p[0] = (v >> 8) & 0xff;
+	p[1] = v & 0xff;
+}
+
+/*
+ * Build an Ethernet packet: mostly IPv4 TCP and UDP, with some IPv6,
+ * ARP, VLAN-tagged and fragmented packets.  IPv4 packets go to one of
+ * a few well-known ports, or, for some TCP packets, to the port that
+ * the term for their source host in a generated policy allows, so that
+ * every expression in the corpus matches some packets.
+ */
+static void
+gen_packet(struct packet *pkt)
+{
+	static const u_int services[] = { 80, 443, 53 };
+	u_char *p, *ip;
+	u_int kind, len, off, proto, paylen;
+
+	kind = mix_random() % 100;
+	paylen = mix_random() % 1400;
+	len = 14 + 4 + 40 + 20 + paylen;
+	p = calloc(1, len);
+	if (p == NULL)
+		error("calloc: %s", pcap_strerror(errno));
+	memset(p, 0x11, 6);
+	memset(p + 6, 0x22, 6);
+	off = 12;
+	if (kind >= 90 && kind < 95) {
+		/* VLAN-tagged */
+		put_short(p + off, 0x8100);
+		put_short(p + off + 2, 100);
+		off += 4;
+	}
+	proto = (kind % 3 == 0) ? 17 : 6;
+	if (kind >= 95) {
+		/* ARP */
+		put_short(p + off, 0x0806);
+		len = off + 2 + 28;
+	} else if (kind >= 80 && kind < 90) {
+		/* IPv6 */
+		put_short(p + off, 0x86dd);
+		ip = p + off + 2;
+		ip[0] = 0x60;
+		put_short(ip + 4, 20 + paylen);
+		ip[6] = proto;
+		ip[7] = 64;
+		ip[8] = 0x20;
+		ip[9] = 0x01;
+		ip[10] = 0x0d;
+		ip[11] = 0xb8;
+		ip[23] = mix_random() % 4;
+		ip[24] = 0x20;
+		ip[25] = 0x01;
+		ip[26] = 0x0d;
+		ip[27] = 0xb8;
+		ip[39] = mix_random() % 4;
+		put_short(ip + 40, 1024 + mix_random() % 8192);
+		put_short(ip + 42, (kind & 1) ? 80 : 53);
+		ip[40 + 13] = 0x10;
+		ip[40 + 12] = 0x50;
+		len = off + 2 + 40 + 20 + paylen;
+	} else {
+		/* IPv4 */
+		put_short(p + off, 0x0800);
+		ip = p + off + 2;
+		ip[0] = 0x45;
+		put_short(ip + 2, 20 + 20 + paylen);
+		if (kind >= 75 && kind < 80)
+			put_short(ip + 6, 0x2000 | (mix_random() % 100));
+		ip[8] = 64;
+		ip[9] = proto;
+		ip[12] = 10;
+		ip[13] = mix_random() % 2;
+		ip[14] = mix_random() % 4;
+		ip[15] = mix_random() % 8;
+		ip[16] = 10;
+		ip[17] = mix_random() % 2;
+		ip[18] = mix_random() % 4;
+		ip[19] = mix_random() % 8;
+		put_short(ip + 20, 1024 + mix_random() % 8192);
+		if (proto == 6 && mix_random() % 8 == 0) {
+			/*
+			 * A service the generated policies allow
+			 * for this source host.
+			 */
+			put_short(ip + 22, 1024 + (ip[14] << 8 | ip[15]));
+		} else
+			put_short(ip + 22, services[mix_random() % 3]);
+		ip[20 + 12] = 0x50;
+		ip[20 + 13] = (kind % 7 == 0) ? 0x02 : 0x10;
+		len = off + 2 + 20 + 20 + paylen;
+	}
+	pkt->hdr.ts.tv_sec = 0;
+	pkt->hdr.ts.tv_usec = 0;
+	pkt->hdr.len = len;
+	pkt->hdr.caplen = len;
+	pkt->data = p;
+}
+
+static void
+gen_packets(int n)
+{
+	int i;
+
+	packets = calloc(n, sizeof(*packets));
+	if (packets == NULL)
+		error("calloc: %s", pcap_strerror(errno));
+	for (i = 0; i < n; i++)
+		gen_packet(&packets[i]);
+	npackets = n;
+}
+
+/*
+ * Read up to "n" packets from a savefile into memory.
+ */
+static int
+read_packets(const char *fname, int n)
+{
+	char errbuf[PCAP_ERRBUF_SIZE];
+	struct pcap_pkthdr *h;
+	const u_char *data;
+	pcap_t *pd;
+	int dlt;
+
+	pd = pcap_open_offline(fname, errbuf);
+	if (pd == NULL)
+		error("%s", errbuf);
+	packets = calloc(n, sizeof(*packets));
+	if (packets == NULL)
+		error("calloc: %s", pcap_strerror(errno));
+	npackets = 0;
+	while (npackets < n && pcap_next_ex(pd, &h, &data) == 1) {
+		packets[npackets].hdr = *h;
+		packets[npackets].data = malloc(h->caplen);
+		if (packets[npackets].data == NULL)
+			error("malloc: %s", pcap_strerror(errno));
+		memcpy(packets[npackets].data, data, h->caplen);
+		npackets++;
+	}
+	if (npackets == 0)
+		error("no packets in %s", fname);
+	dlt = pcap_datalink(pd);
+	pcap_close(pd);
+	return (dlt);
+}
+
+/*
+ * Run a program as bpf_filter() does, counting the instructions
+ * executed; returns what bpf_filter() would.  Loads from outside the
+ * packet reject it, as they do in bpf_filter(); the random number
+ * "sample" uses is always 0, so for programs that use one we only
+ * count instructions, along the path a random number of 0 takes.
+ */
+static u_int
+count_filter(const struct bpf_insn *pc, const u_char *p, u_int wirelen,
+    u_int buflen, u_long *countp)
+{
+	u_int32_t A = 0, X = 0, k;
+	u_int32_t mem[BPF_MEMWORDS];
+	u_long count = 0;
+
+	memset(mem, 0, sizeof(mem));
+	for (;; ++pc) {
+		count++;
+		switch (pc->code) {
+
+		case BPF_RET|BPF_K:
+			*countp += count;
+			return (pc->k);
+
+		case BPF_RET|BPF_A:
+			*countp += count;
+			return (A);
+
+		case BPF_LD|BPF_W|BPF_ABS:
+		case BPF_LD|BPF_H|BPF_ABS:
+		case BPF_LD|BPF_B|BPF_ABS:
+		case BPF_LD|BPF_W|BPF_IND:
+		case BPF_LD|BPF_H|BPF_IND:
+		case BPF_LD|BPF_B|BPF_IND:
+			k = pc->k;
+			if (BPF_MODE(pc->code) == BPF_IND)
+				k += X;
+			else if (pc->code == (BPF_LD|BPF_W|BPF_ABS) &&
+			    k == BPF_AD_RANDOM) {
+				A = 0;
+				break;
+			}
+			switch (BPF_SIZE(pc->code)) {
+
+			case BPF_W:
+				if (k > buflen || 4 > buflen - k)
+					goto reject;
+				A = (u_int32_t)p[k] << 24 | p[k + 1] << 16 |
+				    p[k + 2] << 8 | p[k + 3];
+				break;
+
+			case BPF_H:
+				if (k > buflen || 2 > buflen - k)
+					goto reject;
+				A = p[k] << 8 | p[k + 1];
+				break;
+
+			default:
+				if (k >= buflen)
+					goto reject;
+				A = p[k];
+				break;
+			}
+			break;
+
+		case BPF_LD|BPF_W|BPF_LEN:
+			A = wirelen;
+			break;
+
+		case BPF_LDX|BPF_W|BPF_LEN:
+			X = wirelen;
+			break;
+
+		case BPF_LDX|BPF_MSH|BPF_B:
+			if (pc->k >= buflen)
+				goto reject;
+			X = (p[pc->k] & 0xf) << 2;
+			break;
+
+		case BPF_LD|BPF_IMM:
+			A = pc->k;
+			break;
+
+		case BPF_LDX|BPF_IMM:
+			X = pc->k;
+			break;
+
+		case BPF_LD|BPF_MEM:
+			A = mem[pc->k];
+			break;
+
+		case BPF_LDX|BPF_MEM:
+			X = mem[pc->k];
+			break;
+
+		case BPF_ST:
+			mem[pc->k] = A;
+			break;
+
+		case BPF_STX:
+			mem[pc->k] = X;
+			break;
+
+		case BPF_JMP|BPF_JA:
+			pc += pc->k;
+			break;
+
+		case BPF_JMP|BPF_JGT|BPF_K:
+			pc += (A > pc->k) ? pc->jt : pc->jf;
+			break;
+
+		case BPF_JMP|BPF_JGE|BPF_K:
+			pc += (A >= pc->k) ? pc->jt : pc->jf;
+			break;
+
+		case BPF_JMP|BPF_JEQ|BPF_K:
+			pc += (A == pc->k) ? pc->jt : pc->jf;
+			break;
+
+		case BPF_JMP|BPF_JSET|BPF_K:
+			pc += (A & pc->k) ? pc->jt : pc->jf;
+			break;
+
+		case BPF_JMP|BPF_JGT|BPF_X:
+			pc += (A > X) ? pc->jt : pc->jf;
+			break;
+
+		case BPF_JMP|BPF_JGE|BPF_X:
+			pc += (A >= X) ? pc->jt : pc->jf;
+			break;
+
+		case BPF_JMP|BPF_JEQ|BPF_X:
+			pc += (A == X) ? pc->jt : pc->jf;
+			break;
+
+		case BPF_JMP|BPF_JSET|BPF_X:
+			pc += (A & X) ? pc->jt : pc->jf;
+			break;
+
+		case BPF_ALU|BPF_ADD|BPF_X:
+			A += X;
+			break;
+
+		case BPF_ALU|BPF_SUB|BPF_X:
+			A -= X;
+			break;
+
+		case BPF_ALU|BPF_MUL|BPF_X:
+			A *= X;
+			break;
+
+		case BPF_ALU|BPF_DIV|BPF_X:
+			if (X == 0)
+				goto reject;
+			A /= X;
+			break;
+
+		case BPF_ALU|BPF_AND|BPF_X:
+			A &= X;
+			break;
+
+		case BPF_ALU|BPF_OR|BPF_X:
+			A |= X;
+			break;
+
+		case BPF_ALU|BPF_LSH|BPF_X:
+			A <<= X;
+			break;
+
+		case BPF_ALU|BPF_RSH|BPF_X:
+			A >>= X;
+			break;
+
+		case BPF_ALU|BPF_ADD|BPF_K:
+			A += pc->k;
+			break;
+
+		case BPF_ALU|BPF_SUB|BPF_K:
+			A -= pc->k;
+			break;
+
+		case BPF_ALU|BPF_MUL|BPF_K:
+			A *= pc->k;
+			break;
+
+		case BPF_ALU|BPF_DIV|BPF_K:
+			A /= pc->k;
+			break;
+
+		case BPF_ALU|BPF_AND|BPF_K:
+			A &= pc->k;
+			break;
+
+		case BPF_ALU|BPF_OR|BPF_K:
+			A |= pc->k;
+			break;
+
+		case BPF_ALU|BPF_LSH|BPF_K:
+			A <<= pc->k;
+			break;
+
+		case BPF_ALU|BPF_RSH|BPF_K:
+			A >>= pc->k;
+			break;
+
+		case BPF_ALU|BPF_NEG:
+			A = -A;
+			break;
+
+		case BPF_MISC|BPF_TAX:
+			X = A;
+			break;
+
+		case BPF_MISC|BPF_TXA:
+			A = X;
+			break;
+
+		default:
+			goto reject;
+		}
+	}
+reject:
+	*countp += count;
+	return (0);
+}
+
+/*
+ * Return 1 if a program loads random numbers, as "sample" does, in
+ * which case its results vary from run to run.
+ */
+static int
+uses_random(const struct bpf_program *fcode)
+{
+	u_int i;
+
+	for (i = 0; i < fcode->bf_len; i++)
+		if (fcode->bf_insns[i].code == (BPF_LD|BPF_W|BPF_ABS) &&
+		    fcode->bf_insns[i].k == BPF_AD_RANDOM)
+			return (1);
+	return (0);
+}
+
+static double
+elapsed_ns(const struct timeval *start, const struct timeval *end)
+{
+	return ((end->tv_sec - start->tv_sec) * 1e9 +
+	    (end->tv_usec - start->tv_usec) * 1e3);
+}
+
+/*
+ * Compile an expression repeatedly, for at least 20ms, and return the
+ * average time per compile in microseconds.
+ */
+static double
+time_compile(pcap_t *pd, const char *expr, int optimize,
+    struct bpf_program *fcode)
+{
+	struct timeval start, now;
+	double ns;
+	int n;
+
+	gettimeofday(&start, NULL);
+	n = 0;
+	do {
+		if (n != 0)
+			pcap_freecode(fcode);
+		if (pcap_compile(pd, fcode, expr, optimize,
+		    PCAP_NETMASK_UNKNOWN) < 0)
+			error("%s", pcap_geterr(pd));
+		n++;
+		gettimeofday(&now, NULL);
+		ns = elapsed_ns(&start, &now);
+	} while (ns < 20e6);
+	return (ns / n / 1e3);
+}
+
+static void
+bench(pcap_t *pd, const char *name, const char *expr, int iterations)
+{
+	struct bpf_program fcode, unopt;
+	struct timeval start, end;
+	double compile_us, ns;
+	u_long insns;
+	u_int accepted, ret;
+	int i, j, random;
+
+	compile_us = time_compile(pd, expr, 1, &fcode);
+	if (pcap_compile(pd, &unopt, expr, 0, PCAP_NETMASK_UNKNOWN) < 0)
+		error("%s", pcap_geterr(pd));
+
+	/*
+	 * Count instructions and accepted packets in one pass, checking
+	 * that the counter agrees with bpf_filter() unless the program
+	 * uses random numbers; then time bpf_filter() alone.
+	 */
+	random = uses_random(&fcode);
+	insns = 0;
+	accepted = 0;
+	for (j = 0; j < npackets; j++) {
+		ret = bpf_filter(fcode.bf_insns, packets[j].data,
+		    packets[j].hdr.len, packets[j].hdr.caplen);
+		if (count_filter(fcode.bf_insns, packets[j].data,
+		    packets[j].hdr.len, packets[j].hdr.caplen, &insns) != ret &&
+		    !random)
+			error("%s: instruction counter disagrees with bpf_filter() on packet %d",
+			    name, j);
+		if (ret != 0)
+			accepted++;
+	}
+
+	gettimeofday(&start, NULL);
+	for (i = 0; i < iterations; i++) {
+		for (j = 0; j < npackets; j++)
+			(void)bpf_filter(fcode.bf_insns, packets[j].data,
+			    packets[j].hdr.len, packets[j].hdr.caplen);
+	}
+	gettimeofday(&end, NULL);
+	ns = elapsed_ns(&start, &end) / ((double)iterations * npackets);
+
+	printf("%s\t%u\t%u\t%.1f\t%.2f\t%.2f\t%.1f\n", name, fcode.bf_len,
+	    unopt.bf_len, compile_us, ns, (double)insns / npackets,
+	    100.0 * accepted / npackets);
+	fflush(stdout);
+	pcap_freecode(&fcode);
+	pcap_freecode(&unopt);
+}
+
+int
+main(int argc, char **argv)
+{
+	char *cp;
+	int op;
+	char *infile, *corpusfile, *only;
+	int dlt, iterations, count;
+	long snaplen;
+	pcap_t *pd;
+	char line[65536];
+	FILE *fp;
+	u_int i;
+	int n;
+
+	infile = NULL;
+	corpusfile = NULL;
+	only = NULL;
+	iterations = 100;
+	count = 1000;
+	snaplen = 65535;
+	dlt = DLT_EN10MB;
+
+	if ((cp = strrchr(argv[0], '/')) != NULL)
+		program_name = cp + 1;
+	else
+		program_name = argv[0];
+
+	opterr = 0;
+	while ((op = getopt(argc, argv, "c:e:F:i:r:s:")) != -1) {
+		switch (op) {
+
+		case 'c':
+			count = atoi(optarg);
+			if (count <= 0)
+				error("invalid packet count %s", optarg);
+			break;
+
+		case 'e':
+			only = optarg;
+			break;
+
+		case 'F':
+			corpusfile = optarg;
+			break;
+
+		case 'i':
+			iterations = atoi(optarg);
+			if (iterations <= 0)
+				error("invalid iteration count %s", optarg);
+			break;
+
+		case 'r':
+			infile = optarg;
+			break;
+
+		case 's': {
+			char *end;
+
+			snaplen = strtol(optarg, &end, 0);
+			if (optarg == end || *end != '\0'
+			    || snaplen <= 0 || snaplen > 65535)
+				error("invalid snaplen %s", optarg);
+			break;
+		}
+
+		default:
+			usage();
+			/* NOTREACHED */
+		}
+	}
+	if (optind < argc - 1)
+		usage();
+
+	if (infile != NULL)
+		dlt = read_packets(infile, count);
+	else {
+		if (optind < argc) {
+			dlt = pcap_datalink_name_to_val(argv[optind]);
+			if (dlt != DLT_EN10MB)
+				error("synthetic packets are Ethernet packets; use -r for %s",
+				    argv[optind]);
+		}
+		gen_packets(count);
+	}
+
+	pd = pcap_open_dead(dlt, snaplen);
+	if (pd == NULL)
+		error("Can't open fake pcap_t");
+
+	printf("# %s\tdlt=%s\tpackets=%d\titerations=%d\tmix=%s\n",
+	    pcap_lib_version(), pcap_datalink_val_to_name(dlt), npackets,
+	    iterations, infile != NULL ? infile : "synthetic");
+	printf("# name\tinsns\tinsns_unopt\tcompile_us\tns_per_pkt\tinsns_per_pkt\taccept_pct\n");
+
+	if (corpusfile != NULL) {
+		/*
+		 * One expression per line, optionally preceded by a
+		 * name and a tab; blank lines and lines starting with
+		 * "#" are skipped.
+		 */
+		fp = fopen(corpusfile, "r");
+		if (fp == NULL)
+			error("can't open %s: %s", corpusfile,
+			    pcap_strerror(errno));
+		n = 0;
+		while (fgets(line, sizeof(line), fp) != NULL) {
+			char name[32], *expr;
+
+			n++;
+			line[strcspn(line, "\r\n")] = '\0';
+			if (line[0] == '\0' || line[0] == '#')
+				continue;
+			expr = strchr(line, '\t');
+			if (expr != NULL) {
+				*expr++ = '\0';
+				bench(pd, line, expr, iterations);
+			} else {
+				snprintf(name, sizeof(name), "line-%d", n);
+				bench(pd, name, line, iterations);
+			}
+		}
+		fclose(fp);
+	} else {
+		for (i = 0; i < CORPUS_SIZE; i++) {
+			char *expr;
+
+			if (only != NULL && strcmp(only, corpus[i].name) != 0)
+				continue;
+			if (corpus[i].expr != NULL)
+				bench(pd, corpus[i].name, corpus[i].expr,
+				    iterations);
+			else {
+				expr = gen_policy(atoi(corpus[i].name +
+				    strlen("policy-")));
+				bench(pd, corpus[i].name, expr, iterations);
+				free(expr);
+			}
+		}
+	}
+	pcap_close(pd);
+	exit(0);
+}
+
+/* VARARGS */
+static void
+error(const char *fmt, ...)
+{
+	va_list ap;
+
+	(void)fprintf(stderr, "%s: ", program_name);
+	va_start(ap, fmt);
+	(void)vfprintf(stderr, fmt, ap);
+	va_end(ap);
+	if (*fmt) {
+		fmt += strlen(fmt);
+		if (fmt[-1] != '\n')
+			(void)fputc('\n', stderr);
+	}
+	exit(1);
+	/* NOTREACHED */
+}
+
+static void
+usage(void)
+{
+	(void)fprintf(stderr, "%s, with %s\n", program_name,
+	    pcap_lib_version());
+	(void)fprintf(stderr,
+	    "Usage: %s [ -c count ] [ -e name ] [ -F corpus ] [ -i iterations ]\n"
+	    "\t[ -r file ] [ -s snaplen ] [ dlt ]\n",
+	    program_name);
+	exit(1);
+}
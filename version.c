@@ -0,0 +1 @@
+char pcap_version[] = "1.5.0-PRE-GIT_2026_10_19";
@@ -0,0 +1 @@
+static const char pcap_version_string[] = "libpcap version 1.5.0-PRE-GIT_2026_10_19";